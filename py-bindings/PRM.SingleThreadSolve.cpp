@@ -55,7 +55,7 @@ ompl::base::PlannerStatus PRM_wrapper::solve(const ompl::base::PlannerTerminatio
 
     // Add the valid start states as milestones
     while (const base::State *st = pis_.nextStart())
-        startM_.push_back(addMilestone(si_->cloneState(st)));
+        startM_.push_back(addMilestone(si_->cloneState(st), stats_));
 
     if (startM_.size() == 0)
     {
@@ -74,7 +74,7 @@ ompl::base::PlannerStatus PRM_wrapper::solve(const ompl::base::PlannerTerminatio
     {
         const base::State *st = goalM_.empty() ? pis_.nextGoal(ptc) : pis_.nextGoal();
         if (st)
-            goalM_.push_back(addMilestone(si_->cloneState(st)));
+            goalM_.push_back(addMilestone(si_->cloneState(st), stats_));
 
         if (goalM_.empty())
         {
@@ -108,7 +108,7 @@ ompl::base::PlannerStatus PRM_wrapper::solve(const ompl::base::PlannerTerminatio
         {
             const base::State *st = pis_.nextGoal();
             if (st)
-                goalM_.push_back(addMilestone(si_->cloneState(st)));
+                goalM_.push_back(addMilestone(si_->cloneState(st), stats_));
         }
 
         // maintain a 2:1 ratio for growing/expansion of roadmap
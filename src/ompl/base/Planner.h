@@ -41,6 +41,7 @@
 #include "ompl/base/ProblemDefinition.h"
 #include "ompl/base/PlannerData.h"
 #include "ompl/base/PlannerStatus.h"
+#include "ompl/base/PlannerStatistics.h"
 #include "ompl/base/PlannerTerminationCondition.h"
 #include "ompl/base/GenericParam.h"
 #include "ompl/util/Console.h"
@@ -313,6 +314,28 @@ namespace ompl
                 (without calling clear() in between).  */
             virtual void getPlannerData(PlannerData &data) const;
 
+            /** \brief Get statistics about the work done by the
+                planner (validity checks, nearest neighbor queries,
+                samples, ...) since the last call to clear(). Repeated
+                calls to solve() add to the same counters. */
+            const PlannerStatistics& getStatistics(void) const
+            {
+                return stats_;
+            }
+
+            /** \brief Set whether the statistics include the time spent in each counted operation. This is off by
+                default, since it reads the clock twice around every validity check and nearest neighbor query. */
+            void setTimeStatistics(bool flag)
+            {
+                stats_.setTiming(flag);
+            }
+
+            /** \brief Check whether the statistics include the time spent in each counted operation */
+            bool getTimeStatistics(void) const
+            {
+                return stats_.isTiming();
+            }
+
             /** \brief Get the name of the planner */
             const std::string& getName(void) const;
 
@@ -389,6 +412,9 @@ namespace ompl
             /** \brief A map from parameter names to parameter instances for this planner. This field is populated by the declareParam() function */
             ParamSet             params_;
 
+            /** \brief Statistics about the work done since the last call to clear() */
+            PlannerStatistics    stats_;
+
             /** \brief Flag indicating whether setup() has been called */
             bool                 setup_;
         };
@@ -0,0 +1,198 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+
+#ifndef OMPL_BASE_PLANNER_STATISTICS_
+#define OMPL_BASE_PLANNER_STATISTICS_
+
+#include "ompl/util/Time.h"
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <map>
+#include <ostream>
+
+namespace ompl
+{
+    namespace base
+    {
+        /// The number of times an operation was performed and the time spent performing it
+        struct PlannerCounter
+        {
+            PlannerCounter(void) : calls(0), time(0.0), timed(false)
+            {
+            }
+
+            /// Add the calls and the time counted by \e other
+            void add(const PlannerCounter &other)
+            {
+                calls += other.calls;
+                time += other.time;
+            }
+
+            /// The number of times the operation was performed
+            unsigned long int calls;
+
+            /// The total time spent performing the operation (seconds); only measured if \e timed is set
+            double            time;
+
+            /// Whether the time spent performing the operation is measured
+            bool              timed;
+        };
+
+        /** \brief Statistics about the work done by a planner since the
+            last call to Planner::clear(). Planners update these values
+            while they solve a problem; they can be retrieved with
+            Planner::getStatistics(). Most counters only include the
+            work the planner requests directly: for example, the time
+            a motion validator spends checking states is accounted for
+            as part of the motion check. State validity checks are the
+            exception: they are counted by SpaceInformation::isValid()
+            for the thread that makes them (see ThreadScope), so they
+            include the states checked by motion validators, valid
+            state samplers and control propagation.
+
+            The counters are not reset by Planner::solve(): like the
+            planner's graph, they accumulate over repeated calls to
+            solve() until clear() is called. Calls are always counted;
+            the time spent in each operation is only measured once
+            setTiming() enables it, since reading the clock around
+            every check is not free. */
+        struct PlannerStatistics
+        {
+            /** \brief Count one call to an operation and, if the counter is timed, the time spent in the scope of this instance */
+            class Timer
+            {
+            public:
+
+                /// Start timing an operation accounted for in \e counter
+                Timer(PlannerCounter &counter) : counter_(counter)
+                {
+                    if (counter_.timed)
+                        start_ = time::now();
+                }
+
+                ~Timer(void)
+                {
+                    ++counter_.calls;
+                    if (counter_.timed)
+                        counter_.time += time::seconds(time::now() - start_);
+                }
+
+            private:
+
+                PlannerCounter &counter_;
+                time::point     start_;
+            };
+
+            /** \brief While an instance of this class exists, the state validity checks the
+                calling thread makes through SpaceInformation::isValid() are counted in the
+                given statistics. Planners create one at the start of solve() and in each of
+                their worker threads. Scopes can be nested; the innermost one counts. */
+            class ThreadScope : private boost::noncopyable
+            {
+            public:
+
+                /// Count the state validity checks of the calling thread in \e stats
+                ThreadScope(PlannerStatistics &stats);
+
+                ~ThreadScope(void);
+
+            private:
+
+                PlannerStatistics *previous_;
+            };
+
+            PlannerStatistics(void) : samples(0), graphStates(0)
+            {
+            }
+
+            /// Get the statistics the calling thread counts its state validity checks in; NULL if there is no ThreadScope for it
+            static PlannerStatistics* getThreadStatistics(void);
+
+            /// Reset all the counters; whether they are timed does not change
+            void clear(void)
+            {
+                bool timed = isTiming();
+                *this = PlannerStatistics();
+                setTiming(timed);
+            }
+
+            /// Set whether the time spent in each counted operation is measured (off by default)
+            void setTiming(bool timed)
+            {
+                stateChecks.timed = motionChecks.timed = nnQueries.timed = propagations.timed = timed;
+            }
+
+            /// Check whether the time spent in each counted operation is measured
+            bool isTiming(void) const
+            {
+                return stateChecks.timed;
+            }
+
+            /// Add the counters in \e other to this instance (the graph size is taken to be the larger of the two)
+            void add(const PlannerStatistics &other);
+
+            /** \brief Store the statistics as benchmark run
+                properties (name with type suffix mapped to value). The
+                time spent in each operation is only included when it is
+                measured (see setTiming()). The graph size is not
+                included, since Benchmark obtains it from the planner
+                data. */
+            void getProperties(std::map<std::string, std::string> &properties) const;
+
+            /// Print the statistics
+            void print(std::ostream &out) const;
+
+            /// Calls to the state validity checker
+            PlannerCounter    stateChecks;
+
+            /// Calls to the motion validator
+            PlannerCounter    motionChecks;
+
+            /// Nearest neighbor queries
+            PlannerCounter    nnQueries;
+
+            /// Propagations of controls (only used when planning with controls)
+            PlannerCounter    propagations;
+
+            /// The number of states drawn from samplers, including goal samples
+            unsigned long int samples;
+
+            /// The number of states in the planner's tree or graph
+            unsigned long int graphStates;
+        };
+    }
+}
+
+#endif
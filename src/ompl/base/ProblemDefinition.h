@@ -53,6 +53,7 @@
 #include <limits>
 
 #include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
 
 namespace ompl
 {
@@ -281,7 +282,8 @@ namespace ompl
             /** \brief Return the top solution path, if one is found. The top path is the shortest
                  one that was found, preference being given to solutions that are not approximate.
 
-                This will need to be casted into the specialization computed by the planner */
+                This will need to be casted into the specialization computed by the planner. The top solution
+                is published atomically, so this call does not wait for threads that are adding solutions. */
             PathPtr getSolutionPath(void) const;
 
             /** \brief Add a solution path in a thread-safe manner. Multiple solutions can be set for a goal.
@@ -290,15 +292,37 @@ namespace ompl
             */
             void addSolutionPath(const PathPtr &path, bool approximate = false, double difference = -1.0) const;
 
-            /** \brief Get the number of solutions already found */
+            /** \brief Copy the top solution into \e solution and return true, if one is found. Like getSolutionPath(),
+                this does not wait for threads that are adding solutions, so it is cheap to call from a thread
+                monitoring the progress of planners. */
+            bool getBestSolution(PlannerSolution &solution) const;
+
+            /** \brief Get the number of solutions already found. This includes solutions that were not retained
+                because of the limit set by setMaxSolutionCount() */
             std::size_t getSolutionCount(void) const;
 
-            /** \brief Get all the solution paths available for this goal */
+            /** \brief Get the retained solution paths for this goal, best first */
             std::vector<PlannerSolution> getSolutions(void) const;
 
             /** \brief Forget the solution paths (thread safe). Memory is freed. */
             void clearSolutionPaths(void) const;
 
+            /** \brief Retain at most \e maxSolutions of the best solutions; worse ones are discarded as they are added.
+                The default is 0, which means all solutions are retained. */
+            void setMaxSolutionCount(unsigned int maxSolutions);
+
+            /** \brief Get the maximum number of retained solutions (0 means no limit) */
+            unsigned int getMaxSolutionCount(void) const;
+
+            /** \brief Callback invoked when a solution better than all previous ones is added */
+            typedef boost::function<void(const PlannerSolution&)> BestSolutionCallback;
+
+            /** \brief Set a function to be called every time a new best solution is added. The call is made from
+                the thread that added the solution, after the solution is stored. Calls are serialized, and a solution
+                is not reported if a better one was published before the call could be made, so the reported
+                solutions only improve. */
+            void setBestSolutionCallback(const BestSolutionCallback &callback);
+
             /** \brief Returns true if the problem definition has a proof of non existence for a solution */
             bool hasSolutionNonExistenceProof(void) const;
 
@@ -42,6 +42,7 @@
 #include "ompl/base/MotionValidator.h"
 #include "ompl/base/StateSpace.h"
 #include "ompl/base/ValidStateSampler.h"
+#include "ompl/base/PlannerStatistics.h"
 
 #include "ompl/util/ClassForward.h"
 #include "ompl/util/Console.h"
@@ -94,9 +95,13 @@ namespace ompl
             {
             }
 
-            /** \brief Check if a given state is valid or not */
+            /** \brief Check if a given state is valid or not. The check is counted in the statistics of the calling thread's planner, if any (see PlannerStatistics::ThreadScope) */
             bool isValid(const State *state) const
             {
+                PlannerStatistics *stats = PlannerStatistics::getThreadStatistics();
+                if (!stats)
+                    return stateValidityChecker_->isValid(state);
+                PlannerStatistics::Timer timer(stats->stateChecks);
                 return stateValidityChecker_->isValid(state);
             }
 
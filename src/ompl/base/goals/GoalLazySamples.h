@@ -38,7 +38,9 @@
 #define OMPL_BASE_GOALS_GOAL_LAZY_SAMPLES_
 
 #include "ompl/base/goals/GoalStates.h"
+#include "ompl/base/goals/GoalStateCache.h"
 #include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/function.hpp>
 #include <limits>
 
@@ -61,6 +63,14 @@ namespace ompl
          goals may increase, as the planner is running, in a
          thread-safe manner.
 
+         Sampling can be spread over multiple threads (see
+         setSamplingThreadCount()) and the number of kept states can be
+         bounded (see setMaxStateCount()). Threads waiting for goal
+         states, such as planners in PlannerInputStates::nextGoal(),
+         are woken up as soon as a state is added (see
+         waitForStateCount()). Valid goal states can also be recorded
+         in a GoalStateCache, so that later queries for the same goal
+         start with the states found before (see setStateCache()).
 
          \todo The Python bindings for GoalLazySamples class are still broken.
          The OMPL C++ code creates a new thread from which you should be able
@@ -84,7 +94,9 @@ namespace ompl
                 to this constructor. The sampling thread is
                 automatically started if \e autoStart is true. The
                 sampling function is not called in parallel by
-                OMPL. Hence, the function is not required to be thread
+                OMPL, unless more than one sampling thread is
+                requested (see setSamplingThreadCount()). Hence, by
+                default the function is not required to be thread
                 safe, unless the user issues additional calls in
                 parallel. The instance of GoalLazySamples remains
                 thread safe however.
@@ -112,15 +124,60 @@ namespace ompl
 
             virtual void addState(const State* st);
 
-            /** \brief Start the goal sampling thread */
+            /** \brief Start the goal sampling threads */
             void startSampling(void);
 
-            /** \brief Stop the goal sampling thread */
+            /** \brief Stop the goal sampling threads */
             void stopSampling(void);
 
-            /** \brief Return true if the sampling thread is active */
+            /** \brief Return true if a sampling thread is active */
             bool isSampling(void) const;
 
+            /** \brief Set the number of threads that call the sampling function when sampling is started. The
+                default is 1. With more than one thread, the sampling function is called in parallel and
+                must be thread safe. The change takes effect the next time sampling is started. */
+            void setSamplingThreadCount(unsigned int nthreads);
+
+            /** \brief Get the number of threads that call the sampling function */
+            unsigned int getSamplingThreadCount(void) const
+            {
+                return samplingThreadCount_;
+            }
+
+            /** \brief Set the maximum number of goal states to keep. Once that many states are available, the
+                sampling threads wait (without calling the sampling function) until states are cleared or
+                sampling is stopped. By default, the number of states is not bounded. */
+            void setMaxStateCount(std::size_t count);
+
+            /** \brief Get the maximum number of goal states to keep */
+            std::size_t getMaxStateCount(void) const
+            {
+                return maxStateCount_;
+            }
+
+            /** \brief Block until more than \e count goal states are available, sampling stops, or \e timeout
+                seconds pass. Return true if more than \e count states are available. */
+            bool waitForStateCount(std::size_t count, double timeout) const;
+
+            /** \brief Record valid goal states computed by the sampling threads in \e cache, under the
+                goal identity \e key. The states already stored for \e key are checked for validity and
+                added to the goal before the sampling function is called (or, if sampling is already
+                active, at the next sampling attempt). The same key must not be used for goals of
+                different state spaces. Pass a null \e cache to stop using a cache. */
+            void setStateCache(const GoalStateCachePtr &cache, const std::string &key);
+
+            /** \brief Get the cache of goal states, if any */
+            const GoalStateCachePtr& getStateCache(void) const
+            {
+                return cache_;
+            }
+
+            /** \brief Get the key under which goal states are recorded in the cache */
+            const std::string& getStateCacheKey(void) const
+            {
+                return cacheKey_;
+            }
+
             /** \brief Set the minimum distance that a new state returned by the sampling thread needs to be away from
                 previously added states, so that it is added to the list of goal states. */
             void setMinNewSampleDistance(double dist)
@@ -145,7 +202,8 @@ namespace ompl
                 is not required to be thread safe, as calls are made one at a time. */
             void setNewStateCallback(const NewStateCallbackFn &callback);
 
-            /** \brief Add a state \e st if it further away that \e minDistance from previously added states. Return true if the state was added. */
+            /** \brief Add a state \e st if it further away that \e minDistance from previously added states and fewer than
+                getMaxStateCount() states are kept. Return true if the state was added. */
             bool addStateIfDifferent(const State* st, double minDistance);
 
             /** \brief Return true if GoalStates::couldSample() is true or if the sampling thread is active, as in this case it is possible a sample can be produced at some point. */
@@ -162,6 +220,15 @@ namespace ompl
             /** \brief The function that samples goals by calling \e samplerFunc_ in a separate thread */
             void goalSamplingThread(void);
 
+            /** \brief Wait until fewer than maxStateCount_ states are kept. Return false if sampling is to terminate. */
+            bool waitForCapacity(void);
+
+            /** \brief If a cache was set and its states have not been used yet, add the valid ones to the goal */
+            void warmStart(void);
+
+            /** \brief Record a state found by the sampling threads in the cache, if one is set */
+            void recordState(const State *st);
+
             /** \brief Lock for updating the set of states */
             mutable boost::mutex           lock_;
 
@@ -171,18 +238,42 @@ namespace ompl
             /** \brief Flag used to notify the sampling thread to terminate sampling */
             bool                           terminateSamplingThread_;
 
-            /** \brief Additional thread for sampling goal states */
-            boost::thread                 *samplingThread_;
+            /** \brief Notified when states are added or cleared and when sampling stops */
+            mutable boost::condition_variable statesChanged_;
+
+            /** \brief Additional threads for sampling goal states */
+            std::vector<boost::thread*>    samplingThreads_;
+
+            /** \brief The number of threads to start for sampling goal states */
+            unsigned int                   samplingThreadCount_;
+
+            /** \brief The number of sampling threads that have not finished yet */
+            unsigned int                   activeSamplingThreads_;
 
             /** \brief The number of times the sampling function was called and it returned true */
             unsigned int                   samplingAttempts_;
 
+            /** \brief The maximum number of goal states to keep */
+            std::size_t                    maxStateCount_;
+
+            /** \brief Optional cache goal states are recorded in */
+            GoalStateCachePtr              cache_;
+
+            /** \brief The goal identity states are recorded under in \e cache_ */
+            std::string                    cacheKey_;
+
+            /** \brief Flag indicating the states in \e cache_ still need to be added to the goal */
+            bool                           warmStartPending_;
+
             /** \brief Samples returned by the sampling thread are added to the list of states only if
                 they are at least minDist_ away from already added samples. */
             double                         minDist_;
 
             /** \brief If defined, this function is called when a new state is added to the list of possible samples */
             NewStateCallbackFn             callback_;
+
+            /** \brief Lock ensuring \e callback_ is called by one sampling thread at a time */
+            boost::mutex                   callbackLock_;
         };
 
     }
@@ -0,0 +1,126 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_BASE_GOALS_GOAL_STATE_CACHE_
+#define OMPL_BASE_GOALS_GOAL_STATE_CACHE_
+
+#include "ompl/util/ClassForward.h"
+#include <boost/thread/mutex.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ompl
+{
+
+    namespace base
+    {
+
+        /// @cond IGNORE
+        /** \brief Forward declaration of ompl::base::GoalStateCache */
+        ClassForward(GoalStateCache);
+        /// @endcond
+
+        /** \brief A thread safe store of valid goal states that
+            outlives individual queries. States are kept as real
+            values (see StateSpace::copyToReals()) and are grouped
+            under a key that identifies the goal they were computed
+            for. Goals that are sampled slowly (e.g., by inverse
+            kinematics) can use the states stored for their key to
+            warm-start subsequent queries; see
+            GoalLazySamples::setStateCache(). */
+        class GoalStateCache
+        {
+        public:
+
+            /** \brief Construct a cache that keeps at most \e maxStatesPerKey states for each goal */
+            GoalStateCache(unsigned int maxStatesPerKey = 1000);
+
+            /** \brief Record state \e reals for the goal identified by \e key. Return false if the state was not added,
+                because it is already stored or because the limit of states for \e key was reached. */
+            bool add(const std::string &key, const std::vector<double> &reals);
+
+            /** \brief Get the states stored for the goal identified by \e key */
+            void get(const std::string &key, std::vector< std::vector<double> > &states) const;
+
+            /** \brief Get the number of states stored for the goal identified by \e key */
+            std::size_t size(const std::string &key) const;
+
+            /** \brief Forget the states stored for the goal identified by \e key */
+            void clear(const std::string &key);
+
+            /** \brief Forget all stored states */
+            void clear(void);
+
+            /** \brief Set the maximum number of states kept for each goal */
+            void setMaxStatesPerKey(unsigned int maxStatesPerKey)
+            {
+                maxStatesPerKey_ = maxStatesPerKey;
+            }
+
+            /** \brief Get the maximum number of states kept for each goal */
+            unsigned int getMaxStatesPerKey(void) const
+            {
+                return maxStatesPerKey_;
+            }
+
+            /** \brief Load the cache from a file. The current content is replaced. */
+            void load(const char *filename);
+
+            /** \brief Load the cache from a stream. The current content is replaced. */
+            void load(std::istream &in);
+
+            /** \brief Save the cache to a file */
+            void store(const char *filename) const;
+
+            /** \brief Save the cache to a stream */
+            void store(std::ostream &out) const;
+
+        protected:
+
+            /** \brief Lock protecting the stored states */
+            mutable boost::mutex                                       lock_;
+
+            /** \brief The stored states, grouped by goal key */
+            std::map< std::string, std::vector< std::vector<double> > > states_;
+
+            /** \brief The maximum number of states kept for each goal */
+            unsigned int                                               maxStatesPerKey_;
+        };
+
+    }
+}
+
+#endif
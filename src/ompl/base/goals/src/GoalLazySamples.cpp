@@ -33,13 +33,14 @@
 *********************************************************************/
 
 /* Author: Ioan Sucan */
-
 #include "ompl/base/goals/GoalLazySamples.h"
 #include "ompl/base/ScopedState.h"
 #include "ompl/util/Time.h"
+#include <cassert>
 
 ompl::base::GoalLazySamples::GoalLazySamples(const SpaceInformationPtr &si, const GoalSamplingFn &samplerFunc, bool autoStart, double minDist) :
-    GoalStates(si), samplerFunc_(samplerFunc), terminateSamplingThread_(false), samplingThread_(NULL), samplingAttempts_(0), minDist_(minDist)
+    GoalStates(si), samplerFunc_(samplerFunc), terminateSamplingThread_(false), samplingThreadCount_(1), activeSamplingThreads_(0),
+    samplingAttempts_(0), maxStateCount_(std::numeric_limits<std::size_t>::max()), warmStartPending_(false), minDist_(minDist)
 {
     type_ = GOAL_LAZY_SAMPLES;
     if (autoStart)
@@ -53,31 +54,37 @@ ompl::base::GoalLazySamples::~GoalLazySamples(void)
 
 void ompl::base::GoalLazySamples::startSampling(void)
 {
-    if (samplingThread_ == NULL)
+    if (samplingThreads_.empty())
     {
-        logDebug("Starting goal sampling thread");
-        terminateSamplingThread_ = false;
-        samplingThread_ = new boost::thread(&GoalLazySamples::goalSamplingThread, this);
+        logDebug("Starting %u goal sampling thread(s)", samplingThreadCount_);
+        {
+            boost::mutex::scoped_lock slock(lock_);
+            terminateSamplingThread_ = false;
+            activeSamplingThreads_ = samplingThreadCount_;
+        }
+        for (unsigned int i = 0 ; i < samplingThreadCount_ ; ++i)
+            samplingThreads_.push_back(new boost::thread(&GoalLazySamples::goalSamplingThread, this));
     }
 }
 
 void ompl::base::GoalLazySamples::stopSampling(void)
 {
+    if (samplingThreads_.empty())
+        return;
     if (isSampling())
+        logDebug("Attempting to stop goal sampling threads...");
+
+    boost::mutex::scoped_lock slock(lock_);
+    terminateSamplingThread_ = true;
+    slock.unlock();
+    statesChanged_.notify_all();
+    // join the threads, whether they are still running or finished already
+    for (std::size_t i = 0 ; i < samplingThreads_.size() ; ++i)
     {
-        logDebug("Attempting to stop goal sampling thread...");
-        terminateSamplingThread_ = true;
-        samplingThread_->join();
-        delete samplingThread_;
-        samplingThread_ = NULL;
+        samplingThreads_[i]->join();
+        delete samplingThreads_[i];
     }
-    else
-        if (samplingThread_)
-        { // join a finished thread
-            samplingThread_->join();
-            delete samplingThread_;
-            samplingThread_ = NULL;
-        }
+    samplingThreads_.clear();
 }
 
 void ompl::base::GoalLazySamples::goalSamplingThread(void)
@@ -89,28 +96,131 @@ void ompl::base::GoalLazySamples::goalSamplingThread(void)
         while (!terminateSamplingThread_ && !si_->isSetup())
             boost::this_thread::sleep(time::seconds(0.01));
     }
-    unsigned int prevsa = samplingAttempts_;
+    unsigned int attempts = 0;
     if (!terminateSamplingThread_ && samplerFunc_)
     {
         logDebug("Beginning sampling thread computation");
         ScopedState<> s(si_);
-        while (!terminateSamplingThread_ && samplerFunc_(this, s.get()))
+        while (waitForCapacity() && samplerFunc_(this, s.get()))
         {
-            ++samplingAttempts_;
-            if (si_->satisfiesBounds(s.get()) && si_->isValid(s.get()))
-                addStateIfDifferent(s.get(), minDist_);
+            ++attempts;
+            {
+                boost::mutex::scoped_lock slock(lock_);
+                ++samplingAttempts_;
+            }
+            if (si_->satisfiesBounds(s.get()) && si_->isValid(s.get()) && addStateIfDifferent(s.get(), minDist_))
+                recordState(s.get());
         }
     }
     else
         logWarn("Goal sampling thread never did any work.%s",
                   samplerFunc_ ? (si_->isSetup() ? "" : " Space information not set up.") : " No sampling function set.");
-    terminateSamplingThread_ = true;
-    logDebug("Stopped goal sampling thread after %u sampling attempts", samplingAttempts_ - prevsa);
+
+    // once the sampling function asks for no more calls, all sampling threads stop
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        terminateSamplingThread_ = true;
+        --activeSamplingThreads_;
+    }
+    statesChanged_.notify_all();
+    logDebug("Stopped goal sampling thread after %u sampling attempts", attempts);
+}
+
+bool ompl::base::GoalLazySamples::waitForCapacity(void)
+{
+    warmStart();
+    boost::mutex::scoped_lock slock(lock_);
+    while (!terminateSamplingThread_ && GoalStates::getStateCount() >= maxStateCount_)
+        statesChanged_.wait(slock);
+    return !terminateSamplingThread_;
+}
+
+void ompl::base::GoalLazySamples::warmStart(void)
+{
+    GoalStateCachePtr cache;
+    std::string key;
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        if (!warmStartPending_)
+            return;
+        warmStartPending_ = false;
+        cache = cache_;
+        key = cacheKey_;
+    }
+    if (!cache)
+        return;
+
+    std::vector< std::vector<double> > cached;
+    cache->get(key, cached);
+    ScopedState<> s(si_);
+    std::vector<double> reals;
+    si_->getStateSpace()->copyToReals(reals, s.get());
+    unsigned int added = 0;
+    for (std::size_t i = 0 ; i < cached.size() && !terminateSamplingThread_ ; ++i)
+    {
+        if (cached[i].size() != reals.size())
+            continue;
+        si_->getStateSpace()->copyFromReals(s.get(), cached[i]);
+        if (si_->satisfiesBounds(s.get()) && si_->isValid(s.get()) && addStateIfDifferent(s.get(), minDist_))
+            ++added;
+    }
+    logDebug("Added %u of %u cached goal states", added, (unsigned int)cached.size());
+}
+
+void ompl::base::GoalLazySamples::recordState(const State *st)
+{
+    GoalStateCachePtr cache;
+    std::string key;
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        cache = cache_;
+        key = cacheKey_;
+    }
+    if (cache)
+    {
+        std::vector<double> reals;
+        si_->getStateSpace()->copyToReals(reals, st);
+        cache->add(key, reals);
+    }
 }
 
 bool ompl::base::GoalLazySamples::isSampling(void) const
 {
-    return terminateSamplingThread_ == false && samplingThread_ != NULL;
+    boost::mutex::scoped_lock slock(lock_);
+    return activeSamplingThreads_ > 0;
+}
+
+void ompl::base::GoalLazySamples::setSamplingThreadCount(unsigned int nthreads)
+{
+    assert(nthreads > 0);
+    samplingThreadCount_ = nthreads;
+}
+
+void ompl::base::GoalLazySamples::setMaxStateCount(std::size_t count)
+{
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        maxStateCount_ = count;
+    }
+    statesChanged_.notify_all();
+}
+
+bool ompl::base::GoalLazySamples::waitForStateCount(std::size_t count, double timeout) const
+{
+    boost::system_time deadline = boost::get_system_time() + time::seconds(timeout);
+    boost::mutex::scoped_lock slock(lock_);
+    while (GoalStates::getStateCount() <= count && activeSamplingThreads_ > 0)
+        if (!statesChanged_.timed_wait(slock, deadline))
+            break;
+    return GoalStates::getStateCount() > count;
+}
+
+void ompl::base::GoalLazySamples::setStateCache(const GoalStateCachePtr &cache, const std::string &key)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    cache_ = cache;
+    cacheKey_ = key;
+    warmStartPending_ = cache ? true : false;
 }
 
 bool ompl::base::GoalLazySamples::couldSample(void) const
@@ -120,8 +230,11 @@ bool ompl::base::GoalLazySamples::couldSample(void) const
 
 void ompl::base::GoalLazySamples::clear(void)
 {
-    boost::mutex::scoped_lock slock(lock_);
-    GoalStates::clear();
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        GoalStates::clear();
+    }
+    statesChanged_.notify_all();
 }
 
 double ompl::base::GoalLazySamples::distanceGoal(const State *st) const
@@ -143,8 +256,11 @@ void ompl::base::GoalLazySamples::setNewStateCallback(const NewStateCallbackFn &
 
 void ompl::base::GoalLazySamples::addState(const State* st)
 {
-    boost::mutex::scoped_lock slock(lock_);
-    GoalStates::addState(st);
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        GoalStates::addState(st);
+    }
+    statesChanged_.notify_all();
 }
 
 const ompl::base::State* ompl::base::GoalLazySamples::getState(unsigned int index) const
@@ -171,7 +287,7 @@ bool ompl::base::GoalLazySamples::addStateIfDifferent(const State* st, double mi
     bool added = false;
     {
         boost::mutex::scoped_lock slock(lock_);
-        if (GoalStates::distanceGoal(st) > minDistance)
+        if (GoalStates::getStateCount() < maxStateCount_ && GoalStates::distanceGoal(st) > minDistance)
         {
             GoalStates::addState(st);
             added = true;
@@ -180,8 +296,14 @@ bool ompl::base::GoalLazySamples::addStateIfDifferent(const State* st, double mi
         }
     }
 
-    // the lock is released at this; if needed, issue a call to the callback
+    // the lock is released at this point; wake up threads waiting for states
+    // and, if needed, issue a call to the callback
+    if (added)
+        statesChanged_.notify_all();
     if (newState)
+    {
+        boost::mutex::scoped_lock slock(callbackLock_);
         callback_(newState);
+    }
     return added;
 }
@@ -0,0 +1,148 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/base/goals/GoalStateCache.h"
+#include "ompl/util/Console.h"
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <fstream>
+
+/// @cond IGNORE
+static const boost::uint32_t OMPL_ARCHIVE_MARKER = 0x4C504D4F; // this spells OMPL
+/// @endcond
+
+ompl::base::GoalStateCache::GoalStateCache(unsigned int maxStatesPerKey) : maxStatesPerKey_(maxStatesPerKey)
+{
+}
+
+bool ompl::base::GoalStateCache::add(const std::string &key, const std::vector<double> &reals)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    std::vector< std::vector<double> > &states = states_[key];
+    if (states.size() >= maxStatesPerKey_ || std::find(states.begin(), states.end(), reals) != states.end())
+        return false;
+    states.push_back(reals);
+    return true;
+}
+
+void ompl::base::GoalStateCache::get(const std::string &key, std::vector< std::vector<double> > &states) const
+{
+    boost::mutex::scoped_lock slock(lock_);
+    std::map< std::string, std::vector< std::vector<double> > >::const_iterator it = states_.find(key);
+    if (it == states_.end())
+        states.clear();
+    else
+        states = it->second;
+}
+
+std::size_t ompl::base::GoalStateCache::size(const std::string &key) const
+{
+    boost::mutex::scoped_lock slock(lock_);
+    std::map< std::string, std::vector< std::vector<double> > >::const_iterator it = states_.find(key);
+    return it == states_.end() ? 0 : it->second.size();
+}
+
+void ompl::base::GoalStateCache::clear(const std::string &key)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    states_.erase(key);
+}
+
+void ompl::base::GoalStateCache::clear(void)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    states_.clear();
+}
+
+void ompl::base::GoalStateCache::load(const char *filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    load(in);
+    in.close();
+}
+
+void ompl::base::GoalStateCache::store(const char *filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    store(out);
+    out.close();
+}
+
+void ompl::base::GoalStateCache::load(std::istream &in)
+{
+    clear();
+    if (!in.good() || in.eof())
+    {
+        logWarn("Unable to load goal state cache");
+        return;
+    }
+    try
+    {
+        boost::archive::binary_iarchive ia(in);
+        boost::uint32_t marker;
+        ia >> marker;
+        if (marker != OMPL_ARCHIVE_MARKER)
+        {
+            logError("OMPL archive marker not found");
+            return;
+        }
+        std::map< std::string, std::vector< std::vector<double> > > states;
+        ia >> states;
+        boost::mutex::scoped_lock slock(lock_);
+        states_.swap(states);
+    }
+    catch (boost::archive::archive_exception &ae)
+    {
+        logError("Unable to load archive: %s", ae.what());
+    }
+}
+
+void ompl::base::GoalStateCache::store(std::ostream &out) const
+{
+    if (!out.good())
+    {
+        logWarn("Unable to store goal state cache");
+        return;
+    }
+    boost::archive::binary_oarchive oa(out);
+    boost::mutex::scoped_lock slock(lock_);
+    oa << OMPL_ARCHIVE_MARKER;
+    oa << states_;
+}
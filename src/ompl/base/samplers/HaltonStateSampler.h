@@ -0,0 +1,157 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_BASE_SAMPLERS_HALTON_STATE_SAMPLER_
+#define OMPL_BASE_SAMPLERS_HALTON_STATE_SAMPLER_
+
+#include "ompl/base/StateSampler.h"
+#include "ompl/util/LowDiscrepancy.h"
+
+namespace ompl
+{
+    namespace base
+    {
+
+        /** \brief State sampler that draws uniform samples from a
+            deterministic low-discrepancy (Halton) sequence instead of
+            independent random numbers. Consecutive samples cover the
+            state space evenly, which gives roadmap and
+            tree planners better coverage for the same number of
+            samples, and runs that are repeatable.
+
+            The sampler works for any state space: the dimensions of
+            the sequence are split among the components of the space,
+            which are mapped from the unit cube as follows. Real
+            vectors are scaled to their bounds; SO(2) angles are
+            scaled to [-pi, pi); SO(3) rotations use Hopf coordinates,
+            an area preserving map from [0,1)^3 to unit quaternions;
+            bounded time and discrete spaces are scaled to their
+            ranges. Components of other types (and unbounded time)
+            are sampled by their default sampler.
+
+            sampleUniformNear() and sampleGaussian() sample around a
+            given state, where low-discrepancy brings no benefit;
+            they are forwarded to the default sampler of the space.
+
+            Each instance starts at its own random index of the
+            sequence, so that different instances (e.g., the
+            samplers of the threads of a parallel planner) do not
+            draw the same samples. Scrambled instances also draw
+            their own digit permutations. Both are reproducible
+            across runs when RNG::setSeed() is used, and
+            getSequence().setIndex() selects the part of the
+            sequence an instance samples.
+
+            The sampler is selected through StateSpace::setStateSamplerAllocator(), e.g.:
+            \code
+            space->setStateSamplerAllocator(&ompl::base::allocHaltonStateSampler);
+            \endcode */
+        class HaltonStateSampler : public StateSampler
+        {
+        public:
+
+            /** \brief Constructor. If \e scramble is true, the digits of the sequence are scrambled (see HaltonSequence). */
+            HaltonStateSampler(const StateSpace *space, bool scramble = false);
+
+            virtual ~HaltonStateSampler(void);
+
+            virtual void sampleUniform(State *state);
+
+            virtual void sampleUniformNear(State *state, const State *near, const double distance);
+
+            virtual void sampleGaussian(State *state, const State *mean, const double stdDev);
+
+            /** \brief Get the underlying low-discrepancy sequence */
+            HaltonSequence& getSequence(void)
+            {
+                return sequence_;
+            }
+
+            /** \brief Get the underlying low-discrepancy sequence */
+            const HaltonSequence& getSequence(void) const
+            {
+                return sequence_;
+            }
+
+        protected:
+
+            /** \brief A component of the sampled space that is not itself compound */
+            struct Component
+            {
+                /** \brief The space of the component */
+                const StateSpace          *space;
+
+                /** \brief The indices to follow through nested compound states to reach the component */
+                std::vector<unsigned int>  path;
+
+                /** \brief The type of the space, as used for mapping sequence values to states */
+                int                        type;
+
+                /** \brief The first coordinate of the sequence point used by this component */
+                unsigned int               offset;
+
+                /** \brief The sampler used for components the sequence cannot be mapped to */
+                StateSamplerPtr            fallback;
+            };
+
+            /** \brief Collect the components of \e space (reached by \e path) and assign them coordinates starting at \e dimension */
+            void addComponents(const StateSpace *space, std::vector<unsigned int> &path, unsigned int &dimension);
+
+            /** \brief The components of the sampled space */
+            std::vector<Component> components_;
+
+            /** \brief The default sampler of the space, used for sampling near states */
+            StateSamplerPtr        defaultSampler_;
+
+        private:
+
+            /** \brief The low-discrepancy sequence */
+            HaltonSequence         sequence_;
+
+            /** \brief The current point of the sequence */
+            std::vector<double>    point_;
+
+            /** \brief Count the coordinates needed for \e space */
+            static unsigned int countDimensions(const StateSpace *space);
+        };
+
+        /** \brief Allocate a HaltonStateSampler for \e space */
+        StateSamplerPtr allocHaltonStateSampler(const StateSpace *space);
+
+        /** \brief Allocate a HaltonStateSampler for \e space that uses digit scrambling */
+        StateSamplerPtr allocScrambledHaltonStateSampler(const StateSpace *space);
+    }
+}
+
+#endif
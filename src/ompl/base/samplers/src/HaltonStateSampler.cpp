@@ -0,0 +1,208 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/base/samplers/HaltonStateSampler.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/base/spaces/SO2StateSpace.h"
+#include "ompl/base/spaces/SO3StateSpace.h"
+#include "ompl/base/spaces/TimeStateSpace.h"
+#include "ompl/base/spaces/DiscreteStateSpace.h"
+#include <boost/math/constants/constants.hpp>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+/// @cond IGNORE
+namespace
+{
+    // the number of sequence coordinates a component that is not compound consumes
+    unsigned int componentDimension(const ompl::base::StateSpace *space)
+    {
+        switch (space->getType())
+        {
+        case ompl::base::STATE_SPACE_REAL_VECTOR:
+            return space->getDimension();
+        case ompl::base::STATE_SPACE_SO2:
+            return 1;
+        case ompl::base::STATE_SPACE_SO3:
+            return 3;
+        case ompl::base::STATE_SPACE_TIME:
+            return space->as<ompl::base::TimeStateSpace>()->isBounded() ? 1 : 0;
+        case ompl::base::STATE_SPACE_DISCRETE:
+            return 1;
+        default:
+            return 0;
+        }
+    }
+}
+/// @endcond
+
+ompl::base::HaltonStateSampler::HaltonStateSampler(const StateSpace *space, bool scramble) :
+    StateSampler(space), defaultSampler_(space->allocDefaultStateSampler()),
+    sequence_(countDimensions(space), scramble), point_(sequence_.getDimension())
+{
+    std::vector<unsigned int> path;
+    unsigned int dimension = 0;
+    addComponents(space, path, dimension);
+
+    // start each instance at a different point, so that instances do not replay the same samples
+    sequence_.setIndex(1 + (unsigned long)rng_.uniformInt(0, std::numeric_limits<int>::max() - 1));
+}
+
+ompl::base::HaltonStateSampler::~HaltonStateSampler(void)
+{
+}
+
+unsigned int ompl::base::HaltonStateSampler::countDimensions(const StateSpace *space)
+{
+    if (space->isCompound())
+    {
+        const CompoundStateSpace *cs = space->as<CompoundStateSpace>();
+        unsigned int d = 0;
+        for (unsigned int i = 0 ; i < cs->getSubspaceCount() ; ++i)
+            d += countDimensions(cs->getSubspace(i).get());
+        return d;
+    }
+    return componentDimension(space);
+}
+
+void ompl::base::HaltonStateSampler::addComponents(const StateSpace *space, std::vector<unsigned int> &path, unsigned int &dimension)
+{
+    if (space->isCompound())
+    {
+        const CompoundStateSpace *cs = space->as<CompoundStateSpace>();
+        for (unsigned int i = 0 ; i < cs->getSubspaceCount() ; ++i)
+        {
+            path.push_back(i);
+            addComponents(cs->getSubspace(i).get(), path, dimension);
+            path.pop_back();
+        }
+        return;
+    }
+
+    Component c;
+    c.space = space;
+    c.path = path;
+    c.type = space->getType();
+    c.offset = dimension;
+    unsigned int d = componentDimension(space);
+    if (d == 0)
+        c.fallback = space->allocDefaultStateSampler();
+    dimension += d;
+    components_.push_back(c);
+}
+
+void ompl::base::HaltonStateSampler::sampleUniform(State *state)
+{
+    sequence_.next(point_);
+
+    for (std::size_t i = 0 ; i < components_.size() ; ++i)
+    {
+        const Component &c = components_[i];
+        State *s = state;
+        for (std::size_t j = 0 ; j < c.path.size() ; ++j)
+            s = s->as<CompoundState>()->components[c.path[j]];
+
+        if (c.fallback)
+        {
+            c.fallback->sampleUniform(s);
+            continue;
+        }
+
+        const double *u = point_.empty() ? NULL : &point_[c.offset];
+        switch (c.type)
+        {
+        case STATE_SPACE_REAL_VECTOR:
+            {
+                const RealVectorBounds &bounds = c.space->as<RealVectorStateSpace>()->getBounds();
+                double *values = s->as<RealVectorStateSpace::StateType>()->values;
+                for (std::size_t k = 0 ; k < bounds.low.size() ; ++k)
+                    values[k] = bounds.low[k] + u[k] * (bounds.high[k] - bounds.low[k]);
+            }
+            break;
+        case STATE_SPACE_SO2:
+            s->as<SO2StateSpace::StateType>()->value = (2.0 * u[0] - 1.0) * boost::math::constants::pi<double>();
+            break;
+        case STATE_SPACE_SO3:
+            {
+                // Hopf coordinates: theta in [0, pi] with cos(theta) uniform
+                // in [-1, 1], phi and psi uniform in [0, 2 pi)
+                const double twopi = 2.0 * boost::math::constants::pi<double>();
+                const double ct = sqrt(1.0 - u[0]);    // cos(theta / 2)
+                const double st = sqrt(u[0]);          // sin(theta / 2)
+                const double psi = twopi * u[1];
+                const double phi = twopi * u[2];
+                SO3StateSpace::StateType *q = s->as<SO3StateSpace::StateType>();
+                q->x = ct * cos(psi / 2.0);
+                q->y = ct * sin(psi / 2.0);
+                q->z = st * cos(phi + psi / 2.0);
+                q->w = st * sin(phi + psi / 2.0);
+            }
+            break;
+        case STATE_SPACE_TIME:
+            {
+                const TimeStateSpace *ts = c.space->as<TimeStateSpace>();
+                s->as<TimeStateSpace::StateType>()->position = ts->getMinTimeBound() + u[0] * (ts->getMaxTimeBound() - ts->getMinTimeBound());
+            }
+            break;
+        case STATE_SPACE_DISCRETE:
+            {
+                const DiscreteStateSpace *ds = c.space->as<DiscreteStateSpace>();
+                int v = ds->getLowerBound() + (int)floor(u[0] * (double)(ds->getUpperBound() - ds->getLowerBound() + 1));
+                s->as<DiscreteStateSpace::StateType>()->value = std::min(v, ds->getUpperBound());
+            }
+            break;
+        }
+    }
+}
+
+void ompl::base::HaltonStateSampler::sampleUniformNear(State *state, const State *near, const double distance)
+{
+    defaultSampler_->sampleUniformNear(state, near, distance);
+}
+
+void ompl::base::HaltonStateSampler::sampleGaussian(State *state, const State *mean, const double stdDev)
+{
+    defaultSampler_->sampleGaussian(state, mean, stdDev);
+}
+
+ompl::base::StateSamplerPtr ompl::base::allocHaltonStateSampler(const StateSpace *space)
+{
+    return StateSamplerPtr(new HaltonStateSampler(space));
+}
+
+ompl::base::StateSamplerPtr ompl::base::allocScrambledHaltonStateSampler(const StateSpace *space)
+{
+    return StateSamplerPtr(new HaltonStateSampler(space, true));
+}
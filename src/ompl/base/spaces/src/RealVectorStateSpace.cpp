@@ -49,8 +49,9 @@ void ompl::base::RealVectorStateSampler::sampleUniform(State *state)
     const RealVectorBounds &bounds = static_cast<const RealVectorStateSpace*>(space_)->getBounds();
 
     RealVectorStateSpace::StateType *rstate = static_cast<RealVectorStateSpace::StateType*>(state);
+    rng_.uniform01Array(rstate->values, dim);
     for (unsigned int i = 0 ; i < dim ; ++i)
-        rstate->values[i] = rng_.uniformReal(bounds.low[i], bounds.high[i]);
+        rstate->values[i] = (bounds.high[i] - bounds.low[i]) * rstate->values[i] + bounds.low[i];
 }
 
 void ompl::base::RealVectorStateSampler::sampleUniformNear(State *state, const State *near, const double distance)
@@ -36,7 +36,7 @@
 
 #include "ompl/base/Planner.h"
 #include "ompl/util/Exception.h"
-#include "ompl/base/goals/GoalSampleableRegion.h"
+#include "ompl/base/goals/GoalLazySamples.h"
 #include <sstream>
 #include <boost/thread.hpp>
 
@@ -113,6 +113,7 @@ void ompl::base::Planner::clear(void)
 {
     pis_.clear();
     pis_.update();
+    stats_.clear();
 }
 
 void ompl::base::Planner::getPlannerData(PlannerData &data) const
@@ -319,7 +320,12 @@ const ompl::base::State* ompl::base::PlannerInputStates::nextGoal(const PlannerT
                     start_wait = time::now();
                     logDebug("Waiting for goal region samples ...");
                 }
-                boost::this_thread::sleep(time::seconds(0.01));
+                // lazy goals wake us up as soon as a new state is available;
+                // the timeout only bounds how long ptc goes unchecked
+                if (goal->hasType(GOAL_LAZY_SAMPLES))
+                    static_cast<const GoalLazySamples*>(goal)->waitForStateCount(sampledGoalsCount_, 0.01);
+                else
+                    boost::this_thread::sleep(time::seconds(0.01));
                 attempt = !ptc();
             }
         }
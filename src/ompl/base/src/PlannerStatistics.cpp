@@ -0,0 +1,102 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+
+#include "ompl/base/PlannerStatistics.h"
+#include <boost/thread/tss.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+
+/// @cond IGNORE
+namespace
+{
+    // the statistics are owned by whoever created the ThreadScope, so nothing is freed when a thread exits
+    void keepStatistics(ompl::base::PlannerStatistics*)
+    {
+    }
+
+    boost::thread_specific_ptr<ompl::base::PlannerStatistics> threadStatistics(&keepStatistics);
+}
+/// @endcond
+
+ompl::base::PlannerStatistics::ThreadScope::ThreadScope(PlannerStatistics &stats) : previous_(threadStatistics.get())
+{
+    threadStatistics.reset(&stats);
+}
+
+ompl::base::PlannerStatistics::ThreadScope::~ThreadScope(void)
+{
+    threadStatistics.reset(previous_);
+}
+
+ompl::base::PlannerStatistics* ompl::base::PlannerStatistics::getThreadStatistics(void)
+{
+    return threadStatistics.get();
+}
+
+void ompl::base::PlannerStatistics::add(const PlannerStatistics &other)
+{
+    stateChecks.add(other.stateChecks);
+    motionChecks.add(other.motionChecks);
+    nnQueries.add(other.nnQueries);
+    propagations.add(other.propagations);
+    samples += other.samples;
+    graphStates = std::max(graphStates, other.graphStates);
+}
+
+void ompl::base::PlannerStatistics::getProperties(std::map<std::string, std::string> &properties) const
+{
+    properties["state checks INTEGER"] = boost::lexical_cast<std::string>(stateChecks.calls);
+    properties["motion checks INTEGER"] = boost::lexical_cast<std::string>(motionChecks.calls);
+    properties["nearest neighbor queries INTEGER"] = boost::lexical_cast<std::string>(nnQueries.calls);
+    properties["propagations INTEGER"] = boost::lexical_cast<std::string>(propagations.calls);
+    if (isTiming())
+    {
+        properties["state check time REAL"] = boost::lexical_cast<std::string>(stateChecks.time);
+        properties["motion check time REAL"] = boost::lexical_cast<std::string>(motionChecks.time);
+        properties["nearest neighbor query time REAL"] = boost::lexical_cast<std::string>(nnQueries.time);
+        properties["propagation time REAL"] = boost::lexical_cast<std::string>(propagations.time);
+    }
+    properties["samples INTEGER"] = boost::lexical_cast<std::string>(samples);
+}
+
+void ompl::base::PlannerStatistics::print(std::ostream &out) const
+{
+    out << "State validity checks:    " << stateChecks.calls << " (" << stateChecks.time << " seconds)" << std::endl;
+    out << "Motion checks:            " << motionChecks.calls << " (" << motionChecks.time << " seconds)" << std::endl;
+    out << "Nearest neighbor queries: " << nnQueries.calls << " (" << nnQueries.time << " seconds)" << std::endl;
+    out << "Propagations:             " << propagations.calls << " (" << propagations.time << " seconds)" << std::endl;
+    out << "Samples:                  " << samples << std::endl;
+    out << "Graph states:             " << graphStates << std::endl;
+}
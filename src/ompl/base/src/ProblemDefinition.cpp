@@ -43,6 +43,10 @@
 #include <algorithm>
 
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/version.hpp>
 
 /// @cond IGNORE
 namespace ompl
@@ -50,74 +54,247 @@ namespace ompl
     namespace base
     {
 
+        /* Solutions are spread over shards selected by the adding thread, so concurrent
+           writers rarely share a lock. The best solution is published through a shared
+           pointer that readers access without taking any of the store's mutexes: on Boost
+           1.53 and later through the shared_ptr atomic access functions (which use a small
+           spinlock pool), and through a dedicated mutex on older versions. */
         class ProblemDefinition::PlannerSolutionSet
         {
         public:
 
-            PlannerSolutionSet(void)
+            PlannerSolutionSet(void) : found_(0), retained_(0), maxSolutions_(0)
             {
             }
 
             void add(const PlannerSolution &s)
             {
-                boost::mutex::scoped_lock slock(lock_);
-                int index = solutions_.size();
-                solutions_.push_back(s);
-                solutions_.back().index_ = index;
-                std::sort(solutions_.begin(), solutions_.end());
+                PlannerSolution sol(s);
+                {
+                    boost::mutex::scoped_lock clock(countLock_);
+                    sol.index_ = found_++;
+
+                    /* once the limit is reached, only solutions better than the worst retained one are kept */
+                    if (threshold_ && !(sol < *threshold_))
+                        return;
+                }
+
+                Shard &shard = shards_[boost::hash<boost::thread::id>()(boost::this_thread::get_id()) % SHARD_COUNT];
+                BestPtr candidate;
+                ProblemDefinition::BestSolutionCallback callback;
+                {
+                    boost::mutex::scoped_lock slock(shard.lock);
+                    std::vector<PlannerSolution> &v = shard.solutions;
+                    v.insert(std::upper_bound(v.begin(), v.end(), sol), sol);
+
+                    /* publishing while holding the shard lock keeps clear() from interleaving */
+                    BestPtr best = loadBest();
+                    while (!best || sol < *best)
+                    {
+                        if (!candidate)
+                            candidate.reset(new PlannerSolution(sol));
+                        if (exchangeBest(best, candidate))
+                        {
+                            callback = shard.callback;
+                            break;
+                        }
+                    }
+                }
+
+                bool trim = false;
+                {
+                    boost::mutex::scoped_lock clock(countLock_);
+                    trim = maxSolutions_ > 0 && ++retained_ > maxSolutions_;
+                }
+                if (trim)
+                {
+                    lockAll();
+                    trimLocked();
+                    unlockAll();
+                }
+
+                /* a newer best may have been published in the meantime; it is reported by its own thread */
+                if (callback)
+                {
+                    boost::mutex::scoped_lock cblock(callbackLock_);
+                    if (loadBest() == candidate)
+                        callback(sol);
+                }
             }
 
             void clear(void)
             {
-                boost::mutex::scoped_lock slock(lock_);
-                solutions_.clear();
+                lockAll();
+                for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                    shards_[i].solutions.clear();
+                storeBest(BestPtr());
+                {
+                    boost::mutex::scoped_lock clock(countLock_);
+                    found_ = 0;
+                    retained_ = 0;
+                    threshold_.reset();
+                }
+                unlockAll();
             }
 
             std::vector<PlannerSolution> getSolutions(void)
             {
-                boost::mutex::scoped_lock slock(lock_);
-                std::vector<PlannerSolution> copy = solutions_;
-                return copy;
+                std::vector<PlannerSolution> all;
+                for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                {
+                    boost::mutex::scoped_lock slock(shards_[i].lock);
+                    all.insert(all.end(), shards_[i].solutions.begin(), shards_[i].solutions.end());
+                }
+                std::sort(all.begin(), all.end());
+                return all;
             }
 
-            bool isApproximate(void)
+            boost::shared_ptr<const PlannerSolution> getBest(void) const
             {
-                boost::mutex::scoped_lock slock(lock_);
-                bool result = false;
-                if (!solutions_.empty())
-                    result = solutions_[0].approximate_;
-                return result;
+                return loadBest();
             }
 
-            double getDifference(void)
+            std::size_t getSolutionCount(void) const
             {
-                boost::mutex::scoped_lock slock(lock_);
-                double diff = -1.0;
-                if (!solutions_.empty())
-                    diff = solutions_[0].difference_;
-                return diff;
+                boost::mutex::scoped_lock clock(countLock_);
+                return found_;
+            }
+
+            void setMaxSolutions(unsigned int maxSolutions)
+            {
+                lockAll();
+                {
+                    boost::mutex::scoped_lock clock(countLock_);
+                    maxSolutions_ = maxSolutions;
+                    threshold_.reset();
+                }
+                trimLocked();
+                unlockAll();
             }
 
-            PathPtr getTopSolution(void)
+            unsigned int getMaxSolutions(void) const
             {
-                boost::mutex::scoped_lock slock(lock_);
-                PathPtr copy;
-                if (!solutions_.empty())
-                    copy = solutions_[0].path_;
-                return copy;
+                boost::mutex::scoped_lock clock(countLock_);
+                return maxSolutions_;
             }
 
-            std::size_t getSolutionCount(void)
+            void setBestSolutionCallback(const ProblemDefinition::BestSolutionCallback &callback)
             {
-                boost::mutex::scoped_lock slock(lock_);
-                std::size_t result = solutions_.size();
-                return result;
+                lockAll();
+                for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                    shards_[i].callback = callback;
+                unlockAll();
             }
 
         private:
 
-            std::vector<PlannerSolution> solutions_;
-            boost::mutex                 lock_;
+            typedef boost::shared_ptr<const PlannerSolution> BestPtr;
+
+            static const unsigned int SHARD_COUNT = 8;
+
+            struct Shard
+            {
+                std::vector<PlannerSolution>           solutions;
+                ProblemDefinition::BestSolutionCallback callback;
+                boost::mutex                           lock;
+            };
+
+            void lockAll(void)
+            {
+                for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                    shards_[i].lock.lock();
+            }
+
+            void unlockAll(void)
+            {
+                for (unsigned int i = SHARD_COUNT ; i > 0 ; --i)
+                    shards_[i - 1].lock.unlock();
+            }
+
+            /* drop the worst solutions across all shards until at most maxSolutions_ remain; all shard locks must be held */
+            void trimLocked(void)
+            {
+                boost::mutex::scoped_lock clock(countLock_);
+                retained_ = 0;
+                for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                    retained_ += shards_[i].solutions.size();
+                if (maxSolutions_ == 0)
+                    return;
+                while (retained_ > maxSolutions_)
+                {
+                    Shard *worst = NULL;
+                    for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                        if (!shards_[i].solutions.empty() && (!worst || worst->solutions.back() < shards_[i].solutions.back()))
+                            worst = &shards_[i];
+                    worst->solutions.pop_back();
+                    --retained_;
+                }
+                if (retained_ == maxSolutions_)
+                {
+                    const PlannerSolution *worst = NULL;
+                    for (unsigned int i = 0 ; i < SHARD_COUNT ; ++i)
+                        if (!shards_[i].solutions.empty() && (!worst || *worst < shards_[i].solutions.back()))
+                            worst = &shards_[i].solutions.back();
+                    threshold_.reset(new PlannerSolution(*worst));
+                }
+            }
+
+#if BOOST_VERSION >= 105300
+            BestPtr loadBest(void) const
+            {
+                return boost::atomic_load(&best_);
+            }
+
+            void storeBest(const BestPtr &best)
+            {
+                boost::atomic_store(&best_, best);
+            }
+
+            /* replace the best solution by candidate if it is still expected; otherwise update expected */
+            bool exchangeBest(BestPtr &expected, const BestPtr &candidate)
+            {
+                return boost::atomic_compare_exchange(&best_, &expected, candidate);
+            }
+#else
+            BestPtr loadBest(void) const
+            {
+                boost::mutex::scoped_lock block(bestLock_);
+                return best_;
+            }
+
+            void storeBest(const BestPtr &best)
+            {
+                boost::mutex::scoped_lock block(bestLock_);
+                best_ = best;
+            }
+
+            bool exchangeBest(BestPtr &expected, const BestPtr &candidate)
+            {
+                boost::mutex::scoped_lock block(bestLock_);
+                if (best_ == expected)
+                {
+                    best_ = candidate;
+                    return true;
+                }
+                expected = best_;
+                return false;
+            }
+
+            mutable boost::mutex                     bestLock_;
+#endif
+
+            Shard                                    shards_[SHARD_COUNT];
+            BestPtr                                  best_;
+
+            /* protects found_, retained_, maxSolutions_ and threshold_ */
+            mutable boost::mutex                     countLock_;
+            std::size_t                              found_;
+            std::size_t                              retained_;
+            unsigned int                             maxSolutions_;
+            BestPtr                                  threshold_;
+
+            /* serializes calls to the best solution callback */
+            boost::mutex                             callbackLock_;
         };
     }
 }
@@ -363,7 +540,7 @@ bool ompl::base::ProblemDefinition::isTrivial(unsigned int *startIndex, double *
 
 bool ompl::base::ProblemDefinition::hasSolution(void) const
 {
-    return solutions_->getSolutionCount() > 0;
+    return solutions_->getBest().get() != NULL;
 }
 
 std::size_t ompl::base::ProblemDefinition::getSolutionCount(void) const
@@ -373,7 +550,16 @@ std::size_t ompl::base::ProblemDefinition::getSolutionCount(void) const
 
 ompl::base::PathPtr ompl::base::ProblemDefinition::getSolutionPath(void) const
 {
-    return solutions_->getTopSolution();
+    boost::shared_ptr<const PlannerSolution> best = solutions_->getBest();
+    return best ? best->path_ : PathPtr();
+}
+
+bool ompl::base::ProblemDefinition::getBestSolution(PlannerSolution &solution) const
+{
+    boost::shared_ptr<const PlannerSolution> best = solutions_->getBest();
+    if (best)
+        solution = *best;
+    return best.get() != NULL;
 }
 
 void ompl::base::ProblemDefinition::addSolutionPath(const PathPtr &path, bool approximate, double difference) const
@@ -385,12 +571,14 @@ void ompl::base::ProblemDefinition::addSolutionPath(const PathPtr &path, bool ap
 
 bool ompl::base::ProblemDefinition::hasApproximateSolution(void) const
 {
-    return solutions_->isApproximate();
+    boost::shared_ptr<const PlannerSolution> best = solutions_->getBest();
+    return best ? best->approximate_ : false;
 }
 
 double ompl::base::ProblemDefinition::getSolutionDifference(void) const
 {
-    return solutions_->getDifference();
+    boost::shared_ptr<const PlannerSolution> best = solutions_->getBest();
+    return best ? best->difference_ : -1.0;
 }
 
 std::vector<ompl::base::PlannerSolution> ompl::base::ProblemDefinition::getSolutions(void) const
@@ -403,6 +591,21 @@ void ompl::base::ProblemDefinition::clearSolutionPaths(void) const
     solutions_->clear();
 }
 
+void ompl::base::ProblemDefinition::setMaxSolutionCount(unsigned int maxSolutions)
+{
+    solutions_->setMaxSolutions(maxSolutions);
+}
+
+unsigned int ompl::base::ProblemDefinition::getMaxSolutionCount(void) const
+{
+    return solutions_->getMaxSolutions();
+}
+
+void ompl::base::ProblemDefinition::setBestSolutionCallback(const BestSolutionCallback &callback)
+{
+    solutions_->setBestSolutionCallback(callback);
+}
+
 void ompl::base::ProblemDefinition::print(std::ostream &out) const
 {
     out << "Start states:" << std::endl;
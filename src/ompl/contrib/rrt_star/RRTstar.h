@@ -188,6 +188,34 @@ namespace ompl
                 return delayCC_;
             }
 
+            /** \brief Keep the tree of motions when the planner is
+                cleared, so that replanning is incremental.
+
+                When solve() receives a new start state (after
+                clear() or a change of problem definition), the tree
+                is re-rooted at that state: the state is connected to
+                one of its nearest motions, the path from there to the
+                previous root is reversed (motions are assumed to be
+                reversible), the motions no longer connected to the
+                new root are removed and the costs of the remaining
+                ones are recomputed from the new root. The validity
+                checker may have changed, so the motions that are kept
+                are validated again lazily, when they are first used
+                as a parent; a motion found invalid is removed
+                together with the motions below it. The cheapest kept
+                motion that satisfies the goal is used as the initial
+                solution, which the planner then improves. */
+            void setTreeReuse(bool flag)
+            {
+                treeReuse_ = flag;
+            }
+
+            /** \brief Return true if the tree of motions is kept when the planner is cleared */
+            bool getTreeReuse(void) const
+            {
+                return treeReuse_;
+            }
+
             virtual void setup(void);
 
         protected:
@@ -198,12 +226,12 @@ namespace ompl
             {
             public:
 
-                Motion(void) : state(NULL), parent(NULL), cost(0.0)
+                Motion(void) : state(NULL), parent(NULL), cost(0.0), checked(true), pruned(false)
                 {
                 }
 
                 /** \brief Constructor that allocates memory for the state */
-                Motion(const base::SpaceInformationPtr &si) : state(si->allocState()), parent(NULL), cost(0.0)
+                Motion(const base::SpaceInformationPtr &si) : state(si->allocState()), parent(NULL), cost(0.0), checked(true), pruned(false)
                 {
                 }
 
@@ -222,11 +250,26 @@ namespace ompl
 
                 /** \brief The set of motions descending from the current motion */
                 std::vector<Motion*> children;
+
+                /** \brief True if the motion from the parent is known to be valid; false for motions kept from a previous
+                    tree that have not been validated again yet */
+                bool               checked;
+
+                /** \brief True if the motion was found invalid and removed from the tree */
+                bool               pruned;
             };
 
             /** \brief Free the memory allocated by this planner */
             void freeMemory(void);
 
+            /** \brief Re-root the tree of motions at state \e st, removing the motions no longer connected to it and
+                recomputing the costs of the others */
+            void rerootTree(const base::State *st);
+
+            /** \brief Validate the motions from \e motion up to the first validated ancestor. If one is invalid, it is
+                removed together with the motions below it on this branch, and false is returned. */
+            bool validateBranch(Motion *motion);
+
             /** \brief Sort the near neighbors by cost */
             static bool compareMotion(const Motion* a, const Motion* b)
             {
@@ -269,6 +312,13 @@ namespace ompl
             /** \brief Option to delay and reduce collision checking within iterations */
             bool                                           delayCC_;
 
+            /** \brief Flag indicating whether the tree of motions is kept when the planner is cleared */
+            bool                                           treeReuse_;
+
+            /** \brief Motions removed from the tree during lazy validation. Motions below them may still point to them,
+                so they are freed only when the tree is re-rooted or its memory is freed. */
+            std::vector<Motion*>                           pruned_;
+
         };
 
     }
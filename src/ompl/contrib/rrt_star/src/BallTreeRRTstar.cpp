@@ -95,6 +95,7 @@ void ompl::geometric::BallTreeRRTstar::clear(void)
 
 ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                  *goal   = pdef_->getGoal().get();
     base::GoalSampleableRegion  *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -161,6 +162,7 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
                 goal_s->sampleGoal(rstate);
             else
                 sampler_->sampleUniform(rstate);
+            ++stats_.samples;
 
             /* check to see if it is inside an existing volume */
             if (inVolume(rstate))
@@ -168,11 +170,14 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
                 rejected = true;
 
                 /* see if the state is valid */
-                if(!si_->isValid(rstate))
+                if (!si_->isValid(rstate))
                 {
                     /* if it's not, reduce the size of the nearest volume to the distance
                        between its center and the rejected state */
-                    toTrim = nn_->nearest(rmotion);
+                    {
+                        base::PlannerStatistics::Timer timer(stats_.nnQueries);
+                        toTrim = nn_->nearest(rmotion);
+                    }
                     double newRad = si_->distance(toTrim->state, rstate);
                     if (newRad < toTrim->volRadius)
                         toTrim->volRadius = newRad;
@@ -187,7 +192,11 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
         while (rejected);
 
         /* find closest state in the tree */
-        Motion *nmotion = nn_->nearest(rmotion);
+        Motion *nmotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
 
         base::State *dstate = rstate;
 
@@ -199,7 +208,12 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
             dstate = xstate;
         }
 
-        if (si_->checkMotion(nmotion->state, dstate, lastValid))
+        bool validMotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            validMotion = si_->checkMotion(nmotion->state, dstate, lastValid);
+        }
+        if (validMotion)
         {
             /* create a motion */
             double distN = si_->distance(dstate, nmotion->state);
@@ -212,7 +226,10 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
             double r = std::min(ballRadiusConst_ * pow(log((double)(1 + nn_->size())) / (double)(nn_->size()), stateSpaceDimensionConstant),
                                 ballRadiusMax_);
 
-            nn_->nearestR(motion, r, nbh);
+            {
+                base::PlannerStatistics::Timer timer(stats_.nnQueries);
+                nn_->nearestR(motion, r, nbh);
+            }
             rewireTest += nbh.size();
 
             // cache for distance computations
@@ -249,7 +266,12 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
                         double c = nbh[i]->cost + dists[i];
                         if (c < motion->cost)
                         {
-                            if (si_->checkMotion(nbh[i]->state, dstate, lastValid))
+                            bool validMotion;
+                            {
+                                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                                validMotion = si_->checkMotion(nbh[i]->state, dstate, lastValid);
+                            }
+                            if (validMotion)
                             {
                                 motion->cost = c;
                                 motion->parent = nbh[i];
@@ -284,7 +306,12 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
                         double c = nbh[i]->cost + dists[i];
                         if (c < motion->cost)
                         {
-                            if (si_->checkMotion(nbh[i]->state, dstate, lastValid))
+                            bool validMotion;
+                            {
+                                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                                validMotion = si_->checkMotion(nbh[i]->state, dstate, lastValid);
+                            }
+                            if (validMotion)
                             {
                                 motion->cost = c;
                                 motion->parent = nbh[i];
@@ -325,7 +352,12 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
                         bool v = false;
                         if (valid[i] == 0)
                         {
-                            if(!si_->checkMotion(nbh[i]->state, dstate, lastValid))
+                            bool validMotion;
+                            {
+                                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                                validMotion = si_->checkMotion(nbh[i]->state, dstate, lastValid);
+                            }
+                            if (!validMotion)
                             {
                                 /* if a collision is found, trim radius to distance from motion to last valid state */
                                 double R =  si_->distance(nbh[i]->state, lastValid.first);
@@ -394,7 +426,10 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
         else
         {
             /* if a collision is found, trim radius to distance from motion to last valid state */
-            toTrim = nn_->nearest(nmotion);
+            {
+                base::PlannerStatistics::Timer timer(stats_.nnQueries);
+                toTrim = nn_->nearest(nmotion);
+            }
             double newRadius =  si_->distance(toTrim->state, lastValid.first);
             if (newRadius < toTrim->volRadius)
                 toTrim->volRadius = newRadius;
@@ -435,6 +470,7 @@ ompl::base::PlannerStatus ompl::geometric::BallTreeRRTstar::solve(const base::Pl
         si_->freeState(rmotion->state);
     delete rmotion;
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states. Checked %lu rewire options.", nn_->size(), rewireTest);
 
     return base::PlannerStatus(addedSolution, approximate);
@@ -37,11 +37,50 @@
 #include "ompl/contrib/rrt_star/RRTstar.h"
 #include "ompl/base/goals/GoalSampleableRegion.h"
 #include "ompl/datastructures/NearestNeighborsGNAT.h"
+#include "ompl/geometric/planners/rrt/TreeReuse.h"
 #include "ompl/tools/config/SelfConfig.h"
 #include <algorithm>
 #include <limits>
 #include <map>
 
+namespace
+{
+    // the motions keep their children and their cost from the root up to date
+    template<typename Motion>
+    struct CostHooks : public ompl::geometric::TreeReuseHooks<Motion>
+    {
+        CostHooks(const ompl::base::SpaceInformation *si) : si_(si)
+        {
+        }
+
+        void rerooted(const std::vector<Motion*> &keep)
+        {
+            // the edges changed direction, so the children and the costs are computed again, from the root down
+            for (std::size_t i = 0 ; i < keep.size() ; ++i)
+                keep[i]->children.clear();
+            for (std::size_t i = 1 ; i < keep.size() ; ++i)
+                keep[i]->parent->children.push_back(keep[i]);
+            keep[0]->cost = 0.0;
+            std::vector<Motion*> queue(1, keep[0]);
+            for (std::size_t i = 0 ; i < queue.size() ; ++i)
+                for (std::size_t j = 0 ; j < queue[i]->children.size() ; ++j)
+                {
+                    Motion *child = queue[i]->children[j];
+                    child->cost = queue[i]->cost + si_->distance(queue[i]->state, child->state);
+                    queue.push_back(child);
+                }
+        }
+
+        void disconnected(Motion *motion)
+        {
+            std::vector<Motion*> &children = motion->parent->children;
+            children.erase(std::remove(children.begin(), children.end(), motion), children.end());
+        }
+
+        const ompl::base::SpaceInformation *si_;
+    };
+}
+
 ompl::geometric::RRTstar::RRTstar(const base::SpaceInformationPtr &si) : base::Planner(si, "RRTstar")
 {
     specs_.approximateSolutions = true;
@@ -52,12 +91,14 @@ ompl::geometric::RRTstar::RRTstar(const base::SpaceInformationPtr &si) : base::P
     ballRadiusMax_ = 0.0;
     ballRadiusConst_ = 1.0;
     delayCC_ = true;
+    treeReuse_ = false;
 
     Planner::declareParam<double>("range", this, &RRTstar::setRange, &RRTstar::getRange);
     Planner::declareParam<double>("goal_bias", this, &RRTstar::setGoalBias, &RRTstar::getGoalBias);
     Planner::declareParam<double>("ball_radius_constant", this, &RRTstar::setBallRadiusConstant, &RRTstar::getBallRadiusConstant);
     Planner::declareParam<double>("max_ball_radius", this, &RRTstar::setMaxBallRadius, &RRTstar::getMaxBallRadius);
     Planner::declareParam<bool>("delay_cc", this, &RRTstar::setDelayCC, &RRTstar::getDelayCC);
+    Planner::declareParam<bool>("tree_reuse", this, &RRTstar::setTreeReuse, &RRTstar::getTreeReuse);
 }
 
 ompl::geometric::RRTstar::~RRTstar(void)
@@ -85,13 +126,17 @@ void ompl::geometric::RRTstar::clear(void)
 {
     Planner::clear();
     sampler_.reset();
-    freeMemory();
-    if (nn_)
-        nn_->clear();
+    if (!treeReuse_)
+    {
+        freeMemory();
+        if (nn_)
+            nn_->clear();
+    }
 }
 
 ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                  *goal   = pdef_->getGoal().get();
     base::GoalSampleableRegion  *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -109,8 +154,15 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
         return base::PlannerStatus::INVALID_GOAL;
     }
 
+    bool rerooted = false;
     while (const base::State *st = pis_.nextStart())
     {
+        if (treeReuse_ && !rerooted && nn_->size() > 0)
+        {
+            rerootTree(st);
+            rerooted = true;
+            continue;
+        }
         Motion *motion = new Motion(si_);
         si_->copyState(motion->state, st);
         nn_->add(motion);
@@ -142,16 +194,37 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
     unsigned int         rewireTest = 0;
     double               stateSpaceDimensionConstant = 1.0 / (double)si_->getStateSpace()->getDimension();
 
-    while (ptc() == false)
+    // the cheapest valid motion of the reused tree that satisfies the goal is the initial solution
+    if (rerooted)
+    {
+        std::vector<Motion*> motions;
+        nn_->list(motions);
+        std::sort(motions.begin(), motions.end(), compareMotion);
+        for (std::size_t i = 0 ; i < motions.size() && !solution ; ++i)
+            if (!motions[i]->pruned && goal->isSatisfied(motions[i]->state) && validateBranch(motions[i]))
+            {
+                solution = motions[i];
+                sufficientlyShort = opt ? opt->isSatisfied(solution->cost) : true;
+            }
+    }
+
+    while (!(solution && sufficientlyShort) && ptc() == false)
     {
         // sample random state (with goal biasing)
         if (goal_s && rng_.uniform01() < goalBias_ && goal_s->canSample())
             goal_s->sampleGoal(rstate);
         else
             sampler_->sampleUniform(rstate);
+        ++stats_.samples;
 
         // find closest state in the tree
-        Motion *nmotion = nn_->nearest(rmotion);
+        Motion *nmotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
+        if (!nmotion->checked && !validateBranch(nmotion))
+            continue;
 
         base::State *dstate = rstate;
 
@@ -163,7 +236,12 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
             dstate = xstate;
         }
 
-        if (si_->checkMotion(nmotion->state, dstate))
+        bool validMotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            validMotion = si_->checkMotion(nmotion->state, dstate);
+        }
+        if (validMotion)
         {
             // create a motion
             double distN = si_->distance(dstate, nmotion->state);
@@ -176,7 +254,10 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
             double r = std::min(ballRadiusConst_ * pow(log((double)(1 + nn_->size())) / (double)(nn_->size()), stateSpaceDimensionConstant),
                                 ballRadiusMax_);
 
-            nn_->nearestR(motion, r, nbh);
+            {
+                base::PlannerStatistics::Timer timer(stats_.nnQueries);
+                nn_->nearestR(motion, r, nbh);
+            }
             rewireTest += nbh.size();
 
             // cache for distance computations
@@ -203,12 +284,23 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
                 // collision check until a valid motion is found
                 for (unsigned int i = 0 ; i < nbh.size() ; ++i)
                 {
+                    // motions of a reused tree are validated before they become parents
+                    if (nbh[i]->pruned || (!nbh[i]->checked && !validateBranch(nbh[i])))
+                    {
+                        valid[i] = -1;
+                        continue;
+                    }
                     if (nbh[i] != nmotion)
                     {
                         double c = nbh[i]->cost + dists[i];
                         if (c < motion->cost)
                         {
-                            if (si_->checkMotion(nbh[i]->state, dstate))
+                            bool validMotion;
+                            {
+                                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                                validMotion = si_->checkMotion(nbh[i]->state, dstate);
+                            }
+                            if (validMotion)
                             {
                                 motion->cost = c;
                                 motion->parent = nbh[i];
@@ -232,13 +324,24 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
                 // find which one we connect the new state to
                 for (unsigned int i = 0 ; i < nbh.size() ; ++i)
                 {
+                    // motions of a reused tree are validated before they become parents
+                    if (nbh[i]->pruned || (!nbh[i]->checked && !validateBranch(nbh[i])))
+                    {
+                        valid[i] = -1;
+                        continue;
+                    }
                     if (nbh[i] != nmotion)
                     {
                         dists[i] = si_->distance(nbh[i]->state, dstate);
                         double c = nbh[i]->cost + dists[i];
                         if (c < motion->cost)
                         {
-                            if (si_->checkMotion(nbh[i]->state, dstate))
+                            bool validMotion;
+                            {
+                                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                                validMotion = si_->checkMotion(nbh[i]->state, dstate);
+                            }
+                            if (validMotion)
                             {
                                 motion->cost = c;
                                 motion->parent = nbh[i];
@@ -265,12 +368,17 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
 
             // rewire tree if needed
             for (unsigned int i = 0 ; i < nbh.size() ; ++i)
-                if (nbh[i] != motion->parent)
+                if (nbh[i] != motion->parent && !nbh[i]->pruned)
                 {
                     double c = motion->cost + dists[i];
                     if (c < nbh[i]->cost)
                     {
-                        bool v = valid[i] == 0 ? si_->checkMotion(nbh[i]->state, dstate) : valid[i] == 1;
+                        bool v = valid[i] == 1;
+                        if (valid[i] == 0)
+                        {
+                            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                            v = si_->checkMotion(nbh[i]->state, dstate);
+                        }
                         if (v)
                         {
                             // Remove this node from its parent list
@@ -280,6 +388,7 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
                             // Add this node to the new parent
                             nbh[i]->parent = motion;
                             nbh[i]->cost = c;
+                            nbh[i]->checked = true;
                             nbh[i]->parent->children.push_back(nbh[i]);
                             solCheck.push_back(nbh[i]);
 
@@ -359,6 +468,7 @@ ompl::base::PlannerStatus ompl::geometric::RRTstar::solve(const base::PlannerTer
         si_->freeState(rmotion->state);
     delete rmotion;
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states. Checked %lu rewire options.", nn_->size(), rewireTest);
 
     return base::PlannerStatus(addedSolution, approximate);
@@ -401,6 +511,24 @@ void ompl::geometric::RRTstar::freeMemory(void)
             delete motions[i];
         }
     }
+    for (unsigned int i = 0 ; i < pruned_.size() ; ++i)
+    {
+        si_->freeState(pruned_[i]->state);
+        delete pruned_[i];
+    }
+    pruned_.clear();
+}
+
+void ompl::geometric::RRTstar::rerootTree(const base::State *st)
+{
+    CostHooks<Motion> hooks(si_.get());
+    rerootMotionTree(si_, *nn_, pruned_, st, hooks, "tree");
+}
+
+bool ompl::geometric::RRTstar::validateBranch(Motion *motion)
+{
+    CostHooks<Motion> hooks(si_.get());
+    return validateMotionBranch(si_, *nn_, pruned_, motion, hooks, stats_);
 }
 
 void ompl::geometric::RRTstar::getPlannerData(base::PlannerData &data) const
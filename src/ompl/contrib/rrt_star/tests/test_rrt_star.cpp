@@ -58,6 +58,33 @@ BOOST_AUTO_TEST_CASE(Basic)
     pt.test();
 }
 
+BOOST_AUTO_TEST_CASE(TreeReuse)
+{
+    geometric::SimpleSetup2DMap s("env1.txt");
+    geometric::RRTstar *rrt = new geometric::RRTstar(s.getSpaceInformation());
+    rrt->setTreeReuse(true);
+    s.setPlanner(base::PlannerPtr(rrt));
+    BOOST_REQUIRE(s.solve(1.0));
+    BOOST_REQUIRE(s.haveExactSolutionPath());
+
+    /* continue from a state along the previous solution, keeping the tree */
+    geometric::PathGeometric path(s.getSolutionPath());
+    path.interpolate();
+    base::ScopedState<> start(s.getStateSpace());
+    s.getSpaceInformation()->copyState(start.get(), path.getState(path.getStateCount() / 2));
+    s.clear();
+    s.setStartState(start);
+
+    base::PlannerData data(s.getSpaceInformation());
+    s.getPlanner()->getPlannerData(data);
+    BOOST_CHECK(data.numVertices() > 0);
+
+    BOOST_REQUIRE(s.solve(1.0));
+    BOOST_REQUIRE(s.haveExactSolutionPath());
+    BOOST_CHECK(s.getSpaceInformation()->equalStates(s.getSolutionPath().getState(0), start.get()));
+    BOOST_CHECK(s.getSolutionPath().check());
+}
+
 BOOST_AUTO_TEST_CASE(More)
 {
     // other tests, if you want
@@ -0,0 +1,182 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_CONTROL_MOTION_PRIMITIVES_
+#define OMPL_CONTROL_MOTION_PRIMITIVES_
+
+#include "ompl/control/StatePropagator.h"
+#include "ompl/control/ControlSampler.h"
+#include <boost/unordered_map.hpp>
+#include <vector>
+
+namespace ompl
+{
+
+    namespace control
+    {
+
+        /// @cond IGNORE
+        /** \brief Forward declaration of ompl::control::MotionPrimitiveStatePropagator */
+        ClassForward(MotionPrimitiveStatePropagator);
+        /// @endcond
+
+        /** \class ompl::control::MotionPrimitiveStatePropagatorPtr
+            \brief A boost shared pointer wrapper for ompl::control::MotionPrimitiveStatePropagator */
+
+        /** \brief A state propagator that replaces integration with a table of precomputed motion primitives.
+
+            This applies to systems whose motion is invariant to translation and rotation, planned for
+            in a base::SE2StateSpace or base::SE3StateSpace. A discrete set of controls (the primitives) is
+            propagated once with a \e model propagator, from the origin, for one propagation step
+            (SpaceInformation::getPropagationStepSize()). The resulting displacements are stored.
+            Afterwards, propagating a primitive for a whole number of steps amounts to composing the
+            state with the stored displacement that many times.
+
+            Controls that are not primitives, and durations that are not whole numbers of steps, are
+            passed on to the model. The primitives can be sampled with MotionPrimitiveControlSampler,
+            which can be installed through allocControlSampler(). */
+        class MotionPrimitiveStatePropagator : public StatePropagator
+        {
+        public:
+
+            /** \brief Constructor. \e model is used to compute the primitives and for anything the table does not cover. */
+            MotionPrimitiveStatePropagator(const SpaceInformationPtr &si, const StatePropagatorPtr &model);
+
+            virtual ~MotionPrimitiveStatePropagator(void);
+
+            /** \brief Add a control to the set of primitives. The table is computed at the next call to setup(). */
+            void addPrimitive(const Control *control);
+
+            /** \brief Remove all primitives */
+            void clearPrimitives(void);
+
+            /** \brief Get the number of primitives */
+            unsigned int getPrimitiveCount(void) const
+            {
+                return primitives_.size();
+            }
+
+            /** \brief Get the control of primitive \e index */
+            const Control* getPrimitive(unsigned int index) const
+            {
+                return primitives_[index].control;
+            }
+
+            /** \brief Get the displacement obtained by applying primitive \e index from the origin for one propagation step */
+            const base::State* getDisplacement(unsigned int index) const
+            {
+                return primitives_[index].displacement;
+            }
+
+            /** \brief Compute the table of displacements. This must be called after the propagation step size is set and before planning. */
+            void setup(void);
+
+            /** \brief Return the index of the primitive equal to \e control, or -1 if \e control is not a primitive.
+                After setup(), if the control space supports serialization (in at most MAX_KEY_LENGTH bytes),
+                controls are looked up by their serialization and must match a primitive exactly (as the ones
+                produced by MotionPrimitiveControlSampler do). Otherwise, they are compared with
+                ControlSpace::equalControls(). */
+            int findPrimitive(const Control *control) const;
+
+            virtual void propagate(const base::State *state, const Control* control, const double duration, base::State *result) const;
+
+            virtual bool canPropagateBackward(void) const;
+
+            /** \brief Allocate a sampler that only produces the primitives of this propagator. This can be
+                passed to ControlSpace::setControlSamplerAllocator() (through boost::bind) */
+            ControlSamplerPtr allocControlSampler(const ControlSpace *space) const;
+
+            /** \brief The longest control serialization primitives are looked up by; it is written to the stack on every lookup */
+            static const unsigned int MAX_KEY_LENGTH = 256;
+
+        protected:
+
+            /** \brief A primitive: a control and the displacement it produces in one step */
+            struct Primitive
+            {
+                Control     *control;
+                base::State *displacement;
+            };
+
+            /** \brief Set \e result to \e state composed with \e displacement. \e result may be the same as \e state. */
+            void compose(const base::State *state, const base::State *displacement, base::State *result) const;
+
+            /** \brief Return the index of the primitive whose control serializes to \e key (keyLength_ bytes), or -1 */
+            int findKey(const char *key) const;
+
+            /** \brief The propagator that models the system */
+            StatePropagatorPtr                              model_;
+
+            /** \brief The primitives */
+            std::vector<Primitive>                          primitives_;
+
+            /** \brief The serializations of the controls of the primitives, keyLength_ bytes each (filled in by setup()) */
+            std::vector<char>                               keys_;
+
+            /** \brief The length of the serialization of a control */
+            unsigned int                                    keyLength_;
+
+            /** \brief The index of each primitive, keyed by the hash of the serialization of its control (filled in by setup()) */
+            boost::unordered_multimap<std::size_t, int>     index_;
+
+            /** \brief The step size the displacements were computed for (0 if setup() was not called) */
+            double                                          stepSize_;
+
+            /** \brief Flag indicating the state space is an SE3 space (an SE2 space otherwise) */
+            bool                                            se3_;
+        };
+
+        /** \brief A control sampler that selects uniformly at random among the primitives of a MotionPrimitiveStatePropagator */
+        class MotionPrimitiveControlSampler : public ControlSampler
+        {
+        public:
+
+            /** \brief Constructor */
+            MotionPrimitiveControlSampler(const ControlSpace *space, const MotionPrimitiveStatePropagator *propagator) :
+                ControlSampler(space), propagator_(propagator)
+            {
+            }
+
+            virtual void sample(Control *control);
+
+        protected:
+
+            /** \brief The propagator whose primitives are sampled */
+            const MotionPrimitiveStatePropagator *propagator_;
+        };
+
+    }
+}
+
+#endif
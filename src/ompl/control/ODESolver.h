@@ -47,10 +47,16 @@
 #include "ompl/control/SpaceInformation.h"
 #include "ompl/control/StatePropagator.h"
 #include "ompl/util/Console.h"
+#include "ompl/util/Exception.h"
 
 #include <omplext_odeint/boost/numeric/odeint.hpp>
+#include <omplext_odeint/boost/numeric/odeint/algebra/array_algebra.hpp>
+#include <boost/array.hpp>
 #include <boost/function.hpp>
-#include <cassert>
+#include <boost/ref.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace ompl
@@ -122,7 +128,13 @@ namespace ompl
 
                         virtual void propagate (const base::State *state, const Control* control, const double duration, base::State *result) const
                         {
-                            ODESolver::StateType reals;
+                            // the buffer keeps its size between calls, so no memory is allocated once the pool holds
+                            // a buffer for every concurrent call
+                            ODESolver::PooledBuffer<ODESolver::StateType> buffer (reals_);
+                            if (!buffer.get())
+                                buffer.reset(new ODESolver::StateType());
+                            ODESolver::StateType &reals = *buffer;
+
                             si_->getStateSpace()->copyToReals(reals, state);
                             solver_->solve (reals, control, duration);
                             si_->getStateSpace()->copyFromReals(result, reals);
@@ -131,9 +143,53 @@ namespace ompl
                                 postEvent_ (control, result);
                         }
 
+                        virtual void propagateBatch (const base::State* const* states, const Control* const* controls, const unsigned int n,
+                                                     const double duration, base::State** results) const
+                        {
+                            if (n == 0)
+                                return;
+
+                            // stack the states one after the other and integrate them together; the buffers
+                            // taken from the pool only allocate memory when the batch grows
+                            ODESolver::PooledBuffer<BatchBuffers> batch (batch_);
+                            if (!batch.get())
+                                batch.reset(new BatchBuffers());
+                            ODESolver::StateType &reals = batch->reals;
+                            ODESolver::StateType &all = batch->all;
+                            std::vector<const Control*> &ctrls = batch->controls;
+                            const base::StateSpacePtr &space = si_->getStateSpace();
+                            all.clear();
+                            for (unsigned int i = 0 ; i < n ; ++i)
+                            {
+                                space->copyToReals(reals, states[i]);
+                                all.insert(all.end(), reals.begin(), reals.end());
+                            }
+                            ctrls.assign(controls, controls + n);
+                            solver_->solveBatch (all, ctrls, duration);
+
+                            const std::size_t dim = reals.size();
+                            for (unsigned int i = 0 ; i < n ; ++i)
+                            {
+                                reals.assign(all.begin() + i * dim, all.begin() + (i + 1) * dim);
+                                space->copyFromReals(results[i], reals);
+                                if (postEvent_)
+                                    postEvent_ (controls[i], results[i]);
+                            }
+                        }
+
                     protected:
+                        // the buffers one call to propagateBatch() uses
+                        struct BatchBuffers
+                        {
+                            ODESolver::StateType        reals;
+                            ODESolver::StateType        all;
+                            std::vector<const Control*> controls;
+                        };
+
                         const ODESolver *solver_;
                         ODESolver::PostPropagationEvent postEvent_;
+                        mutable ODESolver::BufferPool<ODESolver::StateType> reals_;
+                        mutable ODESolver::BufferPool<BatchBuffers> batch_;
                 };
 
                 return StatePropagatorPtr(dynamic_cast<StatePropagator*>(new ODESolverStatePropagator(si_, this, postEvent)));
@@ -144,6 +200,145 @@ namespace ompl
             /// \brief Solve the ODE given the initial state, and a control to apply for some duration.
             virtual void solve (StateType &state, const Control* control, const double duration) const = 0;
 
+            /// \brief Solve the ODE for several initial states at once.  \e states holds the
+            /// initial states one after the other, and the i-th of them is integrated with
+            /// the i-th control in \e controls.  The default implementation calls solve()
+            /// for each state in turn.
+            virtual void solveBatch (StateType &states, const std::vector<const Control*> &controls, const double duration) const
+            {
+                const std::size_t dim = states.size() / controls.size();
+                StateType state;
+                for (std::size_t i = 0 ; i < controls.size() ; ++i)
+                {
+                    state.assign(states.begin() + i * dim, states.begin() + (i + 1) * dim);
+                    solve (state, controls[i], duration);
+                    std::copy(state.begin(), state.end(), states.begin() + i * dim);
+                }
+            }
+
+            /// \brief Integrate \e system from time 0 to \e duration with the fixed step \e intStep, using
+            /// \e stepper.  This performs the same steps as boost::numeric::odeint::integrate_const(), but
+            /// uses the stepper and the system by reference, so the buffers the stepper holds are reused.
+            template <class Stepper, class System, class State>
+            static void integrateConst (Stepper &stepper, System &system, State &state, const double duration, double intStep)
+            {
+                if (duration < 0.0)
+                    intStep = -intStep;
+                const std::size_t steps = static_cast<std::size_t>(duration / intStep);
+                double time = 0.0;
+                for (std::size_t i = 0 ; i < steps ; ++i)
+                {
+                    stepper.do_step (boost::ref(system), state, time, intStep);
+                    time = static_cast<double>(i + 1) * intStep;
+                }
+                // make a last step to end exactly at duration
+                if (boost::numeric::omplext_odeint::detail::less_with_sign (time, duration, intStep))
+                    stepper.do_step (boost::ref(system), state, time, duration - time);
+            }
+
+            /// \brief Integrate \e system from time 0 to \e duration with the controlled stepper \e stepper,
+            /// starting with the step \e intStep.  This performs the same steps as
+            /// boost::numeric::odeint::integrate_adaptive(), but uses the stepper and the system by reference.
+            template <class Stepper, class System, class State>
+            static void integrateAdaptive (Stepper &stepper, System &system, State &state, const double duration, const double intStep)
+            {
+                const std::size_t maxAttempts = 1000;
+                double time = 0.0;
+                double dt = duration < 0.0 ? -intStep : intStep;
+                while (boost::numeric::omplext_odeint::detail::less_with_sign (time, duration, dt))
+                {
+                    if (boost::numeric::omplext_odeint::detail::less_with_sign (duration, time + dt, dt))
+                        dt = duration - time;
+
+                    std::size_t trials = 0;
+                    boost::numeric::omplext_odeint::controlled_step_result res;
+                    do
+                    {
+                        res = stepper.try_step (boost::ref(system), state, time, dt);
+                        ++trials;
+                    }
+                    while (res == boost::numeric::omplext_odeint::fail && trials < maxAttempts);
+                    if (trials == maxAttempts)
+                        throw Exception("Integration failed: a step size could not be found");
+                }
+            }
+
+            /// @cond IGNORE
+            // Buffers kept for reuse across integrations. Every call takes a buffer out of the pool
+            // and puts it back when done, so concurrent calls never share one; the pool frees them.
+            template <typename T>
+            class BufferPool : private boost::noncopyable
+            {
+            public:
+                ~BufferPool (void)
+                {
+                    for (std::size_t i = 0 ; i < free_.size() ; ++i)
+                        delete free_[i];
+                }
+
+                T* take (void)
+                {
+                    boost::mutex::scoped_lock slock(lock_);
+                    if (free_.empty())
+                        return NULL;
+                    T *buffer = free_.back();
+                    free_.pop_back();
+                    return buffer;
+                }
+
+                void give (T *buffer)
+                {
+                    boost::mutex::scoped_lock slock(lock_);
+                    free_.push_back(buffer);
+                }
+
+            private:
+                boost::mutex    lock_;
+                std::vector<T*> free_;
+            };
+
+            // A buffer taken from a BufferPool for the duration of one call, or NULL if the pool was empty
+            template <typename T>
+            class PooledBuffer : private boost::noncopyable
+            {
+            public:
+                PooledBuffer (BufferPool<T> &pool) : pool_(pool), buffer_(pool.take())
+                {
+                }
+
+                ~PooledBuffer (void)
+                {
+                    if (buffer_)
+                        pool_.give(buffer_);
+                }
+
+                T* get (void) const
+                {
+                    return buffer_;
+                }
+
+                void reset (T *buffer)
+                {
+                    delete buffer_;
+                    buffer_ = buffer;
+                }
+
+                T& operator* (void) const
+                {
+                    return *buffer_;
+                }
+
+                T* operator-> (void) const
+                {
+                    return buffer_;
+                }
+
+            private:
+                BufferPool<T> &pool_;
+                T             *buffer_;
+            };
+            /// @endcond
+
             /// \brief The SpaceInformation that this ODESolver operates in.
             const SpaceInformationPtr     si_;
 
@@ -165,9 +360,36 @@ namespace ompl
                     ode (current, control, output);
                 }
 
-                ODE ode;
+                const ODE &ode;
                 const Control* control;
             };
+
+            // Functor used by the boost::numeric::odeint stepper object to evaluate several stacked systems
+            struct ODEBatchFunctor
+            {
+                ODEBatchFunctor (const ODE &o, const std::vector<const Control*> &ctrls, std::size_t d, StateType &qbuf, StateType &qdotbuf) :
+                    ode(o), controls(ctrls), dim(d), q(qbuf), qdot(qdotbuf)
+                {
+                    q.resize(dim);
+                    qdot.resize(dim);
+                }
+
+                void operator () (const StateType &current, StateType &output, double /*time*/)
+                {
+                    for (std::size_t i = 0 ; i < controls.size() ; ++i)
+                    {
+                        q.assign(current.begin() + i * dim, current.begin() + (i + 1) * dim);
+                        ode (q, controls[i], qdot);
+                        std::copy(qdot.begin(), qdot.begin() + dim, output.begin() + i * dim);
+                    }
+                }
+
+                const ODE &ode;
+                const std::vector<const Control*> &controls;
+                std::size_t dim;
+                StateType &q;
+                StateType &qdot;
+            };
             /// @endcond
         };
 
@@ -193,10 +415,45 @@ namespace ompl
             /// \brief Solve the ODE using boost::numeric::odeint.
             virtual void solve (StateType &state, const Control* control, const double duration) const
             {
-                Solver solver;
+                // steppers are reused across calls, so their buffers are allocated only once per concurrent call
+                ODESolver::PooledBuffer<Solver> solver (solvers_);
+                if (!solver.get())
+                    solver.reset(new Solver());
                 ODESolver::ODEFunctor odefunc (ode_, control);
-                boost::numeric::omplext_odeint::integrate_const (solver, odefunc, state, 0.0, duration, intStep_);
+                integrateConst (*solver, odefunc, state, duration, intStep_);
             }
+
+            /// \brief Integrate all the stacked states in lockstep.  With a fixed step size this
+            /// computes exactly what solve() computes for each state, but every stage of the
+            /// stepper runs over one contiguous vector.
+            virtual void solveBatch (StateType &states, const std::vector<const Control*> &controls, const double duration) const
+            {
+                // the stepper sizes its buffers on first use, so it is only reused for batches of the same size
+                ODESolver::PooledBuffer<BatchSolver> batchSolver (batchSolvers_);
+                if (!batchSolver.get() || batchSolver->size != states.size())
+                    batchSolver.reset(new BatchSolver(states.size()));
+                ODESolver::ODEBatchFunctor odefunc (ode_, controls, states.size() / controls.size(), batchSolver->q, batchSolver->qdot);
+                integrateConst (batchSolver->solver, odefunc, states, duration, intStep_);
+            }
+
+            /// @cond IGNORE
+            // A stepper for batches of stacked states, along with the buffers of the batch functor
+            struct BatchSolver
+            {
+                BatchSolver (std::size_t s) : size(s) {}
+
+                Solver               solver;
+                std::size_t          size;
+                ODESolver::StateType q;
+                ODESolver::StateType qdot;
+            };
+            /// @endcond
+
+            /// \brief The steppers not in use by an integration
+            mutable ODESolver::BufferPool<Solver> solvers_;
+
+            /// \brief The steppers for batches not in use by an integration
+            mutable ODESolver::BufferPool<BatchSolver> batchSolvers_;
         };
 
         /// \brief Solver for ordinary differential equations of the type q' = f(q, u),
@@ -215,35 +472,60 @@ namespace ompl
             {
             }
 
-            /// \brief Retrieves the error values from the most recent integration
+            /// \brief Retrieves the error values from the most recent integration.  When several
+            /// threads integrate at once, these are the values of the integration that finished last.
             ODESolver::StateType getError (void)
             {
-                ODESolver::StateType error (error_.begin (), error_.end ());
-                return error;
+                boost::mutex::scoped_lock slock(errorLock_);
+                return error_;
             }
 
         protected:
-            /// \brief Solve the ODE using boost::numeric::odeint.  Save the resulting error values into error_.
+
+            /// @cond IGNORE
+            // A stepper along with the error values of the last integration it performed
+            struct ErrorStepper
+            {
+                Solver               solver;
+                ODESolver::StateType error;
+            };
+            /// @endcond
+
+            /// \brief Solve the ODE using boost::numeric::odeint.  Save the resulting error values.
             virtual void solve (StateType &state, const Control* control, const double duration) const
             {
                 ODESolver::ODEFunctor odefunc (ode_, control);
 
-                if (error_.size () != state.size ())
-                    error_.assign (state.size (), 0.0);
-
-                Solver solver;
-                solver.adjust_size (state);
+                // steppers and their error values are reused across calls, so their buffers are allocated only once
+                ODESolver::PooledBuffer<ErrorStepper> stepper (steppers_);
+                if (!stepper.get())
+                {
+                    stepper.reset(new ErrorStepper());
+                    stepper->solver.adjust_size (state);
+                }
+                if (stepper->error.size () != state.size ())
+                    stepper->error.assign (state.size (), 0.0);
 
+                const double dt = duration < 0.0 ? -intStep_ : intStep_;
                 double time = 0.0;
-                while (time < duration)
+                while (boost::numeric::omplext_odeint::detail::less_with_sign (time, duration, dt))
                 {
-                    solver.do_step (odefunc, state, time, intStep_, error_);
-                    time += intStep_;
+                    stepper->solver.do_step (boost::ref(odefunc), state, time, dt, stepper->error);
+                    time += dt;
                 }
+
+                boost::mutex::scoped_lock slock(errorLock_);
+                error_.assign (stepper->error.begin (), stepper->error.end ());
             }
 
-            /// \brief The error values calculated during numerical integration
+            /// \brief The steppers not in use by an integration
+            mutable ODESolver::BufferPool<ErrorStepper> steppers_;
+
+            /// \brief The error values of the most recent integration
             mutable ODESolver::StateType error_;
+
+            /// \brief Guards error_
+            mutable boost::mutex errorLock_;
         };
 
         /// \brief Adaptive step size solver for ordinary differential equations of the type
@@ -288,6 +570,23 @@ namespace ompl
 
         protected:
 
+            /// @cond IGNORE
+            typedef boost::numeric::omplext_odeint::controlled_runge_kutta<Solver> ControlledSolver;
+
+            // A controlled stepper along with the error bounds it was constructed for
+            struct BoundedSolver
+            {
+                BoundedSolver (double e, double eps) : maxError(e), maxEpsilonError(eps),
+                                                      solver(typename ControlledSolver::error_checker_type(e, eps))
+                {
+                }
+
+                double           maxError;
+                double           maxEpsilonError;
+                ControlledSolver solver;
+            };
+            /// @endcond
+
             /// \brief Solve the ordinary differential equation given the input state
             /// of the system, a control to apply to the system, and the duration to
             /// apply the control.  The value of \e state will contain the final
@@ -296,8 +595,164 @@ namespace ompl
             {
                 ODESolver::ODEFunctor odefunc (ode_, control);
 
-                boost::numeric::omplext_odeint::controlled_runge_kutta< Solver > solver (boost::numeric::omplext_odeint::default_error_checker<double>(maxError_, maxEpsilonError_));
-                boost::numeric::omplext_odeint::integrate_adaptive (solver, odefunc, state, 0.0, duration, intStep_);
+                // steppers are reused across calls, and only rebuilt when the error bounds change
+                ODESolver::PooledBuffer<BoundedSolver> solver (solvers_);
+                if (!solver.get() || solver->maxError != maxError_ || solver->maxEpsilonError != maxEpsilonError_)
+                    solver.reset(new BoundedSolver(maxError_, maxEpsilonError_));
+                integrateAdaptive (solver->solver, odefunc, state, duration, intStep_);
+            }
+
+            /// \brief The maximum error allowed when performing numerical integration
+            double maxError_;
+
+            /// \brief The maximum error allowed during one step of numerical integration
+            double maxEpsilonError_;
+
+            /// \brief The steppers not in use by an integration
+            mutable ODESolver::BufferPool<BoundedSolver> solvers_;
+        };
+
+        /// \brief Base class for solvers of systems whose state dimension \e N is known at
+        /// compile time.  The state is kept in a boost::array, so steppers that use odeint's
+        /// array algebra work on fixed-size storage and the compiler can unroll each stage.
+        /// The ODE is given in terms of FixedStateType; the ODE accepted by ODESolver::setODE()
+        /// is not used by these solvers.
+        template <std::size_t N>
+        class ODEFixedSolver : public ODESolver
+        {
+        public:
+
+            /// \brief Fixed-size data type for the state values
+            typedef boost::array<double, N> FixedStateType;
+
+            /// \brief Callback function that defines the ODE on fixed-size states
+            typedef boost::function<void(const FixedStateType &, const Control*, FixedStateType &)> FixedODE;
+
+            /// \brief Parameterized constructor.  Takes a reference to SpaceInformation,
+            /// an ODE to solve, and the integration step size.
+            ODEFixedSolver (const SpaceInformationPtr &si, const FixedODE &ode, double intStep) : ODESolver(si, ODE(), intStep), fixedODE_(ode)
+            {
+            }
+
+            /// \brief Set the ODE to solve
+            void setFixedODE (const FixedODE &ode)
+            {
+                fixedODE_ = ode;
+            }
+
+        protected:
+
+            /// \brief Solve the ODE on fixed-size storage, given the initial state, and a control to apply for some duration.
+            virtual void solveFixed (FixedStateType &state, const Control* control, const double duration) const = 0;
+
+            virtual void solve (StateType &state, const Control* control, const double duration) const
+            {
+                if (state.size() != N)
+                    throw Exception("The state has a different dimension than the fixed-size ODE solver");
+                FixedStateType x;
+                std::copy(state.begin(), state.end(), x.begin());
+                solveFixed (x, control, duration);
+                std::copy(x.begin(), x.end(), state.begin());
+            }
+
+            /// \brief Definition of the ODE to find solutions for.
+            FixedODE fixedODE_;
+
+            /// @cond IGNORE
+            // Functor used by the boost::numeric::odeint stepper object
+            struct ODEFixedFunctor
+            {
+                ODEFixedFunctor (const FixedODE &o, const Control* ctrl) : ode(o), control(ctrl) {}
+
+                void operator () (const FixedStateType &current, FixedStateType &output, double /*time*/)
+                {
+                    ode (current, control, output);
+                }
+
+                const FixedODE &ode;
+                const Control* control;
+            };
+            /// @endcond
+        };
+
+        /// \brief Basic solver for systems with \e N state variables, known at compile time.
+        /// This is the fixed-size counterpart of ODEBasicSolver; the default Solver is a fourth
+        /// order Runge-Kutta method using odeint's array algebra.
+        template <std::size_t N, class Solver = boost::numeric::omplext_odeint::runge_kutta4<boost::array<double, N>, double, boost::array<double, N>, double,
+                                                                                              boost::numeric::omplext_odeint::array_algebra> >
+        class ODEFixedBasicSolver : public ODEFixedSolver<N>
+        {
+        public:
+
+            /// \brief Parameterized constructor.  Takes a reference to the SpaceInformation,
+            /// an ODE to solve, and an optional integration step size - default is 0.01
+            ODEFixedBasicSolver (const SpaceInformationPtr &si, const typename ODEFixedSolver<N>::FixedODE &ode, double intStep = 1e-2) :
+                ODEFixedSolver<N>(si, ode, intStep)
+            {
+            }
+
+        protected:
+
+            /// \brief Solve the ODE using boost::numeric::odeint.  The stepper holds no dynamic
+            /// memory, so it is simply constructed on the stack.
+            virtual void solveFixed (typename ODEFixedSolver<N>::FixedStateType &state, const Control* control, const double duration) const
+            {
+                Solver solver;
+                typename ODEFixedSolver<N>::ODEFixedFunctor odefunc (this->fixedODE_, control);
+                ODESolver::integrateConst (solver, odefunc, state, duration, this->intStep_);
+            }
+        };
+
+        /// \brief Adaptive step size solver for systems with \e N state variables, known at
+        /// compile time.  This is the fixed-size counterpart of ODEAdaptiveSolver; the default
+        /// Solver is a fifth order Runge-Kutta Cash-Karp method using odeint's array algebra.
+        template <std::size_t N, class Solver = boost::numeric::omplext_odeint::runge_kutta_cash_karp54<boost::array<double, N>, double, boost::array<double, N>, double,
+                                                                                                        boost::numeric::omplext_odeint::array_algebra> >
+        class ODEFixedAdaptiveSolver : public ODEFixedSolver<N>
+        {
+        public:
+
+            /// \brief Parameterized constructor.  Takes a reference to the SpaceInformation,
+            /// an ODE to solve, and an optional integration step size - default is 0.01
+            ODEFixedAdaptiveSolver (const SpaceInformationPtr &si, const typename ODEFixedSolver<N>::FixedODE &ode, double intStep = 1e-2) :
+                ODEFixedSolver<N>(si, ode, intStep), maxError_(1e-6), maxEpsilonError_(1e-7)
+            {
+            }
+
+            /// \brief Retrieve the total error allowed during numerical integration
+            double getMaximumError (void) const
+            {
+                return maxError_;
+            }
+
+            /// \brief Set the total error allowed during numerical integration
+            void setMaximumError (double error)
+            {
+                maxError_ = error;
+            }
+
+            /// \brief Retrieve the error tolerance during one step of numerical integration (local truncation error)
+            double getMaximumEpsilonError (void) const
+            {
+                return maxEpsilonError_;
+            }
+
+            /// \brief Set the error tolerance during one step of numerical integration (local truncation error)
+            void setMaximumEpsilonError (double error)
+            {
+                maxEpsilonError_ = error;
+            }
+
+        protected:
+
+            /// \brief Solve the ODE using boost::numeric::odeint.  The stepper holds no dynamic
+            /// memory, so it is simply constructed on the stack.
+            virtual void solveFixed (typename ODEFixedSolver<N>::FixedStateType &state, const Control* control, const double duration) const
+            {
+                typedef boost::numeric::omplext_odeint::controlled_runge_kutta<Solver> ControlledSolver;
+                ControlledSolver solver (typename ControlledSolver::error_checker_type(maxError_, maxEpsilonError_));
+                typename ODEFixedSolver<N>::ODEFixedFunctor odefunc (this->fixedODE_, control);
+                ODESolver::integrateAdaptive (solver, odefunc, state, duration, this->intStep_);
             }
 
             /// \brief The maximum error allowed when performing numerical integration
@@ -39,6 +39,9 @@
 
 #include "ompl/control/DirectedControlSampler.h"
 #include "ompl/control/ControlSampler.h"
+#include "ompl/control/SpaceInformation.h"
+#include <boost/scoped_ptr.hpp>
+#include <vector>
 
 namespace ompl
 {
@@ -80,6 +83,32 @@ namespace ompl
                 numControlSamples_ = numSamples;
             }
 
+            /** \brief Set the number of threads that propagate the candidate controls. With the default
+                value of 1, the candidates are propagated on the calling thread. Otherwise, the calling
+                thread and \e threadCount - 1 worker threads share the candidates. The state propagator
+                and the state validity checker must then be thread safe. */
+            void setThreadCount (unsigned int threadCount);
+
+            /** \brief Get the number of threads that propagate the candidate controls */
+            unsigned int getThreadCount (void) const
+            {
+                return threadCount_;
+            }
+
+            /** \brief Stop evaluating candidate controls as soon as one of them brings the system
+                within \e distance of the target. Candidates whose propagation has not started yet
+                are then skipped. A value of 0 (the default) disables this rule. */
+            void setEarlyStopDistance (double distance)
+            {
+                earlyStopDistance_ = distance;
+            }
+
+            /** \brief Get the distance to the target that stops the evaluation of candidate controls */
+            double getEarlyStopDistance (void) const
+            {
+                return earlyStopDistance_;
+            }
+
             /** \brief Sample a control given that it will be applied
                 to state \e state and the intention is to reach state
                 \e target. This is useful for some algorithms that
@@ -110,12 +139,54 @@ namespace ompl
                 control that brings the system the closest to \e target */
             virtual unsigned int getBestControl (Control *control, const base::State *source, const base::State *target, const Control *previous);
 
+            /** \brief Memory a thread reuses each time it calls evaluateCandidates() */
+            struct EvaluationBuffers
+            {
+                std::vector<Control*>                  controls;
+                std::vector<int>                       steps;
+                std::vector<base::State*>              states;
+                std::vector<unsigned int>              validSteps;
+                SpaceInformation::PropagationBuffers   propagation;
+            };
+
+            /** \brief Propagate candidates from \e source until none is left or the early stop rule applies, and
+                record their distances to \e target. Called by every thread that takes part in the evaluation, each
+                with its own \e buffers. */
+            void evaluateCandidates (const base::State *source, const base::State *target, EvaluationBuffers &buffers);
+
             /** \brief An instance of the control sampler*/
             ControlSamplerPtr       cs_;
 
             /** \brief The number of controls to sample when finding the best control*/
             unsigned int            numControlSamples_;
 
+            /** \brief Candidate controls that are propagated together by getBestControl() */
+            std::vector<Control*>     candidates_;
+
+            /** \brief The states reached by each candidate control */
+            std::vector<base::State*> candidateStates_;
+
+            /** \brief The number of steps sampled for each candidate control */
+            std::vector<int>          candidateSteps_;
+
+            /** \brief The distance to the target reached by each candidate control (infinity if it was skipped) */
+            std::vector<double>       candidateDistances_;
+
+            /** \brief The number of threads that propagate candidate controls */
+            unsigned int              threadCount_;
+
+            /** \brief The distance to the target that stops the evaluation of candidate controls */
+            double                    earlyStopDistance_;
+
+        private:
+
+            /// @cond IGNORE
+            class Workers;
+            /// @endcond
+
+            /** \brief The worker threads and the state of the current evaluation */
+            boost::scoped_ptr<Workers> workers_;
+
         };
 
     }
@@ -44,6 +44,8 @@
 #include "ompl/control/StatePropagator.h"
 #include "ompl/control/Control.h"
 #include "ompl/util/ClassForward.h"
+#include <boost/noncopyable.hpp>
+#include <vector>
 
 namespace ompl
 {
@@ -259,6 +261,49 @@ namespace ompl
             */
             unsigned int propagateWhileValid(const base::State *state, const Control* control, int steps, std::vector<base::State*> &result, bool alloc) const;
 
+            /** \brief Memory that the batched propagateWhileValid() reuses between calls, so that propagating
+                batches repeatedly does not allocate memory every time. An instance must only be used by one
+                thread at a time, and only with the SpaceInformation instance it was first used with. */
+            class PropagationBuffers : private boost::noncopyable
+            {
+            public:
+
+                PropagationBuffers(void) : si_(NULL)
+                {
+                }
+
+                ~PropagationBuffers(void);
+
+            private:
+
+                friend class SpaceInformation;
+
+                const SpaceInformation          *si_;
+                std::vector<base::State*>        temp_;
+                std::vector<const base::State*>  current_;
+                std::vector<base::State*>        next_;
+                std::vector<bool>                stopped_;
+                std::vector<const base::State*>  from_;
+                std::vector<const Control*>      controls_;
+                std::vector<base::State*>        to_;
+                std::vector<std::size_t>         active_;
+            };
+
+            /** \brief Propagate the model of the system from a given state with several controls at once, using StatePropagator::propagateBatch().
+                Each control is applied as in the first definition of propagateWhileValid(), but all motions are advanced in lockstep.
+                \param state the state to start at
+                \param controls the controls to apply
+                \param steps the maximum number of time steps to apply each control for. Either all values are non-negative or all are non-positive (backward propagation).
+                \param result the state at the end of each propagation or the last valid state if a collision is found (allocated by the caller, distinct from \e state)
+                \param validSteps the number of steps performed without collision for each control */
+            void propagateWhileValid(const base::State *state, const std::vector<Control*> &controls, const std::vector<int> &steps,
+                                     std::vector<base::State*> &result, std::vector<unsigned int> &validSteps) const;
+
+            /** \brief Same as the previous definition of propagateWhileValid(), but the temporary states and vectors are
+                taken from \e buffers, which keeps them for the next call */
+            void propagateWhileValid(const base::State *state, const std::vector<Control*> &controls, const std::vector<int> &steps,
+                                     std::vector<base::State*> &result, std::vector<unsigned int> &validSteps, PropagationBuffers &buffers) const;
+
             /** @} */
 
             /** \brief Print information about the current instance of the state space */
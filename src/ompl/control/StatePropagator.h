@@ -37,6 +37,7 @@
 #ifndef OMPL_CONTROL_STATE_PROPAGATOR_
 #define OMPL_CONTROL_STATE_PROPAGATOR_
 
+#include "ompl/base/State.h"
 #include "ompl/control/Control.h"
 #include "ompl/util/ClassForward.h"
 
@@ -94,6 +95,19 @@ namespace ompl
             */
             virtual void propagate(const base::State *state, const Control* control, const double duration, base::State *result) const = 0;
 
+            /** \brief Propagate \e n states at once, each with its own control, for the same amount of time.
+                Element \e i of \e results is set to the outcome of propagate(states[i], controls[i], duration, results[i]).
+                The default implementation simply calls propagate() for each element; propagators that can
+                advance many states together (e.g., by integrating them in lockstep) should override it.
+
+                \note The arrays \e states and \e results may only share entries at the same index. */
+            virtual void propagateBatch(const base::State* const* states, const Control* const* controls, const unsigned int n,
+                                        const double duration, base::State** results) const
+            {
+                for (unsigned int i = 0 ; i < n ; ++i)
+                    propagate(states[i], controls[i], duration, results[i]);
+            }
+
             /** \brief Some systems can only propagate forward in time (i.e., the \e duration argument for the propagate()
                 function is always positive). If this is the case, this function should return false. Planners that need
                 backward propagation (negative durations) will call this function to check. If backward propagation is
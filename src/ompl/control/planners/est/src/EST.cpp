@@ -96,6 +96,7 @@ void ompl::control::EST::freeMemory(void)
 
 ompl::base::PlannerStatus ompl::control::EST::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                   *goal = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -142,6 +143,7 @@ ompl::base::PlannerStatus ompl::control::EST::solve(const base::PlannerTerminati
             if (!sampler_->sampleNear(rmotion->state, existing->state, maxDistance_))
                 continue;
         }
+        ++stats_.samples;
 
         // Extend a motion toward the state we just sampled
         unsigned int duration = controlSampler_->sampleTo(rmotion->control, existing->control,
@@ -149,7 +151,10 @@ ompl::base::PlannerStatus ompl::control::EST::solve(const base::PlannerTerminati
 
         // Propagate the system from the state selected for expansion using the control we
         // just sampled for the given duration.  Save the resulting state into rmotion->state.
-        duration = siC_->propagateWhileValid(existing->state, rmotion->control, duration, rmotion->state);
+        {
+            base::PlannerStatistics::Timer timer(stats_.propagations);
+            duration = siC_->propagateWhileValid(existing->state, rmotion->control, duration, rmotion->state);
+        }
 
         // If the system was propagated for a meaningful amount of time, save into the tree
         if (duration >= siC_->getMinControlDuration())
@@ -209,6 +214,7 @@ ompl::base::PlannerStatus ompl::control::EST::solve(const base::PlannerTerminati
         siC_->freeControl(rmotion->control);
     delete rmotion;
 
+    stats_.graphStates = tree_.size;
     logInform("Created %u states in %u cells", tree_.size, tree_.grid.size());
 
     return addedSolution ? base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::TIMEOUT;
@@ -52,6 +52,8 @@ ompl::control::KPIECE1::KPIECE1(const SpaceInformationPtr &si) : base::Planner(s
     badScoreFactor_ = 0.45;
     goodScoreFactor_ = 0.9;
     tree_.grid.onCellUpdate(computeImportance, NULL);
+    // a cell's importance only decreases when it gains neighbors
+    tree_.grid.setLazyNeighborUpdates(true);
     lastGoalMotion_ = NULL;
 
     Planner::declareParam<double>("goal_bias", this, &KPIECE1::setGoalBias, &KPIECE1::getGoalBias);
@@ -177,6 +179,7 @@ unsigned int ompl::control::KPIECE1::findNextMotion(const std::vector<Grid::Coor
 
 ompl::base::PlannerStatus ompl::control::KPIECE1::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal *goal = pdef_->getGoal().get();
 
@@ -237,7 +240,10 @@ ompl::base::PlannerStatus ompl::control::KPIECE1::solve(const base::PlannerTermi
 
         /* propagate */
         unsigned int cd = controlSampler_->sampleStepCount(siC_->getMinControlDuration(), siC_->getMaxControlDuration());
-        cd = siC_->propagateWhileValid(existing->state, rctrl, cd, states, false);
+        {
+            base::PlannerStatistics::Timer timer(stats_.propagations);
+            cd = siC_->propagateWhileValid(existing->state, rctrl, cd, states, false);
+        }
 
         /* if we have enough steps */
         if (cd >= siC_->getMinControlDuration())
@@ -343,6 +349,7 @@ ompl::base::PlannerStatus ompl::control::KPIECE1::solve(const base::PlannerTermi
     for (unsigned int i = 0 ; i < states.size() ; ++i)
         si_->freeState(states[i]);
 
+    stats_.graphStates = tree_.size;
     logInform("Created %u states in %u cells (%u internal + %u external)", tree_.size, tree_.grid.size(),
                  tree_.grid.countInternal(), tree_.grid.countExternal());
 
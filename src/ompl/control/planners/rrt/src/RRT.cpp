@@ -95,6 +95,7 @@ void ompl::control::RRT::freeMemory(void)
 
 ompl::base::PlannerStatus ompl::control::RRT::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                   *goal = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -136,9 +137,14 @@ ompl::base::PlannerStatus ompl::control::RRT::solve(const base::PlannerTerminati
             goal_s->sampleGoal(rstate);
         else
             sampler_->sampleUniform(rstate);
+        ++stats_.samples;
 
         /* find closest state in the tree */
-        Motion *nmotion = nn_->nearest(rmotion);
+        Motion *nmotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
 
         /* sample a random control that attempts to go towards the random state, and also sample a control duration */
         unsigned int cd = controlSampler_->sampleTo(rctrl, nmotion->control, nmotion->state, rmotion->state);
@@ -147,7 +153,10 @@ ompl::base::PlannerStatus ompl::control::RRT::solve(const base::PlannerTerminati
         {
             // this code is contributed by Jennifer Barry
             std::vector<base::State *> pstates;
-            cd = siC_->propagateWhileValid(nmotion->state, rctrl, cd, pstates, true);
+            {
+                base::PlannerStatistics::Timer timer(stats_.propagations);
+                cd = siC_->propagateWhileValid(nmotion->state, rctrl, cd, pstates, true);
+            }
 
             if (cd >= siC_->getMinControlDuration())
             {
@@ -193,7 +202,10 @@ ompl::base::PlannerStatus ompl::control::RRT::solve(const base::PlannerTerminati
         }
         else
         {
-            cd = siC_->propagateWhileValid(nmotion->state, rctrl, cd, xstate);
+            {
+                base::PlannerStatistics::Timer timer(stats_.propagations);
+                cd = siC_->propagateWhileValid(nmotion->state, rctrl, cd, xstate);
+            }
 
             if (cd >= siC_->getMinControlDuration())
             {
@@ -260,6 +272,7 @@ ompl::base::PlannerStatus ompl::control::RRT::solve(const base::PlannerTerminati
     delete rmotion;
     si_->freeState(xstate);
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states", nn_->size());
 
     return base::PlannerStatus(solved, approximate);
@@ -0,0 +1,158 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_CONTROL_PLANNERS_SYCLOP_ADAPTIVEDECOMPOSITION_
+#define OMPL_CONTROL_PLANNERS_SYCLOP_ADAPTIVEDECOMPOSITION_
+
+#include <deque>
+#include <vector>
+#include "ompl/base/spaces/RealVectorBounds.h"
+#include "ompl/base/State.h"
+#include "ompl/control/planners/syclop/Decomposition.h"
+
+namespace ompl
+{
+    namespace control
+    {
+        /** \brief An AdaptiveDecomposition is a Decomposition that starts as a coarse grid and splits a region
+            in half along every dimension (as in a quadtree in 2D or an octree in 3D) once Syclop's tree covers
+            enough of it. Parts of the space the tree does not reach remain a few large regions, so the number of
+            regions grows with the explored space rather than with the resolution wanted near the tree.
+            Like GridDecomposition, it leaves project() and sampleFromRegion() to subclasses. */
+        class AdaptiveDecomposition : public Decomposition
+        {
+        public:
+
+            /** \brief Constructor. Creates an AdaptiveDecomposition with a given dimension and bounds, whose initial
+                regions form a grid with the given side length. */
+            AdaptiveDecomposition(const int len, const std::size_t dim, const base::RealVectorBounds& b);
+
+            virtual ~AdaptiveDecomposition()
+            {
+            }
+
+            virtual int getNumRegions() const
+            {
+                return leaves_.size();
+            }
+
+            virtual double getRegionVolume(const int rid) const
+            {
+                return cells_[leaves_[rid]].bounds.getVolume();
+            }
+
+            virtual void getNeighbors(const int rid, std::vector<int>& neighbors) const;
+
+            virtual int locateRegion(const base::State* s) const;
+
+            virtual const base::RealVectorBounds& getRegionBounds(const int rid)
+            {
+                return cells_[leaves_[rid]].bounds;
+            }
+
+            virtual bool refineRegion(const int rid, const double coverage, std::vector<int>& newRegions);
+
+            /** \brief Set the number of times a region of the initial grid can be split. Default is 4. */
+            void setMaxDepth(unsigned int depth)
+            {
+                maxDepth_ = depth;
+            }
+
+            /** \brief Get the number of times a region of the initial grid can be split. */
+            unsigned int getMaxDepth(void) const
+            {
+                return maxDepth_;
+            }
+
+            /** \brief Set the fraction [0,1] of a region's volume that must be covered by the tree
+                before the region is split. Default is 0.5. */
+            void setSplitCoverage(double coverage)
+            {
+                splitCoverage_ = coverage;
+            }
+
+            /** \brief Get the fraction of a region's volume that must be covered by the tree before the region is split. */
+            double getSplitCoverage(void) const
+            {
+                return splitCoverage_;
+            }
+
+        protected:
+
+            /** \brief A cell of the decomposition. Cells that have not been split are the regions. */
+            struct Cell
+            {
+                Cell(const std::size_t dim) : bounds(dim), depth(0), region(-1)
+                {
+                }
+
+                /** \brief The bounds of the cell */
+                base::RealVectorBounds bounds;
+
+                /** \brief The number of times the cell of the initial grid containing this cell was split to obtain it */
+                unsigned int           depth;
+
+                /** \brief The region this cell corresponds to, or -1 if the cell was split */
+                int                    region;
+
+                /** \brief The indices of the children of a split cell. Child k covers the upper half of dimension d
+                    if bit d of k is set, and the lower half otherwise. */
+                std::vector<int>       children;
+            };
+
+            /** \brief Collect the regions within the cell with the given index that touch the given bounds. */
+            void collectTouching(const int cell, const base::RealVectorBounds& b, std::vector<int>& regions) const;
+
+            /** \brief Returns the index of the cell of the initial grid containing the given coordinate. */
+            int locateGridCell(const std::vector<double>& coord) const;
+
+            /** \brief The side length of the initial grid */
+            const int               length_;
+
+            /** \brief All cells; the first length_^dim cells form the initial grid */
+            std::deque<Cell>        cells_;
+
+            /** \brief The cell corresponding to each region */
+            std::vector<int>        leaves_;
+
+            unsigned int            maxDepth_;
+            double                  splitCoverage_;
+
+        private:
+            /** \brief Helper method to return len^dim in call to super-constructor. */
+            static int calcNumRegions(const int len, const std::size_t dim);
+        };
+    }
+}
+#endif
@@ -112,6 +112,15 @@ namespace ompl
             /** \brief Returns the bounds of a given region in this Decomposition. */
             virtual const base::RealVectorBounds& getRegionBounds(const int rid) = 0;
 
+            /** \brief Called by Syclop when the tree covers more of a given region; \e coverage is the fraction
+                of the region's volume that is covered. A Decomposition that refines itself may split the region here:
+                one part keeps the index \e rid and the other parts receive the next unused indices, which are
+                stored in \e newRegions. Returns true if the region was split. By default, regions are never split. */
+            virtual bool refineRegion(const int rid, const double coverage, std::vector<int>& newRegions)
+            {
+                return false;
+            }
+
         protected:
 
             const int numRegions_;
@@ -37,10 +37,9 @@
 #ifndef OMPL_CONTROL_PLANNERS_SYCLOP_SYCLOP_
 #define OMPL_CONTROL_PLANNERS_SYCLOP_SYCLOP_
 
-#include <boost/graph/astar_search.hpp>
-#include <boost/graph/graph_traits.hpp>
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/unordered_map.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/tss.hpp>
 #include "ompl/control/planners/PlannerIncludes.h"
 #include "ompl/control/planners/syclop/Decomposition.h"
 #include "ompl/control/planners/syclop/GridDecomposition.h"
@@ -102,7 +101,10 @@ namespace ompl
                 decomp_(d),
                 covGrid_(Defaults::COVGRID_LENGTH, decomp_),
                 graphReady_(false),
-                numMotions_(0)
+                numMotions_(0),
+                threadCount_(1),
+                customLead_(false),
+                leadEstimates_(NULL)
             {
                 specs_.approximateSolutions = true;
 
@@ -112,6 +114,7 @@ namespace ompl
                 Planner::declareParam<double>("prob_abandon_lead_early", this, &Syclop::setProbAbandonLeadEarly, &Syclop::getProbAbandonLeadEarly);
                 Planner::declareParam<double>("prob_add_available_regions", this, &Syclop::setProbAddingToAvailableRegions, &Syclop::getProbAddingToAvailableRegions);
                 Planner::declareParam<double>("prob_shortest_path_lead", this, &Syclop::setProbShortestPathLead, &Syclop::getProbShortestPathLead);
+                Planner::declareParam<unsigned int>("thread_count", this, &Syclop::setThreadCount, &Syclop::getThreadCount);
             }
 
             virtual ~Syclop()
@@ -133,10 +136,12 @@ namespace ompl
             /// @name Tunable parameters
             /// @{
 
-            /** \brief Allows the user to override the lead computation function. */
+            /** \brief Allows the user to override the lead computation function. With more than one expansion
+                thread, a user-defined lead computation blocks the expansion threads while it runs. */
             void setLeadComputeFn(const LeadComputeFn& compute);
 
-            /** \brief Adds an edge cost factor to be used for edge weights between adjacent regions. */
+            /** \brief Adds an edge cost factor to be used for edge weights between adjacent regions. With more than one
+                expansion thread, user-defined edge cost factors make lead computations block the expansion threads. */
             void addEdgeCostFactor(const EdgeCostFactorFn& factor);
 
             /** \brief Clears all edge cost factors, making all edge weights equivalent to 1. */
@@ -224,6 +229,18 @@ namespace ompl
             {
                 probAbandonLeadEarly_ = probability;
             }
+
+            /// \brief Get the number of threads that expand the low-level tree.
+            unsigned int getThreadCount (void) const
+            {
+                return threadCount_;
+            }
+
+            /// \brief Set the number of threads that expand the low-level tree.
+            ///  With more than one thread, the threads concurrently expand the tree
+            ///  from regions of the current lead, while the next lead is computed
+            ///  in the calling thread. Default is 1.
+            void setThreadCount (unsigned int nthreads);
             /// @}
 
             /** \brief Contains default values for Syclop parameters. */
@@ -351,13 +368,43 @@ namespace ompl
             virtual Motion* addRoot(const base::State* s) = 0;
 
             /** \brief Select a Motion from the given Region, and extend the tree from the Motion.
-                Add any new motions created to newMotions. */
+                Add any new motions created to newMotions. This function is called without treeMutex_ held;
+                implementations that can expand concurrently hold it shared while reading the tree or the motions of a
+                Region, and exclusively while sampling from the Decomposition or adding motions to the tree. */
             virtual void selectAndExtend(Region& region, std::vector<Motion*>& newMotions) = 0;
 
-            /** \brief Returns a reference to the Region object with the given index. Assumes the index is valid. */
+            /** \brief Return true if selectAndExtend() may be called from several threads at once (see setThreadCount()). */
+            virtual bool canExpandConcurrently(void) const
+            {
+                return false;
+            }
+
+            /** \brief Return true if the calling thread is one of the threads started to expand the tree concurrently. */
+            bool isExpansionThread(void) const
+            {
+                return worker_.get() != NULL;
+            }
+
+            /** \brief Return the random number generator of the calling thread. This is rng_ unless the
+                call is made from a concurrent expansion thread. */
+            RNG& getThreadRNG(void)
+            {
+                return worker_.get() ? worker_->rng : rng_;
+            }
+
+            /** \brief Return the statistics counters of the calling thread. Counters of concurrent
+                expansion threads are added to stats_ when the threads finish. */
+            base::PlannerStatistics& getThreadStatistics(void)
+            {
+                return worker_.get() ? worker_->stats : stats_;
+            }
+
+            /** \brief Returns a reference to the Region object with the given index. Assumes the index is valid.
+                Regions that have not been created yet share a single empty Region object. */
             inline const Region& getRegionFromIndex(const int rid) const
             {
-                return graph_[boost::vertex(rid,graph_)];
+                boost::unordered_map<int, Region>::const_iterator r = regions_.find(rid);
+                return r == regions_.end() ? emptyRegion_ : r->second;
             }
 
             /** \brief The number of states to sample to estimate free volume in the Decomposition. */
@@ -384,9 +431,12 @@ namespace ompl
             /** \brief The high level decomposition used to focus tree expansion */
             DecompositionPtr decomp_;
 
-            /** \brief Random number generator */
+            /** \brief Random number generator of the thread calling solve(); concurrent expansion threads use their own (see getThreadRNG()) */
             RNG rng_;
 
+            /** \brief Guards the low-level tree and the Region and Adjacency estimates when several threads expand the tree */
+            boost::shared_mutex treeMutex_;
+
         private:
             /** \brief Syclop uses a CoverageGrid to estimate coverage in its assigned Decomposition.
                 The CoverageGrid should have finer resolution than the Decomposition. */
@@ -417,50 +467,6 @@ namespace ompl
                 const DecompositionPtr& decomp;
             };
 
-            typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, Region, Adjacency> RegionGraph;
-            typedef boost::graph_traits<RegionGraph>::vertex_descriptor Vertex;
-            typedef boost::graph_traits<RegionGraph>::vertex_iterator VertexIter;
-            typedef boost::property_map<RegionGraph, boost::vertex_index_t>::type VertexIndexMap;
-            typedef boost::graph_traits<RegionGraph>::edge_iterator EdgeIter;
-
-            /// @cond IGNORE
-            friend class DecompositionHeuristic;
-
-            class DecompositionHeuristic : public boost::astar_heuristic<RegionGraph, double>
-            {
-            public:
-                DecompositionHeuristic(const Syclop* s, const Region& goal) : syclop(s), goalRegion(goal)
-                {
-                }
-
-                double operator()(Vertex v)
-                {
-                    const Region& region = syclop->getRegionFromIndex(v);
-                    return region.alpha*goalRegion.alpha;
-                }
-            private:
-                const Syclop* syclop;
-                const Region& goalRegion;
-            };
-
-            struct found_goal {};
-
-            class GoalVisitor : public boost::default_astar_visitor
-            {
-            public:
-                GoalVisitor(const unsigned int goal) : goalRegion(goal)
-                {
-                }
-                void examine_vertex(Vertex v, const RegionGraph& g)
-                {
-                    if (v == goalRegion)
-                        throw found_goal();
-                }
-            private:
-                const unsigned int goalRegion;
-            };
-            /// @endcond
-
             /// @cond IGNORE
             class RegionSet
             {
@@ -501,6 +507,25 @@ namespace ompl
             };
             /// @endcond
 
+            /** \brief The random stream and statistics counters owned by a concurrent expansion thread. The worker is
+                created by its thread, which counts its state validity checks in \e stats for as long as the worker exists. */
+            struct ExpansionWorker
+            {
+                ExpansionWorker(boost::uint32_t seed, boost::uint32_t stream) : rng(seed, stream), statsScope(stats)
+                {
+                }
+
+                RNG                                  rng;
+                base::PlannerStatistics              stats;
+                base::PlannerStatistics::ThreadScope statsScope;
+            };
+
+            /** \brief The lead and solution shared between the calling thread and the expansion threads */
+            struct ExpansionState;
+
+            /** \brief A copy of the region and adjacency estimates the next lead is computed from while the expansion threads run */
+            struct LeadEstimates;
+
             /** \brief Initializes default values for a given Region. */
             void initRegion(Region& r);
 
@@ -513,8 +538,21 @@ namespace ompl
             /** \brief Initializes a given Adjacency between a source Region and a destination Region. */
             void initEdge(Adjacency& a, const Region* source, const Region* target);
 
-            /** \brief Initializes default values for each Adjacency. */
-            void setupEdgeEstimates(void);
+            /** \brief Returns the Region object with the given index, creating it if needed. */
+            Region& getRegion(const int rid);
+
+            /** \brief Returns the Adjacency from Region r to Region s, creating it if needed,
+                or NULL if the two regions are not neighbors in the Decomposition. */
+            Adjacency* getAdjacency(const int r, const int s);
+
+            /** \brief Returns the coefficient contributed by a Region to edge weights, without creating the Region. */
+            double getRegionAlpha(const int rid) const;
+
+            /** \brief Returns the cost of the edge from Region r to Region s, without creating the Adjacency. */
+            double getEdgeCost(const int r, const int s);
+
+            /** \brief Computes the edge cost from Region r to Region s according to Syclop's list of edge cost factors. */
+            double computeEdgeCost(const int r, const int s);
 
             /** \brief Updates the edge cost for a given Adjacency according to Syclop's list of edge cost factors. */
             void updateEdge(Adjacency& a);
@@ -527,9 +565,9 @@ namespace ompl
                 the State s in Region d, update the corresponding Adjacency's cost and connection estimates. */
             bool updateConnectionEstimate(const Region& c, const Region& d, const base::State* s);
 
-            /** \brief Build a RegionGraph according to the Decomposition assigned to Syclop,
-                creating Region and Adjacency objects for each node and edge. */
-            void buildGraph(void);
+            /** \brief Given that the Decomposition split the Region with index rid into itself and newRegions,
+                move the motions of the Region to the parts that now contain them and update the estimates. */
+            void splitRegion(const int rid, const std::vector<int>& newRegions);
 
             /** \brief Clear all Region and Adjacency objects in the graph. */
             void clearGraphDetails(void);
@@ -537,6 +575,34 @@ namespace ompl
             /** \brief Select a Region in which to promote expansion of the low-level tree. */
             int selectRegion(void);
 
+            /** \brief Select a Region in which to promote expansion of the low-level tree, using the given random number generator. */
+            int selectRegion(RNG& rng);
+
+            /** \brief Choose start and goal regions and compute a lead between them. */
+            void chooseLead(std::vector<int>& lead);
+
+            /** \brief Choose the start and goal regions of the next lead. */
+            void chooseLeadRegions(int& startRegion, int& goalRegion);
+
+            /** \brief Copy the estimates used by the default lead computation and edge cost factor. */
+            void copyLeadEstimates(LeadEstimates& estimates) const;
+
+            /** \brief Returns the estimates a lead is being computed from, or NULL if the live estimates are used. */
+            const LeadEstimates* getLeadEstimates(void) const;
+
+            /** \brief Update the edge costs of the empty adjacencies along a lead. */
+            void includeInLead(const std::vector<int>& lead);
+
+            /** \brief Add a Motion created by expanding the tree from the Region with the given index to the graph,
+                and update the coverage and connection estimates. Returns true if an estimate improved. */
+            bool addMotion(const int region, Motion* motion);
+
+            /** \brief Expand the tree with threadCount_ threads until a solution is found or ptc is met. */
+            void expandConcurrently(const base::PlannerTerminationCondition& ptc, const Motion*& solution, double& goalDist, bool& solved);
+
+            /** \brief The body of a concurrent expansion thread */
+            void expansionThread(unsigned int tid, const base::PlannerTerminationCondition& ptc, ExpansionState* es, boost::uint32_t seed);
+
             /** \brief Compute the set of Regions available for selection. */
             void computeAvailableRegions(void);
 
@@ -556,18 +622,38 @@ namespace ompl
             std::vector<EdgeCostFactorFn> edgeCostFactors_;
             /** \brief An underlying grid used to estimate coverage */
             CoverageGrid covGrid_;
-            /** \brief A graph structure whose nodes and edges correspond to regions and adjacencies in the given Decomposition */
-            RegionGraph graph_;
-            /** \brief This value stores whether the graph structure has been built */
+            /** \brief The regions of the Decomposition that have been created so far. Regions are created the first time
+                they receive an estimate or a motion, so the memory used grows with the part of the Decomposition
+                the planner visits rather than with the size of the Decomposition. */
+            boost::unordered_map<int, Region> regions_;
+            /** \brief Stands in for every region that has not been created yet */
+            Region emptyRegion_;
+            /** \brief This value stores whether the region estimates have been set up */
             bool graphReady_;
-            /** \brief Maps pairs of regions to adjacency objects */
-            boost::unordered_map<std::pair<int,int>, Adjacency*> regionsToEdge_;
+            /** \brief Maps pairs of neighboring regions to the adjacency objects created so far */
+            boost::unordered_map<std::pair<int,int>, Adjacency> regionsToEdge_;
             /** \brief The total number of motions in the low-level tree */
             unsigned int numMotions_;
             /** \brief The set of all regions that contain start states */
             RegionSet startRegions_;
             /** \brief The set of all regions that contain goal states */
             RegionSet goalRegions_;
+            /** \brief The start states, kept to locate their regions again when a region is split */
+            std::vector<const base::State*> startStates_;
+            /** \brief The goal states sampled so far, kept to locate their regions again when a region is split */
+            std::vector<const base::State*> goalStates_;
+
+            /** \brief The number of threads that expand the low-level tree */
+            unsigned int threadCount_;
+
+            /** \brief This value is true if the user changed the lead computation or the edge cost factors */
+            bool customLead_;
+
+            /** \brief The copied estimates the calling thread computes the next lead from, if any */
+            const LeadEstimates* leadEstimates_;
+
+            /** \brief The data of the calling thread, if it is a concurrent expansion thread */
+            boost::thread_specific_ptr<ExpansionWorker> worker_;
         };
     }
 }
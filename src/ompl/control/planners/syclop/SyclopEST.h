@@ -69,6 +69,14 @@ namespace ompl
             virtual Syclop::Motion* addRoot(const base::State* s);
             virtual void selectAndExtend(Region& region, std::vector<Motion*>& newMotions);
 
+            virtual bool canExpandConcurrently(void) const
+            {
+                return true;
+            }
+
+            /** \brief Return the control sampler of the calling thread */
+            ControlSampler* getThreadControlSampler(void);
+
             /** \brief Free the memory allocated by this planner. */
             void freeMemory(void);
 
@@ -78,6 +86,9 @@ namespace ompl
 
             /** \brief The most recent goal motion.  Used for PlannerData computation */
             Motion *lastGoalMotion_;
+
+            /** \brief The control samplers of concurrent expansion threads */
+            boost::thread_specific_ptr<ControlSamplerPtr> threadControlSampler_;
         };
     }
 }
@@ -89,6 +89,14 @@ namespace ompl
             virtual Syclop::Motion* addRoot(const base::State* s);
             virtual void selectAndExtend(Region& region, std::vector<Motion*>& newMotions);
 
+            virtual bool canExpandConcurrently(void) const
+            {
+                return true;
+            }
+
+            /** \brief Return the directed control sampler of the calling thread */
+            DirectedControlSampler* getThreadControlSampler(void);
+
             /** \brief Free the memory allocated by this planner. */
             void freeMemory(void);
 
@@ -105,6 +113,9 @@ namespace ompl
 
             /** \brief The most recent goal motion.  Used for PlannerData computation */
             Motion *lastGoalMotion_;
+
+            /** \brief The directed control samplers of concurrent expansion threads */
+            boost::thread_specific_ptr<DirectedControlSamplerPtr> threadControlSampler_;
         };
     }
 }
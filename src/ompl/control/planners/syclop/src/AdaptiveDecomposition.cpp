@@ -0,0 +1,197 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/control/planners/syclop/AdaptiveDecomposition.h"
+#include <algorithm>
+
+ompl::control::AdaptiveDecomposition::AdaptiveDecomposition(const int len, const std::size_t dim, const base::RealVectorBounds& b) :
+    Decomposition(calcNumRegions(len,dim), dim, b), length_(len), maxDepth_(4), splitCoverage_(0.5)
+{
+    // the initial grid is numbered like a GridDecomposition, with the last dimension varying fastest
+    const int numCells = calcNumRegions(len, dim);
+    std::vector<int> coord(dim);
+    for (int i = 0; i < numCells; ++i)
+    {
+        int rid = i;
+        for (int d = dim-1; d >= 0; --d)
+        {
+            coord[d] = rid % length_;
+            rid /= length_;
+        }
+        Cell cell(dim);
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            const double length = (bounds_.high[d] - bounds_.low[d]) / length_;
+            cell.bounds.low[d] = bounds_.low[d] + length*coord[d];
+            cell.bounds.high[d] = (coord[d] == length_-1 ? bounds_.high[d] : bounds_.low[d] + length*(coord[d]+1));
+        }
+        cell.region = i;
+        cells_.push_back(cell);
+        leaves_.push_back(i);
+    }
+}
+
+int ompl::control::AdaptiveDecomposition::locateGridCell(const std::vector<double>& coord) const
+{
+    int cell = 0;
+    int factor = 1;
+    for (int i = dimension_-1; i >= 0; --i)
+    {
+        int index = (int) (length_*(coord[i]-bounds_.low[i])/(bounds_.high[i]-bounds_.low[i]));
+        // coordinates on (or beyond) the bounds belong to the outermost cells
+        if (index >= length_)
+            index = length_-1;
+        else if (index < 0)
+            index = 0;
+        cell += factor*index;
+        factor *= length_;
+    }
+    return cell;
+}
+
+int ompl::control::AdaptiveDecomposition::locateRegion(const base::State* s) const
+{
+    std::vector<double> coord(dimension_);
+    project(s, coord);
+    int cell = locateGridCell(coord);
+    while (cells_[cell].region < 0)
+    {
+        const base::RealVectorBounds& b = cells_[cell].bounds;
+        std::size_t child = 0;
+        for (std::size_t d = 0; d < dimension_; ++d)
+            if (coord[d] >= 0.5 * (b.low[d] + b.high[d]))
+                child |= (std::size_t)1 << d;
+        cell = cells_[cell].children[child];
+    }
+    return cells_[cell].region;
+}
+
+void ompl::control::AdaptiveDecomposition::getNeighbors(const int rid, std::vector<int>& neighbors) const
+{
+    const base::RealVectorBounds& b = cells_[leaves_[rid]].bounds;
+
+    // the cells of the initial grid that can touch the region
+    std::vector<int> lowCoord(dimension_), highCoord(dimension_);
+    for (std::size_t d = 0; d < dimension_; ++d)
+    {
+        const double length = (bounds_.high[d] - bounds_.low[d]) / length_;
+        lowCoord[d] = std::max((int) ((b.low[d] - bounds_.low[d]) / length) - 1, 0);
+        highCoord[d] = std::min((int) ((b.high[d] - bounds_.low[d]) / length) + 1, length_-1);
+    }
+
+    std::vector<int> coord(lowCoord);
+    std::vector<int> touching;
+    while (true)
+    {
+        int cell = 0;
+        for (std::size_t d = 0; d < dimension_; ++d)
+            cell = cell*length_ + coord[d];
+        collectTouching(cell, b, touching);
+
+        std::size_t d = 0;
+        while (d < dimension_ && coord[d] == highCoord[d])
+        {
+            coord[d] = lowCoord[d];
+            ++d;
+        }
+        if (d == dimension_)
+            break;
+        ++coord[d];
+    }
+
+    for (std::vector<int>::const_iterator i = touching.begin(); i != touching.end(); ++i)
+        if (*i != rid)
+            neighbors.push_back(*i);
+}
+
+void ompl::control::AdaptiveDecomposition::collectTouching(const int cell, const base::RealVectorBounds& b, std::vector<int>& regions) const
+{
+    // split cells share the bounds of their parents exactly, so touching regions can be found by comparison
+    const Cell& c = cells_[cell];
+    for (std::size_t d = 0; d < dimension_; ++d)
+        if (c.bounds.low[d] > b.high[d] || b.low[d] > c.bounds.high[d])
+            return;
+    if (c.region >= 0)
+        regions.push_back(c.region);
+    else
+        for (std::vector<int>::const_iterator i = c.children.begin(); i != c.children.end(); ++i)
+            collectTouching(*i, b, regions);
+}
+
+bool ompl::control::AdaptiveDecomposition::refineRegion(const int rid, const double coverage, std::vector<int>& newRegions)
+{
+    const int parent = leaves_[rid];
+    if (coverage < splitCoverage_ || cells_[parent].depth >= maxDepth_)
+        return false;
+
+    const std::size_t numChildren = (std::size_t)1 << dimension_;
+    for (std::size_t k = 0; k < numChildren; ++k)
+    {
+        Cell child(dimension_);
+        for (std::size_t d = 0; d < dimension_; ++d)
+        {
+            const base::RealVectorBounds& b = cells_[parent].bounds;
+            const double mid = 0.5 * (b.low[d] + b.high[d]);
+            child.bounds.low[d] = (k & ((std::size_t)1 << d)) ? mid : b.low[d];
+            child.bounds.high[d] = (k & ((std::size_t)1 << d)) ? b.high[d] : mid;
+        }
+        child.depth = cells_[parent].depth + 1;
+
+        // the first child keeps the index of the region, the others get new indices
+        const int cell = cells_.size();
+        if (k == 0)
+        {
+            child.region = rid;
+            leaves_[rid] = cell;
+        }
+        else
+        {
+            child.region = leaves_.size();
+            newRegions.push_back(child.region);
+            leaves_.push_back(cell);
+        }
+        cells_[parent].children.push_back(cell);
+        cells_.push_back(child);
+    }
+    cells_[parent].region = -1;
+    return true;
+}
+
+int ompl::control::AdaptiveDecomposition::calcNumRegions(const int len, const std::size_t dim)
+{
+    int numRegions = 1;
+    for (std::size_t i = 0; i < dim; ++i)
+        numRegions *= len;
+    return numRegions;
+}
@@ -37,21 +37,66 @@
 #include "ompl/control/planners/syclop/Syclop.h"
 #include "ompl/base/goals/GoalSampleableRegion.h"
 #include "ompl/base/ProblemDefinition.h"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <limits>
 #include <stack>
+#include <queue>
+#include <functional>
 #include <algorithm>
 
 const double ompl::control::Syclop::Defaults::PROB_ABANDON_LEAD_EARLY   = 0.25;
 const double ompl::control::Syclop::Defaults::PROB_KEEP_ADDING_TO_AVAIL = 0.95;
 const double ompl::control::Syclop::Defaults::PROB_SHORTEST_PATH        = 0.95;
 
+/// @cond IGNORE
+struct ompl::control::Syclop::ExpansionState
+{
+    ExpansionState(void) : generation(0), expansionsLeft(0), abandoned(false), solved(false), solution(NULL),
+                           goalDist(std::numeric_limits<double>::infinity()), activeThreads(0)
+    {
+    }
+
+    /** \brief Incremented every time a new lead is published to the expansion threads */
+    unsigned int                  generation;
+
+    /** \brief The number of region expansions left for the current lead */
+    int                           expansionsLeft;
+
+    /** \brief Set when an expansion thread decides to abandon the current lead early */
+    bool                          abandoned;
+
+    bool                          solved;
+    const Motion                 *solution;
+    double                        goalDist;
+
+    /** \brief The number of expansion threads that have not finished */
+    unsigned int                  activeThreads;
+
+    boost::condition_variable_any cond;
+};
+
+struct ompl::control::Syclop::LeadEstimates
+{
+    /** \brief The estimates of an Adjacency used by the default edge cost factor */
+    struct Edge
+    {
+        double      cost;
+        int         selections;
+        std::size_t coverage;
+    };
+
+    boost::unordered_map<int, double>                  alpha;
+    boost::unordered_map<std::pair<int,int>, Edge>     edges;
+};
+/// @endcond
+
 void ompl::control::Syclop::setup(void)
 {
     base::Planner::setup();
     if (!leadComputeFn)
-        setLeadComputeFn(boost::bind(&ompl::control::Syclop::defaultComputeLead, this, _1, _2, _3));
-    buildGraph();
-    addEdgeCostFactor(boost::bind(&ompl::control::Syclop::defaultEdgeCost, this, _1, _2));
+        leadComputeFn = boost::bind(&ompl::control::Syclop::defaultComputeLead, this, _1, _2, _3);
+    edgeCostFactors_.push_back(boost::bind(&ompl::control::Syclop::defaultEdgeCost, this, _1, _2));
 }
 
 void ompl::control::Syclop::clear(void)
@@ -62,26 +107,30 @@ void ompl::control::Syclop::clear(void)
     clearGraphDetails();
     startRegions_.clear();
     goalRegions_.clear();
+    startStates_.clear();
+    goalStates_.clear();
 }
 
 ompl::base::PlannerStatus ompl::control::Syclop::solve(const base::PlannerTerminationCondition& ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     if (!graphReady_)
     {
         numMotions_ = 0;
         setupRegionEstimates();
-        setupEdgeEstimates();
         graphReady_ = true;
     }
     while (const base::State* s = pis_.nextStart())
     {
         const int region = decomp_->locateRegion(s);
         startRegions_.insert(region);
+        startStates_.push_back(s);
         Motion* startMotion = addRoot(s);
-        graph_[boost::vertex(region,graph_)].motions.push_back(startMotion);
+        Region& startRegion = getRegion(region);
+        startRegion.motions.push_back(startMotion);
         ++numMotions_;
-        updateCoverageEstimate(graph_[boost::vertex(region,graph_)], s);
+        updateCoverageEstimate(startRegion, s);
     }
     if (startRegions_.empty())
     {
@@ -93,7 +142,10 @@ ompl::base::PlannerStatus ompl::control::Syclop::solve(const base::PlannerTermin
     if (goalRegions_.empty())
     {
         if (const base::State* g = pis_.nextGoal(ptc))
+        {
+            goalStates_.push_back(g);
             goalRegions_.insert(decomp_->locateRegion(g));
+        }
         else
         {
             logError("Unable to sample a valid goal state");
@@ -103,80 +155,55 @@ ompl::base::PlannerStatus ompl::control::Syclop::solve(const base::PlannerTermin
 
     logInform("Starting with %u states", numMotions_);
 
-    std::vector<Motion*> newMotions;
     const Motion* solution = NULL;
-    base::Goal* goal = pdef_->getGoal().get();
     double goalDist = std::numeric_limits<double>::infinity();
     bool solved = false;
-    while (!ptc() && !solved)
+    if (threadCount_ > 1 && canExpandConcurrently())
+        expandConcurrently(ptc, solution, goalDist, solved);
+    else
     {
-        const int chosenStartRegion = startRegions_.sampleUniform();
-        int chosenGoalRegion = -1;
-
-        // if we have not sampled too many goal regions already
-        if (pis_.haveMoreGoalStates() && goalRegions_.size() < numMotions_/2)
-        {
-            if (const base::State* g = pis_.nextGoal())
-            {
-                chosenGoalRegion = decomp_->locateRegion(g);
-                goalRegions_.insert(chosenGoalRegion);
-            }
-        }
-        if (chosenGoalRegion == -1)
-            chosenGoalRegion = goalRegions_.sampleUniform();
-
-        leadComputeFn(chosenStartRegion, chosenGoalRegion, lead_);
-        computeAvailableRegions();
-        for (int i = 0; i < numRegionExpansions_ && !solved && !ptc(); ++i)
+        if (threadCount_ > 1)
+            logWarn("%s cannot expand its tree concurrently. Using a single thread.", getName().c_str());
+        std::vector<Motion*> newMotions;
+        base::Goal* goal = pdef_->getGoal().get();
+        while (!ptc() && !solved)
         {
-            const int region = selectRegion();
-            bool improved = false;
-            for (int j = 0; j < numTreeSelections_ && !solved && !ptc(); ++j)
+            chooseLead(lead_);
+            computeAvailableRegions();
+            for (int i = 0; i < numRegionExpansions_ && !solved && !ptc(); ++i)
             {
-                newMotions.clear();
-                selectAndExtend(graph_[boost::vertex(region,graph_)], newMotions);
-                for (std::vector<Motion*>::const_iterator m = newMotions.begin(); m != newMotions.end() && !ptc(); ++m)
+                const int region = selectRegion();
+                Region& regionObj = getRegion(region);
+                bool improved = false;
+                // a region loses its motions when an adaptive decomposition splits it
+                for (int j = 0; j < numTreeSelections_ && !solved && !ptc() && !regionObj.motions.empty(); ++j)
                 {
-                    Motion* motion = *m;
-                    double distance;
-                    solved = goal->isSatisfied(motion->state, &distance);
-                    if (solved)
+                    newMotions.clear();
+                    selectAndExtend(regionObj, newMotions);
+                    for (std::vector<Motion*>::const_iterator m = newMotions.begin(); m != newMotions.end() && !ptc(); ++m)
                     {
-                        goalDist = distance;
-                        solution = motion;
-                        break;
-                    }
+                        Motion* motion = *m;
+                        double distance;
+                        solved = goal->isSatisfied(motion->state, &distance);
+                        if (solved)
+                        {
+                            goalDist = distance;
+                            solution = motion;
+                            break;
+                        }
 
-                    // Check for approximate (best-so-far) solution
-                    if (distance < goalDist)
-                    {
-                        goalDist = distance;
-                        solution = motion;
-                    }
-                    const int newRegion = decomp_->locateRegion(motion->state);
-                    graph_[boost::vertex(newRegion,graph_)].motions.push_back(motion);
-                    ++numMotions_;
-                    Region& newRegionObj = graph_[boost::vertex(newRegion, graph_)];
-                    improved |= updateCoverageEstimate(newRegionObj, motion->state);
-                    if (newRegion != region)
-                    {
-                        // If this is the first time the tree has entered this region, add the region to avail
-                        if (newRegionObj.motions.size() == 1)
-                            availDist_.add(newRegion, newRegionObj.weight);
-                        /* If the tree crosses an entire region and creates an edge (u,v) for which Proj(u) and Proj(v) are non-neighboring regions,
-                            then we do not update connection estimates. This is because Syclop's shortest-path lead computation only considers neighboring regions. */
-                        if (regionsToEdge_.count(std::pair<int,int>(region, newRegion)) > 0)
+                        // Check for approximate (best-so-far) solution
+                        if (distance < goalDist)
                         {
-                            Adjacency* adj = regionsToEdge_[std::pair<int,int>(region,newRegion)];
-                            adj->empty = false;
-                            ++adj->numSelections;
-                            improved |= updateConnectionEstimate(graph_[boost::vertex(region,graph_)], newRegionObj, motion->state);
+                            goalDist = distance;
+                            solution = motion;
                         }
+                        improved |= addMotion(region, motion);
                     }
                 }
+                if (!improved && rng_.uniform01() < probAbandonLeadEarly_)
+                    break;
             }
-            if (!improved && rng_.uniform01() < probAbandonLeadEarly_)
-                break;
         }
     }
     bool addedSolution = false;
@@ -200,14 +227,254 @@ ompl::base::PlannerStatus ompl::control::Syclop::solve(const base::PlannerTermin
     return addedSolution ? base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::TIMEOUT;
 }
 
+void ompl::control::Syclop::setThreadCount(unsigned int nthreads)
+{
+    assert(nthreads > 0);
+    threadCount_ = nthreads;
+    specs_.multithreaded = nthreads > 1;
+}
+
+void ompl::control::Syclop::chooseLead(std::vector<int>& lead)
+{
+    int startRegion, goalRegion;
+    chooseLeadRegions(startRegion, goalRegion);
+    leadComputeFn(startRegion, goalRegion, lead);
+}
+
+void ompl::control::Syclop::chooseLeadRegions(int& chosenStartRegion, int& chosenGoalRegion)
+{
+    chosenStartRegion = startRegions_.sampleUniform();
+    chosenGoalRegion = -1;
+
+    // if we have not sampled too many goal regions already
+    if (pis_.haveMoreGoalStates() && goalRegions_.size() < numMotions_/2)
+    {
+        if (const base::State* g = pis_.nextGoal())
+        {
+            goalStates_.push_back(g);
+            chosenGoalRegion = decomp_->locateRegion(g);
+            goalRegions_.insert(chosenGoalRegion);
+        }
+    }
+    if (chosenGoalRegion == -1)
+        chosenGoalRegion = goalRegions_.sampleUniform();
+}
+
+void ompl::control::Syclop::copyLeadEstimates(LeadEstimates& estimates) const
+{
+    estimates.alpha.clear();
+    for (boost::unordered_map<int, Region>::const_iterator i = regions_.begin(); i != regions_.end(); ++i)
+        estimates.alpha[i->first] = i->second.alpha;
+    estimates.edges.clear();
+    for (boost::unordered_map<std::pair<int,int>, Adjacency>::const_iterator i = regionsToEdge_.begin(); i != regionsToEdge_.end(); ++i)
+    {
+        LeadEstimates::Edge& e = estimates.edges[i->first];
+        e.cost = i->second.cost;
+        e.selections = i->second.empty ? i->second.numLeadInclusions : i->second.numSelections;
+        e.coverage = i->second.covGridCells.size();
+    }
+}
+
+const ompl::control::Syclop::LeadEstimates* ompl::control::Syclop::getLeadEstimates(void) const
+{
+    // expansion threads update the live estimates, so they never read the copy
+    return isExpansionThread() ? NULL : leadEstimates_;
+}
+
+void ompl::control::Syclop::includeInLead(const std::vector<int>& lead)
+{
+    for (std::size_t i = 0; i + 1 < lead.size(); ++i)
+    {
+        // regions split while the lead was computed may no longer be neighbors
+        Adjacency* adj = getAdjacency(lead[i], lead[i+1]);
+        if (adj && adj->empty)
+        {
+            ++adj->numLeadInclusions;
+            updateEdge(*adj);
+        }
+    }
+}
+
+bool ompl::control::Syclop::addMotion(const int region, Motion* motion)
+{
+    const int newRegion = decomp_->locateRegion(motion->state);
+    Region& newRegionObj = getRegion(newRegion);
+    newRegionObj.motions.push_back(motion);
+    ++numMotions_;
+    const bool covered = updateCoverageEstimate(newRegionObj, motion->state);
+    bool improved = covered;
+    if (newRegion != region)
+    {
+        // If this is the first time the tree has entered this region, add the region to avail
+        if (newRegionObj.motions.size() == 1)
+            availDist_.add(newRegion, newRegionObj.weight);
+        /* If the tree crosses an entire region and creates an edge (u,v) for which Proj(u) and Proj(v) are non-neighboring regions,
+            then we do not update connection estimates. This is because Syclop's shortest-path lead computation only considers neighboring regions. */
+        if (Adjacency* adj = getAdjacency(region, newRegion))
+        {
+            adj->empty = false;
+            ++adj->numSelections;
+            improved |= updateConnectionEstimate(getRegion(region), newRegionObj, motion->state);
+        }
+    }
+
+    // decompositions that adapt to the tree may split the region now that it is covered further
+    if (covered)
+    {
+        const double coverage = newRegionObj.covGridCells.size() * covGrid_.getRegionVolume(0) / newRegionObj.volume;
+        std::vector<int> newRegions;
+        if (decomp_->refineRegion(newRegion, std::min(coverage, 1.0), newRegions))
+            splitRegion(newRegion, newRegions);
+    }
+    return improved;
+}
+
+void ompl::control::Syclop::expandConcurrently(const base::PlannerTerminationCondition& ptc, const Motion*& solution, double& goalDist, bool& solved)
+{
+    ExpansionState es;
+    LeadEstimates estimates;
+    std::vector<int> nextLead;
+    int startRegion, goalRegion;
+    boost::unique_lock<boost::shared_mutex> lock(treeMutex_);
+
+    chooseLead(lead_);
+    computeAvailableRegions();
+    es.expansionsLeft = numRegionExpansions_;
+    es.activeThreads = threadCount_;
+
+    // every thread gets its own random stream, derived from a seed drawn
+    // here so that the streams do not depend on the order in which
+    // threads start
+    const boost::uint32_t seed = (boost::uint32_t)rng_.uniformInt(1, std::numeric_limits<int>::max());
+    boost::thread_group threads;
+    for (unsigned int i = 0 ; i < threadCount_ ; ++i)
+        threads.create_thread(boost::bind(&Syclop::expansionThread, this, i, boost::cref(ptc), &es, seed));
+
+    while (true)
+    {
+        // the next lead is computed from a copy of the estimates available now,
+        // while the expansion threads keep extending the tree along the current
+        // one; user-defined lead computations read the live estimates and keep
+        // the lock
+        if (customLead_)
+            chooseLead(nextLead);
+        else
+        {
+            chooseLeadRegions(startRegion, goalRegion);
+            copyLeadEstimates(estimates);
+            lock.unlock();
+            leadEstimates_ = &estimates;
+            leadComputeFn(startRegion, goalRegion, nextLead);
+            leadEstimates_ = NULL;
+            lock.lock();
+            includeInLead(nextLead);
+        }
+        while (es.expansionsLeft > 0 && !es.abandoned && !es.solved && es.activeThreads > 0)
+            es.cond.wait(lock);
+        if (es.solved || es.activeThreads == 0)
+            break;
+        lead_.swap(nextLead);
+        computeAvailableRegions();
+        es.expansionsLeft = numRegionExpansions_;
+        es.abandoned = false;
+        ++es.generation;
+        es.cond.notify_all();
+    }
+    lock.unlock();
+    threads.join_all();
+
+    solution = es.solution;
+    goalDist = es.goalDist;
+    solved = es.solved;
+}
+
+void ompl::control::Syclop::expansionThread(unsigned int tid, const base::PlannerTerminationCondition& ptc, ExpansionState* es, boost::uint32_t seed)
+{
+    worker_.reset(new ExpansionWorker(seed, tid));
+    worker_->stats.setTiming(stats_.isTiming());
+    RNG& rng = worker_->rng;
+    base::Goal* goal = pdef_->getGoal().get();
+    std::vector<Motion*> newMotions;
+    std::vector<double> distances;
+
+    boost::unique_lock<boost::shared_mutex> lock(treeMutex_);
+    while (!es->solved && !ptc())
+    {
+        if (es->expansionsLeft <= 0 || es->abandoned)
+        {
+            es->cond.wait(lock);
+            continue;
+        }
+        // wake up the calling thread as soon as the last region of this lead
+        // is taken, so that the next lead is ready when the expansions end
+        if (--es->expansionsLeft == 0)
+            es->cond.notify_all();
+        const unsigned int generation = es->generation;
+        const int region = selectRegion(rng);
+        Region& regionObj = getRegion(region);
+        bool improved = false;
+        for (int j = 0; j < numTreeSelections_ && !es->solved && !ptc() && !regionObj.motions.empty(); ++j)
+        {
+            lock.unlock();
+            newMotions.clear();
+            selectAndExtend(regionObj, newMotions);
+
+            // goal checks do not touch the graph, so they are done before
+            // taking the lock again
+            distances.resize(newMotions.size());
+            std::size_t reached = newMotions.size();
+            for (std::size_t k = 0 ; k < newMotions.size() ; ++k)
+                if (goal->isSatisfied(newMotions[k]->state, &distances[k]))
+                {
+                    reached = k;
+                    break;
+                }
+
+            lock.lock();
+            for (std::size_t k = 0 ; k < newMotions.size() && !es->solved ; ++k)
+            {
+                if (k == reached)
+                {
+                    es->solved = true;
+                    es->goalDist = distances[k];
+                    es->solution = newMotions[k];
+                    es->cond.notify_all();
+                    break;
+                }
+
+                // Check for approximate (best-so-far) solution
+                if (distances[k] < es->goalDist)
+                {
+                    es->goalDist = distances[k];
+                    es->solution = newMotions[k];
+                }
+                improved |= addMotion(region, newMotions[k]);
+            }
+        }
+        // only the lead the region was selected from can be abandoned
+        if (!improved && generation == es->generation && rng.uniform01() < probAbandonLeadEarly_)
+        {
+            es->abandoned = true;
+            es->cond.notify_all();
+        }
+    }
+    --es->activeThreads;
+    es->cond.notify_all();
+    stats_.add(worker_->stats);
+    lock.unlock();
+    worker_.reset();
+}
+
 void ompl::control::Syclop::setLeadComputeFn(const LeadComputeFn& compute)
 {
     leadComputeFn = compute;
+    customLead_ = true;
 }
 
 void ompl::control::Syclop::addEdgeCostFactor(const EdgeCostFactorFn& factor)
 {
     edgeCostFactors_.push_back(factor);
+    customLead_ = true;
 }
 
 void ompl::control::Syclop::clearEdgeCostFactors(void)
@@ -218,16 +485,18 @@ void ompl::control::Syclop::clearEdgeCostFactors(void)
 void ompl::control::Syclop::initRegion(Region& r)
 {
     r.numSelections = 0;
-    r.volume = 1.0;
+    r.volume = decomp_->getRegionVolume(r.index);
     r.percentValidCells = 1.0;
-    r.freeVolume = 1.0;
+    r.freeVolume = r.volume;
+    if (r.freeVolume < std::numeric_limits<double>::epsilon())
+        r.freeVolume = std::numeric_limits<double>::epsilon();
+    updateRegion(r);
 }
 
 void ompl::control::Syclop::setupRegionEstimates(void)
 {
-    std::vector<int> numTotal(decomp_->getNumRegions(), 0);
-    std::vector<int> numValid(decomp_->getNumRegions(), 0);
-    base::StateValidityCheckerPtr checker = si_->getStateValidityChecker();
+    boost::unordered_map<int, int> numTotal;
+    boost::unordered_map<int, int> numValid;
     base::StateSamplerPtr sampler = si_->allocStateSampler();
     base::State* s = si_->allocState();
 
@@ -235,20 +504,17 @@ void ompl::control::Syclop::setupRegionEstimates(void)
     {
         sampler->sampleUniform(s);
         int rid = decomp_->locateRegion(s);
-        if (checker->isValid(s))
+        if (si_->isValid(s))
             ++numValid[rid];
         ++numTotal[rid];
     }
     si_->freeState(s);
 
-    for (int i = 0; i < decomp_->getNumRegions(); ++i)
+    // regions that received no samples keep the estimates they are created with
+    for (boost::unordered_map<int, int>::const_iterator i = numTotal.begin(); i != numTotal.end(); ++i)
     {
-        Region& r = graph_[boost::vertex(i, graph_)];
-        r.volume = decomp_->getRegionVolume(i);
-        if (numTotal[i] == 0)
-            r.percentValidCells = 1.0;
-        else
-            r.percentValidCells = ((double) numValid[i]) / (double)numTotal[i];
+        Region& r = getRegion(i->first);
+        r.percentValidCells = ((double) numValid[i->first]) / (double)i->second;
         r.freeVolume = r.percentValidCells * r.volume;
         if (r.freeVolume < std::numeric_limits<double>::epsilon())
             r.freeVolume = std::numeric_limits<double>::epsilon();
@@ -268,30 +534,87 @@ void ompl::control::Syclop::initEdge(Adjacency& adj, const Region* source, const
     adj.source = source;
     adj.target = target;
     updateEdge(adj);
-    regionsToEdge_[std::pair<int,int>(source->index, target->index)] = &adj;
 }
 
-void ompl::control::Syclop::setupEdgeEstimates(void)
+ompl::control::Syclop::Region& ompl::control::Syclop::getRegion(const int rid)
+{
+    boost::unordered_map<int, Region>::iterator i = regions_.find(rid);
+    if (i != regions_.end())
+        return i->second;
+    Region& r = regions_[rid];
+    r.index = rid;
+    initRegion(r);
+    return r;
+}
+
+ompl::control::Syclop::Adjacency* ompl::control::Syclop::getAdjacency(const int r, const int s)
+{
+    const std::pair<int,int> key(r, s);
+    boost::unordered_map<std::pair<int,int>, Adjacency>::iterator i = regionsToEdge_.find(key);
+    if (i != regionsToEdge_.end())
+        return &i->second;
+
+    std::vector<int> neighbors;
+    decomp_->getNeighbors(r, neighbors);
+    if (std::find(neighbors.begin(), neighbors.end(), s) == neighbors.end())
+        return NULL;
+
+    Adjacency& adj = regionsToEdge_[key];
+    adj.empty = true;
+    adj.numLeadInclusions = 0;
+    adj.numSelections = 0;
+    initEdge(adj, &getRegion(r), &getRegion(s));
+    return &adj;
+}
+
+double ompl::control::Syclop::getRegionAlpha(const int rid) const
+{
+    if (const LeadEstimates* estimates = getLeadEstimates())
+    {
+        boost::unordered_map<int, double>::const_iterator i = estimates->alpha.find(rid);
+        if (i != estimates->alpha.end())
+            return i->second;
+    }
+    else
+    {
+        boost::unordered_map<int, Region>::const_iterator i = regions_.find(rid);
+        if (i != regions_.end())
+            return i->second.alpha;
+    }
+
+    // a region that has not been created has no coverage and is assumed to be entirely free
+    double f = std::max(decomp_->getRegionVolume(rid), std::numeric_limits<double>::epsilon());
+    f = f*f*f*f;
+    return 1.0 / f;
+}
+
+double ompl::control::Syclop::getEdgeCost(const int r, const int s)
 {
-    EdgeIter ei, eend;
-    for (boost::tie(ei,eend) = boost::edges(graph_); ei != eend; ++ei)
+    if (const LeadEstimates* estimates = getLeadEstimates())
     {
-        Adjacency& adj = graph_[*ei];
-        adj.empty = true;
-        adj.numLeadInclusions = 0;
-        adj.numSelections = 0;
-        updateEdge(adj);
+        boost::unordered_map<std::pair<int,int>, LeadEstimates::Edge>::const_iterator i = estimates->edges.find(std::pair<int,int>(r, s));
+        return i != estimates->edges.end() ? i->second.cost : computeEdgeCost(r, s);
     }
+    boost::unordered_map<std::pair<int,int>, Adjacency>::const_iterator i = regionsToEdge_.find(std::pair<int,int>(r, s));
+    if (i != regionsToEdge_.end())
+        return i->second.cost;
+    return computeEdgeCost(r, s);
 }
 
-void ompl::control::Syclop::updateEdge(Adjacency& a)
+double ompl::control::Syclop::computeEdgeCost(const int r, const int s)
 {
-    a.cost = 1.0;
+    double cost = 1.0;
     for (std::vector<EdgeCostFactorFn>::const_iterator i = edgeCostFactors_.begin(); i != edgeCostFactors_.end(); ++i)
     {
         const EdgeCostFactorFn& factor = *i;
-        a.cost *= factor(a.source->index, a.target->index);
+        cost *= factor(r, s);
     }
+    return cost;
+}
+
+void ompl::control::Syclop::updateEdge(Adjacency& a)
+{
+    a.cost = computeEdgeCost(a.source->index, a.target->index);
 }
 
 bool ompl::control::Syclop::updateCoverageEstimate(Region& r, const base::State *s)
@@ -306,7 +629,7 @@ bool ompl::control::Syclop::updateCoverageEstimate(Region& r, const base::State
 
 bool ompl::control::Syclop::updateConnectionEstimate(const Region& c, const Region& d, const base::State *s)
 {
-    Adjacency& adj = *regionsToEdge_[std::pair<int,int>(c.index,d.index)];
+    Adjacency& adj = regionsToEdge_[std::pair<int,int>(c.index,d.index)];
     const int covCell = covGrid_.locateRegion(s);
     if (adj.covGridCells.count(covCell) == 1)
         return false;
@@ -315,49 +638,76 @@ bool ompl::control::Syclop::updateConnectionEstimate(const Region& c, const Regi
     return true;
 }
 
-void ompl::control::Syclop::buildGraph(void)
+void ompl::control::Syclop::splitRegion(const int rid, const std::vector<int>& newRegions)
 {
-    VertexIndexMap index = get(boost::vertex_index, graph_);
-    std::vector<int> neighbors;
-    for (int i = 0; i < decomp_->getNumRegions(); ++i)
+    Region& region = getRegion(rid);
+    std::vector<Motion*> motions;
+    motions.swap(region.motions);
+    region.covGridCells.clear();
+
+    // the adjacencies of the split region no longer match the decomposition;
+    // they are created again when they are needed
+    for (boost::unordered_map<std::pair<int,int>, Adjacency>::iterator i = regionsToEdge_.begin(); i != regionsToEdge_.end(); )
     {
-        const RegionGraph::vertex_descriptor v = boost::add_vertex(graph_);
-        Region& r = graph_[boost::vertex(v,graph_)];
-        initRegion(r);
-        r.index = index[v];
+        if (i->first.first == rid || i->first.second == rid)
+            i = regionsToEdge_.erase(i);
+        else
+            ++i;
     }
-    VertexIter vi, vend;
-    for (boost::tie(vi,vend) = boost::vertices(graph_); vi != vend; ++vi)
+
+    // all parts inherit the free space estimate of the region they come from
+    const double percentValidCells = region.percentValidCells;
+    std::vector<int> parts(newRegions);
+    parts.push_back(rid);
+    for (std::vector<int>::const_iterator i = parts.begin(); i != parts.end(); ++i)
     {
-        /* Create an edge between this vertex and each of its neighboring regions in the decomposition,
-            and initialize the edge's Adjacency object. */
-        decomp_->getNeighbors(index[*vi], neighbors);
-        for (std::vector<int>::const_iterator j = neighbors.begin(); j != neighbors.end(); ++j)
-        {
-            RegionGraph::edge_descriptor edge;
-            bool ignore;
-            boost::tie(edge, ignore) = boost::add_edge(*vi, boost::vertex(*j,graph_), graph_);
-            initEdge(graph_[edge], &graph_[*vi], &graph_[boost::vertex(*j,graph_)]);
-        }
-        neighbors.clear();
+        Region& r = getRegion(*i);
+        r.numSelections = 0;
+        r.volume = decomp_->getRegionVolume(*i);
+        r.percentValidCells = percentValidCells;
+        r.freeVolume = r.percentValidCells * r.volume;
+        if (r.freeVolume < std::numeric_limits<double>::epsilon())
+            r.freeVolume = std::numeric_limits<double>::epsilon();
+        updateRegion(r);
+    }
+    for (std::vector<Motion*>::const_iterator m = motions.begin(); m != motions.end(); ++m)
+    {
+        Region& r = getRegion(decomp_->locateRegion((*m)->state));
+        r.motions.push_back(*m);
+        updateCoverageEstimate(r, (*m)->state);
     }
+
+    startRegions_.clear();
+    for (std::vector<const base::State*>::const_iterator s = startStates_.begin(); s != startStates_.end(); ++s)
+        startRegions_.insert(decomp_->locateRegion(*s));
+    goalRegions_.clear();
+    for (std::vector<const base::State*>::const_iterator g = goalStates_.begin(); g != goalStates_.end(); ++g)
+        goalRegions_.insert(decomp_->locateRegion(*g));
+
+    // the parts take the place of the region in the current lead, and only
+    // regions that still contain motions remain available for selection
+    std::vector<int>::iterator pos = std::find(lead_.begin(), lead_.end(), rid);
+    if (pos != lead_.end())
+        lead_.insert(pos + 1, newRegions.begin(), newRegions.end());
+    computeAvailableRegions();
 }
 
 void ompl::control::Syclop::clearGraphDetails(void)
 {
-    VertexIter vi, vend;
-    for (boost::tie(vi,vend) = boost::vertices(graph_); vi != vend; ++vi)
-        graph_[*vi].clear();
-    EdgeIter ei, eend;
-    for (boost::tie(ei,eend) = boost::edges(graph_); ei != eend; ++ei)
-        graph_[*ei].clear();
+    regions_.clear();
+    regionsToEdge_.clear();
     graphReady_ = false;
 }
 
 int ompl::control::Syclop::selectRegion(void)
 {
-    const int index = availDist_.sample(rng_.uniform01());
-    Region& region = graph_[boost::vertex(index,graph_)];
+    return selectRegion(rng_);
+}
+
+int ompl::control::Syclop::selectRegion(RNG& rng)
+{
+    const int index = availDist_.sample(rng.uniform01());
+    Region& region = getRegion(index);
     ++region.numSelections;
     updateRegion(region);
     return index;
@@ -368,11 +718,13 @@ void ompl::control::Syclop::computeAvailableRegions(void)
     availDist_.clear();
     for (int i = lead_.size()-1; i >= 0; --i)
     {
-        Region& r = graph_[boost::vertex(lead_[i],graph_)];
+        const Region& r = getRegionFromIndex(lead_[i]);
         if (!r.motions.empty())
         {
             availDist_.add(lead_[i], r.weight);
-            if (rng_.uniform01() >= probKeepAddingToAvail_)
+            // expansion threads recompute the available regions when they split one, while the
+            // calling thread may be drawing from rng_ for the next lead
+            if (getThreadRNG().uniform01() >= probKeepAddingToAvail_)
                 break;
         }
     }
@@ -387,110 +739,136 @@ void ompl::control::Syclop::defaultComputeLead(int startRegion, int goalRegion,
         return;
     }
 
-    else if (rng_.uniform01() < probShortestPath_)
+    /* Both searches run over the neighbors reported by the decomposition, so only
+       the regions a search actually reaches are looked at. */
+    boost::unordered_map<int, int> parents;
+    std::vector<int> neighbors;
+    bool goalFound = false;
+    /* When the lead is computed from copied estimates, the expansion threads may refine the
+       decomposition meanwhile, so it is queried under a shared lock, one region at a time. */
+    const bool concurrent = getLeadEstimates() != NULL;
+    if (rng_.uniform01() < probShortestPath_)
     {
-        std::vector<RegionGraph::vertex_descriptor> parents(decomp_->getNumRegions());
-        std::vector<double> distances(decomp_->getNumRegions());
-
-        try
-        {
-            boost::astar_search(graph_, boost::vertex(startRegion, graph_), DecompositionHeuristic(this, getRegionFromIndex(goalRegion)),
-                boost::weight_map(get(&Adjacency::cost, graph_)).distance_map(
-                    boost::make_iterator_property_map(distances.begin(), get(boost::vertex_index, graph_)
-                )).predecessor_map(
-                    boost::make_iterator_property_map(parents.begin(), get(boost::vertex_index, graph_))
-                ).visitor(GoalVisitor(goalRegion))
-            );
-        }
-        catch (found_goal fg)
+        typedef std::pair<double, int> QueueEntry;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > open;
+        boost::unordered_map<int, double> distances;
+        boost::shared_lock<boost::shared_mutex> decompLock(treeMutex_, boost::defer_lock);
+        if (concurrent)
+            decompLock.lock();
+        const double goalAlpha = getRegionAlpha(goalRegion);
+
+        distances[startRegion] = 0.0;
+        parents[startRegion] = startRegion;
+        open.push(QueueEntry(getRegionAlpha(startRegion)*goalAlpha, startRegion));
+        if (concurrent)
+            decompLock.unlock();
+        while (!open.empty())
         {
-            int region = goalRegion;
-            int leadLength = 1;
-
-            while (region != startRegion)
+            boost::shared_lock<boost::shared_mutex> nodeLock(treeMutex_, boost::defer_lock);
+            if (concurrent)
+                nodeLock.lock();
+            const double f = open.top().first;
+            const int v = open.top().second;
+            open.pop();
+            if (v == goalRegion)
             {
-                region = parents[region];
-                ++leadLength;
+                goalFound = true;
+                break;
             }
-            lead.resize(leadLength);
-            region = goalRegion;
-            for (int i = leadLength-1; i >= 0; --i)
+            const double dv = distances[v];
+            // skip entries left behind by a shorter path to v
+            if (f > dv + getRegionAlpha(v)*goalAlpha)
+                continue;
+
+            neighbors.clear();
+            decomp_->getNeighbors(v, neighbors);
+            for (std::vector<int>::const_iterator i = neighbors.begin(); i != neighbors.end(); ++i)
             {
-                lead[i] = region;
-                region = parents[region];
+                const double d = dv + getEdgeCost(v, *i);
+                boost::unordered_map<int, double>::iterator di = distances.find(*i);
+                if (di == distances.end() || d < di->second)
+                {
+                    distances[*i] = d;
+                    parents[*i] = v;
+                    open.push(QueueEntry(d + getRegionAlpha(*i)*goalAlpha, *i));
+                }
             }
         }
     }
     else
     {
-        /* Run a random-DFS over the decomposition graph from the start region to the goal region.
-           There may be a way to do this using boost::depth_first_search. */
-        VertexIndexMap index = get(boost::vertex_index, graph_);
+        /* Run a random-DFS over the decomposition graph from the start region to the goal region. */
         std::stack<int> nodesToProcess;
-        std::vector<int> parents(decomp_->getNumRegions(), -1);
         parents[startRegion] = startRegion;
         nodesToProcess.push(startRegion);
-        bool goalFound = false;
         while (!goalFound && !nodesToProcess.empty())
         {
             const int v = nodesToProcess.top();
             nodesToProcess.pop();
-            std::vector<int> neighbors;
-            boost::graph_traits<RegionGraph>::adjacency_iterator ai, aend;
-            for (boost::tie(ai,aend) = adjacent_vertices(boost::vertex(v,graph_),graph_); ai != aend; ++ai)
+            std::vector<int> adjacent;
+            neighbors.clear();
             {
-                if (parents[index[*ai]] < 0)
+                boost::shared_lock<boost::shared_mutex> nodeLock(treeMutex_, boost::defer_lock);
+                if (concurrent)
+                    nodeLock.lock();
+                decomp_->getNeighbors(v, neighbors);
+            }
+            for (std::vector<int>::const_iterator i = neighbors.begin(); i != neighbors.end(); ++i)
+            {
+                if (parents.count(*i) == 0)
                 {
-                    neighbors.push_back(index[*ai]);
-                    parents[index[*ai]] = v;
+                    adjacent.push_back(*i);
+                    parents[*i] = v;
                 }
             }
-            for (std::size_t i = 0; i < neighbors.size(); ++i)
+            for (std::size_t i = 0; i < adjacent.size(); ++i)
             {
-                const int choice = rng_.uniformInt(i, neighbors.size()-1);
-                if (neighbors[choice] == goalRegion)
+                const int choice = rng_.uniformInt(i, adjacent.size()-1);
+                if (adjacent[choice] == goalRegion)
                 {
-                    int region = goalRegion;
-                    int leadLength = 1;
-                    while (region != startRegion)
-                    {
-                        region = parents[region];
-                        ++leadLength;
-                    }
-                    lead.resize(leadLength);
-                    region = goalRegion;
-                    for (int j = leadLength-1; j >= 0; --j)
-                    {
-                        lead[j] = region;
-                        region = parents[region];
-                    }
                     goalFound = true;
                     break;
                 }
-                nodesToProcess.push(neighbors[choice]);
-                std::swap(neighbors[i], neighbors[choice]);
+                nodesToProcess.push(adjacent[choice]);
+                std::swap(adjacent[i], adjacent[choice]);
             }
         }
     }
 
-    //Now that we have a lead, update the edge weights.
-    for (std::size_t i = 0; i < lead.size()-1; ++i)
+    if (goalFound)
     {
-        Adjacency& adj = *regionsToEdge_[std::pair<int,int>(lead[i], lead[i+1])];
-        if (adj.empty)
-        {
-            ++adj.numLeadInclusions;
-            updateEdge(adj);
-        }
+        for (int region = goalRegion; region != startRegion; region = parents[region])
+            lead.push_back(region);
+        lead.push_back(startRegion);
+        std::reverse(lead.begin(), lead.end());
     }
+
+    //Now that we have a lead, update the edge weights. A lead computed from copied
+    //estimates is included by the caller once it holds the lock again.
+    if (!concurrent)
+        includeInLead(lead);
 }
 
 double ompl::control::Syclop::defaultEdgeCost(int r, int s)
 {
-    const Adjacency& a = *regionsToEdge_[std::pair<int,int>(r,s)];
     double factor = 1.0;
-    const int nsel = (a.empty ? a.numLeadInclusions : a.numSelections);
-    factor = (double)(1 + nsel*nsel) / (double)(1 + a.covGridCells.size()*a.covGridCells.size());
-    factor *= (a.source->alpha * a.target->alpha);
+    // an adjacency that has not been created has no selections and no coverage, which gives a factor of 1
+    if (const LeadEstimates* estimates = getLeadEstimates())
+    {
+        boost::unordered_map<std::pair<int,int>, LeadEstimates::Edge>::const_iterator i = estimates->edges.find(std::pair<int,int>(r,s));
+        if (i != estimates->edges.end())
+            factor = (double)(1 + i->second.selections*i->second.selections) / (double)(1 + i->second.coverage*i->second.coverage);
+    }
+    else
+    {
+        boost::unordered_map<std::pair<int,int>, Adjacency>::const_iterator i = regionsToEdge_.find(std::pair<int,int>(r,s));
+        if (i != regionsToEdge_.end())
+        {
+            const Adjacency& a = i->second;
+            const int nsel = (a.empty ? a.numLeadInclusions : a.numSelections);
+            factor = (double)(1 + nsel*nsel) / (double)(1 + a.covGridCells.size()*a.covGridCells.size());
+        }
+    }
+    factor *= (getRegionAlpha(r) * getRegionAlpha(s));
     return factor;
 }
@@ -88,15 +88,35 @@ ompl::control::Syclop::Motion* ompl::control::SyclopEST::addRoot(const base::Sta
     return motion;
 }
 
+ompl::control::ControlSampler* ompl::control::SyclopEST::getThreadControlSampler(void)
+{
+    if (!isExpansionThread())
+        return controlSampler_.get();
+    if (!threadControlSampler_.get())
+        threadControlSampler_.reset(new ControlSamplerPtr(siC_->allocControlSampler()));
+    return threadControlSampler_->get();
+}
+
 void ompl::control::SyclopEST::selectAndExtend(Region& region, std::vector<Motion*>& newMotions)
 {
-    Motion* treeMotion = region.motions[rng_.uniformInt(0, region.motions.size()-1)];
+    Motion* treeMotion;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(treeMutex_);
+        // another thread may have split the region and moved its motions elsewhere
+        if (region.motions.empty())
+            return;
+        treeMotion = region.motions[getThreadRNG().uniformInt(0, region.motions.size()-1)];
+    }
     Control* rctrl = siC_->allocControl();
     base::State* newState = si_->allocState();
 
-    controlSampler_->sample(rctrl, treeMotion->state);
-    unsigned int duration = controlSampler_->sampleStepCount(siC_->getMinControlDuration(), siC_->getMaxControlDuration());
-    duration = siC_->propagateWhileValid(treeMotion->state, rctrl, duration, newState);
+    ControlSampler* controlSampler = getThreadControlSampler();
+    controlSampler->sample(rctrl, treeMotion->state);
+    unsigned int duration = controlSampler->sampleStepCount(siC_->getMinControlDuration(), siC_->getMaxControlDuration());
+    {
+        base::PlannerStatistics::Timer timer(getThreadStatistics().propagations);
+        duration = siC_->propagateWhileValid(treeMotion->state, rctrl, duration, newState);
+    }
 
     if (duration >= siC_->getMinControlDuration())
     {
@@ -105,8 +125,9 @@ void ompl::control::SyclopEST::selectAndExtend(Region& region, std::vector<Motio
         siC_->copyControl(motion->control, rctrl);
         motion->steps = duration;
         motion->parent = treeMotion;
-        motions_.push_back(motion);
         newMotions.push_back(motion);
+        boost::unique_lock<boost::shared_mutex> lock(treeMutex_);
+        motions_.push_back(motion);
 
         lastGoalMotion_ = motion;
     }
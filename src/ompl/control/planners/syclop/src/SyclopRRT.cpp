@@ -102,17 +102,33 @@ ompl::control::Syclop::Motion* ompl::control::SyclopRRT::addRoot(const base::Sta
     return motion;
 }
 
+ompl::control::DirectedControlSampler* ompl::control::SyclopRRT::getThreadControlSampler(void)
+{
+    if (!isExpansionThread())
+        return controlSampler_.get();
+    if (!threadControlSampler_.get())
+        threadControlSampler_.reset(new DirectedControlSamplerPtr(siC_->allocDirectedControlSampler()));
+    return threadControlSampler_->get();
+}
+
 void ompl::control::SyclopRRT::selectAndExtend(Region& region, std::vector<Motion*>& newMotions)
 {
+    base::PlannerStatistics& stats = getThreadStatistics();
     Motion* rmotion = new Motion(siC_);
-    base::StateSamplerPtr sampler(si_->allocStateSampler());
-    decomp_->sampleFromRegion(region.index, sampler, rmotion->state);
+    {
+        // decompositions are not required to sample from several threads
+        boost::unique_lock<boost::shared_mutex> lock(treeMutex_);
+        decomp_->sampleFromRegion(region.index, sampler_, rmotion->state);
+    }
+    ++stats.samples;
 
     Motion* nmotion;
+    boost::shared_lock<boost::shared_mutex> readLock(treeMutex_);
     if (regionalNN_)
     {
         /* Instead of querying the nearest neighbors datastructure over the entire tree of motions,
          * here we perform a linear search over all motions in the selected region and its neighbors. */
+        base::PlannerStatistics::Timer timer(stats.nnQueries);
         std::vector<int> searchRegions;
         decomp_->getNeighbors(region.index, searchRegions);
         searchRegions.push_back(region.index);
@@ -124,6 +140,15 @@ void ompl::control::SyclopRRT::selectAndExtend(Region& region, std::vector<Motio
             motions.insert(motions.end(), regionMotions.begin(), regionMotions.end());
         }
 
+        // another thread may have split the region and moved its motions elsewhere
+        if (motions.empty())
+        {
+            si_->freeState(rmotion->state);
+            siC_->freeControl(rmotion->control);
+            delete rmotion;
+            return;
+        }
+
         std::vector<Motion*>::const_iterator i = motions.begin();
         nmotion = *i;
         double minDistance = distanceFunction(rmotion, nmotion);
@@ -143,14 +168,19 @@ void ompl::control::SyclopRRT::selectAndExtend(Region& region, std::vector<Motio
     else
     {
         assert (nn_);
+        base::PlannerStatistics::Timer timer(stats.nnQueries);
         nmotion = nn_->nearest(rmotion);
     }
+    readLock.unlock();
 
     base::State* newState = si_->allocState();
 
-    unsigned int duration = controlSampler_->sampleTo(rmotion->control, nmotion->control, nmotion->state, rmotion->state);
+    unsigned int duration = getThreadControlSampler()->sampleTo(rmotion->control, nmotion->control, nmotion->state, rmotion->state);
 
-    duration = siC_->propagateWhileValid(nmotion->state, rmotion->control, duration, newState);
+    {
+        base::PlannerStatistics::Timer timer(stats.propagations);
+        duration = siC_->propagateWhileValid(nmotion->state, rmotion->control, duration, newState);
+    }
 
     if (duration >= siC_->getMinControlDuration())
     {
@@ -160,6 +190,7 @@ void ompl::control::SyclopRRT::selectAndExtend(Region& region, std::vector<Motio
         motion->steps = duration;
         motion->parent = nmotion;
         newMotions.push_back(motion);
+        boost::unique_lock<boost::shared_mutex> lock(treeMutex_);
         if (nn_)
             nn_->add(motion);
         lastGoalMotion_ = motion;
@@ -0,0 +1,246 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/control/MotionPrimitives.h"
+#include "ompl/control/SpaceInformation.h"
+#include "ompl/base/spaces/SE2StateSpace.h"
+#include "ompl/base/spaces/SE3StateSpace.h"
+#include "ompl/util/Exception.h"
+#include <boost/math/constants/constants.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
+#include <cmath>
+
+ompl::control::MotionPrimitiveStatePropagator::MotionPrimitiveStatePropagator(const SpaceInformationPtr &si, const StatePropagatorPtr &model) :
+    StatePropagator(si), model_(model), keyLength_(0), stepSize_(0.0), se3_(false)
+{
+}
+
+ompl::control::MotionPrimitiveStatePropagator::~MotionPrimitiveStatePropagator(void)
+{
+    clearPrimitives();
+}
+
+void ompl::control::MotionPrimitiveStatePropagator::addPrimitive(const Control *control)
+{
+    Primitive p;
+    p.control = si_->cloneControl(control);
+    p.displacement = si_->allocState();
+    primitives_.push_back(p);
+    index_.clear();
+    stepSize_ = 0.0;
+}
+
+void ompl::control::MotionPrimitiveStatePropagator::clearPrimitives(void)
+{
+    for (std::size_t i = 0 ; i < primitives_.size() ; ++i)
+    {
+        si_->freeControl(primitives_[i].control);
+        si_->freeState(primitives_[i].displacement);
+    }
+    primitives_.clear();
+    keys_.clear();
+    index_.clear();
+    stepSize_ = 0.0;
+}
+
+void ompl::control::MotionPrimitiveStatePropagator::setup(void)
+{
+    const base::StateSpace *space = si_->getStateSpace().get();
+    if (dynamic_cast<const base::SE3StateSpace*>(space))
+        se3_ = true;
+    else if (dynamic_cast<const base::SE2StateSpace*>(space))
+        se3_ = false;
+    else
+        throw Exception("Motion primitives require an SE2 or SE3 state space");
+
+    base::State *origin = si_->allocState();
+    if (se3_)
+    {
+        base::SE3StateSpace::StateType *o = origin->as<base::SE3StateSpace::StateType>();
+        o->setXYZ(0.0, 0.0, 0.0);
+        o->rotation().setIdentity();
+    }
+    else
+    {
+        base::SE2StateSpace::StateType *o = origin->as<base::SE2StateSpace::StateType>();
+        o->setXY(0.0, 0.0);
+        o->setYaw(0.0);
+    }
+
+    stepSize_ = si_->getPropagationStepSize();
+    for (std::size_t i = 0 ; i < primitives_.size() ; ++i)
+        model_->propagate(origin, primitives_[i].control, stepSize_, primitives_[i].displacement);
+    si_->freeState(origin);
+
+    // index the primitives by control; the first of several equal primitives is the one found
+    index_.clear();
+    const ControlSpacePtr &cspace = si_->getControlSpace();
+    keyLength_ = cspace->getSerializationLength();
+    if (keyLength_ > 0 && keyLength_ <= MAX_KEY_LENGTH)
+    {
+        keys_.resize(keyLength_ * primitives_.size());
+        for (std::size_t i = 0 ; i < primitives_.size() ; ++i)
+        {
+            char *key = &keys_[i * keyLength_];
+            cspace->serialize(key, primitives_[i].control);
+            if (findKey(key) < 0)
+                index_.insert(std::make_pair(boost::hash_range(key, key + keyLength_), (int)i));
+        }
+    }
+    else
+        keys_.clear();
+}
+
+int ompl::control::MotionPrimitiveStatePropagator::findKey(const char *key) const
+{
+    typedef boost::unordered_multimap<std::size_t, int>::const_iterator Iterator;
+    std::pair<Iterator, Iterator> range = index_.equal_range(boost::hash_range(key, key + keyLength_));
+    // different controls may have the same hash
+    for (Iterator it = range.first ; it != range.second ; ++it)
+        if (memcmp(&keys_[it->second * keyLength_], key, keyLength_) == 0)
+            return it->second;
+    return -1;
+}
+
+int ompl::control::MotionPrimitiveStatePropagator::findPrimitive(const Control *control) const
+{
+    if (!index_.empty())
+    {
+        char key[MAX_KEY_LENGTH];
+        si_->getControlSpace()->serialize(key, control);
+        return findKey(key);
+    }
+
+    for (std::size_t i = 0 ; i < primitives_.size() ; ++i)
+        if (si_->equalControls(primitives_[i].control, control))
+            return i;
+    return -1;
+}
+
+void ompl::control::MotionPrimitiveStatePropagator::propagate(const base::State *state, const Control* control, const double duration, base::State *result) const
+{
+    if (stepSize_ > 0.0 && duration > 0.0)
+    {
+        // only whole numbers of steps can be looked up
+        const double steps = duration / stepSize_;
+        const double k = floor(steps + 0.5);
+        if (k >= 1.0 && fabs(steps - k) < 1e-9 * k)
+        {
+            int index = findPrimitive(control);
+            if (index >= 0)
+            {
+                const base::State *displacement = primitives_[index].displacement;
+                compose(state, displacement, result);
+                for (unsigned int s = 1 ; s < (unsigned int)k ; ++s)
+                    compose(result, displacement, result);
+                return;
+            }
+        }
+    }
+    model_->propagate(state, control, duration, result);
+}
+
+bool ompl::control::MotionPrimitiveStatePropagator::canPropagateBackward(void) const
+{
+    return model_->canPropagateBackward();
+}
+
+ompl::control::ControlSamplerPtr ompl::control::MotionPrimitiveStatePropagator::allocControlSampler(const ControlSpace *space) const
+{
+    return ControlSamplerPtr(new MotionPrimitiveControlSampler(space, this));
+}
+
+void ompl::control::MotionPrimitiveStatePropagator::compose(const base::State *state, const base::State *displacement, base::State *result) const
+{
+    if (se3_)
+    {
+        const base::SE3StateSpace::StateType *s = state->as<base::SE3StateSpace::StateType>();
+        const base::SE3StateSpace::StateType *d = displacement->as<base::SE3StateSpace::StateType>();
+        base::SE3StateSpace::StateType *r = result->as<base::SE3StateSpace::StateType>();
+        const base::SO3StateSpace::StateType &q = s->rotation();
+        const base::SO3StateSpace::StateType &p = d->rotation();
+
+        // rotate the displacement by the orientation of the state: v' = v + 2w(u x v) + 2u x (u x v), with u = (q.x, q.y, q.z)
+        const double vx = d->getX(), vy = d->getY(), vz = d->getZ();
+        const double cx = q.y * vz - q.z * vy, cy = q.z * vx - q.x * vz, cz = q.x * vy - q.y * vx;
+        const double x = s->getX() + vx + 2.0 * (q.w * cx + q.y * cz - q.z * cy);
+        const double y = s->getY() + vy + 2.0 * (q.w * cy + q.z * cx - q.x * cz);
+        const double z = s->getZ() + vz + 2.0 * (q.w * cz + q.x * cy - q.y * cx);
+
+        // the orientation is the product q * p
+        const double w  = q.w * p.w - q.x * p.x - q.y * p.y - q.z * p.z;
+        const double qx = q.w * p.x + q.x * p.w + q.y * p.z - q.z * p.y;
+        const double qy = q.w * p.y - q.x * p.z + q.y * p.w + q.z * p.x;
+        const double qz = q.w * p.z + q.x * p.y - q.y * p.x + q.z * p.w;
+
+        // renormalize, so rounding errors do not accumulate over long chains of primitives
+        const double n = 1.0 / sqrt(w * w + qx * qx + qy * qy + qz * qz);
+
+        r->setXYZ(x, y, z);
+        base::SO3StateSpace::StateType &o = r->rotation();
+        o.w = w * n;
+        o.x = qx * n;
+        o.y = qy * n;
+        o.z = qz * n;
+    }
+    else
+    {
+        const base::SE2StateSpace::StateType *s = state->as<base::SE2StateSpace::StateType>();
+        const base::SE2StateSpace::StateType *d = displacement->as<base::SE2StateSpace::StateType>();
+        base::SE2StateSpace::StateType *r = result->as<base::SE2StateSpace::StateType>();
+        const double c = cos(s->getYaw());
+        const double sn = sin(s->getYaw());
+        const double x = s->getX() + c * d->getX() - sn * d->getY();
+        const double y = s->getY() + sn * d->getX() + c * d->getY();
+
+        // keep the yaw in [-pi, pi], as SO2StateSpace::enforceBounds() does
+        double yaw = fmod(s->getYaw() + d->getYaw(), 2.0 * boost::math::constants::pi<double>());
+        if (yaw < -boost::math::constants::pi<double>())
+            yaw += 2.0 * boost::math::constants::pi<double>();
+        else
+            if (yaw > boost::math::constants::pi<double>())
+                yaw -= 2.0 * boost::math::constants::pi<double>();
+        r->setXY(x, y);
+        r->setYaw(yaw);
+    }
+}
+
+void ompl::control::MotionPrimitiveControlSampler::sample(Control *control)
+{
+    const unsigned int n = propagator_->getPrimitiveCount();
+    if (n == 0)
+        throw Exception("No motion primitives to sample from");
+    space_->copyControl(control, propagator_->getPrimitive(rng_.uniformInt(0, n - 1)));
+}
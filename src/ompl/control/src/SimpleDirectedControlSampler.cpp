@@ -36,14 +36,151 @@
 
 #include "ompl/control/SimpleDirectedControlSampler.h"
 #include "ompl/control/SpaceInformation.h"
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <limits>
+
+/// @cond IGNORE
+// Hands out chunks of candidate controls to the threads that evaluate them
+class ompl::control::SimpleDirectedControlSampler::Workers
+{
+public:
+
+    Workers(SimpleDirectedControlSampler *owner, unsigned int threadCount) :
+        owner_(owner), threadCount_(threadCount), generation_(0), running_(0), exit_(false),
+        source_(NULL), target_(NULL), next_(0), end_(0), chunk_(1), stop_(false)
+    {
+        for (unsigned int i = 0 ; i < threadCount_ ; ++i)
+            threads_.create_thread(boost::bind(&Workers::loop, this));
+    }
+
+    ~Workers(void)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            exit_ = true;
+        }
+        start_.notify_all();
+        threads_.join_all();
+    }
+
+    // evaluate count candidates, in chunks of the given size, on the calling thread and all the worker threads
+    void run(unsigned int count, unsigned int chunk, const base::State *source, const base::State *target)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            next_ = 0;
+            end_ = count;
+            chunk_ = chunk;
+            stop_ = false;
+            source_ = source;
+            target_ = target;
+            running_ = threadCount_;
+            ++generation_;
+        }
+        if (threadCount_ > 0)
+            start_.notify_all();
+        owner_->evaluateCandidates(source, target, buffers_);
+
+        boost::mutex::scoped_lock lock(mutex_);
+        while (running_ > 0)
+            done_.wait(lock);
+    }
+
+    // get the next range [from, to) of candidates to evaluate; return false if there is none
+    bool nextChunk(unsigned int &from, unsigned int &to)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        if (stop_ || next_ >= end_)
+            return false;
+        from = next_;
+        to = std::min(end_, next_ + chunk_);
+        next_ = to;
+        return true;
+    }
+
+    // skip the candidates that have not been handed out yet
+    void stop(void)
+    {
+        boost::mutex::scoped_lock lock(mutex_);
+        stop_ = true;
+    }
+
+private:
+
+    void loop(void)
+    {
+        EvaluationBuffers buffers;
+        unsigned int seen = 0;
+        while (true)
+        {
+            const base::State *source;
+            const base::State *target;
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                while (!exit_ && generation_ == seen)
+                    start_.wait(lock);
+                if (exit_)
+                    return;
+                seen = generation_;
+                source = source_;
+                target = target_;
+            }
+            owner_->evaluateCandidates(source, target, buffers);
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                if (--running_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    SimpleDirectedControlSampler *owner_;
+    unsigned int                  threadCount_;
+    boost::thread_group           threads_;
+    boost::mutex                  mutex_;
+    boost::condition_variable     start_;
+    boost::condition_variable     done_;
+    unsigned int                  generation_;
+    unsigned int                  running_;
+    bool                          exit_;
+    const base::State            *source_;
+    const base::State            *target_;
+    unsigned int                  next_;
+    unsigned int                  end_;
+    unsigned int                  chunk_;
+    bool                          stop_;
+
+    // the buffers of the thread that calls run()
+    EvaluationBuffers             buffers_;
+};
+/// @endcond
 
 ompl::control::SimpleDirectedControlSampler::SimpleDirectedControlSampler(const SpaceInformation *si, unsigned int k) :
-    DirectedControlSampler(si), cs_(si->allocControlSampler()), numControlSamples_(k)
+    DirectedControlSampler(si), cs_(si->allocControlSampler()), numControlSamples_(k), threadCount_(1), earlyStopDistance_(0.0),
+    workers_(new Workers(this, 0))
 {
 }
 
 ompl::control::SimpleDirectedControlSampler::~SimpleDirectedControlSampler(void)
 {
+    workers_.reset();
+    for (std::size_t i = 0 ; i < candidates_.size() ; ++i)
+    {
+        si_->freeControl(candidates_[i]);
+        si_->freeState(candidateStates_[i]);
+    }
+}
+
+void ompl::control::SimpleDirectedControlSampler::setThreadCount(unsigned int threadCount)
+{
+    if (threadCount < 1)
+        threadCount = 1;
+    if (threadCount != threadCount_)
+    {
+        workers_.reset(new Workers(this, threadCount - 1));
+        threadCount_ = threadCount;
+    }
 }
 
 unsigned int ompl::control::SimpleDirectedControlSampler::sampleTo(Control *control, const base::State *source, const base::State *target)
@@ -71,34 +208,65 @@ unsigned int ompl::control::SimpleDirectedControlSampler::getBestControl (Contro
 
     if (numControlSamples_ > 1)
     {
-        Control     *tempControl = si_->allocControl();
-        base::State *tempState   = si_->allocState();
-
-        // Propagate the first control, and find how far it is from the target state
-        si_->propagateWhileValid(source, control, steps, tempState);
-        double bestDistance = si_->distance(tempState, target);
+        while (candidates_.size() < numControlSamples_)
+        {
+            candidates_.push_back(si_->allocControl());
+            candidateStates_.push_back(si_->allocState());
+        }
+        candidateSteps_.resize(numControlSamples_);
+        candidateDistances_.assign(numControlSamples_, std::numeric_limits<double>::infinity());
 
-        // Sample k-1 more controls, and save the control that gets closest to target
+        // Sample k-1 more controls, in the same order as they would be sampled one at a time
+        si_->copyControl(candidates_[0], control);
+        candidateSteps_[0] = steps;
         for (unsigned int i = 1; i < numControlSamples_; ++i)
         {
-            unsigned int sampleSteps = cs_->sampleStepCount(minDuration, maxDuration);
+            candidateSteps_[i] = cs_->sampleStepCount(minDuration, maxDuration);
             if (previous)
-                cs_->sampleNext(tempControl, previous, source);
+                cs_->sampleNext(candidates_[i], previous, source);
             else
-                cs_->sample(tempControl, source);
+                cs_->sample(candidates_[i], source);
+        }
 
-            si_->propagateWhileValid(source, tempControl, sampleSteps, tempState);
-            double tempDistance = si_->distance(tempState, target);
-            if (tempDistance < bestDistance)
+        // Propagate the controls, in batches shared by the available threads. With the early stop rule,
+        // batches are smaller, so that fewer candidates are in flight when the rule applies.
+        unsigned int chunk = (numControlSamples_ + threadCount_ - 1) / threadCount_;
+        if (earlyStopDistance_ > 0.0)
+            chunk = std::max(1u, chunk / 4);
+        workers_->run(numControlSamples_, chunk, source, target);
+
+        // Save the control that gets closest to target; the first candidate is always evaluated
+        double bestDistance = candidateDistances_[0];
+        for (unsigned int i = 1; i < numControlSamples_; ++i)
+            if (candidateDistances_[i] < bestDistance)
             {
-                si_->copyControl(control, tempControl);
-                bestDistance = tempDistance;
-                steps = sampleSteps;
+                si_->copyControl(control, candidates_[i]);
+                bestDistance = candidateDistances_[i];
+                steps = candidateSteps_[i];
             }
-        }
-
-        si_->freeControl(tempControl);
-        si_->freeState(tempState);
     }
     return steps;
 }
+
+void ompl::control::SimpleDirectedControlSampler::evaluateCandidates(const base::State *source, const base::State *target,
+                                                                     EvaluationBuffers &buffers)
+{
+    unsigned int from = 0, to = 0;
+    while (workers_->nextChunk(from, to))
+    {
+        buffers.controls.assign(candidates_.begin() + from, candidates_.begin() + to);
+        buffers.steps.assign(candidateSteps_.begin() + from, candidateSteps_.begin() + to);
+        buffers.states.assign(candidateStates_.begin() + from, candidateStates_.begin() + to);
+        si_->propagateWhileValid(source, buffers.controls, buffers.steps, buffers.states, buffers.validSteps, buffers.propagation);
+
+        bool close = false;
+        for (unsigned int i = from ; i < to ; ++i)
+        {
+            candidateDistances_[i] = si_->distance(candidateStates_[i], target);
+            if (candidateDistances_[i] < earlyStopDistance_)
+                close = true;
+        }
+        if (close)
+            workers_->stop();
+    }
+}
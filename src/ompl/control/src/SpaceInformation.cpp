@@ -289,6 +289,95 @@ unsigned int ompl::control::SpaceInformation::propagateWhileValid(const base::St
     return st;
 }
 
+ompl::control::SpaceInformation::PropagationBuffers::~PropagationBuffers(void)
+{
+    for (std::size_t i = 0 ; i < temp_.size() ; ++i)
+        si_->freeState(temp_[i]);
+}
+
+void ompl::control::SpaceInformation::propagateWhileValid(const base::State *state, const std::vector<Control*> &controls, const std::vector<int> &steps,
+                                                          std::vector<base::State*> &result, std::vector<unsigned int> &validSteps) const
+{
+    PropagationBuffers buffers;
+    propagateWhileValid(state, controls, steps, result, validSteps, buffers);
+}
+
+void ompl::control::SpaceInformation::propagateWhileValid(const base::State *state, const std::vector<Control*> &controls, const std::vector<int> &steps,
+                                                          std::vector<base::State*> &result, std::vector<unsigned int> &validSteps,
+                                                          PropagationBuffers &buffers) const
+{
+    const std::size_t n = controls.size();
+    assert(steps.size() == n && result.size() >= n);
+    assert(buffers.si_ == NULL || buffers.si_ == this);
+
+    bool backward = false;
+    bool forward = false;
+    for (std::size_t i = 0 ; i < n ; ++i)
+    {
+        backward = backward || steps[i] < 0;
+        forward = forward || steps[i] > 0;
+    }
+    if (backward && forward)
+        throw Exception("Batch propagation requires all step counts to have the same sign");
+    const double signedStepSize = backward ? -stepSize_ : stepSize_;
+
+    // each motion alternates between its result state and one temporary state;
+    // current[i] always points to the last valid state of motion i
+    buffers.si_ = this;
+    std::vector<base::State*> &temp = buffers.temp_;
+    while (temp.size() < n)
+        temp.push_back(allocState());
+    std::vector<const base::State*> &current = buffers.current_;
+    current.assign(n, state);
+    std::vector<base::State*> &next = buffers.next_;
+    next.assign(result.begin(), result.begin() + n);
+    std::vector<bool> &stopped = buffers.stopped_;
+    stopped.assign(n, false);
+    validSteps.assign(n, 0);
+
+    std::vector<const base::State*> &from = buffers.from_;
+    std::vector<const Control*> &ctrl = buffers.controls_;
+    std::vector<base::State*> &to = buffers.to_;
+    std::vector<std::size_t> &active = buffers.active_;
+
+    for (int st = 0 ; ; ++st)
+    {
+        from.clear();
+        ctrl.clear();
+        to.clear();
+        active.clear();
+        for (std::size_t i = 0 ; i < n ; ++i)
+            if (!stopped[i] && st < abs(steps[i]))
+            {
+                from.push_back(current[i]);
+                ctrl.push_back(controls[i]);
+                to.push_back(next[i]);
+                active.push_back(i);
+            }
+        if (active.empty())
+            break;
+
+        statePropagator_->propagateBatch(&from[0], &ctrl[0], active.size(), signedStepSize, &to[0]);
+
+        for (std::size_t j = 0 ; j < active.size() ; ++j)
+        {
+            const std::size_t i = active[j];
+            if (isValid(next[i]))
+            {
+                current[i] = next[i];
+                next[i] = next[i] == result[i] ? temp[i] : result[i];
+                validSteps[i] = st + 1;
+            }
+            else
+                stopped[i] = true;
+        }
+    }
+
+    for (std::size_t i = 0 ; i < n ; ++i)
+        if (current[i] != result[i])
+            copyState(result[i], current[i]);
+}
+
 void ompl::control::SpaceInformation::printSettings(std::ostream &out) const
 {
     base::SpaceInformation::printSettings(out);
@@ -0,0 +1,244 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_DATASTRUCTURES_DARY_HEAP_
+#define OMPL_DATASTRUCTURES_DARY_HEAP_
+
+#include <functional>
+#include <vector>
+#include <cassert>
+
+namespace ompl
+{
+
+    /** \brief This class provides an implementation of an updatable
+        min-heap with \e D children per node, stored in a single
+        array. Unlike BinaryHeap, no memory is allocated per element:
+        the heap stores the elements themselves (typically pointers)
+        and keeps the position of each element in a field of the
+        element, which the \e Position functor gives access to. An
+        element can therefore be in at most one heap that uses the
+        same field at a time.
+
+        \e Position is called with an element and must return a
+        reference to the <tt>unsigned int</tt> field where the heap
+        stores the element's position. A wider node (\e D = 4 by
+        default) makes the heap shallower, which reduces the number
+        of moves per update and keeps children in the same cache
+        line. */
+    template <typename _T,
+              class Position,
+              class LessThan = std::less<_T>,
+              unsigned int D = 4>
+    class DAryHeap
+    {
+    public:
+
+        DAryHeap(void)
+        {
+        }
+
+        ~DAryHeap(void)
+        {
+        }
+
+        /** \brief Clear the heap */
+        void clear(void)
+        {
+            vector_.clear();
+        }
+
+        /** \brief Return the top element. The heap must not be empty. */
+        const _T& top(void) const
+        {
+            assert(!vector_.empty());
+            return vector_[0];
+        }
+
+        /** \brief Remove the top element */
+        void pop(void)
+        {
+            removePos(0);
+        }
+
+        /** \brief Remove a specific element */
+        void remove(const _T &element)
+        {
+            const unsigned int pos = position_(element);
+            assert(pos < vector_.size());
+            removePos(pos);
+        }
+
+        /** \brief Add a new element */
+        void insert(const _T &element)
+        {
+            const unsigned int pos = vector_.size();
+            vector_.push_back(element);
+            position_(vector_[pos]) = pos;
+            percolateUp(pos);
+        }
+
+        /** \brief Add a set of elements to the heap. If the number
+            of added elements is large compared to the size of the
+            heap, the heap is rebuilt instead of percolating each
+            element. */
+        void insert(const std::vector<_T> &list)
+        {
+            const unsigned int n = vector_.size();
+            vector_.insert(vector_.end(), list.begin(), list.end());
+            for (unsigned int i = n ; i < vector_.size() ; ++i)
+                position_(vector_[i]) = i;
+            if (list.size() > n)
+                build();
+            else
+                for (unsigned int i = n ; i < vector_.size() ; ++i)
+                    percolateUp(i);
+        }
+
+        /** \brief Clear the heap, add the set of elements \e list to it and rebuild it. */
+        void buildFrom(const std::vector<_T> &list)
+        {
+            vector_ = list;
+            for (unsigned int i = 0 ; i < vector_.size() ; ++i)
+                position_(vector_[i]) = i;
+            build();
+        }
+
+        /** \brief Rebuild the heap after the keys of many elements changed. This takes linear time. */
+        void rebuild(void)
+        {
+            build();
+        }
+
+        /** \brief Update the position of an element in the heap after its key changed */
+        void update(const _T &element)
+        {
+            const unsigned int pos = position_(element);
+            assert(pos < vector_.size());
+            percolateDown(percolateUp(pos));
+        }
+
+        /** \brief Check if the heap is empty */
+        bool empty(void) const
+        {
+            return vector_.empty();
+        }
+
+        /** \brief Get the number of elements in the heap */
+        unsigned int size(void) const
+        {
+            return vector_.size();
+        }
+
+        /** \brief Get the data stored in this heap */
+        void getContent(std::vector<_T> &content) const
+        {
+            content.insert(content.end(), vector_.begin(), vector_.end());
+        }
+
+    private:
+
+        LessThan          lt_;
+
+        Position          position_;
+
+        std::vector<_T>   vector_;
+
+        void removePos(unsigned int pos)
+        {
+            const unsigned int last = vector_.size() - 1;
+            if (pos < last)
+            {
+                vector_[pos] = vector_[last];
+                position_(vector_[pos]) = pos;
+                vector_.pop_back();
+                percolateDown(percolateUp(pos));
+            }
+            else
+                vector_.pop_back();
+        }
+
+        void build(void)
+        {
+            if (vector_.size() > 1)
+                for (int i = (vector_.size() - 2) / D ; i >= 0 ; --i)
+                    percolateDown(i);
+        }
+
+        unsigned int percolateDown(unsigned int pos)
+        {
+            const unsigned int n = vector_.size();
+            _T tmp = vector_[pos];
+            while (true)
+            {
+                const unsigned int first = pos * D + 1;
+                if (first >= n)
+                    break;
+                const unsigned int end = first + D < n ? first + D : n;
+                unsigned int child = first;
+                for (unsigned int c = first + 1 ; c < end ; ++c)
+                    if (lt_(vector_[c], vector_[child]))
+                        child = c;
+                if (!lt_(vector_[child], tmp))
+                    break;
+                vector_[pos] = vector_[child];
+                position_(vector_[pos]) = pos;
+                pos = child;
+            }
+            vector_[pos] = tmp;
+            position_(vector_[pos]) = pos;
+            return pos;
+        }
+
+        unsigned int percolateUp(unsigned int pos)
+        {
+            _T tmp = vector_[pos];
+            while (pos > 0)
+            {
+                const unsigned int parent = (pos - 1) / D;
+                if (!lt_(tmp, vector_[parent]))
+                    break;
+                vector_[pos] = vector_[parent];
+                position_(vector_[pos]) = pos;
+                pos = parent;
+            }
+            vector_[pos] = tmp;
+            position_(vector_[pos]) = pos;
+            return pos;
+        }
+    };
+
+}
+
+#endif
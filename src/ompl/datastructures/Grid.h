@@ -41,6 +41,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <boost/unordered_map.hpp>
+#include <boost/cstdint.hpp>
 #include <algorithm>
 
 namespace ompl
@@ -121,50 +122,40 @@ namespace ompl
         /// Get the cell at a specified coordinate
         Cell* getCell(const Coord &coord) const
         {
-            iterator pos = hash_.find(const_cast<Coord*>(&coord));
-            Cell *c = (pos != hash_.end()) ? pos->second : NULL;
-            return c;
+            return hash_.lookup(coord, coord.size(), 0);
         }
 
         /// Get the list of neighbors for a given cell
         void    neighbors(const Cell* cell, CellArray& list) const
         {
-            Coord test = cell->coord;
-            neighbors(test, list);
+            neighbors(cell->coord, list);
         }
 
-        /// Get the list of neighbors for a given coordinate
+        /// Get the list of neighbors for a given coordinate. The
+        /// neighbors are looked up in place, without constructing
+        /// the neighboring coordinates.
         void    neighbors(const Coord& coord, CellArray& list) const
-        {
-            Coord test = coord;
-            neighbors(test, list);
-        }
-
-        /// Get the list of neighbors for a given coordinate
-        void    neighbors(Coord& coord, CellArray& list) const
         {
             list.reserve(list.size() + maxNeighbors_);
 
             for (int i = dimension_ - 1 ; i >= 0 ; --i)
             {
-                coord[i]--;
-
-                iterator pos = hash_.find(&coord);
-                Cell *cell = (pos != hash_.end()) ? pos->second : NULL;
-
+                Cell *cell = hash_.lookup(coord, i, -1);
                 if (cell)
                     list.push_back(cell);
-                coord[i] += 2;
-
-                pos = hash_.find(&coord);
-                cell = (pos != hash_.end()) ? pos->second : NULL;
 
+                cell = hash_.lookup(coord, i, 1);
                 if (cell)
                     list.push_back(cell);
-                coord[i]--;
             }
         }
 
+        /// Get the list of neighbors for a given coordinate
+        void    neighbors(Coord& coord, CellArray& list) const
+        {
+            neighbors(static_cast<const Coord&>(coord), list);
+        }
+
         /// Get the connected components formed by the cells in this grid (based on neighboring relation)
         std::vector< std::vector<Cell*> > components(void) const
         {
@@ -326,21 +317,46 @@ namespace ompl
                 delete content[i];
         }
 
+        /// Hash a coordinate. If \e dim is a valid index, \e delta
+        /// is added to that element of the coordinate first; this
+        /// hashes a neighbor of the coordinate without constructing
+        /// it. Every element is mixed into a 64-bit state that is
+        /// finalized with the MurmurHash3 mixer, so the low bits used
+        /// to index the table depend on all elements.
+        static std::size_t hashCoord(const Coord &coord, std::size_t dim, int delta)
+        {
+            boost::uint64_t h = 0x9E3779B97F4A7C15ULL;
+            for (std::size_t i = 0 ; i < coord.size() ; ++i)
+            {
+                const boost::uint32_t v = (boost::uint32_t)(i == dim ? coord[i] + delta : coord[i]);
+                h = (h ^ v) * 0x100000001B3ULL;
+            }
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return (std::size_t)h;
+        }
+
+        /// Check if \e coord equals \e other, with \e delta added to element \e dim of \e other
+        static bool equalCoord(const Coord &coord, const Coord &other, std::size_t dim, int delta)
+        {
+            if (coord.size() != other.size())
+                return false;
+            for (std::size_t i = 0 ; i < coord.size() ; ++i)
+                if (coord[i] != (i == dim ? other[i] + delta : other[i]))
+                    return false;
+            return true;
+        }
+
         /// Hash function for coordinates
         struct HashFunCoordPtr
         {
             /// Hash function for coordinates
             std::size_t operator()(const Coord* const s) const
             {
-                unsigned long h = 0;
-                for (int i = s->size() - 1; i >= 0; --i)
-                {
-                    int high = h & 0xf8000000;
-                    h = h << 5;
-                    h = h ^ (high >> 27);
-                    h = h ^ s->at(i);
-                }
-                return (std::size_t) h;
+                return hashCoord(*s, s->size(), 0);
             }
         };
 
@@ -355,8 +371,210 @@ namespace ompl
             }
         };
 
-        /// Define the datatype for the used hash structure
-        typedef boost::unordered_map<Coord*, Cell*, HashFunCoordPtr, EqualCoordPtr> CoordHash;
+        /// Hash table from coordinates to cells. The table uses open
+        /// addressing with linear probing in a power-of-two sized
+        /// array that is kept at most half full. The full hash of
+        /// each entry is stored with it, so probes rarely need to
+        /// compare coordinates, and erasing shifts the following
+        /// entries back instead of leaving tombstones.
+        class CoordHash
+        {
+        public:
+
+            /// The type of the stored entries
+            typedef std::pair<Coord*, Cell*> value_type;
+
+            /// Iterator over the entries in the table
+            class const_iterator
+            {
+            public:
+
+                const_iterator(void) : pos_(NULL), end_(NULL)
+                {
+                }
+
+                const_iterator(const value_type *pos, const value_type *end) : pos_(pos), end_(end)
+                {
+                    skip();
+                }
+
+                const value_type& operator*(void) const
+                {
+                    return *pos_;
+                }
+
+                const value_type* operator->(void) const
+                {
+                    return pos_;
+                }
+
+                const_iterator& operator++(void)
+                {
+                    ++pos_;
+                    skip();
+                    return *this;
+                }
+
+                const_iterator operator++(int)
+                {
+                    const_iterator r = *this;
+                    ++(*this);
+                    return r;
+                }
+
+                bool operator==(const const_iterator &other) const
+                {
+                    return pos_ == other.pos_;
+                }
+
+                bool operator!=(const const_iterator &other) const
+                {
+                    return pos_ != other.pos_;
+                }
+
+            private:
+
+                void skip(void)
+                {
+                    while (pos_ != end_ && pos_->second == NULL)
+                        ++pos_;
+                }
+
+                const value_type *pos_;
+                const value_type *end_;
+
+                friend class CoordHash;
+            };
+
+            /// Entries cannot be changed in place, so all iterators are constant
+            typedef const_iterator iterator;
+
+            CoordHash(void) : size_(0)
+            {
+            }
+
+            bool empty(void) const
+            {
+                return size_ == 0;
+            }
+
+            std::size_t size(void) const
+            {
+                return size_;
+            }
+
+            const_iterator begin(void) const
+            {
+                return slots_.empty() ? const_iterator() : const_iterator(&slots_[0], &slots_[0] + slots_.size());
+            }
+
+            const_iterator end(void) const
+            {
+                return slots_.empty() ? const_iterator() : const_iterator(&slots_[0] + slots_.size(), &slots_[0] + slots_.size());
+            }
+
+            /// Find the entry for a coordinate
+            const_iterator find(const Coord *coord) const
+            {
+                std::size_t index;
+                if (locate(*coord, coord->size(), 0, index))
+                    return const_iterator(&slots_[index], &slots_[0] + slots_.size());
+                return end();
+            }
+
+            /// Find the cell at \e coord, with \e delta added to element \e dim (if \e dim is a valid index); returns NULL if there is no such cell
+            Cell* lookup(const Coord &coord, std::size_t dim, int delta) const
+            {
+                std::size_t index;
+                return locate(coord, dim, delta, index) ? slots_[index].second : NULL;
+            }
+
+            /// Insert an entry, unless its coordinate is already present
+            void insert(const value_type &value)
+            {
+                if (2 * (size_ + 1) > slots_.size())
+                    grow();
+                const std::size_t h = hashCoord(*value.first, value.first->size(), 0);
+                const std::size_t mask = slots_.size() - 1;
+                for (std::size_t i = h & mask ; ; i = (i + 1) & mask)
+                {
+                    if (slots_[i].second == NULL)
+                    {
+                        slots_[i] = value;
+                        hashes_[i] = h;
+                        ++size_;
+                        return;
+                    }
+                    if (hashes_[i] == h && equalCoord(*slots_[i].first, *value.first, value.first->size(), 0))
+                        return;
+                }
+            }
+
+            /// Erase the entry at \e pos
+            void erase(const_iterator pos)
+            {
+                const std::size_t mask = slots_.size() - 1;
+                std::size_t i = pos.pos_ - &slots_[0];
+                // move back the following entries of the probe run that
+                // cannot be found anymore once slot i is empty
+                for (std::size_t j = (i + 1) & mask ; slots_[j].second != NULL ; j = (j + 1) & mask)
+                    if (((j - (hashes_[j] & mask)) & mask) >= ((j - i) & mask))
+                    {
+                        slots_[i] = slots_[j];
+                        hashes_[i] = hashes_[j];
+                        i = j;
+                    }
+                slots_[i] = value_type(static_cast<Coord*>(NULL), static_cast<Cell*>(NULL));
+                --size_;
+            }
+
+            void clear(void)
+            {
+                slots_.clear();
+                hashes_.clear();
+                size_ = 0;
+            }
+
+        private:
+
+            bool locate(const Coord &coord, std::size_t dim, int delta, std::size_t &index) const
+            {
+                if (size_ == 0)
+                    return false;
+                const std::size_t h = hashCoord(coord, dim, delta);
+                const std::size_t mask = slots_.size() - 1;
+                for (std::size_t i = h & mask ; slots_[i].second != NULL ; i = (i + 1) & mask)
+                    if (hashes_[i] == h && equalCoord(*slots_[i].first, coord, dim, delta))
+                    {
+                        index = i;
+                        return true;
+                    }
+                return false;
+            }
+
+            void grow(void)
+            {
+                std::vector<value_type> slots(slots_.empty() ? 16 : 2 * slots_.size(),
+                                              value_type(static_cast<Coord*>(NULL), static_cast<Cell*>(NULL)));
+                std::vector<std::size_t> hashes(slots.size());
+                const std::size_t mask = slots.size() - 1;
+                for (std::size_t j = 0 ; j < slots_.size() ; ++j)
+                    if (slots_[j].second)
+                    {
+                        std::size_t i = hashes_[j] & mask;
+                        while (slots[i].second)
+                            i = (i + 1) & mask;
+                        slots[i] = slots_[j];
+                        hashes[i] = hashes_[j];
+                    }
+                slots_.swap(slots);
+                hashes_.swap(hashes);
+            }
+
+            std::vector<value_type>  slots_;
+            std::vector<std::size_t> hashes_;
+            std::size_t              size_;
+        };
 
         /// Helper to sort components by size
         struct SortComponents
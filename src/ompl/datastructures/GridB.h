@@ -38,7 +38,7 @@
 #define OMPL_DATASTRUCTURES_GRID_B_
 
 #include "ompl/datastructures/GridN.h"
-#include "ompl/datastructures/BinaryHeap.h"
+#include "ompl/datastructures/DAryHeap.h"
 
 namespace ompl
 {
@@ -64,11 +64,11 @@ namespace ompl
     protected:
 
         /// \cond IGNORE
-        // the type of cell here needs an extra pointer to allow the updatable heap to work fast
-        // however, this stays hidden from the user
+        // the type of cell here needs to store its position in the heap that contains it
+        // and whether its priority is out of date; this stays hidden from the user
         struct CellX : public Cell
         {
-            CellX(void) : Cell()
+            CellX(void) : Cell(), heapPosition(0), stale(false)
             {
             }
 
@@ -76,7 +76,8 @@ namespace ompl
             {
             }
 
-            void *heapElement;
+            unsigned int heapPosition;
+            bool         stale;
         };
 
         /// \endcond
@@ -88,7 +89,7 @@ namespace ompl
 
         /// Constructor
         explicit
-        GridB(unsigned int dimension) : GridN<_T>(dimension)
+        GridB(unsigned int dimension) : GridN<_T>(dimension), lazyNeighborUpdates_(false)
         {
             setupHeaps();
         }
@@ -106,17 +107,36 @@ namespace ompl
             eventCellUpdateData_ = arg;
         }
 
+        /// Enable or disable lazy updates of cell priorities after a
+        /// change in their number of neighbors. When enabled, adding
+        /// a cell only marks the neighbors that stay on the same
+        /// side of the border as out of date; their priorities are
+        /// recomputed when they reach the top of their heap. This is
+        /// only correct if gaining neighbors never makes a cell more
+        /// preferred by the heap ordering (removing cells always
+        /// updates the neighbors right away).
+        void setLazyNeighborUpdates(bool lazy)
+        {
+            lazyNeighborUpdates_ = lazy;
+        }
+
+        /// Check if lazy neighbor updates are enabled
+        bool getLazyNeighborUpdates(void) const
+        {
+            return lazyNeighborUpdates_;
+        }
+
         /// Return the cell that is at the top of the heap maintaining internal cells
         Cell* topInternal(void) const
         {
-            Cell* top = static_cast<Cell*>(internal_.top()->data);
+            Cell* top = static_cast<Cell*>(validTop(internal_));
             return top ? top : topExternal();
         }
 
         /// Return the cell that is at the top of the heap maintaining external cells
         Cell* topExternal(void) const
         {
-            Cell* top = static_cast<Cell*>(external_.top()->data);
+            Cell* top = static_cast<Cell*>(validTop(external_));
             return top ? top : topInternal();
         }
 
@@ -147,22 +167,25 @@ namespace ompl
         /// Update the position in the heaps for a particular cell.
         void update(Cell* cell)
         {
+            CellX* cx = static_cast<CellX*>(cell);
+            cx->stale = false;
             eventCellUpdate_(cell, eventCellUpdateData_);
             if (cell->border)
-                external_.update(reinterpret_cast<typename externalBHeap::Element*>
-                                  (static_cast<CellX*>(cell)->heapElement));
+                external_.update(cx);
             else
-                internal_.update(reinterpret_cast<typename internalBHeap::Element*>
-                                  (static_cast<CellX*>(cell)->heapElement));
+                internal_.update(cx);
         }
 
-            /// Update all cells and reconstruct the heaps
+        /// Update all cells and reconstruct the heaps
         void updateAll(void)
         {
             std::vector< Cell* > cells;
             this->getCells(cells);
             for (int i = cells.size() - 1 ; i >= 0 ; --i)
+            {
+                static_cast<CellX*>(cells[i])->stale = false;
                 eventCellUpdate_(cells[i], eventCellUpdateData_);
+            }
             external_.rebuild();
             internal_.rebuild();
         }
@@ -173,7 +196,8 @@ namespace ompl
             CellX* cell = new CellX();
             cell->coord = coord;
 
-            CellArray *list = nbh ? nbh : new CellArray();
+            CellArray local;
+            CellArray *list = nbh ? nbh : &local;
             this->neighbors(cell->coord, *list);
 
             for (typename CellArray::iterator cl = list->begin() ; cl != list->end() ; ++cl)
@@ -184,19 +208,26 @@ namespace ompl
                 if (c->border && c->neighbors >= GridN<_T>::interiorCellNeighborsLimit_)
                     c->border = false;
 
+                if (lazyNeighborUpdates_ && wasBorder == c->border)
+                {
+                    c->stale = true;
+                    continue;
+                }
+
+                c->stale = false;
                 eventCellUpdate_(c, eventCellUpdateData_);
 
                 if (c->border)
-                    external_.update(reinterpret_cast<typename externalBHeap::Element*>(c->heapElement));
+                    external_.update(c);
                 else
                 {
                     if (wasBorder)
                     {
-                        external_.remove(reinterpret_cast<typename externalBHeap::Element*>(c->heapElement));
+                        external_.remove(c);
                         internal_.insert(c);
                     }
                     else
-                        internal_.update(reinterpret_cast<typename internalBHeap::Element*>(c->heapElement));
+                        internal_.update(c);
                 }
             }
 
@@ -204,9 +235,6 @@ namespace ompl
             if (cell->border && cell->neighbors >= GridN<_T>::interiorCellNeighborsLimit_)
                 cell->border = false;
 
-            if (!nbh)
-                delete list;
-
             return static_cast<Cell*>(cell);
         }
 
@@ -214,6 +242,7 @@ namespace ompl
         virtual void add(Cell* cell)
         {
             CellX* ccell = static_cast<CellX*>(cell);
+            ccell->stale = false;
             eventCellUpdate_(ccell, eventCellUpdateData_);
 
             GridN<_T>::add(cell);
@@ -229,10 +258,10 @@ namespace ompl
         {
             if (cell)
             {
-                CellArray *list = new CellArray();
-                this->neighbors(cell->coord, *list);
+                CellArray list;
+                this->neighbors(cell->coord, list);
 
-                for (typename CellArray::iterator cl = list->begin() ; cl != list->end() ; ++cl)
+                for (typename CellArray::iterator cl = list.begin() ; cl != list.end() ; ++cl)
                 {
                     CellX* c = static_cast<CellX*>(*cl);
                     bool wasBorder = c->border;
@@ -240,33 +269,32 @@ namespace ompl
                     if (!c->border && c->neighbors < GridN<_T>::interiorCellNeighborsLimit_)
                         c->border = true;
 
+                    c->stale = false;
                     eventCellUpdate_(c, eventCellUpdateData_);
 
                     if (c->border)
                     {
                         if (wasBorder)
-                            external_.update(reinterpret_cast<typename externalBHeap::Element*>(c->heapElement));
+                            external_.update(c);
                         else
                         {
-                            internal_.remove(reinterpret_cast<typename internalBHeap::Element*>(c->heapElement));
+                            internal_.remove(c);
                             external_.insert(c);
                         }
                     }
                     else
-                        internal_.update(reinterpret_cast<typename internalBHeap::Element*>(c->heapElement));
+                        internal_.update(c);
                 }
 
-                delete list;
-
                 typename GridN<_T>::CoordHash::iterator pos = GridN<_T>::hash_.find(&cell->coord);
                 if (pos != GridN<_T>::hash_.end())
                 {
                     GridN<_T>::hash_.erase(pos);
                     CellX* cx = static_cast<CellX*>(cell);
                     if (cx->border)
-                        external_.remove(reinterpret_cast<typename externalBHeap::Element*>(cx->heapElement));
+                        external_.remove(cx);
                     else
-                        internal_.remove(reinterpret_cast<typename internalBHeap::Element*>(cx->heapElement));
+                        internal_.remove(cx);
                     return true;
                 }
             }
@@ -304,8 +332,6 @@ namespace ompl
         {
             eventCellUpdate_     = &noCellUpdate;
             eventCellUpdateData_ = NULL;
-            internal_.onAfterInsert(&setHeapElementI, NULL);
-            external_.onAfterInsert(&setHeapElementE, NULL);
         }
 
         /// Clear the data from both heaps
@@ -338,29 +364,47 @@ namespace ompl
             LessThanExternal lt_;
         };
 
+        /// Access the position of a cell in the heap that contains it
+        struct HeapPosition
+        {
+            unsigned int& operator()(CellX* const &cell) const
+            {
+                return cell->heapPosition;
+            }
+        };
+
         /// Datatype for a heap of cells containing interior cells
-        typedef BinaryHeap< CellX*, LessThanInternalCell > internalBHeap;
+        typedef DAryHeap< CellX*, HeapPosition, LessThanInternalCell > internalBHeap;
 
         /// Datatype for a heap of cells containing exterior cells
-        typedef BinaryHeap< CellX*, LessThanExternalCell > externalBHeap;
+        typedef DAryHeap< CellX*, HeapPosition, LessThanExternalCell > externalBHeap;
 
-        /// Routine used internally for keeping track of binary heap elements for internal cells
-        static void setHeapElementI(typename internalBHeap::Element* element, void *)
+        /// Return the top of \e heap, after recomputing the
+        /// priorities of out of date cells that reach the top; NULL
+        /// for an empty heap
+        template<typename Heap>
+        CellX* validTop(Heap &heap) const
         {
-            element->data->heapElement = reinterpret_cast<void*>(element);
+            while (!heap.empty())
+            {
+                CellX* top = heap.top();
+                if (!top->stale)
+                    return top;
+                top->stale = false;
+                eventCellUpdate_(top, eventCellUpdateData_);
+                heap.update(top);
+            }
+            return NULL;
         }
 
-        /// Routine used internally for keeping track of binary heap elements for external cells
-        static void setHeapElementE(typename externalBHeap::Element* element, void *)
-        {
-            element->data->heapElement = reinterpret_cast<void*>(element);
-        }
+        /// Flag indicating whether neighbor count changes update priorities lazily
+        bool                  lazyNeighborUpdates_;
 
-        /// The heap of interior cells
-        internalBHeap internal_;
+        /// The heap of interior cells (mutable, as out of date priorities are updated when the top is queried)
+        mutable internalBHeap internal_;
 
-        /// The heap of external cells
-        externalBHeap external_;
+        /// The heap of external cells (mutable, as out of date priorities are updated when the top is queried)
+        mutable externalBHeap external_;
     };
 
 }
@@ -137,19 +137,11 @@ namespace ompl
         /// Get the list of neighbors for a given cell
         void    neighbors(const Cell* cell, CellArray& list) const
         {
-            Coord test = cell->coord;
-            neighbors(test, list);
+            neighbors(cell->coord, list);
         }
 
         /// Get the list of neighbors for a given coordinate
         void    neighbors(const Coord& coord, CellArray& list) const
-        {
-            Coord test = coord;
-            neighbors(test, list);
-        }
-
-        /// Get the list of neighbors for a given coordinate
-        void    neighbors(Coord& coord, CellArray& list) const
         {
             BaseCellArray baselist;
             Grid<_T>::neighbors(coord, baselist);
@@ -158,6 +150,12 @@ namespace ompl
                 list.push_back(static_cast<Cell*>(baselist[i]));
         }
 
+        /// Get the list of neighbors for a given coordinate
+        void    neighbors(Coord& coord, CellArray& list) const
+        {
+            neighbors(static_cast<const Coord&>(coord), list);
+        }
+
         /// Instantiate a new cell at given coordinates;
         /// Optionally return the list of future neighbors.  Note:
         /// this call only creates the cell, but does not add it to
@@ -168,7 +166,8 @@ namespace ompl
             Cell *cell = new Cell();
             cell->coord = coord;
 
-            BaseCellArray *list = nbh ? nbh : new BaseCellArray();
+            BaseCellArray local;
+            BaseCellArray *list = nbh ? nbh : &local;
             Grid<_T>::neighbors(cell->coord, *list);
 
             for (typename BaseCellArray::iterator cl = list->begin() ; cl != list->end() ; ++cl)
@@ -183,9 +182,6 @@ namespace ompl
             if (cell->border && cell->neighbors >= interiorCellNeighborsLimit_)
                 cell->border = false;
 
-            if (!nbh)
-                delete list;
-
             return cell;
         }
 
@@ -195,16 +191,15 @@ namespace ompl
         {
             if (cell)
             {
-                BaseCellArray *list = new BaseCellArray();
-                Grid<_T>::neighbors(cell->coord, *list);
-                for (typename BaseCellArray::iterator cl = list->begin() ; cl != list->end() ; ++cl)
+                BaseCellArray list;
+                Grid<_T>::neighbors(cell->coord, list);
+                for (typename BaseCellArray::iterator cl = list.begin() ; cl != list.end() ; ++cl)
                 {
                     Cell* c = static_cast<Cell*>(*cl);
                     c->neighbors--;
                     if (!c->border && c->neighbors < interiorCellNeighborsLimit_)
                         c->border = true;
                 }
-                delete list;
                 typename Grid<_T>::CoordHash::iterator pos = Grid<_T>::hash_.find(&cell->coord);
                 if (pos != Grid<_T>::hash_.end())
                 {
@@ -43,62 +43,20 @@
 
 namespace ompl
 {
-    /** \brief A container that supports probabilistic sampling over weighted data. */
-    template <typename _T>
-    class PDF
+
+    /** \brief Weight storage for PDF that keeps a layered binary tree of partial sums.
+        Updates and sampling take O(log n) time. This is the default backend. */
+    class PDFLayeredTree
     {
     public:
 
-        /** \brief A class that will hold data contained in the PDF. */
-        class Element
-        {
-            friend class PDF;
-        public:
-            /** \brief The data contained in this Element. */
-            _T data_;
-        private:
-            Element(const _T& d, const std::size_t i) : data_(d), index_(i)
-            {
-            }
-            std::size_t index_;
-        };
-
-        /** \brief Constructs an empty PDF. */
-        PDF(void)
-        {
-        }
-
-        /** \brief Constructs a PDF containing a given vector of data with given weights. */
-        PDF(const std::vector<_T>& d, const std::vector<double>& weights)
-        {
-            if (d.size() != weights.size())
-                throw Exception("Data vector and weight vector must be of equal length");
-            //by default, reserve space for 512 elements
-            data_.reserve(512u);
-            //n elements require at most log2(n)+2 rows of the tree
-            tree_.reserve(11u);
-            for (std::size_t i = 0; i < d.size(); ++i)
-                add(d[i], weights[i]);
-        }
-
-        /** \brief Destructor. Clears allocated memory. */
-        ~PDF(void)
-        {
-            clear();
-        }
-
-        /** \brief Adds a piece of data with a given weight to the PDF. Returns a corresponding Element, which can be used to subsequently update or remove the data from the PDF. */
-        Element* add(const _T& d, const double w)
+        /** \brief Append a weight */
+        void push(const double w)
         {
-            if (w < 0)
-                throw Exception("Weight argument must be a nonnegative value");
-            Element* elem = new Element(d, data_.size());
-            data_.push_back(elem);
-            if (data_.size() == 1)
+            if (tree_.empty())
             {
-                std::vector<double> r(1, w);
-                tree_.push_back(r);
-                return elem;
+                tree_.push_back(std::vector<double>(1, w));
+                return;
             }
             tree_.front().push_back(w);
             for (std::size_t i = 1; i < tree_.size(); ++i)
@@ -112,45 +70,17 @@ namespace ompl
                         tree_[i].back() += w;
                         ++i;
                     }
-                    return elem;
+                    return;
                 }
             }
             //If we've made it here, then we need to add a new head to the tree.
             std::vector<double> head(1, tree_.back()[0] + tree_.back()[1]);
             tree_.push_back(head);
-            return elem;
-        }
-
-        /** \brief Returns a piece of data from the PDF according to the input sampling value,
-which must be between 0 and 1. */
-        const _T& sample(double r) const
-        {
-            if (data_.empty())
-                throw Exception("Cannot sample from an empty PDF");
-            if (r < 0 || r > 1)
-                throw Exception("Sampling value must be between 0 and 1");
-            std::size_t row = tree_.size() - 1;
-            r *= tree_[row].front();
-            std::size_t node = 0;
-            while (row != 0)
-            {
-                --row;
-                node <<= 1;
-                if (r > tree_[row][node])
-                {
-                    r -= tree_[row][node];
-                    ++node;
-                }
-            }
-            return data_[node]->data_;
         }
 
-        /** \brief Updates the data in the given Element with a new weight value. */
-        void update(Element* elem, const double w)
+        /** \brief Set the weight at position \e index */
+        void set(std::size_t index, const double w)
         {
-            std::size_t index = elem->index_;
-            if (index >= data_.size())
-                throw Exception("Element to update is not in PDF");
             const double weightChange = w - tree_.front()[index];
             tree_.front()[index] = w;
             index >>= 1;
@@ -161,40 +91,34 @@ which must be between 0 and 1. */
             }
         }
 
-        /** \brief Returns the current weight of the given Element. */
-        double getWeight(const Element* elem) const
+        /** \brief Get the weight at position \e index */
+        double get(const std::size_t index) const
         {
-            return tree_.front()[elem->index_];
+            return tree_.front()[index];
         }
 
-        /** \brief Removes the data in the given Element from the PDF. After calling this function, the Element object should no longer be used. */
-        void remove(Element* elem)
+        /** \brief Move the last weight to position \e index and drop the last position */
+        void swapRemove(const std::size_t index)
         {
-            if (data_.size() == 1)
+            const std::size_t n = tree_.front().size();
+            if (n == 1)
             {
-                delete data_.front();
-                data_.clear();
                 tree_.clear();
                 return;
             }
 
-            const std::size_t index = elem->index_;
-            delete data_[index];
-
             double weight;
-            if (index+1 == data_.size())
+            if (index+1 == n)
                 weight = tree_.front().back();
             else
             {
-                std::swap(data_[index], data_.back());
-                data_[index]->index_ = index;
                 std::swap(tree_.front()[index], tree_.front().back());
 
                 /* If index and back() are siblings in the tree, then
                  * we don't need to make an extra pass over the tree.
                  * The amount by which we change the values at the edge
                  * of the tree is different in this case. */
-                if (index+2 == data_.size() && index%2 == 0)
+                if (index+2 == n && index%2 == 0)
                     weight = tree_.front().back();
                 else
                 {
@@ -211,7 +135,6 @@ which must be between 0 and 1. */
 
             /* Now that the element to remove is at the edge of the tree,
              * pop it off and update the corresponding weights. */
-            data_.pop_back();
             tree_.front().pop_back();
             for (std::size_t i = 1; i < tree_.size() && tree_[i-1].size() > 1; ++i)
             {
@@ -231,13 +154,389 @@ which must be between 0 and 1. */
             tree_.pop_back();
         }
 
+        /** \brief Return the position selected by the sampling value \e r, which is in [0,1] */
+        std::size_t sample(double r) const
+        {
+            std::size_t row = tree_.size() - 1;
+            r *= tree_[row].front();
+            std::size_t node = 0;
+            while (row != 0)
+            {
+                --row;
+                node <<= 1;
+                if (r > tree_[row][node])
+                {
+                    r -= tree_[row][node];
+                    ++node;
+                }
+            }
+            return node;
+        }
+
+        /** \brief Reserve space for \e n weights */
+        void reserve(const std::size_t n)
+        {
+            //n elements require at most log2(n)+2 rows of the tree
+            std::size_t rows = 2;
+            for (std::size_t m = n; m > 1; m >>= 1)
+                ++rows;
+            tree_.reserve(rows);
+        }
+
+        /** \brief Remove all weights */
+        void clear(void)
+        {
+            tree_.clear();
+        }
+
+        /** \brief Print the partial sums above the leaves */
+        void print(std::ostream& out) const
+        {
+            for (std::size_t i = 1; i < tree_.size(); ++i)
+            {
+                for (std::size_t j = 0; j < tree_[i].size(); ++j)
+                    out << tree_[i][j] << " ";
+                out << std::endl;
+            }
+        }
+
+    private:
+
+        std::vector<std::vector<double> > tree_;
+    };
+
+    /** \brief Weight storage for PDF that keeps a flat Fenwick (binary indexed) tree.
+        Updates and sampling take O(log n) time, appending and removing the last
+        position are O(log n) and O(1), and all sums are kept in two contiguous
+        arrays. This suits distributions whose weights change often. */
+    class PDFFenwickTree
+    {
+    public:
+
+        /** \brief Append a weight */
+        void push(const double w)
+        {
+            weights_.push_back(w);
+            // node i (1-based) covers the positions (i - lowbit(i), i]
+            const std::size_t i = weights_.size();
+            const std::size_t low = i & (~i + 1);
+            double s = w;
+            for (std::size_t j = i - 1; j > i - low; j -= j & (~j + 1))
+                s += sums_[j - 1];
+            sums_.push_back(s);
+        }
+
+        /** \brief Set the weight at position \e index */
+        void set(const std::size_t index, const double w)
+        {
+            const double weightChange = w - weights_[index];
+            weights_[index] = w;
+            for (std::size_t i = index + 1; i <= sums_.size(); i += i & (~i + 1))
+                sums_[i - 1] += weightChange;
+        }
+
+        /** \brief Get the weight at position \e index */
+        double get(const std::size_t index) const
+        {
+            return weights_[index];
+        }
+
+        /** \brief Move the last weight to position \e index and drop the last position */
+        void swapRemove(const std::size_t index)
+        {
+            // the node of the last position covers no other node, so it can simply be dropped
+            if (index + 1 < weights_.size())
+                set(index, weights_.back());
+            weights_.pop_back();
+            sums_.pop_back();
+        }
+
+        /** \brief Return the position selected by the sampling value \e r, which is in [0,1] */
+        std::size_t sample(double r) const
+        {
+            const std::size_t n = sums_.size();
+            std::size_t step = 1;
+            while (step <= n / 2)
+                step <<= 1;
+            double t = 0.0;
+            for (std::size_t i = n; i > 0; i -= i & (~i + 1))
+                t += sums_[i - 1];
+            r *= t;
+
+            // find the largest prefix whose sum is smaller than r
+            std::size_t pos = 0;
+            for ( ; step > 0 ; step >>= 1)
+                if (pos + step <= n && sums_[pos + step - 1] < r)
+                {
+                    pos += step;
+                    r -= sums_[pos - 1];
+                }
+            return pos < n ? pos : n - 1;
+        }
+
+        /** \brief Reserve space for \e n weights */
+        void reserve(const std::size_t n)
+        {
+            weights_.reserve(n);
+            sums_.reserve(n);
+        }
+
+        /** \brief Remove all weights */
+        void clear(void)
+        {
+            weights_.clear();
+            sums_.clear();
+        }
+
+        /** \brief Print the node sums of the tree */
+        void print(std::ostream& out) const
+        {
+            for (std::size_t j = 0; j < sums_.size(); ++j)
+                out << sums_[j] << " ";
+            out << std::endl;
+        }
+
+    private:
+
+        std::vector<double> weights_;
+        std::vector<double> sums_;
+    };
+
+    /** \brief Weight storage for PDF that keeps a Walker alias table.
+        Sampling takes O(1) time. Any change to the weights invalidates the table,
+        which is rebuilt in O(n) time at the next sample, so this backend suits
+        distributions that are built once and sampled many times. */
+    class PDFAliasTable
+    {
+    public:
+
+        PDFAliasTable(void) : valid_(false)
+        {
+        }
+
+        /** \brief Append a weight */
+        void push(const double w)
+        {
+            weights_.push_back(w);
+            valid_ = false;
+        }
+
+        /** \brief Set the weight at position \e index */
+        void set(const std::size_t index, const double w)
+        {
+            weights_[index] = w;
+            valid_ = false;
+        }
+
+        /** \brief Get the weight at position \e index */
+        double get(const std::size_t index) const
+        {
+            return weights_[index];
+        }
+
+        /** \brief Move the last weight to position \e index and drop the last position */
+        void swapRemove(const std::size_t index)
+        {
+            weights_[index] = weights_.back();
+            weights_.pop_back();
+            valid_ = false;
+        }
+
+        /** \brief Return the position selected by the sampling value \e r, which is in [0,1] */
+        std::size_t sample(const double r) const
+        {
+            if (!valid_)
+                build();
+            const std::size_t n = weights_.size();
+            const double u = r * n;
+            std::size_t column = static_cast<std::size_t>(u);
+            if (column >= n)
+                column = n - 1;
+            return u - column < prob_[column] ? column : alias_[column];
+        }
+
+        /** \brief Reserve space for \e n weights */
+        void reserve(const std::size_t n)
+        {
+            weights_.reserve(n);
+        }
+
+        /** \brief Remove all weights */
+        void clear(void)
+        {
+            weights_.clear();
+            prob_.clear();
+            alias_.clear();
+            valid_ = false;
+        }
+
+        /** \brief Print the alias table */
+        void print(std::ostream& out) const
+        {
+            if (!valid_)
+                build();
+            for (std::size_t j = 0; j < prob_.size(); ++j)
+                out << "(" << prob_[j] << "," << alias_[j] << ") ";
+            out << std::endl;
+        }
+
+    private:
+
+        /** \brief Construct the table with Vose's method */
+        void build(void) const
+        {
+            const std::size_t n = weights_.size();
+            prob_.resize(n);
+            alias_.resize(n);
+            double total = 0.0;
+            for (std::size_t i = 0 ; i < n ; ++i)
+                total += weights_[i];
+
+            // a distribution with no mass is sampled uniformly
+            const double scale = total > 0.0 ? n / total : 0.0;
+            std::vector<std::size_t> small, large;
+            for (std::size_t i = 0 ; i < n ; ++i)
+            {
+                prob_[i] = total > 0.0 ? weights_[i] * scale : 1.0;
+                alias_[i] = i;
+                if (prob_[i] < 1.0)
+                    small.push_back(i);
+                else
+                    large.push_back(i);
+            }
+            while (!small.empty() && !large.empty())
+            {
+                const std::size_t s = small.back();
+                const std::size_t l = large.back();
+                small.pop_back();
+                alias_[s] = l;
+                prob_[l] -= 1.0 - prob_[s];
+                if (prob_[l] < 1.0)
+                {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // whatever is left over is only off by rounding error
+            for (std::size_t i = 0 ; i < small.size() ; ++i)
+                prob_[small[i]] = 1.0;
+            for (std::size_t i = 0 ; i < large.size() ; ++i)
+                prob_[large[i]] = 1.0;
+            valid_ = true;
+        }
+
+        std::vector<double>              weights_;
+        mutable std::vector<double>      prob_;
+        mutable std::vector<std::size_t> alias_;
+        mutable bool                     valid_;
+    };
+
+    /** \brief A container that supports probabilistic sampling over weighted data.
+
+        The way weights are stored and sampled is selected by \e Weights:
+        PDFLayeredTree (the default), PDFFenwickTree for weights that change
+        often, or PDFAliasTable for weights that are sampled many more times
+        than they change. */
+    template <typename _T, class Weights = PDFLayeredTree>
+    class PDF
+    {
+    public:
+
+        /** \brief A class that will hold data contained in the PDF. */
+        class Element
+        {
+            friend class PDF;
+        public:
+            /** \brief The data contained in this Element. */
+            _T data_;
+        private:
+            Element(const _T& d, const std::size_t i) : data_(d), index_(i)
+            {
+            }
+            std::size_t index_;
+        };
+
+        /** \brief Constructs an empty PDF. */
+        PDF(void)
+        {
+        }
+
+        /** \brief Constructs a PDF containing a given vector of data with given weights. */
+        PDF(const std::vector<_T>& d, const std::vector<double>& weights)
+        {
+            if (d.size() != weights.size())
+                throw Exception("Data vector and weight vector must be of equal length");
+            //by default, reserve space for 512 elements
+            data_.reserve(512u);
+            weights_.reserve(512u);
+            for (std::size_t i = 0; i < d.size(); ++i)
+                add(d[i], weights[i]);
+        }
+
+        /** \brief Destructor. Clears allocated memory. */
+        ~PDF(void)
+        {
+            clear();
+        }
+
+        /** \brief Adds a piece of data with a given weight to the PDF. Returns a corresponding Element, which can be used to subsequently update or remove the data from the PDF. */
+        Element* add(const _T& d, const double w)
+        {
+            if (w < 0)
+                throw Exception("Weight argument must be a nonnegative value");
+            Element* elem = new Element(d, data_.size());
+            data_.push_back(elem);
+            weights_.push(w);
+            return elem;
+        }
+
+        /** \brief Returns a piece of data from the PDF according to the input sampling value,
+which must be between 0 and 1. */
+        const _T& sample(double r) const
+        {
+            if (data_.empty())
+                throw Exception("Cannot sample from an empty PDF");
+            if (r < 0 || r > 1)
+                throw Exception("Sampling value must be between 0 and 1");
+            return data_[weights_.sample(r)]->data_;
+        }
+
+        /** \brief Updates the data in the given Element with a new weight value. */
+        void update(Element* elem, const double w)
+        {
+            std::size_t index = elem->index_;
+            if (index >= data_.size())
+                throw Exception("Element to update is not in PDF");
+            weights_.set(index, w);
+        }
+
+        /** \brief Returns the current weight of the given Element. */
+        double getWeight(const Element* elem) const
+        {
+            return weights_.get(elem->index_);
+        }
+
+        /** \brief Removes the data in the given Element from the PDF. After calling this function, the Element object should no longer be used. */
+        void remove(Element* elem)
+        {
+            const std::size_t index = elem->index_;
+            delete data_[index];
+            if (index+1 != data_.size())
+            {
+                data_[index] = data_.back();
+                data_[index]->index_ = index;
+            }
+            data_.pop_back();
+            weights_.swapRemove(index);
+        }
+
         /** \brief Clears the PDF. */
         void clear(void)
         {
             for (typename std::vector<Element*>::iterator e = data_.begin(); e != data_.end(); ++e)
                 delete *e;
             data_.clear();
-            tree_.clear();
+            weights_.clear();
         }
 
         /** \brief Returns the number of elements in the PDF. */
@@ -255,24 +554,19 @@ which must be between 0 and 1. */
         /** \brief Prints the PDF tree to a given output stream. Used for debugging purposes. */
         void printTree(std::ostream& out = std::cout) const
         {
-            if (tree_.empty())
+            if (data_.empty())
                 return;
-            for (std::size_t j = 0; j < tree_[0].size(); ++j)
-                out << "(" << data_[j]->data_ << "," << tree_[0][j] << ") ";
+            for (std::size_t j = 0; j < data_.size(); ++j)
+                out << "(" << data_[j]->data_ << "," << weights_.get(j) << ") ";
             out << std::endl;
-            for (std::size_t i = 1; i < tree_.size(); ++i)
-            {
-                for (std::size_t j = 0; j < tree_[i].size(); ++j)
-                    out << tree_[i][j] << " ";
-                out << std::endl;
-            }
+            weights_.print(out);
             out << std::endl;
         }
 
     private:
 
-        std::vector<Element*>              data_;
-        std::vector<std::vector<double > > tree_;
+        std::vector<Element*> data_;
+        Weights               weights_;
     };
 }
 
@@ -39,10 +39,14 @@
 
 #include "ompl/base/SpaceInformation.h"
 #include "ompl/geometric/PathGeometric.h"
+#include "ompl/datastructures/NearestNeighbors.h"
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/thread/mutex.hpp>
 #include <iostream>
 #include <set>
+#include <vector>
+#include <utility>
 
 namespace ompl
 {
@@ -66,6 +70,11 @@ namespace ompl
             <em>IEEE Trans. on Robotics</em>, vol. 27, pp. 365–371, Apr. 2011.
             DOI: <a href="http://dx.doi.org/10.1109/TRO.2010.2098622">10.1109/TRO.2010.2098622</a><br>
             <a href="http://ieeexplore.ieee.org/stamp/stamp.jsp?tp=&arnumber=5686946">[PDF]</a>
+
+            The vertices of recorded paths are kept in a nearest neighbors structure, so a new path is only aligned
+            with the recorded paths that come close to it. The candidate edges between paths are validated by
+            getThreadCount() threads, and the shortest path through the hybridization graph is updated incrementally
+            as paths are recorded.
         */
         class PathHybridization
         {
@@ -78,13 +87,25 @@ namespace ompl
             /** \brief Get the currently computed hybrid path. computeHybridPath() needs to have been called before. */
             const base::PathPtr& getHybridPath(void) const;
 
-            /** \brief Run Dijkstra's algorithm to find out the shortest path among the mixed ones */
+            /** \brief Extract the shortest path among the mixed ones. The shortest path distances are updated
+                incrementally by recordPath(), so this only follows the predecessors back from the goal. */
             void computeHybridPath(void);
 
             /** \brief Add a path to the hybridization. If \e matchAcrossGaps is true, more possible edge connections are evaluated.
-                Return the number of attempted connections between paths. */
+                The path is only aligned with the previously recorded paths that have a vertex within twice the
+                gap cost of one of its vertices; other paths could not have a matching vertex.
+                Return the number of distinct connections between paths that were checked. */
             unsigned int recordPath(const base::PathPtr &pp, bool matchAcrossGaps);
 
+            /** \brief Set the number of threads used to validate the candidate edges between paths. Default is 1. */
+            void setThreadCount(unsigned int nthreads);
+
+            /** \brief Get the number of threads used to validate the candidate edges between paths */
+            unsigned int getThreadCount(void) const
+            {
+                return threadCount_;
+            }
+
             /** \brief Get the number of paths that are currently considered as part of the hybridization */
             std::size_t pathCount(void) const;
 
@@ -144,7 +165,31 @@ namespace ompl
             };
             /// @endcond
 
-            void attemptNewEdge(const PathInfo &p, const PathInfo &q, int indexP, int indexQ);
+            typedef std::pair<Vertex, Vertex> VertexPair;
+
+            /** \brief Queue the edge between state \e indexP of \e p and state \e indexQ of \e q for validation */
+            void attemptNewEdge(const PathInfo &p, const PathInfo &q, int indexP, int indexQ, std::vector<VertexPair> &attempts) const;
+
+            /** \brief Validate the edges in \e attempts and add the valid ones to the graph; their end points are
+                appended to \e touched */
+            void addValidEdges(std::vector<VertexPair> &attempts, std::vector<Vertex> &touched);
+
+            /** \brief The body of a thread started by addValidEdges() */
+            void checkEdgesThread(const std::vector<VertexPair> &attempts, std::vector<char> &valid, std::size_t *next, boost::mutex *lock) const;
+
+            /** \brief Add a vertex for \e state to the graph, with no known path from the root */
+            Vertex addVertex(base::State *state);
+
+            /** \brief Propagate the decrease of shortest path distances through the edges at \e seeds */
+            void updateShortestPaths(const std::vector<Vertex> &seeds);
+
+            /** \brief Reset the graph to contain only the root and the goal */
+            void resetGraph(void);
+
+            double distanceFunction(const Vertex a, const Vertex b) const
+            {
+                return si_->distance(stateProperty_[a], stateProperty_[b]);
+            }
 
             base::SpaceInformationPtr                         si_;
             HGraph                                            g_;
@@ -153,6 +198,20 @@ namespace ompl
             Vertex                                            goal_;
             std::set<PathInfo>                                paths_;
             base::PathPtr                                     hpath_;
+
+            /** \brief The vertices of the recorded paths */
+            boost::shared_ptr< NearestNeighbors<Vertex> >     nn_;
+
+            /** \brief The recorded path each vertex belongs to (NULL for the root and the goal) */
+            std::vector<const PathInfo*>                      owner_;
+
+            /** \brief The shortest path distance of each vertex from the root */
+            std::vector<double>                               dist_;
+
+            /** \brief The predecessor of each vertex on its shortest path from the root */
+            std::vector<Vertex>                               prev_;
+
+            unsigned int                                      threadCount_;
         };
     }
 }
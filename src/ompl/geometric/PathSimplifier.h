@@ -43,7 +43,12 @@
 #include "ompl/util/ClassForward.h"
 #include "ompl/util/RandomNumbers.h"
 #include "ompl/util/Console.h"
+#include "ompl/util/Time.h"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <limits>
+#include <vector>
 
 namespace ompl
 {
@@ -67,15 +72,48 @@ namespace ompl
         {
         public:
 
-            /** \brief Create an instance for a specified space information */
-            PathSimplifier(const base::SpaceInformationPtr &si) : si_(si)
+            /** \brief The simplification operations simplifyAdaptive() can schedule */
+            enum Stage
             {
-            }
+                /** \brief reduceVertices() with default arguments */
+                REDUCE_VERTICES,
+
+                /** \brief collapseCloseVertices() with default arguments */
+                COLLAPSE_CLOSE_VERTICES,
+
+                /** \brief shortcutPath() with default arguments */
+                SHORTCUT_PATH,
+
+                /** \brief smoothBSpline() as simplify() calls it */
+                SMOOTH_BSPLINE
+            };
+
+            /** \brief An entry of the trace simplifyAdaptive() records after each stage it runs */
+            struct TraceEntry
+            {
+                /** \brief The stage that was run */
+                Stage  stage;
+
+                /** \brief The time (seconds) since simplifyAdaptive() started, at the end of the stage */
+                double time;
 
-            virtual ~PathSimplifier(void)
+                /** \brief The length of the path at the end of the stage */
+                double length;
+            };
+
+            /** \brief Create an instance for a specified space information */
+            PathSimplifier(const base::SpaceInformationPtr &si) : si_(si), threadCount_(1), minImprovementRate_(0.05),
+                                                                 round_(0), helpers_(0), pending_(0), shutdown_(false),
+                                                                 roundSi_(NULL), roundStates_(NULL), roundCandidates_(NULL), next_(0)
             {
+                stages_.push_back(REDUCE_VERTICES);
+                stages_.push_back(COLLAPSE_CLOSE_VERTICES);
+                stages_.push_back(SHORTCUT_PATH);
+                stages_.push_back(SMOOTH_BSPLINE);
             }
 
+            virtual ~PathSimplifier(void);
+
 
             /** \brief Given a path, attempt to remove vertices from
                 it while keeping the path valid. This is an iterative
@@ -203,14 +241,167 @@ namespace ompl
             /** \brief Run simplification algorithms on the path as long as the termination condition does not become true */
             void simplify(PathGeometric &path, const base::PlannerTerminationCondition &ptc);
 
+            /** \brief Run the stages set by setStages() on the path, scheduling them by how productive they are, until
+                the termination condition becomes true or no stage improves the path fast enough.
+
+                Each stage is first run once, in order. The improvement rate of a stage is the relative decrease of the
+                path length per second it achieved, averaged over its recent runs; a run that does not shorten the path
+                sets it to 0. After that, the stage with the highest rate is run next. A stage whose rate drops below
+                getMinImprovementRate() is only tried again once another stage has shortened the path, and the process
+                stops when all stages are below that rate. The length of the path after each stage is recorded in
+                getTrace(). */
+            void simplifyAdaptive(PathGeometric &path, const base::PlannerTerminationCondition &ptc);
+
+            /** \brief Run simplifyAdaptive() for at most \e maxTime seconds */
+            void simplifyAdaptive(PathGeometric &path, double maxTime);
+
+            /** \brief Set the stages simplifyAdaptive() chooses from. By default, all stages are used, in the order
+                simplify() runs them. */
+            void setStages(const std::vector<Stage> &stages)
+            {
+                stages_ = stages;
+            }
+
+            /** \brief Get the stages simplifyAdaptive() chooses from */
+            const std::vector<Stage>& getStages(void) const
+            {
+                return stages_;
+            }
+
+            /** \brief Set the improvement rate (fraction of the path length removed per second) below which
+                simplifyAdaptive() considers a stage unproductive. Default is 0.05. */
+            void setMinImprovementRate(double rate)
+            {
+                minImprovementRate_ = rate;
+            }
+
+            /** \brief Get the improvement rate below which simplifyAdaptive() considers a stage unproductive */
+            double getMinImprovementRate(void) const
+            {
+                return minImprovementRate_;
+            }
+
+            /** \brief Get the path length versus time trace recorded by the last call to simplifyAdaptive() */
+            const std::vector<TraceEntry>& getTrace(void) const
+            {
+                return trace_;
+            }
+
+            /** \brief Set the number of threads reduceVertices() and shortcutPath() use. With more than one thread,
+                batches of random shortcuts are checked concurrently against the current path, and the largest set of
+                valid shortcuts that do not overlap is applied to the path at once. Default is 1. */
+            void setThreadCount(unsigned int nthreads);
+
+            /** \brief Get the number of threads reduceVertices() and shortcutPath() use */
+            unsigned int getThreadCount(void) const
+            {
+                return threadCount_;
+            }
+
         protected:
 
+            /** \brief A shortcut between two points of a path. Each point is either a vertex of the path (\e index
+                is set) or a point interpolated on the segment that starts at vertex \e pos. Applying the shortcut keeps
+                the vertices up to \e first and from \e last on, and replaces the ones in between by the interpolated
+                points. */
+            struct Shortcut
+            {
+                int              pos0, pos1;
+                int              index0, index1;
+                double           t0, t1;
+
+                /** \brief The distance along the path between the two points */
+                double           along;
+
+                int              first, last;
+
+                /** \brief Storage for the interpolated points */
+                base::State     *state0, *state1;
+
+                /** \brief Set if sampling did not produce a usable pair of points */
+                bool             skip;
+
+                /** \brief Set if the motion between the two points is valid */
+                bool             valid;
+
+                /** \brief How much applying the shortcut improves the path */
+                double           gain;
+            };
+
+            /** \brief Run \e stage on \e path */
+            void runStage(PathGeometric &path, Stage stage);
+
+            /** \brief The batched implementation of reduceVertices() (if \e vertices is true) and shortcutPath() used when
+                there are several threads */
+            bool shortcutBatched(PathGeometric &path, unsigned int maxSteps, unsigned int maxEmptySteps, double rangeRatio,
+                                 double snapToVertex, bool vertices);
+
+            /** \brief Check the shortcuts in \e candidates against the vertices in \e states, using threadCount_ threads:
+                the calling thread and threadCount_ - 1 helper threads from the pool */
+            void checkShortcuts(const base::SpaceInformationPtr &si, const std::vector<base::State*> &states,
+                                std::vector<Shortcut> &candidates);
+
+            /** \brief Check the shortcuts of the current round until there are none left */
+            void checkShortcutsThread(void);
+
+            /** \brief The loop of the pool thread \e index, which helps check shortcuts in each round started after round \e round */
+            void worker(unsigned int index, unsigned int round);
+
+
             /** \brief The space information this path simplifier uses */
             base::SpaceInformationPtr si_;
 
             /** \brief Instance of random number generator */
             RNG                       rng_;
 
+            /** \brief The number of threads used for shortcutting */
+            unsigned int              threadCount_;
+
+            /** \brief The stages simplifyAdaptive() chooses from */
+            std::vector<Stage>        stages_;
+
+            /** \brief The improvement rate below which a stage is considered unproductive */
+            double                    minImprovementRate_;
+
+            /** \brief The trace recorded by the last call to simplifyAdaptive() */
+            std::vector<TraceEntry>   trace_;
+
+            /** \brief The helper threads of checkShortcuts(). They are started when first needed and kept until the
+                simplifier is destroyed, so checking a batch of shortcuts does not create and join threads. */
+            std::vector<boost::thread*> workers_;
+
+            /** \brief Lock held by checkShortcuts(), since there is a single round of checks at a time */
+            boost::mutex              checkLock_;
+
+            /** \brief Lock for the state of the pool and for next_ */
+            boost::mutex              poolLock_;
+
+            /** \brief Signaled when a round starts or the pool shuts down */
+            boost::condition_variable roundStart_;
+
+            /** \brief Signaled when a helper thread is done with the current round */
+            boost::condition_variable roundDone_;
+
+            /** \brief The number of rounds started so far */
+            unsigned int              round_;
+
+            /** \brief The number of helper threads taking part in the current round */
+            unsigned int              helpers_;
+
+            /** \brief The number of helper threads still working on the current round */
+            unsigned int              pending_;
+
+            /** \brief Set when the pool threads must exit */
+            bool                      shutdown_;
+
+            /** \brief The arguments of checkShortcuts() for the current round */
+            const base::SpaceInformationPtr *roundSi_;
+            const std::vector<base::State*> *roundStates_;
+            std::vector<Shortcut>    *roundCandidates_;
+
+            /** \brief The index of the next candidate to check in the current round */
+            std::size_t               next_;
+
         };
     }
 }
@@ -130,6 +130,34 @@ namespace ompl
                                                 const std::map<std::string, double> &startVel,
                                                 const std::map<std::string, double> &endVel,
                                                 unsigned int maxSteps = 10) const;
+
+            /** \brief Compute a time parametrization of the path that moves along it as fast as the limits allow.
+                Return true on success.
+
+                The state space must be a RealVectorStateSpace, or a compound of them. The real values of the states
+                (StateSpace::copyToReals()) are treated as joint positions, and the path is followed along straight
+                lines between its states. The limits of each joint bound the speed, acceleration and jerk along every
+                segment of the path, depending on its direction. Since the direction of motion cannot change
+                instantly within these limits, the path stops at every state where it does not go straight on. A
+                forward and a backward pass then propagate the acceleration limits along the path, and each segment
+                is traversed with a (jerk-limited) accelerate, cruise, decelerate profile. The cost is linear in the
+                number of states.
+
+                \param maxVel The maximum velocity of each joint
+                \param maxAcc The maximum acceleration of each joint
+                \param maxJerk The maximum jerk of each joint; if empty, jerk is not limited
+                \param times The time stamp (in seconds) for each of the states along the path. Starts at 0.0
+                \param velocities The speed along the path (distance in joint space per second) at each of the states
+                \param startVel The speed along the path at its start
+                \param endVel The speed along the path at its end */
+            bool computeTimeOptimalParametrization(const PathGeometric &path,
+                                                   const std::vector<double> &maxVel,
+                                                   const std::vector<double> &maxAcc,
+                                                   const std::vector<double> &maxJerk,
+                                                   std::vector<double> &times,
+                                                   std::vector<double> &velocities,
+                                                   double startVel = 0.0,
+                                                   double endVel = 0.0) const;
         private:
           
             bool computeFastTimeParametrizationPart(const PathGeometric &path,
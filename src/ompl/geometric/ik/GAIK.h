@@ -41,6 +41,8 @@
 #include "ompl/base/goals/GoalRegion.h"
 #include "ompl/geometric/ik/HCIK.h"
 #include "ompl/util/Console.h"
+#include "ompl/util/Time.h"
+#include <boost/thread/mutex.hpp>
 
 namespace ompl
 {
@@ -157,11 +159,73 @@ namespace ompl
                 return maxDistance_;
             }
 
+            /** \brief Set the number of threads to use. With more than one thread, GAIK runs an island model: each
+                thread evolves its own population (of the size set by setPoolSize(), setPoolMutationSize() and
+                setPoolRandomSize()) with its own sampler, and the best individuals of each island periodically
+                migrate to the next island. Default is 1. */
+            void setThreadCount(unsigned int nthreads);
+
+            /** \brief Get the number of threads (islands) used */
+            unsigned int getThreadCount(void) const
+            {
+                return threadCount_;
+            }
+
+            /** \brief Set the number of generations between migrations, when multiple islands are used */
+            void setMigrationInterval(unsigned int generations)
+            {
+                migrationInterval_ = generations;
+            }
+
+            /** \brief Get the number of generations between migrations, when multiple islands are used */
+            unsigned int getMigrationInterval(void) const
+            {
+                return migrationInterval_;
+            }
+
+            /** \brief Set the number of individuals that migrate from an island at a time */
+            void setMigrationSize(unsigned int size)
+            {
+                migrationSize_ = size;
+            }
+
+            /** \brief Get the number of individuals that migrate from an island at a time */
+            unsigned int getMigrationSize(void) const
+            {
+                return migrationSize_;
+            }
+
             /** \brief Clear the pool of samples */
             void clear(void);
 
         private:
 
+            struct Individual;
+
+            /** \brief The state shared by the threads of the island model during a call to solve() */
+            struct IslandSearch;
+
+            /** \brief Run the island model; this is solve() when more than one thread is used */
+            bool solveIslands(const time::point &endTime, const base::GoalRegion &goal, base::State *result,
+                              const std::vector<base::State*> &hint);
+
+            /** \brief Evolve island \e index until a solution is found by any island or time runs out */
+            void evolveIsland(unsigned int index, IslandSearch *search);
+
+            /** \brief Try to turn the best individuals of the islands into a solution using hill climbing, in parallel */
+            bool improveIslands(const base::GoalRegion &goal, base::State *result);
+
+            /** \brief The body of a thread started by improveIslands() */
+            void improveThread(const base::GoalRegion *goal, const std::vector<const Individual*> *candidates,
+                               std::size_t *next, boost::mutex *lock, base::State *result, bool *solved);
+
+            /** \brief Compute the distance to the goal and the validity of \e ind; return true if it is a solution */
+            bool evaluate(Individual &ind, const base::GoalRegion &goal) const
+            {
+                ind.valid = valid(ind.state);
+                return goal.isSatisfied(ind.state, &ind.distance) && ind.valid;
+            }
+
             /** \brief Use hill climbing to attempt to get a state closer to the goal */
             void tryToImprove(const base::GoalRegion &goal, base::State *state, double distance);
 
@@ -178,6 +242,16 @@ namespace ompl
                 bool         valid;
             };
 
+            /** \brief A population evolved by one thread of the island model */
+            struct Island
+            {
+                std::vector<Individual>  pool;
+                base::StateSamplerPtr    sampler;
+
+                /** \brief Individuals that migrated from the previous island; protected by islandLock_ */
+                std::vector<Individual>  incoming;
+            };
+
             struct IndividualSort
             {
                 bool operator()(const Individual& a, const Individual& b)
@@ -200,6 +274,12 @@ namespace ompl
             bool                                         tryImprove_;
 
             double                                       maxDistance_;
+
+            unsigned int                                 threadCount_;
+            unsigned int                                 migrationInterval_;
+            unsigned int                                 migrationSize_;
+            std::vector<Island>                          islands_;
+            boost::mutex                                 islandLock_;
         };
 
     }
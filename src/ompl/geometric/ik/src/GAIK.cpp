@@ -38,11 +38,14 @@
 #include "ompl/util/Time.h"
 #include "ompl/util/Exception.h"
 #include "ompl/tools/config/SelfConfig.h"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <algorithm>
 #include <limits>
 
 ompl::geometric::GAIK::GAIK(const base::SpaceInformationPtr &si) : hcik_(si), si_(si), poolSize_(100), poolMutation_(20), poolRandom_(30),
-                                                                   generations_(0), tryImprove_(false), maxDistance_(0.0)
+                                                                   generations_(0), tryImprove_(false), maxDistance_(0.0),
+                                                                   threadCount_(1), migrationInterval_(10), migrationSize_(2)
 {
     hcik_.setMaxImproveSteps(3);
     setValidityCheck(true);
@@ -50,8 +53,13 @@ ompl::geometric::GAIK::GAIK(const base::SpaceInformationPtr &si) : hcik_(si), si
 
 ompl::geometric::GAIK::~GAIK(void)
 {
-    for (unsigned int i = 0 ; i < pool_.size() ; ++i)
-        si_->freeState(pool_[i].state);
+    clear();
+}
+
+void ompl::geometric::GAIK::setThreadCount(unsigned int nthreads)
+{
+    assert(nthreads > 0);
+    threadCount_ = nthreads;
 }
 
 bool ompl::geometric::GAIK::solve(double solveTime, const base::GoalRegion &goal, base::State *result, const std::vector<base::State*> &hint)
@@ -70,6 +78,9 @@ bool ompl::geometric::GAIK::solve(double solveTime, const base::GoalRegion &goal
 
     time::point    endTime = time::now() + time::seconds(solveTime);
 
+    if (threadCount_ > 1)
+        return solveIslands(endTime, goal, result, hint);
+
     unsigned int   maxPoolSize = poolSize_ + poolMutation_ + poolRandom_;
     IndividualSort gs;
     bool           solved = false;
@@ -286,6 +297,232 @@ void ompl::geometric::GAIK::tryToImprove(const base::GoalRegion &goal, base::Sta
 void ompl::geometric::GAIK::clear(void)
 {
     generations_ = 0;
+    for (unsigned int i = 0 ; i < pool_.size() ; ++i)
+        si_->freeState(pool_[i].state);
     pool_.clear();
     sampler_.reset();
+    for (std::size_t k = 0 ; k < islands_.size() ; ++k)
+    {
+        for (std::size_t i = 0 ; i < islands_[k].pool.size() ; ++i)
+            si_->freeState(islands_[k].pool[i].state);
+        for (std::size_t i = 0 ; i < islands_[k].incoming.size() ; ++i)
+            si_->freeState(islands_[k].incoming[i].state);
+    }
+    islands_.clear();
+}
+
+/// @cond IGNORE
+struct ompl::geometric::GAIK::IslandSearch
+{
+    const base::GoalRegion           *goal;
+    time::point                       endTime;
+    const std::vector<base::State*>  *hint;
+
+    /** \brief Set once any island finds a solution; protected by islandLock_ */
+    bool                              solved;
+    base::State                      *solution;
+    double                            distance;
+    unsigned int                      generations;
+};
+/// @endcond
+
+bool ompl::geometric::GAIK::solveIslands(const time::point &endTime, const base::GoalRegion &goal, base::State *result,
+                                         const std::vector<base::State*> &hint)
+{
+    if (islands_.size() != threadCount_)
+    {
+        clear();
+        islands_.resize(threadCount_);
+        for (std::size_t k = 0 ; k < islands_.size() ; ++k)
+            islands_[k].sampler = si_->allocStateSampler();
+    }
+
+    IslandSearch search;
+    search.goal = &goal;
+    search.endTime = endTime;
+    search.hint = &hint;
+    search.solved = false;
+    search.solution = result;
+    search.distance = 0.0;
+    search.generations = 0;
+
+    boost::thread_group threads;
+    for (unsigned int k = 1 ; k < threadCount_ ; ++k)
+        threads.create_thread(boost::bind(&GAIK::evolveIsland, this, k, &search));
+    evolveIsland(0, &search);
+    threads.join_all();
+
+    generations_ += search.generations;
+    logInform("Ran for %u generations on %u islands", search.generations, threadCount_);
+
+    if (search.solved)
+    {
+        if (tryImprove_)
+        {
+            base::State *found = si_->cloneState(result);
+            tryToImprove(goal, result, search.distance);
+            if (!valid(result))
+                si_->copyState(result, found);
+            si_->freeState(found);
+        }
+        return true;
+    }
+
+    return tryImprove_ ? improveIslands(goal, result) : false;
+}
+
+void ompl::geometric::GAIK::evolveIsland(unsigned int index, IslandSearch *search)
+{
+    Island &island = islands_[index];
+    const base::GoalRegion &goal = *search->goal;
+    const std::vector<base::State*> &hint = *search->hint;
+    unsigned int maxPoolSize = poolSize_ + poolMutation_ + poolRandom_;
+    unsigned int mutationsSize = poolSize_ + poolMutation_;
+    int solution = -1;
+
+    // the hints are dealt to the islands in turn; they go at the bottom of the pool, which
+    // is otherwise filled with random states on the first call and kept on later ones
+    std::size_t initialSize = island.pool.size();
+    for (std::size_t i = maxPoolSize ; i < initialSize ; ++i)
+        si_->freeState(island.pool[i].state);
+    island.pool.resize(maxPoolSize);
+    for (std::size_t i = initialSize ; i < maxPoolSize ; ++i)
+        island.pool[i].state = si_->allocState();
+
+    unsigned int nh = 0;
+    for (std::size_t h = index ; h < hint.size() && nh < maxPoolSize ; h += threadCount_, ++nh)
+    {
+        Individual &ind = island.pool[maxPoolSize - nh - 1];
+        si_->copyState(ind.state, hint[h]);
+        si_->enforceBounds(ind.state);
+    }
+    for (std::size_t i = 0 ; i < maxPoolSize && solution < 0 ; ++i)
+    {
+        if (i >= initialSize && i < maxPoolSize - nh)
+            island.sampler->sampleUniform(island.pool[i].state);
+        // the goal may have changed since the previous call, so every individual is evaluated
+        if (evaluate(island.pool[i], goal))
+            solution = i;
+    }
+
+    IndividualSort gs;
+    unsigned int generations = 0;
+    while (solution < 0 && time::now() < search->endTime)
+    {
+        ++generations;
+        std::sort(island.pool.begin(), island.pool.end(), gs);
+        bool immigrants = false;
+
+        {
+            boost::mutex::scoped_lock slock(islandLock_);
+            if (search->solved)
+                break;
+
+            // immigrants replace the worst individuals that survive to the next generation
+            for (std::size_t i = 0 ; i < island.incoming.size() ; ++i)
+            {
+                Individual &ind = island.pool[poolSize_ - 1 - i % poolSize_];
+                std::swap(ind.state, island.incoming[i].state);
+                ind.distance = island.incoming[i].distance;
+                ind.valid = island.incoming[i].valid;
+                si_->freeState(island.incoming[i].state);
+            }
+            immigrants = !island.incoming.empty();
+            island.incoming.clear();
+
+            // emigrants go to the next island, in a ring
+            if (generations % migrationInterval_ == 0)
+            {
+                std::vector<Individual> &out = islands_[(index + 1) % islands_.size()].incoming;
+                for (unsigned int i = 0 ; i < migrationSize_ && i < poolSize_ && out.size() < poolSize_ ; ++i)
+                {
+                    Individual ind = island.pool[i];
+                    ind.state = si_->cloneState(ind.state);
+                    out.push_back(ind);
+                }
+            }
+        }
+        if (immigrants)
+            std::sort(island.pool.begin(), island.pool.end(), gs);
+
+        // add mutations
+        for (unsigned int i = poolSize_ ; i < mutationsSize && solution < 0 ; ++i)
+        {
+            island.sampler->sampleUniformNear(island.pool[i].state, island.pool[i % poolSize_].state, maxDistance_);
+            if (evaluate(island.pool[i], goal))
+                solution = i;
+        }
+
+        // add random states
+        for (unsigned int i = mutationsSize ; i < maxPoolSize && solution < 0 ; ++i)
+        {
+            island.sampler->sampleUniform(island.pool[i].state);
+            if (evaluate(island.pool[i], goal))
+                solution = i;
+        }
+    }
+
+    boost::mutex::scoped_lock slock(islandLock_);
+    search->generations += generations;
+    if (solution >= 0 && !search->solved)
+    {
+        search->solved = true;
+        si_->copyState(search->solution, island.pool[solution].state);
+        search->distance = island.pool[solution].distance;
+    }
+}
+
+bool ompl::geometric::GAIK::improveIslands(const base::GoalRegion &goal, base::State *result)
+{
+    // hill climb from the best valid individuals of every island
+    IndividualSort gs;
+    std::vector<const Individual*> candidates;
+    for (std::size_t k = 0 ; k < islands_.size() ; ++k)
+    {
+        std::vector<Individual> &pool = islands_[k].pool;
+        std::sort(pool.begin(), pool.end(), gs);
+        for (std::size_t i = 0 ; i < 5 && i < pool.size() ; ++i)
+            if (pool[i].valid)
+                candidates.push_back(&pool[i]);
+    }
+
+    std::size_t next = 0;
+    bool solved = false;
+    boost::mutex lock;
+    boost::thread_group threads;
+    for (std::size_t k = 1 ; k < std::min<std::size_t>(threadCount_, candidates.size()) ; ++k)
+        threads.create_thread(boost::bind(&GAIK::improveThread, this, &goal, &candidates, &next, &lock, result, &solved));
+    improveThread(&goal, &candidates, &next, &lock, result, &solved);
+    threads.join_all();
+    return solved;
+}
+
+void ompl::geometric::GAIK::improveThread(const base::GoalRegion *goal, const std::vector<const Individual*> *candidates,
+                                          std::size_t *next, boost::mutex *lock, base::State *result, bool *solved)
+{
+    base::State *state = si_->allocState();
+    while (true)
+    {
+        std::size_t i;
+        {
+            boost::mutex::scoped_lock slock(*lock);
+            if (*solved || *next >= candidates->size())
+                break;
+            i = (*next)++;
+        }
+
+        const Individual &ind = *(*candidates)[i];
+        si_->copyState(state, ind.state);
+        tryToImprove(*goal, state, ind.distance);
+        if (valid(state) && goal->isSatisfied(state))
+        {
+            boost::mutex::scoped_lock slock(*lock);
+            if (!*solved)
+            {
+                *solved = true;
+                si_->copyState(result, state);
+            }
+        }
+    }
+    si_->freeState(state);
 }
@@ -93,6 +93,7 @@ void ompl::geometric::EST::freeMemory(void)
 
 ompl::base::PlannerStatus ompl::geometric::EST::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                   *goal = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -132,8 +133,15 @@ ompl::base::PlannerStatus ompl::geometric::EST::solve(const base::PlannerTermina
         else
             if (!sampler_->sampleNear(xstate, existing->state, maxDistance_))
                 continue;
+        ++stats_.samples;
 
-        if (si_->checkMotion(existing->state, xstate))
+        bool valid;
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            valid = si_->checkMotion(existing->state, xstate);
+        }
+
+        if (valid)
         {
             /* create a motion */
             Motion *motion = new Motion(si_);
@@ -187,6 +195,7 @@ ompl::base::PlannerStatus ompl::geometric::EST::solve(const base::PlannerTermina
 
     si_->freeState(xstate);
 
+    stats_.graphStates = tree_.size;
     logInform("Created %u states in %u cells", tree_.size, tree_.grid.size());
 
     return base::PlannerStatus(solved, approximate);
@@ -123,6 +123,8 @@ namespace ompl
                                                              freeMotion_(freeMotion)
             {
                 grid_.onCellUpdate(computeImportance, NULL);
+                // a cell's importance only decreases when it gains neighbors
+                grid_.setLazyNeighborUpdates(true);
                 selectBorderFraction_ = 0.9;
             }
 
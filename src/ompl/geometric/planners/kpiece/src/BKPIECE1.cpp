@@ -78,6 +78,7 @@ void ompl::geometric::BKPIECE1::setup(void)
 
 ompl::base::PlannerStatus ompl::geometric::BKPIECE1::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -152,8 +153,13 @@ ompl::base::PlannerStatus ompl::geometric::BKPIECE1::solve(const base::PlannerTe
         assert(existing);
         if (sampler_->sampleNear(xstate, existing->state, maxDistance_))
         {
+            ++stats_.samples;
             std::pair<base::State*, double> fail(xstate, 0.0);
-            bool keep = si_->checkMotion(existing->state, xstate, fail);
+            bool keep;
+            {
+                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                keep = si_->checkMotion(existing->state, xstate, fail);
+            }
             if (!keep && fail.second > minValidPathFraction_)
                 keep = true;
 
@@ -174,8 +180,14 @@ ompl::base::PlannerStatus ompl::geometric::BKPIECE1::solve(const base::PlannerTe
                 {
                     Motion* connectOther = cellC->data->motions[rng_.uniformInt(0, cellC->data->motions.size() - 1)];
 
-                    if (goal->isStartGoalPairValid(startTree ? connectOther->root : motion->root, startTree ? motion->root : connectOther->root) &&
-                        si_->checkMotion(motion->state, connectOther->state))
+                    bool connect = goal->isStartGoalPairValid(startTree ? connectOther->root : motion->root, startTree ? motion->root : connectOther->root);
+                    if (connect)
+                    {
+                        base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                        connect = si_->checkMotion(motion->state, connectOther->state);
+                    }
+
+                    if (connect)
                     {
                         if (startTree)
                             connectionPoint_ = std::make_pair<base::State*, base::State*>(connectOther->state, motion->state);
@@ -224,6 +236,7 @@ ompl::base::PlannerStatus ompl::geometric::BKPIECE1::solve(const base::PlannerTe
 
     si_->freeState(xstate);
 
+    stats_.graphStates = dStart_.getMotionCount() + dGoal_.getMotionCount();
     logInform("Created %u (%u start + %u goal) states in %u cells (%u start (%u on boundary) + %u goal (%u on boundary))",
                 dStart_.getMotionCount() + dGoal_.getMotionCount(), dStart_.getMotionCount(), dGoal_.getMotionCount(),
                 dStart_.getCellCount() + dGoal_.getCellCount(), dStart_.getCellCount(), dStart_.getGrid().countExternal(),
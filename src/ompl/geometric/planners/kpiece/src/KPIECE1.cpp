@@ -95,6 +95,7 @@ void ompl::geometric::KPIECE1::freeMotion(Motion *motion)
 
 ompl::base::PlannerStatus ompl::geometric::KPIECE1::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                   *goal = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -140,9 +141,14 @@ ompl::base::PlannerStatus ompl::geometric::KPIECE1::solve(const base::PlannerTer
             goal_s->sampleGoal(xstate);
         else
             sampler_->sampleUniformNear(xstate, existing->state, maxDistance_);
+        ++stats_.samples;
 
         std::pair<base::State*, double> fail(xstate, 0.0);
-        bool keep = si_->checkMotion(existing->state, xstate, fail);
+        bool keep;
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            keep = si_->checkMotion(existing->state, xstate, fail);
+        }
         if (!keep && fail.second > minValidPathFraction_)
             keep = true;
 
@@ -205,6 +211,7 @@ ompl::base::PlannerStatus ompl::geometric::KPIECE1::solve(const base::PlannerTer
 
     si_->freeState(xstate);
 
+    stats_.graphStates = disc_.getMotionCount();
     logInform("Created %u states in %u cells (%u internal + %u external)", disc_.getMotionCount(), disc_.getCellCount(),
                 disc_.getGrid().countInternal(), disc_.getGrid().countExternal());
 
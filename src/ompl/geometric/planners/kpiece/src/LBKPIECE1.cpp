@@ -74,6 +74,7 @@ void ompl::geometric::LBKPIECE1::setup(void)
 
 ompl::base::PlannerStatus ompl::geometric::LBKPIECE1::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -148,6 +149,7 @@ ompl::base::PlannerStatus ompl::geometric::LBKPIECE1::solve(const base::PlannerT
         disc.selectMotion(existing, ecell);
         assert(existing);
         sampler_->sampleUniformNear(xstate, existing->state, maxDistance_);
+        ++stats_.samples;
 
         /* create a motion */
         Motion* motion = new Motion(si_);
@@ -217,6 +219,7 @@ ompl::base::PlannerStatus ompl::geometric::LBKPIECE1::solve(const base::PlannerT
 
     si_->freeState(xstate);
 
+    stats_.graphStates = dStart_.getMotionCount() + dGoal_.getMotionCount();
     logInform("Created %u (%u start + %u goal) states in %u cells (%u start (%u on boundary) + %u goal (%u on boundary))",
                 dStart_.getMotionCount() + dGoal_.getMotionCount(), dStart_.getMotionCount(), dGoal_.getMotionCount(),
                 dStart_.getCellCount() + dGoal_.getCellCount(), dStart_.getCellCount(), dStart_.getGrid().countExternal(),
@@ -243,7 +246,12 @@ bool ompl::geometric::LBKPIECE1::isPathValid(Discretization<Motion> &disc, Motio
     for (int i = mpath.size() - 1 ; i >= 0 ; --i)
         if (!mpath[i]->valid)
         {
-            if (si_->checkMotion(mpath[i]->parent->state, mpath[i]->state, lastValid))
+            bool valid;
+            {
+                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                valid = si_->checkMotion(mpath[i]->parent->state, mpath[i]->state, lastValid);
+            }
+            if (valid)
                 mpath[i]->valid = true;
             else
             {
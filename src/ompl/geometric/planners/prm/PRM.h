@@ -39,6 +39,7 @@
 
 #include "ompl/geometric/planners/PlannerIncludes.h"
 #include "ompl/datastructures/NearestNeighbors.h"
+#include "ompl/datastructures/PDF.h"
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/pending/disjoint_sets.hpp>
@@ -268,8 +269,12 @@ namespace ompl
             /** \brief Free all the memory allocated by the planner */
             void freeMemory(void);
 
-            /** \brief Construct a milestone for a given state (\e state) and store it in the nearest neighbors data structure */
-            virtual Vertex addMilestone(base::State *state);
+            /** \brief Construct a milestone for a given state (\e state) and store it in the nearest neighbors data structure.
+                The work done is counted in \e stats, so that each thread of solve() can keep its own statistics. */
+            virtual Vertex addMilestone(base::State *state, base::PlannerStatistics &stats);
+
+            /** \brief Set the expansion weight of milestone \e v from its connection attempts, adding \e v to the expansion distribution if needed. The caller must hold graphMutex_ */
+            void updateExpansionWeight(Vertex v);
 
             /** \brief Make two milestones (\e m1 and \e m2) be part of the same connected component. The component with fewer elements will get the id of the component with more elements. */
             void uniteComponents(Vertex m1, Vertex m2);
@@ -284,8 +289,8 @@ namespace ompl
                 expansion step) */
             void expandRoadmap(const base::PlannerTerminationCondition &ptc, std::vector<base::State*> &workStates);
 
-            /** Thread that checks for solution */
-            void checkForSolution (const base::PlannerTerminationCondition &ptc, base::PathPtr &solution);
+            /** Thread that checks for solution; the work it does is counted in \e stats */
+            void checkForSolution (const base::PlannerTerminationCondition &ptc, base::PathPtr &solution, base::PlannerStatistics &stats);
 
             /** \brief Check if there exists a solution, i.e., there exists a pair of milestones such that the first is in \e start and the second is in \e goal, and the two milestones are in the same connected component. If a solution is found, the path is saved. */
             bool haveSolution(const std::vector<Vertex> &start, const std::vector<Vertex> &goal, base::PathPtr &solution);
@@ -340,6 +345,13 @@ namespace ompl
                 boost::property_map<Graph, boost::vertex_predecessor_t>::type >
                                                                    disjointSets_;
 
+            /** \brief Distribution over the milestones used to select where to expand the roadmap. It is kept up to date as
+                connection attempts are made, so expandRoadmap() does not need to rebuild it */
+            PDF<Vertex, PDFFenwickTree>                            expansionPDF_;
+
+            /** \brief The element of expansionPDF_ corresponding to each milestone */
+            std::vector<PDF<Vertex, PDFFenwickTree>::Element*>     expansionElements_;
+
             /** \brief Maximum unique id number used so for for edges */
             unsigned int                                           maxEdgeID_;
 
@@ -152,6 +152,8 @@ void ompl::geometric::PRM::freeMemory(void)
     foreach (Vertex v, boost::vertices(g_))
         si_->freeState(stateProperty_[v]);
     g_.clear();
+    expansionPDF_.clear();
+    expansionElements_.clear();
 }
 
 void ompl::geometric::PRM::expandRoadmap(double expandTime)
@@ -177,25 +179,28 @@ void ompl::geometric::PRM::expandRoadmap(const base::PlannerTerminationCondition
     // as indicated in
     //  "Probabilistic Roadmaps for Path Planning in High-Dimensional Configuration Spaces"
     //        Lydia E. Kavraki, Petr Svestka, Jean-Claude Latombe, and Mark H. Overmars
+    // The distribution is maintained incrementally by updateExpansionWeight()
 
-    PDF<Vertex> pdf;
-    foreach (Vertex v, boost::vertices(g_))
-    {
-        const unsigned int t = totalConnectionAttemptsProperty_[v];
-        pdf.add(v, (double)(t - successfulConnectionAttemptsProperty_[v]) / (double)t);
-    }
-
-    if (pdf.empty())
+    graphMutex_.lock();
+    const bool empty = expansionPDF_.empty();
+    graphMutex_.unlock();
+    if (empty)
         return;
 
     while (ptc() == false)
     {
-        Vertex v = pdf.sample(rng_.uniform01());
-        unsigned int s = si_->randomBounceMotion(simpleSampler_, stateProperty_[v], workStates.size(), workStates, false);
+        // milestones are also added by the thread checking for solutions, so the distribution is sampled under the lock
+        graphMutex_.lock();
+        Vertex v = expansionPDF_.sample(rng_.uniform01());
+        const base::State *start = stateProperty_[v];
+        graphMutex_.unlock();
+
+        unsigned int s = si_->randomBounceMotion(simpleSampler_, start, workStates.size(), workStates, false);
+        ++stats_.samples;
         if (s > 0)
         {
             s--;
-            Vertex last = addMilestone(si_->cloneState(workStates[s]));
+            Vertex last = addMilestone(si_->cloneState(workStates[s]), stats_);
 
             graphMutex_.lock();
             for (unsigned int i = 0 ; i < s ; ++i)
@@ -206,6 +211,7 @@ void ompl::geometric::PRM::expandRoadmap(const base::PlannerTerminationCondition
                 totalConnectionAttemptsProperty_[m] = 1;
                 successfulConnectionAttemptsProperty_[m] = 0;
                 disjointSets_.make_set(m);
+                updateExpansionWeight(m);
 
                 // add the edge to the parent vertex
                 const double weight = distanceFunction(v, m);
@@ -266,17 +272,19 @@ void ompl::geometric::PRM::growRoadmap(const base::PlannerTerminationCondition &
             {
                 found = sampler_->sample(workState);
                 attempts++;
+                ++stats_.samples;
             } while (attempts < magic::FIND_VALID_STATE_ATTEMPTS_WITHOUT_TIME_CHECK && !found);
         }
         // add it as a milestone
         if (found)
-            addMilestone(si_->cloneState(workState));
+            addMilestone(si_->cloneState(workState), stats_);
     }
 }
 
 void ompl::geometric::PRM::checkForSolution (const base::PlannerTerminationCondition &ptc,
-                                             base::PathPtr &solution)
+                                             base::PathPtr &solution, base::PlannerStatistics &stats)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats);
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
     while (!ptc() && !addedSolution_)
     {
@@ -285,7 +293,7 @@ void ompl::geometric::PRM::checkForSolution (const base::PlannerTerminationCondi
         {
             const base::State *st = pis_.nextGoal();
             if (st)
-                goalM_.push_back(addMilestone(si_->cloneState(st)));
+                goalM_.push_back(addMilestone(si_->cloneState(st), stats));
         }
 
         // Check for a solution
@@ -352,6 +360,7 @@ bool ompl::geometric::PRM::addedNewSolution(void) const
 
 ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -363,7 +372,7 @@ ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTermina
 
     // Add the valid start states as milestones
     while (const base::State *st = pis_.nextStart())
-        startM_.push_back(addMilestone(si_->cloneState(st)));
+        startM_.push_back(addMilestone(si_->cloneState(st), stats_));
 
     if (startM_.size() == 0)
     {
@@ -382,7 +391,7 @@ ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTermina
     {
         const base::State *st = goalM_.empty() ? pis_.nextGoal(ptc) : pis_.nextGoal();
         if (st)
-            goalM_.push_back(addMilestone(si_->cloneState(st)));
+            goalM_.push_back(addMilestone(si_->cloneState(st), stats_));
 
         if (goalM_.empty())
         {
@@ -407,7 +416,10 @@ ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTermina
     addedSolution_ = false;
     base::PathPtr sol;
     sol.reset();
-    boost::thread slnThread (boost::bind(&PRM::checkForSolution, this, ptc, boost::ref(sol)));
+    // the solution thread counts its work separately, since this thread keeps updating stats_
+    base::PlannerStatistics slnStats;
+    slnStats.setTiming(stats_.isTiming());
+    boost::thread slnThread (boost::bind(&PRM::checkForSolution, this, ptc, boost::ref(sol), boost::ref(slnStats)));
 
     // construct new planner termination condition that fires when the given ptc is true, or a solution is found
     base::PlannerOrTerminationCondition ptcOrSolutionFound (ptc, base::PlannerTerminationCondition(boost::bind(&PRM::addedNewSolution, this)));
@@ -426,6 +438,8 @@ ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTermina
     // Ensure slnThread is ceased before exiting solve
     slnThread.join();
 
+    stats_.add(slnStats);
+    stats_.graphStates = boost::num_vertices(g_);
     logInform("Created %u states", boost::num_vertices(g_) - nrStartStates);
 
     if (sol)
@@ -443,7 +457,7 @@ ompl::base::PlannerStatus ompl::geometric::PRM::solve(const base::PlannerTermina
     return sol ? (addedNewSolution() ? base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::APPROXIMATE_SOLUTION) : base::PlannerStatus::TIMEOUT;
 }
 
-ompl::geometric::PRM::Vertex ompl::geometric::PRM::addMilestone(base::State *state)
+ompl::geometric::PRM::Vertex ompl::geometric::PRM::addMilestone(base::State *state, base::PlannerStatistics &stats)
 {
     graphMutex_.lock();
     Vertex m = boost::add_vertex(g_);
@@ -459,14 +473,23 @@ ompl::geometric::PRM::Vertex ompl::geometric::PRM::addMilestone(base::State *sta
     if (!connectionStrategy_)
         throw Exception(name_, "No connection strategy!");
 
-    const std::vector<Vertex>& neighbors = connectionStrategy_(m);
+    const std::vector<Vertex> *neighbors;
+    {
+        base::PlannerStatistics::Timer timer(stats.nnQueries);
+        neighbors = &connectionStrategy_(m);
+    }
 
-    foreach (Vertex n, neighbors)
+    foreach (Vertex n, *neighbors)
         if ((boost::same_component(m, n, disjointSets_) || connectionFilter_(m, n)))
         {
             totalConnectionAttemptsProperty_[m]++;
             totalConnectionAttemptsProperty_[n]++;
-            if (si_->checkMotion(stateProperty_[m], stateProperty_[n]))
+            bool valid;
+            {
+                base::PlannerStatistics::Timer timer(stats.motionChecks);
+                valid = si_->checkMotion(stateProperty_[m], stateProperty_[n]);
+            }
+            if (valid)
             {
                 successfulConnectionAttemptsProperty_[m]++;
                 successfulConnectionAttemptsProperty_[n]++;
@@ -479,12 +502,32 @@ ompl::geometric::PRM::Vertex ompl::geometric::PRM::addMilestone(base::State *sta
                 uniteComponents(n, m);
                 graphMutex_.unlock();
             }
+            graphMutex_.lock();
+            updateExpansionWeight(n);
+            graphMutex_.unlock();
         }
 
+    graphMutex_.lock();
+    updateExpansionWeight(m);
+    graphMutex_.unlock();
     nn_->add(m);
     return m;
 }
 
+void ompl::geometric::PRM::updateExpansionWeight(Vertex v)
+{
+    const unsigned int t = totalConnectionAttemptsProperty_[v];
+    const double w = (double)(t - successfulConnectionAttemptsProperty_[v]) / (double)t;
+
+    // milestones may enter the distribution out of index order when both planning threads add them
+    if (v >= expansionElements_.size())
+        expansionElements_.resize(v + 1, NULL);
+    if (expansionElements_[v])
+        expansionPDF_.update(expansionElements_[v], w);
+    else
+        expansionElements_[v] = expansionPDF_.add(v, w);
+}
+
 void ompl::geometric::PRM::uniteComponents(Vertex m1, Vertex m2)
 {
     disjointSets_.union_set(m1, m2);
@@ -113,6 +113,32 @@ namespace ompl
                 return maxDistance_;
             }
 
+            /** \brief Keep the tree of motions when the planner is
+                cleared, so that replanning is incremental.
+
+                When solve() receives a new start state (after
+                clear() or a change of problem definition), the tree
+                is re-rooted at that state: the state is connected to
+                one of its nearest motions, the path from there to the
+                previous root is reversed (motions are assumed to be
+                reversible) and the motions no longer connected to the
+                new root are removed. The validity checker may have
+                changed, so the motions that are kept are validated
+                again lazily, when they are first extended; a motion
+                found invalid is removed together with the motions
+                below it. Kept motions that satisfy the goal are
+                considered before any new sample is drawn. */
+            void setTreeReuse(bool flag)
+            {
+                treeReuse_ = flag;
+            }
+
+            /** \brief Return true if the tree of motions is kept when the planner is cleared */
+            bool getTreeReuse(void) const
+            {
+                return treeReuse_;
+            }
+
             /** \brief Set a different nearest neighbors datastructure */
             template<template<typename T> class NN>
             void setNearestNeighbors(void)
@@ -133,12 +159,12 @@ namespace ompl
             {
             public:
 
-                Motion(void) : state(NULL), parent(NULL)
+                Motion(void) : state(NULL), parent(NULL), checked(true), pruned(false)
                 {
                 }
 
                 /** \brief Constructor that allocates memory for the state */
-                Motion(const base::SpaceInformationPtr &si) : state(si->allocState()), parent(NULL)
+                Motion(const base::SpaceInformationPtr &si) : state(si->allocState()), parent(NULL), checked(true), pruned(false)
                 {
                 }
 
@@ -152,11 +178,25 @@ namespace ompl
                 /** \brief The parent motion in the exploration tree */
                 Motion            *parent;
 
+                /** \brief True if the motion from the parent is known to be valid; false for motions kept from a previous
+                    tree that have not been validated again yet */
+                bool               checked;
+
+                /** \brief True if the motion was found invalid and removed from the tree */
+                bool               pruned;
+
             };
 
             /** \brief Free the memory allocated by this planner */
             void freeMemory(void);
 
+            /** \brief Re-root the tree of motions at state \e st, removing the motions no longer connected to it */
+            void rerootTree(const base::State *st);
+
+            /** \brief Validate the motions from \e motion up to the first validated ancestor. If one is invalid, it is
+                removed together with the motions below it on this branch, and false is returned. */
+            bool validateBranch(Motion *motion);
+
             /** \brief Compute distance between motions (actually distance between contained states) */
             double distanceFunction(const Motion* a, const Motion* b) const
             {
@@ -180,6 +220,13 @@ namespace ompl
 
             /** \brief The most recent goal motion.  Used for PlannerData computation */
             Motion                                         *lastGoalMotion_;
+
+            /** \brief Flag indicating whether the tree of motions is kept when the planner is cleared */
+            bool                                           treeReuse_;
+
+            /** \brief Motions removed from the tree during lazy validation. Motions below them may still point to them,
+                so they are freed only when the tree is re-rooted or its memory is freed. */
+            std::vector<Motion*>                           pruned_;
         };
 
     }
@@ -89,6 +89,32 @@ namespace ompl
                 return maxDistance_;
             }
 
+            /** \brief Keep the trees of motions when the planner is
+                cleared, so that replanning is incremental.
+
+                When solve() receives a new start state (after
+                clear() or a change of problem definition), the start
+                tree is re-rooted at that state; the goal tree is
+                re-rooted in the same way at the first new goal
+                state. Re-rooting connects the new root to one of its
+                nearest motions, reverses the path from there to the
+                previous root (motions are assumed to be reversible)
+                and removes the motions no longer connected to the new
+                root. The validity checker may have changed, so the
+                motions that are kept are validated again lazily, when
+                they are first extended; a motion found invalid is
+                removed together with the motions below it. */
+            void setTreeReuse(bool flag)
+            {
+                treeReuse_ = flag;
+            }
+
+            /** \brief Return true if the trees of motions are kept when the planner is cleared */
+            bool getTreeReuse(void) const
+            {
+                return treeReuse_;
+            }
+
             /** \brief Set a different nearest neighbors datastructure */
             template<template<typename T> class NN>
             void setNearestNeighbors(void)
@@ -106,13 +132,13 @@ namespace ompl
             {
             public:
 
-                Motion(void) : root(NULL), state(NULL), parent(NULL)
+                Motion(void) : root(NULL), state(NULL), parent(NULL), checked(true), pruned(false)
                 {
                     parent = NULL;
                     state  = NULL;
                 }
 
-                Motion(const base::SpaceInformationPtr &si) : root(NULL), state(si->allocState()), parent(NULL)
+                Motion(const base::SpaceInformationPtr &si) : root(NULL), state(si->allocState()), parent(NULL), checked(true), pruned(false)
                 {
                 }
 
@@ -124,6 +150,13 @@ namespace ompl
                 base::State       *state;
                 Motion            *parent;
 
+                /** \brief True if the motion from the parent is known to be valid; false for motions kept from a previous
+                    tree that have not been validated again yet */
+                bool               checked;
+
+                /** \brief True if the motion was found invalid and removed from its tree */
+                bool               pruned;
+
             };
 
             /** \brief A nearest-neighbor datastructure representing a tree of motions */
@@ -151,6 +184,13 @@ namespace ompl
             /** \brief Free the memory allocated by this planner */
             void freeMemory(void);
 
+            /** \brief Re-root \e tree at state \e st, removing the motions no longer connected to it */
+            void rerootTree(TreeData &tree, const base::State *st);
+
+            /** \brief Validate the motions from \e motion up to the first validated ancestor. If one is invalid, it is
+                removed from \e tree together with the motions below it on this branch, and false is returned. */
+            bool validateBranch(TreeData &tree, Motion *motion);
+
             /** \brief Compute distance between motions (actually distance between contained states) */
             double distanceFunction(const Motion* a, const Motion* b) const
             {
@@ -177,6 +217,16 @@ namespace ompl
 
             /** \brief The pair of states in each tree connected during planning.  Used for PlannerData computation */
             std::pair<base::State*, base::State*>      connectionPoint_;
+
+            /** \brief Flag indicating whether the trees of motions are kept when the planner is cleared */
+            bool                          treeReuse_;
+
+            /** \brief Motions removed from the start tree during lazy validation. Motions below them may still point to
+                them, so they are freed only when the start tree is re-rooted or the memory of the planner is freed. */
+            std::vector<Motion*>          prunedStart_;
+
+            /** \brief Motions removed from the goal tree during lazy validation */
+            std::vector<Motion*>          prunedGoal_;
         };
 
     }
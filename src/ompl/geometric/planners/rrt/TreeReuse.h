@@ -0,0 +1,228 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_GEOMETRIC_PLANNERS_RRT_TREE_REUSE_
+#define OMPL_GEOMETRIC_PLANNERS_RRT_TREE_REUSE_
+
+#include "ompl/base/SpaceInformation.h"
+#include "ompl/base/PlannerStatistics.h"
+#include "ompl/datastructures/NearestNeighbors.h"
+#include "ompl/tools/config/MagicConstants.h"
+#include "ompl/util/Console.h"
+#include <vector>
+#include <map>
+
+namespace ompl
+{
+    namespace geometric
+    {
+
+        /** \brief The planner-specific steps of re-rooting a tree
+            of motions and validating its branches. The default
+            implementation does nothing; planners that keep more
+            information in their motions than the parent pointer and
+            the \e checked and \e pruned flags derive from it. */
+        template<typename Motion>
+        struct TreeReuseHooks
+        {
+            /** \brief Called for every motion kept when the tree is re-rooted at \e root (including \e root itself) */
+            void kept(Motion * /* motion */, Motion * /* root */)
+            {
+            }
+
+            /** \brief Called once the tree is re-rooted; \e keep contains the motions in the tree, the new root first */
+            void rerooted(const std::vector<Motion*> & /* keep */)
+            {
+            }
+
+            /** \brief Called when the branch below \e motion, which is invalid or was already pruned, is disconnected from its parent */
+            void disconnected(Motion * /* motion */)
+            {
+            }
+        };
+
+        /** \brief Re-root the tree of motions in \e nn at state \e
+            st. The new root is connected to one of its nearest
+            motions that is still connected to the previous root, the
+            path from that motion to the previous root is reversed
+            (motions are assumed to be reversible) and the motions no
+            longer connected to the new root are freed, together with
+            the motions in \e pruned. The kept motions are marked as
+            not validated, so validateMotionBranch() checks them
+            again when they are used. \e name describes the tree in
+            the log message. */
+        template<typename Motion, typename Hooks>
+        void rerootMotionTree(const base::SpaceInformationPtr &si, NearestNeighbors<Motion*> &nn, std::vector<Motion*> &pruned,
+                              const base::State *st, Hooks &hooks, const char *name)
+        {
+            Motion *root = new Motion(si);
+            si->copyState(root->state, st);
+
+            // connect the new root to one of its nearest motions that is still connected to a root
+            std::vector<Motion*> nbh;
+            nn.nearestK(root, magic::TREE_REUSE_ATTACH_ATTEMPTS, nbh);
+            Motion *attach = NULL;
+            for (std::size_t i = 0 ; i < nbh.size() && !attach ; ++i)
+            {
+                bool connected = true;
+                for (Motion *m = nbh[i] ; m && connected ; m = m->parent)
+                    connected = !m->pruned;
+                if (connected && si->checkMotion(root->state, nbh[i]->state))
+                    attach = nbh[i];
+            }
+
+            // reverse the path from the attachment point to the previous root
+            Motion *prev = root;
+            for (Motion *m = attach ; m ; )
+            {
+                Motion *next = m->parent;
+                m->parent = prev;
+                prev = m;
+                m = next;
+            }
+
+            // keep the motions that lead to the new root, without validating them yet
+            std::vector<Motion*> motions;
+            nn.list(motions);
+            std::map<Motion*, bool> reaches;
+            reaches[root] = true;
+            std::vector<Motion*> keep(1, root);
+            hooks.kept(root, root);
+            std::vector<Motion*> branch;
+            for (std::size_t i = 0 ; i < motions.size() ; ++i)
+            {
+                branch.clear();
+                bool result = false;
+                for (Motion *m = motions[i] ; m && !m->pruned ; m = m->parent)
+                {
+                    typename std::map<Motion*, bool>::const_iterator it = reaches.find(m);
+                    if (it != reaches.end())
+                    {
+                        result = it->second;
+                        break;
+                    }
+                    branch.push_back(m);
+                }
+                for (std::size_t j = 0 ; j < branch.size() ; ++j)
+                    reaches[branch[j]] = result;
+                if (result)
+                {
+                    motions[i]->checked = false;
+                    hooks.kept(motions[i], root);
+                    keep.push_back(motions[i]);
+                }
+            }
+            if (attach)
+                attach->checked = true;
+
+            for (std::size_t i = 0 ; i < motions.size() ; ++i)
+                if (!reaches[motions[i]])
+                {
+                    si->freeState(motions[i]->state);
+                    delete motions[i];
+                }
+            for (std::size_t i = 0 ; i < pruned.size() ; ++i)
+            {
+                si->freeState(pruned[i]->state);
+                delete pruned[i];
+            }
+            pruned.clear();
+
+            hooks.rerooted(keep);
+
+            nn.clear();
+            nn.add(keep);
+            logInform("Reusing %u of %u states from the previous %s", (unsigned int)keep.size() - 1, (unsigned int)motions.size(), name);
+        }
+
+        /** \brief Validate the motions from \e motion up to the
+            first motion already validated, top-down. If a motion is
+            found to be invalid, it and the motions below it on the
+            branch are removed from \e nn and appended to \e pruned,
+            since other motions may still point to them. The motion
+            checks are counted in \e stats. Return true if the branch
+            is connected to the root. */
+        template<typename Motion, typename Hooks>
+        bool validateMotionBranch(const base::SpaceInformationPtr &si, NearestNeighbors<Motion*> &nn, std::vector<Motion*> &pruned,
+                                  Motion *motion, Hooks &hooks, base::PlannerStatistics &stats)
+        {
+            // the motions that have not been validated yet, bottom-up; the root is always validated
+            std::vector<Motion*> branch;
+            for (Motion *m = motion ; !m->checked ; m = m->parent)
+            {
+                branch.push_back(m);
+                if (m->pruned)
+                    break;
+            }
+            if (branch.empty())
+                return true;
+
+            // validate top-down, so that the parent of every checked motion is valid
+            std::size_t invalid = branch.size();
+            if (branch.back()->pruned)
+                invalid = branch.size() - 1;
+            else
+                for (std::size_t i = branch.size() ; i-- > 0 ; )
+                {
+                    bool valid;
+                    {
+                        base::PlannerStatistics::Timer timer(stats.motionChecks);
+                        valid = si->checkMotion(branch[i]->parent->state, branch[i]->state);
+                    }
+                    if (!valid)
+                    {
+                        invalid = i;
+                        break;
+                    }
+                    branch[i]->checked = true;
+                }
+            if (invalid == branch.size())
+                return true;
+
+            // the rest of the branch is no longer connected to the root
+            hooks.disconnected(branch[invalid]);
+            for (std::size_t i = 0 ; i <= invalid ; ++i)
+                if (!branch[i]->pruned)
+                {
+                    nn.remove(branch[i]);
+                    branch[i]->pruned = true;
+                    pruned.push_back(branch[i]);
+                }
+            return false;
+        }
+
+    }
+}
+
+#endif
@@ -162,7 +162,7 @@ namespace ompl
                 boost::mutex lock;
             };
 
-            void threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol);
+            void threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol, boost::uint32_t seed);
             void freeMemory(void);
 
             double distanceFunction(const Motion* a, const Motion* b) const
@@ -176,6 +176,9 @@ namespace ompl
 
             unsigned int                                        threadCount_;
 
+            /** \brief The random number generator used to seed the per-thread random streams */
+            RNG                                                 rng_;
+
             double                                              goalBias_;
             double                                              maxDistance_;
 
@@ -94,6 +94,7 @@ void ompl::geometric::LazyRRT::freeMemory(void)
 
 ompl::base::PlannerStatus ompl::geometric::LazyRRT::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                 *goal   = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
@@ -132,9 +133,14 @@ ompl::base::PlannerStatus ompl::geometric::LazyRRT::solve(const base::PlannerTer
             goal_s->sampleGoal(rstate);
         else
             sampler_->sampleUniform(rstate);
+        ++stats_.samples;
 
         /* find closest state in the tree */
-        Motion *nmotion = nn_->nearest(rmotion);
+        Motion *nmotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
         assert(nmotion != rmotion);
         base::State *dstate = rstate;
 
@@ -175,7 +181,12 @@ ompl::base::PlannerStatus ompl::geometric::LazyRRT::solve(const base::PlannerTer
             for (int i = mpath.size() - 1 ; i >= 0 && solutionFound; --i)
                 if (!mpath[i]->valid)
                 {
-                    if (si_->checkMotion(mpath[i]->parent->state, mpath[i]->state))
+                    bool valid;
+                    {
+                        base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                        valid = si_->checkMotion(mpath[i]->parent->state, mpath[i]->state);
+                    }
+                    if (valid)
                         mpath[i]->valid = true;
                     else
                     {
@@ -200,6 +211,7 @@ ompl::base::PlannerStatus ompl::geometric::LazyRRT::solve(const base::PlannerTer
     si_->freeState(rstate);
     delete rmotion;
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states", nn_->size());
 
     return solutionFound ?  base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::TIMEOUT;
@@ -37,6 +37,7 @@
 #include "ompl/geometric/planners/rrt/RRT.h"
 #include "ompl/base/goals/GoalSampleableRegion.h"
 #include "ompl/datastructures/NearestNeighborsGNAT.h"
+#include "ompl/geometric/planners/rrt/TreeReuse.h"
 #include "ompl/tools/config/SelfConfig.h"
 #include <limits>
 
@@ -48,9 +49,11 @@ ompl::geometric::RRT::RRT(const base::SpaceInformationPtr &si) : base::Planner(s
     goalBias_ = 0.05;
     maxDistance_ = 0.0;
     lastGoalMotion_ = NULL;
+    treeReuse_ = false;
 
     Planner::declareParam<double>("range", this, &RRT::setRange, &RRT::getRange);
     Planner::declareParam<double>("goal_bias", this, &RRT::setGoalBias, &RRT::getGoalBias);
+    Planner::declareParam<bool>("tree_reuse", this, &RRT::setTreeReuse, &RRT::getTreeReuse);
 }
 
 ompl::geometric::RRT::~RRT(void)
@@ -62,9 +65,12 @@ void ompl::geometric::RRT::clear(void)
 {
     Planner::clear();
     sampler_.reset();
-    freeMemory();
-    if (nn_)
-        nn_->clear();
+    if (!treeReuse_)
+    {
+        freeMemory();
+        if (nn_)
+            nn_->clear();
+    }
     lastGoalMotion_ = NULL;
 }
 
@@ -92,16 +98,42 @@ void ompl::geometric::RRT::freeMemory(void)
             delete motions[i];
         }
     }
+    for (unsigned int i = 0 ; i < pruned_.size() ; ++i)
+    {
+        si_->freeState(pruned_[i]->state);
+        delete pruned_[i];
+    }
+    pruned_.clear();
+}
+
+void ompl::geometric::RRT::rerootTree(const base::State *st)
+{
+    TreeReuseHooks<Motion> hooks;
+    rerootMotionTree(si_, *nn_, pruned_, st, hooks, "tree");
+}
+
+bool ompl::geometric::RRT::validateBranch(Motion *motion)
+{
+    TreeReuseHooks<Motion> hooks;
+    return validateMotionBranch(si_, *nn_, pruned_, motion, hooks, stats_);
 }
 
 ompl::base::PlannerStatus ompl::geometric::RRT::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::Goal                 *goal   = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
 
+    bool rerooted = false;
     while (const base::State *st = pis_.nextStart())
     {
+        if (treeReuse_ && !rerooted && nn_->size() > 0)
+        {
+            rerootTree(st);
+            rerooted = true;
+            continue;
+        }
         Motion *motion = new Motion(si_);
         si_->copyState(motion->state, st);
         nn_->add(motion);
@@ -125,7 +157,20 @@ ompl::base::PlannerStatus ompl::geometric::RRT::solve(const base::PlannerTermina
     base::State *rstate = rmotion->state;
     base::State *xstate = si_->allocState();
 
-    while (ptc() == false)
+    /* the reused tree may already reach the goal */
+    if (rerooted)
+    {
+        std::vector<Motion*> motions;
+        nn_->list(motions);
+        for (std::size_t i = 0 ; i < motions.size() && !solution ; ++i)
+            if (!motions[i]->pruned && goal->isSatisfied(motions[i]->state) && validateBranch(motions[i]))
+            {
+                approxdif = 0.0;
+                solution = motions[i];
+            }
+    }
+
+    while (solution == NULL && ptc() == false)
     {
 
         /* sample random state (with goal biasing) */
@@ -133,9 +178,16 @@ ompl::base::PlannerStatus ompl::geometric::RRT::solve(const base::PlannerTermina
             goal_s->sampleGoal(rstate);
         else
             sampler_->sampleUniform(rstate);
+        ++stats_.samples;
 
         /* find closest state in the tree */
-        Motion *nmotion = nn_->nearest(rmotion);
+        Motion *nmotion;
+        {
+            base::PlannerStatistics::Timer timer(stats_.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
+        if (!nmotion->checked && !validateBranch(nmotion))
+            continue;
         base::State *dstate = rstate;
 
         /* find state to add */
@@ -146,7 +198,13 @@ ompl::base::PlannerStatus ompl::geometric::RRT::solve(const base::PlannerTermina
             dstate = xstate;
         }
 
-        if (si_->checkMotion(nmotion->state, dstate))
+        bool valid;
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            valid = si_->checkMotion(nmotion->state, dstate);
+        }
+
+        if (valid)
         {
             /* create a motion */
             Motion *motion = new Motion(si_);
@@ -203,6 +261,7 @@ ompl::base::PlannerStatus ompl::geometric::RRT::solve(const base::PlannerTermina
         si_->freeState(rmotion->state);
     delete rmotion;
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states", nn_->size());
 
     return base::PlannerStatus(solved, approximate);
@@ -37,16 +37,32 @@
 #include "ompl/geometric/planners/rrt/RRTConnect.h"
 #include "ompl/datastructures/NearestNeighborsGNAT.h"
 #include "ompl/base/goals/GoalSampleableRegion.h"
+#include "ompl/geometric/planners/rrt/TreeReuse.h"
 #include "ompl/tools/config/SelfConfig.h"
 
+namespace
+{
+    // every motion of a re-rooted tree records the state at the root of its tree
+    template<typename Motion>
+    struct RootHooks : public ompl::geometric::TreeReuseHooks<Motion>
+    {
+        void kept(Motion *motion, Motion *root)
+        {
+            motion->root = root->state;
+        }
+    };
+}
+
 ompl::geometric::RRTConnect::RRTConnect(const base::SpaceInformationPtr &si) : base::Planner(si, "RRTConnect")
 {
     specs_.recognizedGoal = base::GOAL_SAMPLEABLE_REGION;
     specs_.directed = true;
 
     maxDistance_ = 0.0;
+    treeReuse_ = false;
 
     Planner::declareParam<double>("range", this, &RRTConnect::setRange, &RRTConnect::getRange);
+    Planner::declareParam<bool>("tree_reuse", this, &RRTConnect::setTreeReuse, &RRTConnect::getTreeReuse);
     connectionPoint_ = std::make_pair<base::State*, base::State*>(NULL, NULL);
 }
 
@@ -94,24 +110,60 @@ void ompl::geometric::RRTConnect::freeMemory(void)
             delete motions[i];
         }
     }
+
+    for (unsigned int i = 0 ; i < prunedStart_.size() ; ++i)
+    {
+        si_->freeState(prunedStart_[i]->state);
+        delete prunedStart_[i];
+    }
+    prunedStart_.clear();
+
+    for (unsigned int i = 0 ; i < prunedGoal_.size() ; ++i)
+    {
+        si_->freeState(prunedGoal_[i]->state);
+        delete prunedGoal_[i];
+    }
+    prunedGoal_.clear();
 }
 
 void ompl::geometric::RRTConnect::clear(void)
 {
     Planner::clear();
     sampler_.reset();
-    freeMemory();
-    if (tStart_)
-        tStart_->clear();
-    if (tGoal_)
-        tGoal_->clear();
+    if (!treeReuse_)
+    {
+        freeMemory();
+        if (tStart_)
+            tStart_->clear();
+        if (tGoal_)
+            tGoal_->clear();
+    }
     connectionPoint_ = std::make_pair<base::State*, base::State*>(NULL, NULL);
 }
 
+void ompl::geometric::RRTConnect::rerootTree(TreeData &tree, const base::State *st)
+{
+    RootHooks<Motion> hooks;
+    // motions of the other tree may only point to motions pruned from their own tree
+    rerootMotionTree(si_, *tree, tree == tStart_ ? prunedStart_ : prunedGoal_, st, hooks, tree == tStart_ ? "start tree" : "goal tree");
+}
+
+bool ompl::geometric::RRTConnect::validateBranch(TreeData &tree, Motion *motion)
+{
+    RootHooks<Motion> hooks;
+    return validateMotionBranch(si_, *tree, tree == tStart_ ? prunedStart_ : prunedGoal_, motion, hooks, stats_);
+}
+
 ompl::geometric::RRTConnect::GrowState ompl::geometric::RRTConnect::growTree(TreeData &tree, TreeGrowingInfo &tgi, Motion *rmotion)
 {
     /* find closest state in the tree */
-    Motion *nmotion = tree->nearest(rmotion);
+    Motion *nmotion;
+    {
+        base::PlannerStatistics::Timer timer(stats_.nnQueries);
+        nmotion = tree->nearest(rmotion);
+    }
+    if (!nmotion->checked && !validateBranch(tree, nmotion))
+        return TRAPPED;
 
     /* assume we can reach the state we go towards */
     bool reach = true;
@@ -128,7 +180,21 @@ ompl::geometric::RRTConnect::GrowState ompl::geometric::RRTConnect::growTree(Tre
     // if we are in the start tree, we just check the motion like we normally do;
     // if we are in the goal tree, we need to check the motion in reverse, but checkMotion() assumes the first state it receives as argument is valid,
     // so we check that one first
-    bool validMotion = tgi.start ? si_->checkMotion(nmotion->state, dstate) : si_->getStateValidityChecker()->isValid(dstate) && si_->checkMotion(dstate, nmotion->state);
+    bool validMotion;
+    if (tgi.start)
+    {
+        base::PlannerStatistics::Timer timer(stats_.motionChecks);
+        validMotion = si_->checkMotion(nmotion->state, dstate);
+    }
+    else
+    {
+        validMotion = si_->isValid(dstate);
+        if (validMotion)
+        {
+            base::PlannerStatistics::Timer timer(stats_.motionChecks);
+            validMotion = si_->checkMotion(dstate, nmotion->state);
+        }
+    }
 
     if (validMotion)
     {
@@ -151,6 +217,7 @@ ompl::geometric::RRTConnect::GrowState ompl::geometric::RRTConnect::growTree(Tre
 
 ompl::base::PlannerStatus ompl::geometric::RRTConnect::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -160,8 +227,15 @@ ompl::base::PlannerStatus ompl::geometric::RRTConnect::solve(const base::Planner
         return base::PlannerStatus::UNRECOGNIZED_GOAL_TYPE;
     }
 
+    bool rerooted = false;
     while (const base::State *st = pis_.nextStart())
     {
+        if (treeReuse_ && !rerooted && tStart_->size() > 0)
+        {
+            rerootTree(tStart_, st);
+            rerooted = true;
+            continue;
+        }
         Motion *motion = new Motion(si_);
         si_->copyState(motion->state, st);
         motion->root = motion->state;
@@ -180,6 +254,27 @@ ompl::base::PlannerStatus ompl::geometric::RRTConnect::solve(const base::Planner
         return base::PlannerStatus::INVALID_GOAL;
     }
 
+    // a reused goal tree is re-rooted at the first goal state of the current problem; its previous roots may no
+    // longer be goal states, so without a new goal state the tree is discarded
+    if (treeReuse_ && tGoal_->size() > 0 && pis_.getSampledGoalsCount() == 0)
+    {
+        if (const base::State *st = pis_.nextGoal(ptc))
+            rerootTree(tGoal_, st);
+        else
+        {
+            std::vector<Motion*> motions;
+            tGoal_->list(motions);
+            motions.insert(motions.end(), prunedGoal_.begin(), prunedGoal_.end());
+            for (unsigned int i = 0 ; i < motions.size() ; ++i)
+            {
+                si_->freeState(motions[i]->state);
+                delete motions[i];
+            }
+            tGoal_->clear();
+            prunedGoal_.clear();
+        }
+    }
+
     if (!sampler_)
         sampler_ = si_->allocStateSampler();
 
@@ -220,6 +315,7 @@ ompl::base::PlannerStatus ompl::geometric::RRTConnect::solve(const base::Planner
 
         /* sample random state */
         sampler_->sampleUniform(rstate);
+        ++stats_.samples;
 
         GrowState gs = growTree(tree, tgi, rmotion);
 
@@ -290,6 +386,7 @@ ompl::base::PlannerStatus ompl::geometric::RRTConnect::solve(const base::Planner
     si_->freeState(rstate);
     delete rmotion;
 
+    stats_.graphStates = tStart_->size() + tGoal_->size();
     logInform("Created %u states (%u start + %u goal)", tStart_->size() + tGoal_->size(), tStart_->size(), tGoal_->size());
 
     return solved ? base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::TIMEOUT;
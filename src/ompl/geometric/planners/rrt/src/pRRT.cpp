@@ -99,12 +99,15 @@ void ompl::geometric::pRRT::freeMemory(void)
     }
 }
 
-void ompl::geometric::pRRT::threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol)
+void ompl::geometric::pRRT::threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol, boost::uint32_t seed)
 {
     checkValidity();
     base::Goal                 *goal   = pdef_->getGoal().get();
     base::GoalSampleableRegion *goal_s = dynamic_cast<base::GoalSampleableRegion*>(goal);
-    RNG                         rng;
+    RNG                         rng(seed, tid);
+    base::PlannerStatistics     stats;
+    stats.setTiming(stats_.isTiming());
+    base::PlannerStatistics::ThreadScope statsScope(stats);
 
     Motion *rmotion   = new Motion(si_);
     base::State *rstate = rmotion->state;
@@ -117,10 +120,15 @@ void ompl::geometric::pRRT::threadSolve(unsigned int tid, const base::PlannerTer
             goal_s->sampleGoal(rstate);
         else
             samplerArray_[tid]->sampleUniform(rstate);
+        ++stats.samples;
 
         /* find closest state in the tree */
+        Motion *nmotion;
         nnLock_.lock();
-        Motion *nmotion = nn_->nearest(rmotion);
+        {
+            base::PlannerStatistics::Timer timer(stats.nnQueries);
+            nmotion = nn_->nearest(rmotion);
+        }
         nnLock_.unlock();
         base::State *dstate = rstate;
 
@@ -132,7 +140,13 @@ void ompl::geometric::pRRT::threadSolve(unsigned int tid, const base::PlannerTer
             dstate = xstate;
         }
 
-        if (si_->checkMotion(nmotion->state, dstate))
+        bool valid;
+        {
+            base::PlannerStatistics::Timer timer(stats.motionChecks);
+            valid = si_->checkMotion(nmotion->state, dstate);
+        }
+
+        if (valid)
         {
             /* create a motion */
             Motion *motion = new Motion(si_);
@@ -170,10 +184,15 @@ void ompl::geometric::pRRT::threadSolve(unsigned int tid, const base::PlannerTer
     if (rmotion->state)
         si_->freeState(rmotion->state);
     delete rmotion;
+
+    sol->lock.lock();
+    stats_.add(stats);
+    sol->lock.unlock();
 }
 
 ompl::base::PlannerStatus ompl::geometric::pRRT::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     base::GoalRegion *goal = dynamic_cast<base::GoalRegion*>(pdef_->getGoal().get());
 
     if (!goal)
@@ -204,9 +223,13 @@ ompl::base::PlannerStatus ompl::geometric::pRRT::solve(const base::PlannerTermin
     sol.approxsol = NULL;
     sol.approxdif = std::numeric_limits<double>::infinity();
 
+    // every thread gets its own random stream, derived from a seed drawn
+    // here so that the streams do not depend on the order in which
+    // threads start
+    const boost::uint32_t seed = (boost::uint32_t)rng_.uniformInt(1, std::numeric_limits<int>::max());
     std::vector<boost::thread*> th(threadCount_);
     for (unsigned int i = 0 ; i < threadCount_ ; ++i)
-        th[i] = new boost::thread(boost::bind(&pRRT::threadSolve, this, i, ptc, &sol));
+        th[i] = new boost::thread(boost::bind(&pRRT::threadSolve, this, i, ptc, &sol, seed));
     for (unsigned int i = 0 ; i < threadCount_ ; ++i)
     {
         th[i]->join();
@@ -242,6 +265,7 @@ ompl::base::PlannerStatus ompl::geometric::pRRT::solve(const base::PlannerTermin
         solved = true;
     }
 
+    stats_.graphStates = nn_->size();
     logInform("Created %u states", nn_->size());
 
     return base::PlannerStatus(solved, approximate);
@@ -242,7 +242,7 @@ namespace ompl
                 boost::mutex                     lock;
             };
 
-            void threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol);
+            void threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol, boost::uint32_t seed);
 
             void freeMemory(void)
             {
@@ -255,8 +255,8 @@ namespace ompl
             void addMotion(TreeData &tree, Motion *motion);
             Motion* selectMotion(RNG &rng, TreeData &tree);
             void removeMotion(TreeData &tree, Motion *motion, std::map<Motion*, bool> &seen);
-            bool isPathValid(TreeData &tree, Motion *motion);
-            bool checkSolution(RNG &rng, bool start, TreeData &tree, TreeData &otherTree, Motion *motion, std::vector<Motion*> &solution);
+            bool isPathValid(TreeData &tree, Motion *motion, base::PlannerStatistics &stats);
+            bool checkSolution(RNG &rng, bool start, TreeData &tree, TreeData &otherTree, Motion *motion, std::vector<Motion*> &solution, base::PlannerStatistics &stats);
 
 
             base::StateSamplerArray<base::ValidStateSampler> samplerArray_;
@@ -274,6 +274,9 @@ namespace ompl
 
             unsigned int                                     threadCount_;
 
+            /** \brief The random number generator used to seed the per-thread random streams */
+            RNG                                              rng_;
+
             /** \brief The pair of states in each tree connected during planning.  Used for PlannerData computation */
             std::pair<base::State*, base::State*>            connectionPoint_;
         };
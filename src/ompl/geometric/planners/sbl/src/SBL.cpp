@@ -80,6 +80,7 @@ void ompl::geometric::SBL::freeGridMotions(Grid<MotionInfo> &grid)
 
 ompl::base::PlannerStatus ompl::geometric::SBL::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     checkValidity();
     base::GoalSampleableRegion *goal = dynamic_cast<base::GoalSampleableRegion*>(pdef_->getGoal().get());
 
@@ -150,6 +151,7 @@ ompl::base::PlannerStatus ompl::geometric::SBL::solve(const base::PlannerTermina
         assert(existing);
         if (!sampler_->sampleNear(xstate, existing->state, maxDistance_))
             continue;
+        ++stats_.samples;
 
         /* create a motion */
         Motion *motion = new Motion(si_);
@@ -174,6 +176,7 @@ ompl::base::PlannerStatus ompl::geometric::SBL::solve(const base::PlannerTermina
 
     si_->freeState(xstate);
 
+    stats_.graphStates = tStart_.size + tGoal_.size;
     logInform("Created %u (%u start + %u goal) states in %u cells (%u start + %u goal)", tStart_.size + tGoal_.size, tStart_.size, tGoal_.size,
                  tStart_.grid.size() + tGoal_.grid.size(), tStart_.grid.size(), tGoal_.grid.size());
 
@@ -252,7 +255,12 @@ bool ompl::geometric::SBL::isPathValid(TreeData &tree, Motion *motion)
     for (int i = mpath.size() - 1 ; i >= 0 ; --i)
         if (!mpath[i]->valid)
         {
-            if (si_->checkMotion(mpath[i]->parent->state, mpath[i]->state))
+            bool valid;
+            {
+                base::PlannerStatistics::Timer timer(stats_.motionChecks);
+                valid = si_->checkMotion(mpath[i]->parent->state, mpath[i]->state);
+            }
+            if (valid)
                 mpath[i]->valid = true;
             else
             {
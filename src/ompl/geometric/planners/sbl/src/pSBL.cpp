@@ -103,10 +103,13 @@ void ompl::geometric::pSBL::freeGridMotions(Grid<MotionInfo> &grid)
     }
 }
 
-void ompl::geometric::pSBL::threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol)
+void ompl::geometric::pSBL::threadSolve(unsigned int tid, const base::PlannerTerminationCondition &ptc, SolutionInfo *sol, boost::uint32_t seed)
 {
     checkValidity();
-    RNG              rng;
+    RNG              rng(seed, tid);
+    base::PlannerStatistics stats;
+    stats.setTiming(stats_.isTiming());
+    base::PlannerStatistics::ThreadScope statsScope(stats);
 
     std::vector<Motion*> solution;
     base::State *xstate = si_->allocState();
@@ -153,6 +156,7 @@ void ompl::geometric::pSBL::threadSolve(unsigned int tid, const base::PlannerTer
         Motion *existing = selectMotion(rng, tree);
         if (!samplerArray_[tid]->sampleNear(xstate, existing->state, maxDistance_))
             continue;
+        ++stats.samples;
 
         /* create a motion */
         Motion *motion = new Motion(si_);
@@ -166,7 +170,7 @@ void ompl::geometric::pSBL::threadSolve(unsigned int tid, const base::PlannerTer
 
         addMotion(tree, motion);
 
-        if (checkSolution(rng, !startTree, tree, otherTree, motion, solution))
+        if (checkSolution(rng, !startTree, tree, otherTree, motion, solution, stats))
         {
             sol->lock.lock();
             if (!sol->found)
@@ -189,10 +193,15 @@ void ompl::geometric::pSBL::threadSolve(unsigned int tid, const base::PlannerTer
     }
 
     si_->freeState(xstate);
+
+    sol->lock.lock();
+    stats_.add(stats);
+    sol->lock.unlock();
 }
 
 ompl::base::PlannerStatus ompl::geometric::pSBL::solve(const base::PlannerTerminationCondition &ptc)
 {
+    base::PlannerStatistics::ThreadScope statsScope(stats_);
     base::GoalState *goal = dynamic_cast<base::GoalState*>(pdef_->getGoal().get());
 
     if (!goal)
@@ -243,22 +252,27 @@ ompl::base::PlannerStatus ompl::geometric::pSBL::solve(const base::PlannerTermin
     sol.found = false;
     loopCounter_ = 0;
 
+    // every thread gets its own random stream, derived from a seed drawn
+    // here so that the streams do not depend on the order in which
+    // threads start
+    const boost::uint32_t seed = (boost::uint32_t)rng_.uniformInt(1, std::numeric_limits<int>::max());
     std::vector<boost::thread*> th(threadCount_);
     for (unsigned int i = 0 ; i < threadCount_ ; ++i)
-        th[i] = new boost::thread(boost::bind(&pSBL::threadSolve, this, i, ptc, &sol));
+        th[i] = new boost::thread(boost::bind(&pSBL::threadSolve, this, i, ptc, &sol, seed));
     for (unsigned int i = 0 ; i < threadCount_ ; ++i)
     {
         th[i]->join();
         delete th[i];
     }
 
+    stats_.graphStates = tStart_.size + tGoal_.size;
     logInform("Created %u (%u start + %u goal) states in %u cells (%u start + %u goal)", tStart_.size + tGoal_.size, tStart_.size, tGoal_.size,
              tStart_.grid.size() + tGoal_.grid.size(), tStart_.grid.size(), tGoal_.grid.size());
 
     return sol.found ? base::PlannerStatus::EXACT_SOLUTION : base::PlannerStatus::TIMEOUT;
 }
 
-bool ompl::geometric::pSBL::checkSolution(RNG &rng, bool start, TreeData &tree, TreeData &otherTree, Motion *motion, std::vector<Motion*> &solution)
+bool ompl::geometric::pSBL::checkSolution(RNG &rng, bool start, TreeData &tree, TreeData &otherTree, Motion *motion, std::vector<Motion*> &solution, base::PlannerStatistics &stats)
 {
     Grid<MotionInfo>::Coord coord;
     projectionEvaluator_->computeCoordinates(motion->state, coord);
@@ -285,7 +299,7 @@ bool ompl::geometric::pSBL::checkSolution(RNG &rng, bool start, TreeData &tree,
 
             addMotion(tree, connect);
 
-            if (isPathValid(tree, connect) && isPathValid(otherTree, connectOther))
+            if (isPathValid(tree, connect, stats) && isPathValid(otherTree, connectOther, stats))
             {
                 if (start)
                     connectionPoint_ = std::make_pair<base::State*, base::State*>(motion->state, connectOther->state);
@@ -325,7 +339,7 @@ bool ompl::geometric::pSBL::checkSolution(RNG &rng, bool start, TreeData &tree,
     return false;
 }
 
-bool ompl::geometric::pSBL::isPathValid(TreeData &tree, Motion *motion)
+bool ompl::geometric::pSBL::isPathValid(TreeData &tree, Motion *motion, base::PlannerStatistics &stats)
 {
     std::vector<Motion*> mpath;
 
@@ -344,7 +358,12 @@ bool ompl::geometric::pSBL::isPathValid(TreeData &tree, Motion *motion)
         mpath[i]->lock.lock();
         if (!mpath[i]->valid)
         {
-            if (si_->checkMotion(mpath[i]->parent->state, mpath[i]->state))
+            bool valid;
+            {
+                base::PlannerStatistics::Timer timer(stats.motionChecks);
+                valid = si_->checkMotion(mpath[i]->parent->state, mpath[i]->state);
+            }
+            if (valid)
                 mpath[i]->valid = true;
             else
             {
@@ -35,7 +35,13 @@
 /* Author: Ioan Sucan */
 
 #include "ompl/geometric/PathHybridization.h"
-#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include "ompl/datastructures/NearestNeighborsGNAT.h"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
 
 namespace ompl
 {
@@ -47,12 +53,11 @@ namespace ompl
 }
 
 ompl::geometric::PathHybridization::PathHybridization(const base::SpaceInformationPtr &si) :
-    si_(si), stateProperty_(boost::get(vertex_state_t(), g_))
+    si_(si), stateProperty_(boost::get(vertex_state_t(), g_)), threadCount_(1)
 {
-    root_ = boost::add_vertex(g_);
-    stateProperty_[root_] = NULL;
-    goal_ = boost::add_vertex(g_);
-    stateProperty_[goal_] = NULL;
+    nn_.reset(new NearestNeighborsGNAT<Vertex>());
+    nn_->setDistanceFunction(boost::bind(&PathHybridization::distanceFunction, this, _1, _2));
+    resetGraph();
 }
 
 ompl::geometric::PathHybridization::~PathHybridization(void)
@@ -63,12 +68,35 @@ void ompl::geometric::PathHybridization::clear(void)
 {
     hpath_.reset();
     paths_.clear();
+    resetGraph();
+}
 
+void ompl::geometric::PathHybridization::resetGraph(void)
+{
+    nn_->clear();
     g_.clear();
-    root_ = boost::add_vertex(g_);
-    stateProperty_[root_] = NULL;
-    goal_ = boost::add_vertex(g_);
-    stateProperty_[goal_] = NULL;
+    owner_.clear();
+    dist_.clear();
+    prev_.clear();
+    root_ = addVertex(NULL);
+    goal_ = addVertex(NULL);
+    dist_[root_] = 0.0;
+}
+
+ompl::geometric::PathHybridization::Vertex ompl::geometric::PathHybridization::addVertex(base::State *state)
+{
+    Vertex v = boost::add_vertex(g_);
+    stateProperty_[v] = state;
+    owner_.push_back(NULL);
+    dist_.push_back(std::numeric_limits<double>::infinity());
+    prev_.push_back(v);
+    return v;
+}
+
+void ompl::geometric::PathHybridization::setThreadCount(unsigned int nthreads)
+{
+    assert(nthreads > 0);
+    threadCount_ = nthreads;
 }
 
 void ompl::geometric::PathHybridization::print(std::ostream &out) const
@@ -83,18 +111,47 @@ void ompl::geometric::PathHybridization::print(std::ostream &out) const
 
 void ompl::geometric::PathHybridization::computeHybridPath(void)
 {
-    boost::vector_property_map<Vertex> prev(boost::num_vertices(g_));
-    boost::dijkstra_shortest_paths(g_, root_, boost::predecessor_map(prev));
-    if (prev[goal_] != goal_)
+    if (prev_[goal_] != goal_)
     {
         PathGeometric *h = new PathGeometric(si_);
-        for (Vertex pos = prev[goal_]; prev[pos] != pos; pos = prev[pos])
+        for (Vertex pos = prev_[goal_]; prev_[pos] != pos; pos = prev_[pos])
             h->append(stateProperty_[pos]);
         h->reverse();
         hpath_.reset(h);
     }
 }
 
+void ompl::geometric::PathHybridization::updateShortestPaths(const std::vector<Vertex> &seeds)
+{
+    // edges are only ever added, so distances can only decrease; this is Dijkstra's algorithm
+    // restricted to the part of the graph where that happens
+    typedef std::pair<double, Vertex> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    for (std::size_t i = 0 ; i < seeds.size() ; ++i)
+        if (dist_[seeds[i]] < std::numeric_limits<double>::infinity())
+            queue.push(Entry(dist_[seeds[i]], seeds[i]));
+
+    while (!queue.empty())
+    {
+        Entry e = queue.top();
+        queue.pop();
+        if (e.first > dist_[e.second])
+            continue;
+        boost::graph_traits<HGraph>::out_edge_iterator ei, eend;
+        for (boost::tie(ei, eend) = boost::out_edges(e.second, g_) ; ei != eend ; ++ei)
+        {
+            Vertex u = boost::target(*ei, g_);
+            double d = e.first + boost::get(boost::edge_weight, g_, *ei);
+            if (d < dist_[u])
+            {
+                dist_[u] = d;
+                prev_[u] = e.second;
+                queue.push(Entry(d, u));
+            }
+        }
+    }
+}
+
 const ompl::base::PathPtr& ompl::geometric::PathHybridization::getHybridPath(void) const
 {
     return hpath_;
@@ -125,12 +182,8 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
     if (paths_.find(pi) != paths_.end())
         return 0;
 
-    // the number of connection attempts
-    unsigned int nattempts = 0;
-
     // start from virtual root
-    Vertex v0 = boost::add_vertex(g_);
-    stateProperty_[v0] = pi.states_[0];
+    Vertex v0 = addVertex(pi.states_[0]);
     pi.vertices_.push_back(v0);
 
     // add all the vertices of the path, and the edges between them, to the HGraph
@@ -140,8 +193,7 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
     double length = 0.0;
     for (std::size_t j = 1 ; j < pi.states_.size() ; ++j)
     {
-        Vertex v1 = boost::add_vertex(g_);
-        stateProperty_[v1] = pi.states_[j];
+        Vertex v1 = addVertex(pi.states_[j]);
         double weight = si_->distance(pi.states_[j-1], pi.states_[j]);
         const HGraph::edge_property_type properties(weight);
         boost::add_edge(v0, v1, properties, g_);
@@ -154,9 +206,39 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
     boost::add_edge(v0, goal_, prop0, g_);
     pi.length_ = length;
 
+    // the shortest paths can only change through the new edges
+    std::vector<Vertex> touched(1, root_);
+
+    // find the previously added paths that come close enough to this one to have a matching state;
+    // a match further away than two gaps is never part of an optimal alignment. Matching across gaps
+    // also tries states that are not aligned, so then every path is considered.
+    std::set<const PathInfo*> close;
+    if (!matchAcrossGaps && nn_->size() > 0)
+    {
+        double maxLength = 0.0;
+        for (std::set<PathInfo>::const_iterator it = paths_.begin() ; it != paths_.end() ; ++it)
+            maxLength = std::max(maxLength, it->length_);
+        double radius = 2.0 * (pi.length_ + maxLength) / (2.0 / magic::GAP_COST_FRACTION);
+        std::vector<Vertex> nbh;
+        for (std::size_t j = 0 ; j < pi.vertices_.size() ; ++j)
+        {
+            nn_->nearestR(pi.vertices_[j], radius, nbh);
+            for (std::size_t k = 0 ; k < nbh.size() ; ++k)
+            {
+                const PathInfo *q = owner_[nbh[k]];
+                if (close.find(q) == close.end() &&
+                    distanceFunction(pi.vertices_[j], nbh[k]) <= 2.0 * (pi.length_ + q->length_) / (2.0 / magic::GAP_COST_FRACTION))
+                    close.insert(q);
+            }
+        }
+    }
+
     // find matches with previously added paths
+    std::vector<VertexPair> attempts;
     for (std::set<PathInfo>::const_iterator it = paths_.begin() ; it != paths_.end() ; ++it)
     {
+        if (!matchAcrossGaps && close.find(&*it) == close.end())
+            continue;
         const PathGeometric *q = static_cast<const PathGeometric*>(it->path_.get());
         std::vector<int> indexP, indexQ;
         matchPaths(*p, *q, (pi.length_ + it->length_) / (2.0 / magic::GAP_COST_FRACTION), indexP, indexQ);
@@ -186,10 +268,7 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
                     // if it did, try to match the endpoint with the elements in q
                     if (gapP)
                         for (std::size_t j = gapStartP ; j < i ; ++j)
-                        {
-                            attemptNewEdge(pi, *it, indexP[i], indexQ[j]);
-                            ++nattempts;
-                        }
+                            attemptNewEdge(pi, *it, indexP[i], indexQ[j], attempts);
                     // remember the last non-negative index in p
                     lastP = i;
                     gapP = false;
@@ -204,20 +283,14 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
                 {
                     if (gapQ)
                         for (std::size_t j = gapStartQ ; j < i ; ++j)
-                        {
-                            attemptNewEdge(pi, *it, indexP[j], indexQ[i]);
-                            ++nattempts;
-                        }
+                            attemptNewEdge(pi, *it, indexP[j], indexQ[i], attempts);
                     lastQ = i;
                     gapQ = false;
                 }
 
                 // try to match corresponding index values and gep beginnings
                 if (lastP >= 0 && lastQ >= 0)
-                {
-                    attemptNewEdge(pi, *it, indexP[lastP], indexQ[lastQ]);
-                    ++nattempts;
-                }
+                    attemptNewEdge(pi, *it, indexP[lastP], indexQ[lastQ], attempts);
             }
         }
         else
@@ -225,25 +298,66 @@ unsigned int ompl::geometric::PathHybridization::recordPath(const base::PathPtr
             // attempt new edge only when states align
             for (std::size_t i = 0 ; i < indexP.size() ; ++i)
                 if (indexP[i] >= 0 && indexQ[i] >= 0)
-                {
-                    attemptNewEdge(pi, *it, indexP[i], indexQ[i]);
-                    ++nattempts;
-                }
+                    attemptNewEdge(pi, *it, indexP[i], indexQ[i], attempts);
         }
     }
 
+    // the same pair of states is often proposed more than once
+    std::sort(attempts.begin(), attempts.end());
+    attempts.erase(std::unique(attempts.begin(), attempts.end()), attempts.end());
+    unsigned int nattempts = attempts.size();
+    addValidEdges(attempts, touched);
+
     // remember this path is part of the hybridization
-    paths_.insert(pi);
+    const PathInfo *info = &*paths_.insert(pi).first;
+    for (std::size_t j = 0 ; j < info->vertices_.size() ; ++j)
+        owner_[info->vertices_[j]] = info;
+    nn_->add(info->vertices_);
+
+    updateShortestPaths(touched);
     return nattempts;
 }
 
-void ompl::geometric::PathHybridization::attemptNewEdge(const PathInfo &p, const PathInfo &q, int indexP, int indexQ)
+void ompl::geometric::PathHybridization::attemptNewEdge(const PathInfo &p, const PathInfo &q, int indexP, int indexQ,
+                                                        std::vector<VertexPair> &attempts) const
+{
+    attempts.push_back(VertexPair(p.vertices_[indexP], q.vertices_[indexQ]));
+}
+
+void ompl::geometric::PathHybridization::addValidEdges(std::vector<VertexPair> &attempts, std::vector<Vertex> &touched)
 {
-    if (si_->checkMotion(p.states_[indexP], q.states_[indexQ]))
+    std::vector<char> valid(attempts.size(), 0);
+    std::size_t next = 0;
+    boost::mutex lock;
+    boost::thread_group threads;
+    for (std::size_t i = 1 ; i < std::min<std::size_t>(threadCount_, attempts.size()) ; ++i)
+        threads.create_thread(boost::bind(&PathHybridization::checkEdgesThread, this, boost::cref(attempts), boost::ref(valid), &next, &lock));
+    checkEdgesThread(attempts, valid, &next, &lock);
+    threads.join_all();
+
+    for (std::size_t i = 0 ; i < attempts.size() ; ++i)
+        if (valid[i])
+        {
+            const HGraph::edge_property_type properties(distanceFunction(attempts[i].first, attempts[i].second));
+            boost::add_edge(attempts[i].first, attempts[i].second, properties, g_);
+            touched.push_back(attempts[i].first);
+            touched.push_back(attempts[i].second);
+        }
+}
+
+void ompl::geometric::PathHybridization::checkEdgesThread(const std::vector<VertexPair> &attempts, std::vector<char> &valid,
+                                                          std::size_t *next, boost::mutex *lock) const
+{
+    while (true)
     {
-        double weight = si_->distance(p.states_[indexP], q.states_[indexQ]);
-        const HGraph::edge_property_type properties(weight);
-        boost::add_edge(p.vertices_[indexP], q.vertices_[indexQ], properties, g_);
+        std::size_t i;
+        {
+            boost::mutex::scoped_lock slock(*lock);
+            i = (*next)++;
+        }
+        if (i >= attempts.size())
+            break;
+        valid[i] = si_->checkMotion(stateProperty_[attempts[i].first], stateProperty_[attempts[i].second]) ? 1 : 0;
     }
 }
 
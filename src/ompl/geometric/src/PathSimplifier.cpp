@@ -41,6 +41,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <map>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 /* Based on COMP450 2010 project of Yun Yu and Linda Hill (Rice University) */
 void ompl::geometric::PathSimplifier::smoothBSpline(PathGeometric &path, unsigned int maxSteps, double minChange)
@@ -113,6 +115,8 @@ bool ompl::geometric::PathSimplifier::reduceVertices(PathGeometric &path, unsign
         states.swap(newStates);
         result = true;
     }
+    else if (threadCount_ > 1)
+        result = shortcutBatched(path, maxSteps, maxEmptySteps, rangeRatio, 0.0, true);
     else
         for (unsigned int i = 0 ; i < maxSteps && nochange < maxEmptySteps ; ++i, ++nochange)
         {
@@ -159,6 +163,9 @@ bool ompl::geometric::PathSimplifier::shortcutPath(PathGeometric &path, unsigned
     if (maxEmptySteps == 0)
         maxEmptySteps = path.getStateCount();
 
+    if (threadCount_ > 1)
+        return shortcutBatched(path, maxSteps, maxEmptySteps, rangeRatio, snapToVertex, false);
+
     const base::SpaceInformationPtr &si = path.getSpaceInformation();
     std::vector<base::State*> &states = path.getStates();
 
@@ -297,6 +304,329 @@ bool ompl::geometric::PathSimplifier::shortcutPath(PathGeometric &path, unsigned
     return result;
 }
 
+ompl::geometric::PathSimplifier::~PathSimplifier(void)
+{
+    {
+        boost::mutex::scoped_lock slock(poolLock_);
+        shutdown_ = true;
+        roundStart_.notify_all();
+    }
+    for (std::size_t i = 0 ; i < workers_.size() ; ++i)
+    {
+        workers_[i]->join();
+        delete workers_[i];
+    }
+}
+
+void ompl::geometric::PathSimplifier::setThreadCount(unsigned int nthreads)
+{
+    assert(nthreads > 0);
+    threadCount_ = nthreads;
+}
+
+bool ompl::geometric::PathSimplifier::shortcutBatched(PathGeometric &path, unsigned int maxSteps, unsigned int maxEmptySteps, double rangeRatio,
+                                                       double snapToVertex, bool vertices)
+{
+    const base::SpaceInformationPtr &si = path.getSpaceInformation();
+    std::vector<base::State*> &states = path.getStates();
+
+    // a few candidates per thread, so that threads that draw cheap motions do not wait for the others
+    std::vector<Shortcut> candidates(2 * threadCount_);
+    for (std::size_t k = 0 ; k < candidates.size() ; ++k)
+    {
+        candidates[k].state0 = vertices ? NULL : si->allocState();
+        candidates[k].state1 = vertices ? NULL : si->allocState();
+    }
+
+    std::vector<double> dists;
+    std::vector<std::size_t> order, previous, chosen;
+    std::vector<double> best;
+    std::vector<base::State*> newStates;
+
+    bool result = false;
+    unsigned int steps = 0;
+    unsigned int nochange = 0;
+    while (steps < maxSteps && nochange < maxEmptySteps && states.size() > 2)
+    {
+        int count = states.size();
+        int maxN  = count - 1;
+        int range = 1 + (int)(floor(0.5 + (double)count * rangeRatio));
+
+        dists.resize(states.size());
+        dists[0] = 0.0;
+        for (std::size_t j = 1 ; j < dists.size() ; ++j)
+            dists[j] = dists[j - 1] + si->distance(states[j-1], states[j]);
+        double threshold = dists.back() * snapToVertex;
+        double rd = rangeRatio * dists.back();
+
+        // sample a batch of shortcuts the same way reduceVertices() and shortcutPath() sample one
+        for (std::size_t k = 0 ; k < candidates.size() ; ++k)
+        {
+            Shortcut &c = candidates[k];
+            c.skip = false;
+            c.valid = false;
+            c.gain = 0.0;
+            if (vertices)
+            {
+                int p1 = rng_.uniformInt(0, maxN);
+                int p2 = rng_.uniformInt(std::max(p1 - range, 0), std::min(maxN, p1 + range));
+                if (abs(p1 - p2) < 2)
+                {
+                    if (p1 < maxN - 1)
+                        p2 = p1 + 2;
+                    else
+                        if (p1 > 1)
+                            p2 = p1 - 2;
+                        else
+                        {
+                            c.skip = true;
+                            continue;
+                        }
+                }
+                if (p1 > p2)
+                    std::swap(p1, p2);
+                c.pos0 = c.index0 = c.first = p1;
+                c.pos1 = c.index1 = c.last = p2;
+                c.t0 = c.t1 = 0.0;
+                c.along = 0.0;
+            }
+            else
+            {
+                c.index0 = -1;
+                c.t0 = 0.0;
+                double p0 = rng_.uniformReal(0.0, dists.back());
+                std::vector<double>::iterator pit = std::lower_bound(dists.begin(), dists.end(), p0);
+                c.pos0 = pit == dists.end() ? dists.size() - 1 : pit - dists.begin();
+                if (c.pos0 == 0 || dists[c.pos0] - p0 < threshold)
+                    c.index0 = c.pos0;
+                else
+                {
+                    while (c.pos0 > 0 && p0 < dists[c.pos0])
+                        --c.pos0;
+                    if (p0 - dists[c.pos0] < threshold)
+                        c.index0 = c.pos0;
+                }
+
+                c.index1 = -1;
+                c.t1 = 0.0;
+                double p1 = rng_.uniformReal(std::max(0.0, p0 - rd), std::min(p0 + rd, dists.back()));
+                pit = std::lower_bound(dists.begin(), dists.end(), p1);
+                c.pos1 = pit == dists.end() ? dists.size() - 1 : pit - dists.begin();
+                if (c.pos1 == 0 || dists[c.pos1] - p1 < threshold)
+                    c.index1 = c.pos1;
+                else
+                {
+                    while (c.pos1 > 0 && p1 < dists[c.pos1])
+                        --c.pos1;
+                    if (p1 - dists[c.pos1] < threshold)
+                        c.index1 = c.pos1;
+                }
+
+                if (c.pos0 == c.pos1 || c.index0 == c.pos1 || c.index1 == c.pos0 ||
+                    c.pos0 + 1 == c.index1 || c.pos1 + 1 == c.index0 ||
+                    (c.index0 >=0 && c.index1 >= 0 && abs(c.index0 - c.index1) < 2))
+                {
+                    c.skip = true;
+                    continue;
+                }
+
+                if (c.index0 >= 0)
+                    p0 = dists[c.index0];
+                else
+                    c.t0 = (p0 - dists[c.pos0]) / (dists[c.pos0 + 1] - dists[c.pos0]);
+                if (c.index1 >= 0)
+                    p1 = dists[c.index1];
+                else
+                    c.t1 = (p1 - dists[c.pos1]) / (dists[c.pos1 + 1] - dists[c.pos1]);
+
+                if (c.pos0 > c.pos1)
+                {
+                    std::swap(c.pos0, c.pos1);
+                    std::swap(c.index0, c.index1);
+                    std::swap(c.t0, c.t1);
+                    std::swap(c.state0, c.state1);
+                    std::swap(p0, p1);
+                }
+                c.along = p1 - p0;
+                c.first = c.index0 >= 0 ? c.index0 : c.pos0;
+                c.last = c.index1 >= 0 ? c.index1 : c.pos1 + 1;
+            }
+        }
+        steps += candidates.size();
+
+        checkShortcuts(si, states, candidates);
+
+        // pick the non-overlapping valid shortcuts of largest total gain (weighted interval scheduling);
+        // two shortcuts may share the vertex where one ends and the other starts
+        order.clear();
+        for (std::size_t k = 0 ; k < candidates.size() ; ++k)
+            if (candidates[k].valid)
+            {
+                // reduceVertices() is after fewer vertices, shortcutPath() after a shorter path
+                if (vertices)
+                    candidates[k].gain = candidates[k].last - candidates[k].first - 1;
+                order.push_back(k);
+            }
+        if (order.empty())
+        {
+            nochange += candidates.size();
+            continue;
+        }
+        for (std::size_t a = 1 ; a < order.size() ; ++a)
+            for (std::size_t b = a ; b > 0 && candidates[order[b]].last < candidates[order[b - 1]].last ; --b)
+                std::swap(order[b], order[b - 1]);
+
+        best.assign(order.size() + 1, 0.0);
+        previous.assign(order.size(), 0);
+        for (std::size_t a = 0 ; a < order.size() ; ++a)
+        {
+            const Shortcut &c = candidates[order[a]];
+            std::size_t p = a;
+            while (p > 0 && candidates[order[p - 1]].last > c.first)
+                --p;
+            previous[a] = p;
+            best[a + 1] = std::max(best[a], best[p] + c.gain);
+        }
+        chosen.clear();
+        for (std::size_t a = order.size() ; a > 0 ; )
+            if (best[a] > best[a - 1])
+            {
+                chosen.push_back(order[a - 1]);
+                a = previous[a - 1];
+            }
+            else
+                --a;
+        if (chosen.empty())
+        {
+            nochange += candidates.size();
+            continue;
+        }
+
+        // splice all the chosen shortcuts into the path in a single pass
+        newStates.clear();
+        newStates.reserve(states.size());
+        int next = 0;
+        for (std::size_t a = chosen.size() ; a > 0 ; --a)
+        {
+            const Shortcut &c = candidates[chosen[a - 1]];
+            for (int j = next ; j <= c.first ; ++j)
+                newStates.push_back(states[j]);
+            if (c.index0 < 0)
+                newStates.push_back(si->cloneState(c.state0));
+            if (c.index1 < 0)
+                newStates.push_back(si->cloneState(c.state1));
+            for (int j = c.first + 1 ; j < c.last ; ++j)
+                si->freeState(states[j]);
+            next = c.last;
+        }
+        for (int j = next ; j < count ; ++j)
+            newStates.push_back(states[j]);
+        states.swap(newStates);
+
+        result = true;
+        nochange = 0;
+    }
+
+    for (std::size_t k = 0 ; k < candidates.size() ; ++k)
+        if (candidates[k].state0)
+        {
+            si->freeState(candidates[k].state0);
+            si->freeState(candidates[k].state1);
+        }
+    return result;
+}
+
+void ompl::geometric::PathSimplifier::checkShortcuts(const base::SpaceInformationPtr &si, const std::vector<base::State*> &states,
+                                                      std::vector<Shortcut> &candidates)
+{
+    boost::mutex::scoped_lock clock(checkLock_);
+    {
+        boost::mutex::scoped_lock slock(poolLock_);
+        while (workers_.size() + 1 < threadCount_)
+            workers_.push_back(new boost::thread(boost::bind(&PathSimplifier::worker, this, workers_.size(), round_)));
+
+        roundSi_ = &si;
+        roundStates_ = &states;
+        roundCandidates_ = &candidates;
+        next_ = 0;
+        helpers_ = threadCount_ - 1;
+        pending_ = helpers_;
+        ++round_;
+        roundStart_.notify_all();
+    }
+
+    checkShortcutsThread();
+
+    boost::mutex::scoped_lock slock(poolLock_);
+    while (pending_ > 0)
+        roundDone_.wait(slock);
+    roundSi_ = NULL;
+    roundStates_ = NULL;
+    roundCandidates_ = NULL;
+}
+
+void ompl::geometric::PathSimplifier::checkShortcutsThread(void)
+{
+    const base::SpaceInformationPtr &si = *roundSi_;
+    const std::vector<base::State*> &states = *roundStates_;
+    std::vector<Shortcut> &candidates = *roundCandidates_;
+    while (true)
+    {
+        std::size_t k;
+        {
+            boost::mutex::scoped_lock slock(poolLock_);
+            k = next_++;
+        }
+        if (k >= candidates.size())
+            break;
+
+        Shortcut &c = candidates[k];
+        if (c.skip)
+            continue;
+
+        const base::State *s0 = states[c.index0 >= 0 ? c.index0 : c.pos0];
+        if (c.index0 < 0)
+        {
+            si->getStateSpace()->interpolate(states[c.pos0], states[c.pos0 + 1], c.t0, c.state0);
+            s0 = c.state0;
+        }
+        const base::State *s1 = states[c.index1 >= 0 ? c.index1 : c.pos1];
+        if (c.index1 < 0)
+        {
+            si->getStateSpace()->interpolate(states[c.pos1], states[c.pos1 + 1], c.t1, c.state1);
+            s1 = c.state1;
+        }
+
+        c.valid = si->checkMotion(s0, s1);
+        if (c.valid)
+            c.gain = c.along - si->distance(s0, s1);
+    }
+}
+
+void ompl::geometric::PathSimplifier::worker(unsigned int index, unsigned int round)
+{
+    boost::mutex::scoped_lock slock(poolLock_);
+    while (true)
+    {
+        while (round_ == round && !shutdown_)
+            roundStart_.wait(slock);
+        if (shutdown_)
+            break;
+        round = round_;
+
+        // there may be more threads than needed in this round
+        if (index >= helpers_)
+            continue;
+        slock.unlock();
+
+        checkShortcutsThread();
+
+        slock.lock();
+        --pending_;
+        roundDone_.notify_all();
+    }
+}
+
 bool ompl::geometric::PathSimplifier::collapseCloseVertices(PathGeometric &path, unsigned int maxSteps, unsigned int maxEmptySteps)
 {
     if (path.getStateCount() < 3)
@@ -416,3 +746,86 @@ void ompl::geometric::PathSimplifier::simplify(PathGeometric &path, const base::
         if (!p.first)
             logDebug("The solution path was slightly touching on an invalid region of the state space, but it was successfully fixed.");
 }
+
+void ompl::geometric::PathSimplifier::simplifyAdaptive(PathGeometric &path, double maxTime)
+{
+    simplifyAdaptive(path, base::timedPlannerTerminationCondition(maxTime));
+}
+
+void ompl::geometric::PathSimplifier::runStage(PathGeometric &path, Stage stage)
+{
+    switch (stage)
+    {
+    case REDUCE_VERTICES:
+        reduceVertices(path);
+        break;
+    case COLLAPSE_CLOSE_VERTICES:
+        collapseCloseVertices(path);
+        break;
+    case SHORTCUT_PATH:
+        shortcutPath(path);
+        break;
+    case SMOOTH_BSPLINE:
+        smoothBSpline(path, 3, path.length()/100.0);
+        break;
+    }
+}
+
+void ompl::geometric::PathSimplifier::simplifyAdaptive(PathGeometric &path, const base::PlannerTerminationCondition &ptc)
+{
+    trace_.clear();
+    if (path.getStateCount() < 3 || stages_.empty())
+        return;
+
+    // a negative rate marks a stage that is due to be tried (again)
+    std::vector<double> rates(stages_.size(), -1.0);
+    time::point start = time::now();
+    double length = path.length();
+
+    while (ptc() == false)
+    {
+        // untried stages go first, in order; otherwise, pick the most productive one
+        std::size_t next = 0;
+        for (std::size_t i = 1 ; i < rates.size() ; ++i)
+            if (rates[next] >= 0.0 && (rates[i] < 0.0 || rates[i] > rates[next]))
+                next = i;
+        if (rates[next] >= 0.0 && rates[next] < minImprovementRate_)
+            break;
+
+        time::point stageStart = time::now();
+        runStage(path, stages_[next]);
+        time::point stageEnd = time::now();
+
+        double newLength = path.length();
+        double gain = length > std::numeric_limits<double>::epsilon() ? (length - newLength) / length : 0.0;
+        if (gain < magic::MIN_RELATIVE_PATH_IMPROVEMENT)
+            gain = 0.0;
+        double elapsed = std::max(time::seconds(stageEnd - stageStart), std::numeric_limits<double>::epsilon());
+        double rate = gain / elapsed;
+        rates[next] = rates[next] < 0.0 || rate <= 0.0 ? rate : (rates[next] + rate) / 2.0;
+
+        // once the path changed, stages that had stopped helping may help again
+        if (gain > 0.0)
+            for (std::size_t i = 0 ; i < rates.size() ; ++i)
+                if (i != next && rates[i] >= 0.0 && rates[i] < minImprovementRate_)
+                    rates[i] = -1.0;
+        length = newLength;
+
+        TraceEntry entry;
+        entry.stage = stages_[next];
+        entry.time = time::seconds(stageEnd - start);
+        entry.length = length;
+        trace_.push_back(entry);
+
+        if (path.getStateCount() < 3)
+            break;
+    }
+
+    // we always run this
+    const std::pair<bool, bool> &p = path.checkAndRepair(magic::MAX_VALID_SAMPLE_ATTEMPTS);
+    if (!p.second)
+        logWarn("Solution path may slightly touch on an invalid region of the state space");
+    else
+        if (!p.first)
+            logDebug("The solution path was slightly touching on an invalid region of the state space, but it was successfully fixed.");
+}
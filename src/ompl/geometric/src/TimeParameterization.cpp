@@ -375,3 +375,208 @@ bool ompl::geometric::TimeParameterization::computeFastTimeParametrizationPart(c
     }  
     return valid;
 }
+
+namespace ompl
+{
+    namespace geometric
+    {
+        /// @cond IGNORE
+        namespace
+        {
+            // the real values of the states are joint positions only if every component of the space is a real vector
+            bool isRealVectorSpace(const base::StateSpace *space)
+            {
+                if (!space->isCompound())
+                    return space->getType() == base::STATE_SPACE_REAL_VECTOR;
+                const base::CompoundStateSpace *compound = space->as<base::CompoundStateSpace>();
+                for (unsigned int i = 0 ; i < compound->getSubspaceCount() ; ++i)
+                    if (!isRealVectorSpace(compound->getSubspace(i).get()))
+                        return false;
+                return true;
+            }
+
+            // consecutive segments whose directions have a cosine at least this large are treated as one straight line
+            const double STRAIGHT_COSINE = 1.0 - 1e-9;
+
+            // the limits along one segment of the path, for the speed along the path and its derivatives
+            struct SegmentLimits
+            {
+                double length;
+                double vel;
+                double acc;
+                double jerk;
+            };
+
+            // the time needed to change the speed by dv, starting and ending at zero acceleration
+            double speedChangeTime(double dv, const SegmentLimits &lim)
+            {
+                if (lim.jerk == std::numeric_limits<double>::infinity())
+                    return dv / lim.acc;
+                if (dv >= lim.acc * lim.acc / lim.jerk)
+                    return dv / lim.acc + lim.acc / lim.jerk;
+                return 2.0 * sqrt(dv / lim.jerk);
+            }
+
+            // the distance covered while changing the speed from va to vb; the profiles are symmetric, so the
+            // average speed is the mean of the two
+            double speedChangeDistance(double va, double vb, const SegmentLimits &lim)
+            {
+                return (va + vb) / 2.0 * speedChangeTime(fabs(vb - va), lim);
+            }
+
+            // the largest speed that can be reached from v0 within the segment
+            double reachableSpeed(double v0, const SegmentLimits &lim)
+            {
+                if (lim.jerk == std::numeric_limits<double>::infinity())
+                    return std::min(lim.vel, sqrt(v0 * v0 + 2.0 * lim.acc * lim.length));
+                if (speedChangeDistance(v0, lim.vel, lim) <= lim.length)
+                    return lim.vel;
+                double lo = v0, hi = lim.vel;
+                for (int i = 0 ; i < 60 ; ++i)
+                {
+                    double mid = (lo + hi) / 2.0;
+                    if (speedChangeDistance(v0, mid, lim) <= lim.length)
+                        lo = mid;
+                    else
+                        hi = mid;
+                }
+                return lo;
+            }
+
+            // the time to traverse the segment starting at speed v0 and ending at speed v1, reaching the
+            // highest possible speed in between
+            double segmentTime(double v0, double v1, const SegmentLimits &lim)
+            {
+                if (lim.length <= std::numeric_limits<double>::epsilon())
+                    return 0.0;
+                double lo = std::max(v0, v1);
+                double hi = lim.vel;
+                double cruise = lim.length - speedChangeDistance(v0, hi, lim) - speedChangeDistance(hi, v1, lim);
+                if (cruise < 0.0)
+                {
+                    for (int i = 0 ; i < 60 ; ++i)
+                    {
+                        double mid = (lo + hi) / 2.0;
+                        if (speedChangeDistance(v0, mid, lim) + speedChangeDistance(mid, v1, lim) <= lim.length)
+                            lo = mid;
+                        else
+                            hi = mid;
+                    }
+                    hi = lo;
+                    cruise = std::max(0.0, lim.length - speedChangeDistance(v0, hi, lim) - speedChangeDistance(hi, v1, lim));
+                }
+                double t = speedChangeTime(hi - v0, lim) + speedChangeTime(hi - v1, lim);
+                if (cruise > 0.0)
+                    t += hi > std::numeric_limits<double>::epsilon() ? cruise / hi : 0.0;
+                return t;
+            }
+        }
+        /// @endcond
+    }
+}
+
+bool ompl::geometric::TimeParameterization::computeTimeOptimalParametrization(const PathGeometric &path,
+                                                                              const std::vector<double> &maxVel,
+                                                                              const std::vector<double> &maxAcc,
+                                                                              const std::vector<double> &maxJerk,
+                                                                              std::vector<double> &times,
+                                                                              std::vector<double> &velocities,
+                                                                              double startVel, double endVel) const
+{
+    times.clear();
+    velocities.clear();
+
+    const base::StateSpacePtr &ss = path.getSpaceInformation()->getStateSpace();
+    if (!isRealVectorSpace(ss.get()))
+    {
+        logError("The state space of the path is not a real vector space. Cannot compute time parameterization.");
+        return false;
+    }
+    const std::size_t dim = ss->getValueLocations().size();
+    if (maxVel.size() != dim || maxAcc.size() != dim || (!maxJerk.empty() && maxJerk.size() != dim))
+    {
+        logError("Expected limits for %u joints. Cannot compute time parameterization.", (unsigned int)dim);
+        return false;
+    }
+    for (std::size_t j = 0 ; j < dim ; ++j)
+        if (maxVel[j] <= 0.0 || maxAcc[j] <= 0.0 || (!maxJerk.empty() && maxJerk[j] <= 0.0))
+        {
+            logError("Joint limits must be positive. Cannot compute time parameterization.");
+            return false;
+        }
+
+    const std::size_t n = path.getStateCount();
+    if (n == 0)
+        return true;
+    times.resize(n, 0.0);
+    velocities.resize(n, 0.0);
+    if (n == 1)
+        return true;
+
+    // the joint values of the states; only two consecutive states are needed at a time
+    std::vector<double> prev, next, dir(dim), prevDir(dim);
+    ss->copyToReals(prev, path.getState(0));
+
+    // the limits along each segment follow from the joint limits and the direction of the segment
+    std::vector<SegmentLimits> seg(n - 1);
+    velocities[0] = startVel;
+    for (std::size_t i = 0 ; i + 1 < n ; ++i)
+    {
+        ss->copyToReals(next, path.getState(i + 1));
+        SegmentLimits &lim = seg[i];
+        double len2 = 0.0;
+        for (std::size_t j = 0 ; j < dim ; ++j)
+        {
+            dir[j] = next[j] - prev[j];
+            len2 += dir[j] * dir[j];
+        }
+        lim.length = sqrt(len2);
+        lim.vel = lim.acc = lim.jerk = std::numeric_limits<double>::infinity();
+        if (lim.length > std::numeric_limits<double>::epsilon())
+            for (std::size_t j = 0 ; j < dim ; ++j)
+            {
+                dir[j] /= lim.length;
+                double u = fabs(dir[j]);
+                if (u > std::numeric_limits<double>::epsilon())
+                {
+                    lim.vel = std::min(lim.vel, maxVel[j] / u);
+                    lim.acc = std::min(lim.acc, maxAcc[j] / u);
+                    if (!maxJerk.empty())
+                        lim.jerk = std::min(lim.jerk, maxJerk[j] / u);
+                }
+            }
+
+        // the speed at the state between this segment and the previous one; the velocity of
+        // each joint only stays continuous where the path goes straight on, so the path stops
+        // wherever it changes direction
+        if (i > 0)
+        {
+            double c = 0.0;
+            if (lim.length > std::numeric_limits<double>::epsilon() && seg[i - 1].length > std::numeric_limits<double>::epsilon())
+                for (std::size_t j = 0 ; j < dim ; ++j)
+                    c += dir[j] * prevDir[j];
+            velocities[i] = c >= STRAIGHT_COSINE ? std::min(std::min(seg[i - 1].vel, lim.vel), std::numeric_limits<double>::max()) : 0.0;
+        }
+        prev.swap(next);
+        prevDir.swap(dir);
+    }
+    velocities[0] = std::min(velocities[0], seg.front().vel);
+    velocities[n - 1] = std::min(endVel, seg.back().vel);
+
+    // the speed at each state is limited by how fast the neighboring states can accelerate or decelerate to it
+    for (std::size_t i = 1 ; i < n ; ++i)
+        velocities[i] = std::min(velocities[i], reachableSpeed(velocities[i - 1], seg[i - 1]));
+    for (std::size_t i = n - 1 ; i > 0 ; --i)
+        velocities[i - 1] = std::min(velocities[i - 1], reachableSpeed(velocities[i], seg[i - 1]));
+
+    if (startVel - velocities[0] > std::numeric_limits<double>::epsilon() * std::max(1.0, startVel))
+    {
+        logError("The start velocity cannot be met within the limits. Cannot compute time parameterization.");
+        return false;
+    }
+
+    for (std::size_t i = 1 ; i < n ; ++i)
+        times[i] = times[i - 1] + segmentTime(velocities[i - 1], velocities[i], seg[i - 1]);
+
+    return true;
+}
@@ -143,10 +143,11 @@ namespace ompl
                 /** \brief Constructor that provides default values for all members */
                 Request(double maxTime = 5.0, double maxMem = 4096.0,
                     unsigned int runCount = 100, bool displayProgress = true,
-                    bool saveConsoleOutput = true, bool useThreads = true)
+                    bool saveConsoleOutput = true, bool useThreads = true,
+                    bool timeStatistics = false)
                     : maxTime(maxTime), maxMem(maxMem), runCount(runCount),
                     displayProgress(displayProgress), saveConsoleOutput(saveConsoleOutput),
-                    useThreads(useThreads)
+                    useThreads(useThreads), timeStatistics(timeStatistics)
                 {
                 }
 
@@ -167,6 +168,9 @@ namespace ompl
 
                 /// \brief flag indicating whether planner runs should be run in a separate thread. It is advisable to set this to \c true, so that a crashing planner doesn't result in a crash of the benchmark program. However, in the Python bindings this is set to \c false to avoid multi-threading problems in Python.
                 bool         useThreads;
+
+                /// \brief flag indicating whether planners measure the time spent in each operation they count (see base::PlannerStatistics); false by default, since reading the clock adds to the measured planning time. The setting of each planner is restored after its runs.
+                bool         timeStatistics;
             };
 
             /** \brief Constructor needs the SimpleSetup instance needed for planning. Optionally, the experiment name (\e name) can be specified */
@@ -399,6 +399,7 @@ void ompl::tools::Benchmark::benchmark(const Request &req)
             csetup_->setup();
         planners_[i]->params().getParams(exp_.planners[i].common);
         planners_[i]->getSpaceInformation()->params().getParams(exp_.planners[i].common);
+        const bool timeStatistics = planners_[i]->getTimeStatistics();
 
         // run the planner
         for (unsigned int j = 0 ; j < req.runCount ; ++j)
@@ -412,10 +413,11 @@ void ompl::tools::Benchmark::benchmark(const Request &req)
 
             logInform("Preparing for run %d of %s", status_.activeRun, status_.activePlanner.c_str());
 
-            // make sure all planning data structures are cleared
+            // make sure all planning data structures are cleared; the run properties include the time spent in each operation only on request
             try
             {
                 planners_[i]->clear();
+                planners_[i]->setTimeStatistics(req.timeStatistics);
                 if (gsetup_)
                 {
                     gsetup_->getProblemDefinition()->clearSolutionPaths();
@@ -528,6 +530,9 @@ void ompl::tools::Benchmark::benchmark(const Request &req)
                 for (std::map<std::string, std::string>::const_iterator it = pd.properties.begin() ; it != pd.properties.end() ; ++it)
                     run[it->first] = it->second;
 
+                // record the work counters collected by the planner during this run
+                planners_[i]->getStatistics().getProperties(run);
+
                 // execute post-run event, if set
                 try
                 {
@@ -558,6 +563,7 @@ void ompl::tools::Benchmark::benchmark(const Request &req)
                 logError(es.str().c_str());
             }
         }
+        planners_[i]->setTimeStatistics(timeStatistics);
     }
 
     status_.running = false;
@@ -89,6 +89,16 @@ namespace ompl
             samples are generated. */
         static const unsigned int TEST_STATE_COUNT = 1000;
 
+        /** \brief When path simplification stages are scheduled by how
+            much they shorten the path, decreases of the path length by
+            less than this fraction are considered no improvement */
+        static const double MIN_RELATIVE_PATH_IMPROVEMENT = 1e-6;
+
+        /** \brief When a planner reuses its tree for a new start
+            state, this is the number of nearest motions it attempts
+            to connect the new start state to */
+        static const unsigned int TREE_REUSE_ATTACH_ATTEMPTS = 10;
+
     }
 }
 
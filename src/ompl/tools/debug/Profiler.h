@@ -56,10 +56,13 @@
 #if ENABLE_PROFILING
 
 #include <map>
+#include <deque>
+#include <vector>
 #include <string>
 #include <iostream>
 #include <boost/thread.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/detail/atomic_count.hpp>
 
 #include "ompl/util/Time.h"
 
@@ -73,30 +76,63 @@ namespace ompl
             spent in various chunks of code. This is different from
             external profiling tools in that it allows the user to count
             time spent in various bits of code (sub-function granularity)
-            or count how many times certain pieces of code are executed.*/
+            or count how many times certain pieces of code are executed.
+
+            Names of blocks, events and averages are interned once into a
+            Profiler::Key (see Profiler::Register() and the
+            OMPL_PROFILE_BLOCK() family of macros). Counting by key
+            only touches data owned by the calling thread and does not
+            take any locks; per-thread data is combined only when
+            status() is called. The variants that take a std::string
+            remain available for convenience, but pay for a (thread-local)
+            lookup of the name on every call.
+
+            Optionally, a timeline of the recorded blocks, events and
+            averages can be kept (see setTimelineEnabled()). Each thread
+            records into a ring buffer of fixed capacity, so memory use is
+            bounded and only the most recent activity is kept. The
+            timeline can be exported in the Chrome trace event format
+            (see timeline()), which can be viewed with chrome://tracing or
+            Perfetto. */
         class Profiler : private boost::noncopyable
         {
         public:
 
-            /** \brief This instance will call Profiler::begin() when constructed and Profiler::end() when it goes out of scope. */
+            /** \brief The identifier of an interned name. Keys are shared by all instances of the profiler. */
+            typedef unsigned int Key;
+
+            /** \brief This instance will call Profiler::begin() when constructed and Profiler::end() when it goes out of scope.
+                If the profiler is disabled at construction time, this block does nothing. */
             class ScopedBlock
             {
             public:
                 /** \brief Start counting time for the block named \e name of the profiler \e prof */
-                ScopedBlock(const std::string &name, Profiler &prof = Profiler::Instance()) : name_(name), prof_(prof)
+                ScopedBlock(const std::string &name, Profiler &prof = Profiler::Instance()) : prof_(prof.enabled() ? &prof : NULL), key_(0)
                 {
-                    prof_.begin(name);
+                    if (prof_)
+                    {
+                        key_ = prof_->key(name);
+                        prof_->begin(key_);
+                    }
+                }
+
+                /** \brief Start counting time for the block identified by \e key of the profiler \e prof */
+                ScopedBlock(Key key, Profiler &prof = Profiler::Instance()) : prof_(prof.enabled() ? &prof : NULL), key_(key)
+                {
+                    if (prof_)
+                        prof_->begin(key_);
                 }
 
                 ~ScopedBlock(void)
                 {
-                    prof_.end(name_);
+                    if (prof_)
+                        prof_->end(key_);
                 }
 
             private:
 
-                std::string  name_;
-                Profiler    &prof_;
+                Profiler    *prof_;
+                Key          key_;
             };
 
             /** \brief This instance will call Profiler::start() when constructed and Profiler::stop() when it goes out of scope.
@@ -127,20 +163,20 @@ namespace ompl
             /** \brief Return an instance of the class */
             static Profiler& Instance(void);
 
+            /** \brief Return the key for \e name, registering the name if it was not seen before.
+                This takes a global lock and is meant to be called once per name (e.g., to initialize a static variable). */
+            static Key Register(const std::string &name);
+
+            /** \brief Return the name a key was registered with */
+            static std::string KeyName(Key key);
+
             /** \brief Constructor. It is allowed to separately instantiate this
-                class (not only as a singleton) */
-            Profiler(bool printOnDestroy = false, bool autoStart = false) : running_(false), printOnDestroy_(printOnDestroy)
-            {
-                if (autoStart)
-                    start();
-            }
+                class (not only as a singleton). An instance must outlive
+                all the threads that record data into it. */
+            Profiler(bool printOnDestroy = false, bool autoStart = false);
 
             /** \brief Destructor */
-            ~Profiler(void)
-            {
-                if (printOnDestroy_ && !data_.empty())
-                    status();
-            }
+            ~Profiler(void);
 
             /** \brief Start counting time */
             static void Start(void)
@@ -169,6 +205,34 @@ namespace ompl
             /** \brief Clear counted time and events */
             void clear(void);
 
+            /** \brief Enable or disable recording of blocks, events and averages */
+            static void SetEnabled(bool flag)
+            {
+                Instance().setEnabled(flag);
+            }
+
+            /** \brief Check if recording of blocks, events and averages is enabled */
+            static bool Enabled(void)
+            {
+                return Instance().enabled();
+            }
+
+            /** \brief Enable or disable recording of blocks, events and
+                averages. When disabled, recording functions return
+                immediately. Recording is enabled by default. This can be
+                called while other threads are recording. */
+            void setEnabled(bool flag)
+            {
+                boost::mutex::scoped_lock slock(lock_);
+                enabled_.set(flag);
+            }
+
+            /** \brief Check if recording of blocks, events and averages is enabled */
+            bool enabled(void) const
+            {
+                return enabled_;
+            }
+
             /** \brief Count a specific event for a number of times */
             static void Event(const std::string& name, const unsigned int times = 1)
             {
@@ -176,7 +240,29 @@ namespace ompl
             }
 
             /** \brief Count a specific event for a number of times */
-            void event(const std::string &name, const unsigned int times = 1);
+            static void Event(Key key, const unsigned int times = 1)
+            {
+                Instance().event(key, times);
+            }
+
+            /** \brief Count a specific event for a number of times */
+            void event(const std::string &name, const unsigned int times = 1)
+            {
+                if (enabled_)
+                    event(key(name), times);
+            }
+
+            /** \brief Count a specific event for a number of times */
+            void event(Key key, const unsigned int times = 1)
+            {
+                if (enabled_)
+                {
+                    PerThread &pt = perThread();
+                    pt.slot(key).events += times;
+                    if (timeline_)
+                        record(pt, key, 'i', time::now(), times);
+                }
+            }
 
             /** \brief Maintain the average of a specific value */
             static void Average(const std::string& name, const double value)
@@ -185,7 +271,32 @@ namespace ompl
             }
 
             /** \brief Maintain the average of a specific value */
-            void average(const std::string &name, const double value);
+            static void Average(Key key, const double value)
+            {
+                Instance().average(key, value);
+            }
+
+            /** \brief Maintain the average of a specific value */
+            void average(const std::string &name, const double value)
+            {
+                if (enabled_)
+                    average(key(name), value);
+            }
+
+            /** \brief Maintain the average of a specific value */
+            void average(Key key, const double value)
+            {
+                if (enabled_)
+                {
+                    PerThread &pt = perThread();
+                    AvgInfo &a = pt.slot(key).avg;
+                    a.total += value;
+                    a.totalSqr += value*value;
+                    a.parts++;
+                    if (timeline_)
+                        record(pt, key, 'C', time::now(), value);
+                }
+            }
 
             /** \brief Begin counting time for a specific chunk of code */
             static void Begin(const std::string &name)
@@ -193,17 +304,63 @@ namespace ompl
                 Instance().begin(name);
             }
 
+            /** \brief Begin counting time for a specific chunk of code */
+            static void Begin(Key key)
+            {
+                Instance().begin(key);
+            }
+
             /** \brief Stop counting time for a specific chunk of code */
             static void End(const std::string &name)
             {
                 Instance().end(name);
             }
 
+            /** \brief Stop counting time for a specific chunk of code */
+            static void End(Key key)
+            {
+                Instance().end(key);
+            }
+
+            /** \brief Begin counting time for a specific chunk of code */
+            void begin(const std::string &name)
+            {
+                if (enabled_)
+                    begin(key(name));
+            }
+
             /** \brief Begin counting time for a specific chunk of code */
-            void begin(const std::string &name);
+            void begin(Key key)
+            {
+                if (enabled_)
+                {
+                    PerThread &pt = perThread();
+                    TimeInfo &t = pt.slot(key).time;
+                    t.set();
+                    if (timeline_)
+                        record(pt, key, 'B', t.start);
+                }
+            }
+
+            /** \brief Stop counting time for a specific chunk of code */
+            void end(const std::string &name)
+            {
+                if (enabled_)
+                    end(key(name));
+            }
 
             /** \brief Stop counting time for a specific chunk of code */
-            void end(const std::string &name);
+            void end(Key key)
+            {
+                if (enabled_)
+                {
+                    PerThread &pt = perThread();
+                    const time::point now = time::now();
+                    pt.slot(key).time.update(now);
+                    if (timeline_)
+                        record(pt, key, 'E', now);
+                }
+            }
 
             /** \brief Print the status of the profiled code chunks and
                 events. Optionally, computation done by different threads
@@ -215,7 +372,9 @@ namespace ompl
 
             /** \brief Print the status of the profiled code chunks and
                 events. Optionally, computation done by different threads
-                can be printed separately. */
+                can be printed separately. Data of threads that are still
+                recording is read without synchronization, so it may be
+                slightly out of date. */
             void status(std::ostream &out = std::cout, bool merge = true);
 
             /** \brief Print the status of the profiled code chunks and
@@ -229,6 +388,64 @@ namespace ompl
                 events to the console (using msg::Console) */
             void console(void);
 
+            /** \brief Enable or disable recording of the timeline */
+            static void SetTimelineEnabled(bool flag)
+            {
+                Instance().setTimelineEnabled(flag);
+            }
+
+            /** \brief Enable or disable recording of the timeline. When
+                enabled, every block, event and average recorded by a
+                thread is also stored, with a time stamp, in a ring buffer
+                owned by that thread. Disabled by default. This can be
+                called while other threads are recording. */
+            void setTimelineEnabled(bool flag)
+            {
+                boost::mutex::scoped_lock slock(lock_);
+                timeline_.set(flag);
+            }
+
+            /** \brief Check if recording of the timeline is enabled */
+            bool timelineEnabled(void) const
+            {
+                return timeline_;
+            }
+
+            /** \brief Set the number of timeline entries kept for each
+                thread (\e perThread) and the number of terminated threads
+                whose timeline is kept (\e retainedThreads). The memory
+                used by the timeline is bounded by (number of running
+                threads + \e retainedThreads) * \e perThread entries.
+                Threads that already allocated their ring buffer keep
+                its previous capacity. */
+            void setTimelineCapacity(unsigned int perThread, unsigned int retainedThreads);
+
+            /** \brief Get the number of timeline entries kept for each thread */
+            unsigned int getTimelineCapacity(void) const
+            {
+                return timelineCapacity_;
+            }
+
+            /** \brief Get the number of terminated threads whose timeline is kept */
+            unsigned int getTimelineRetainedThreads(void) const
+            {
+                return timelineRetained_;
+            }
+
+            /** \brief Write the recorded timeline in the Chrome trace event (JSON) format */
+            static void Timeline(std::ostream &out)
+            {
+                Instance().timeline(out);
+            }
+
+            /** \brief Write the recorded timeline in the Chrome trace
+                event (JSON) format. Blocks are written as duration events,
+                events as instant events and averages as counters. Time
+                stamps are in microseconds since the construction of the
+                profiler. Entries recorded while the timeline is being
+                written may be missing from the output. */
+            void timeline(std::ostream &out);
+
             /** \brief Check if the profiler is counting time or not */
             bool running(void) const
             {
@@ -243,6 +460,34 @@ namespace ompl
 
         private:
 
+            /** \brief A boolean read without locks by the recording
+                functions; changes must be serialized by the caller */
+            class Flag
+            {
+            public:
+
+                Flag(bool value) : value_(value ? 1 : 0)
+                {
+                }
+
+                operator bool(void) const
+                {
+                    return value_ != 0;
+                }
+
+                void set(bool value)
+                {
+                    if (value && value_ == 0)
+                        ++value_;
+                    else if (!value && value_ != 0)
+                        --value_;
+                }
+
+            private:
+
+                boost::detail::atomic_count value_;
+            };
+
             /** \brief Information about time spent in a section of the code */
             struct TimeInfo
             {
@@ -274,7 +519,13 @@ namespace ompl
                 /** \brief Add the counted time to the total time */
                 void update(void)
                 {
-                    const time::duration &dt = time::now() - start;
+                    update(time::now());
+                }
+
+                /** \brief Add the time counted until \e now to the total time */
+                void update(const time::point &now)
+                {
+                    const time::duration &dt = now - start;
                     if (dt > longest)
                         longest = dt;
                     if (dt < shortest)
@@ -282,11 +533,26 @@ namespace ompl
                     total = total + dt;
                     ++parts;
                 }
+
+                /** \brief Add the time counted by \e other to this structure */
+                void merge(const TimeInfo &other)
+                {
+                    total = total + other.total;
+                    parts += other.parts;
+                    if (shortest > other.shortest)
+                        shortest = other.shortest;
+                    if (longest < other.longest)
+                        longest = other.longest;
+                }
             };
 
             /** \brief Information maintained about averaged values */
             struct AvgInfo
             {
+                AvgInfo(void) : total(0.0), totalSqr(0.0), parts(0)
+                {
+                }
+
                 /** \brief The sum of the values to average */
                 double            total;
 
@@ -297,8 +563,113 @@ namespace ompl
                 unsigned long int parts;
             };
 
-            /** \brief Information to be maintained for each thread */
+            /** \brief The data recorded for one key by one thread */
+            struct Slot
+            {
+                Slot(void) : events(0)
+                {
+                }
+
+                /** \brief The number of times the event was counted */
+                unsigned long int events;
+
+                /** \brief The averaged value */
+                AvgInfo           avg;
+
+                /** \brief The amount of time spent in the block */
+                TimeInfo          time;
+            };
+
+            /** \brief An entry in the timeline */
+            struct TimelineEntry
+            {
+                /** \brief Microseconds since the construction of the profiler */
+                long long         stamp;
+
+                /** \brief The value of a counter, or the number of times an event was counted */
+                double            value;
+
+                /** \brief The recorded name */
+                Key               key;
+
+                /** \brief The Chrome trace event phase ('B', 'E', 'i' or 'C') */
+                char              phase;
+            };
+
+            /** \brief The timeline of one thread, stored as a ring buffer */
+            struct ThreadTimeline
+            {
+                ThreadTimeline(void) : count(0), tid(0)
+                {
+                }
+
+                /** \brief The storage of the ring buffer; allocated once, on first use */
+                std::vector<TimelineEntry> entries;
+
+                /** \brief The number of entries recorded so far (the ring holds the last entries.size() ones) */
+                unsigned long int          count;
+
+                /** \brief A small integer identifying the thread in the exported timeline */
+                unsigned int               tid;
+
+                /** \brief The thread the timeline was recorded by */
+                boost::thread::id          id;
+            };
+
+            /** \brief Number of slots allocated at once by a thread */
+            static const unsigned int SLOTS_PER_CHUNK = 64;
+
+            /** \brief Maximum number of chunks of slots (the number of distinct keys is limited to SLOTS_PER_CHUNK * MAX_CHUNKS) */
+            static const unsigned int MAX_CHUNKS = 256;
+
+            /** \brief Information to be maintained for each thread. Slots
+                are allocated in chunks that are never moved, so that
+                status() can read them while the owning thread keeps
+                recording. Only the owning thread writes to this data. */
             struct PerThread
+            {
+                PerThread(Profiler *prof);
+                ~PerThread(void);
+
+                /** \brief Reset all the recorded data */
+                void reset(void);
+
+                /** \brief Reset the recorded data and mark it as belonging to \e gen */
+                void renew(long gen);
+
+                /** \brief Return the slot for a key */
+                Slot& slot(Key key)
+                {
+                    Slot *chunk = chunks[key / SLOTS_PER_CHUNK];
+                    if (!chunk)
+                        chunk = allocateChunk(key / SLOTS_PER_CHUNK);
+                    return chunk[key % SLOTS_PER_CHUNK];
+                }
+
+                /** \brief Allocate the chunk of slots with the given index */
+                Slot* allocateChunk(unsigned int index);
+
+                /** \brief The profiler this data is recorded for; NULL if the profiler was destroyed before the thread terminated */
+                Profiler                    *owner;
+
+                /** \brief The value of Profiler::generation_ the data was recorded for; older data was cleared */
+                boost::detail::atomic_count  generation;
+
+                /** \brief The thread recording the data */
+                boost::thread::id            id;
+
+                /** \brief The chunks of slots, indexed by key / SLOTS_PER_CHUNK */
+                Slot                        *chunks[MAX_CHUNKS];
+
+                /** \brief Keys of names already looked up by this thread */
+                std::map<std::string, Key>   cache;
+
+                /** \brief The timeline recorded by this thread */
+                ThreadTimeline               timeline;
+            };
+
+            /** \brief Combined data, indexed by name, used for printing */
+            struct Combined
             {
                 /** \brief The stored events */
                 std::map<std::string, unsigned long int> events;
@@ -310,12 +681,96 @@ namespace ompl
                 std::map<std::string, TimeInfo>          time;
             };
 
-            void printThreadInfo(std::ostream &out, const PerThread &data);
+            /** \brief Return the data of the calling thread */
+            PerThread& perThread(void)
+            {
+                PerThread *pt = tss_.get();
+                if (!pt)
+                    return registerThread();
+                // clear() only announces a new generation; each thread resets its own data
+                const long gen = generation_;
+                if (pt->generation != gen)
+                    pt->renew(gen);
+                return *pt;
+            }
+
+            /** \brief Check if the data of a thread was recorded since the last call to clear() */
+            bool current(const PerThread &pt) const
+            {
+                return (long)pt.generation == (long)generation_;
+            }
+
+            /** \brief Add an entry to the timeline of the calling thread */
+            void record(PerThread &pt, Key key, char phase, const time::point &when, double value = 0.0)
+            {
+                ThreadTimeline &t = pt.timeline;
+                if (t.entries.empty() && !allocateTimeline(t))
+                    return;
+                TimelineEntry &e = t.entries[t.count % t.entries.size()];
+                e.stamp = (when - epoch_).total_microseconds();
+                e.value = value;
+                e.key = key;
+                e.phase = phase;
+                ++t.count;
+            }
+
+            /** \brief Allocate the ring buffer of a thread's timeline; return false if the capacity is 0 */
+            bool allocateTimeline(ThreadTimeline &t);
+
+            /** \brief Write the timeline of one thread in the Chrome trace event format */
+            void writeTimeline(std::ostream &out, const ThreadTimeline &t, bool &first);
+
+            /** \brief Return the key for \e name, using the cache of the calling thread */
+            Key key(const std::string &name);
+
+            /** \brief Allocate the data for the calling thread */
+            PerThread& registerThread(void);
+
+            /** \brief Called when a thread that recorded data terminates */
+            static void retireThread(PerThread *pt);
+
+            /** \brief Add the data in \e src to \e dest */
+            static void accumulate(PerThread &dest, const PerThread &src);
+
+            /** \brief Add the data in \e src to \e dest, by name */
+            static void combine(Combined &dest, const PerThread &src);
+
+            void printThreadInfo(std::ostream &out, const Combined &data);
 
             boost::mutex                           lock_;
-            std::map<boost::thread::id, PerThread> data_;
+
+            /** \brief The data of the threads that are currently recording */
+            std::vector<PerThread*>                threads_;
+
+            /** \brief Data accumulated from threads that have terminated */
+            PerThread                              retired_;
+
+            /** \brief Data structures of terminated threads, available for reuse */
+            std::vector<PerThread*>                free_;
+
+            /** \brief Timelines of the most recently terminated threads */
+            std::deque<ThreadTimeline>             retiredTimelines_;
+
+            /** \brief The time stamps in the timeline are relative to this point */
+            time::point                            epoch_;
+
+            /** \brief The number of timeline entries kept for each thread */
+            unsigned int                           timelineCapacity_;
+
+            /** \brief The number of terminated threads whose timeline is kept */
+            unsigned int                           timelineRetained_;
+
+            /** \brief Counter used to assign timeline identifiers to threads */
+            unsigned int                           nextTid_;
+
+            /** \brief Incremented by clear(); per-thread data recorded for an older generation is discarded */
+            boost::detail::atomic_count            generation_;
+
+            boost::thread_specific_ptr<PerThread>  tss_;
             TimeInfo                               tinfo_;
             bool                                   running_;
+            Flag                                   enabled_;
+            Flag                                   timeline_;
             bool                                   printOnDestroy_;
 
         };
@@ -339,6 +794,8 @@ namespace ompl
         {
         public:
 
+            typedef unsigned int Key;
+
             class ScopedBlock
             {
             public:
@@ -347,6 +804,10 @@ namespace ompl
                 {
                 }
 
+                ScopedBlock(Key, Profiler & = Profiler::Instance())
+                {
+                }
+
                 ~ScopedBlock(void)
                 {
                 }
@@ -367,6 +828,16 @@ namespace ompl
 
             static Profiler& Instance(void);
 
+            static Key Register(const std::string &)
+            {
+                return 0;
+            }
+
+            static std::string KeyName(Key)
+            {
+                return std::string();
+            }
+
             Profiler(bool = true, bool = true)
             {
             }
@@ -399,38 +870,88 @@ namespace ompl
             {
             }
 
+            static void SetEnabled(bool)
+            {
+            }
+
+            static bool Enabled(void)
+            {
+                return false;
+            }
+
+            void setEnabled(bool)
+            {
+            }
+
+            bool enabled(void) const
+            {
+                return false;
+            }
+
             static void Event(const std::string&, const unsigned int = 1)
             {
             }
 
+            static void Event(Key, const unsigned int = 1)
+            {
+            }
+
             void event(const std::string &, const unsigned int = 1)
             {
             }
 
+            void event(Key, const unsigned int = 1)
+            {
+            }
+
             static void Average(const std::string&, const double)
             {
             }
 
+            static void Average(Key, const double)
+            {
+            }
+
             void average(const std::string &, const double)
             {
             }
 
+            void average(Key, const double)
+            {
+            }
+
             static void Begin(const std::string &)
             {
             }
 
+            static void Begin(Key)
+            {
+            }
+
             static void End(const std::string &)
             {
             }
 
+            static void End(Key)
+            {
+            }
+
             void begin(const std::string &)
             {
             }
 
+            void begin(Key)
+            {
+            }
+
             void end(const std::string &)
             {
             }
 
+            void end(Key)
+            {
+            }
+
             static void Status(std::ostream & = std::cout, bool = true)
             {
             }
@@ -447,6 +968,43 @@ namespace ompl
             {
             }
 
+            static void SetTimelineEnabled(bool)
+            {
+            }
+
+            void setTimelineEnabled(bool)
+            {
+            }
+
+            bool timelineEnabled(void) const
+            {
+                return false;
+            }
+
+            void setTimelineCapacity(unsigned int, unsigned int)
+            {
+            }
+
+            unsigned int getTimelineCapacity(void) const
+            {
+                return 0;
+            }
+
+            unsigned int getTimelineRetainedThreads(void) const
+            {
+                return 0;
+            }
+
+            static void Timeline(std::ostream &out)
+            {
+                Instance().timeline(out);
+            }
+
+            void timeline(std::ostream &out)
+            {
+                out << "{\"traceEvents\":[]}" << std::endl;
+            }
+
             bool running(void) const
             {
                 return false;
@@ -462,4 +1020,39 @@ namespace ompl
 
 #endif
 
+/// @cond IGNORE
+#define OMPL_PROFILER_CONCAT_(a, b) a ## b
+#define OMPL_PROFILER_CONCAT(a, b) OMPL_PROFILER_CONCAT_(a, b)
+/// @endcond
+
+#if ENABLE_PROFILING
+
+/** \brief Count the time spent in the enclosing scope under the name \e name (a string literal).
+    The name is interned only once, the first time the scope is entered. */
+#define OMPL_PROFILE_BLOCK(name)                                        \
+    static const ompl::tools::Profiler::Key OMPL_PROFILER_CONCAT(ompl_profiler_key_, __LINE__) = ompl::tools::Profiler::Register(name); \
+    ompl::tools::Profiler::ScopedBlock OMPL_PROFILER_CONCAT(ompl_profiler_block_, __LINE__)(OMPL_PROFILER_CONCAT(ompl_profiler_key_, __LINE__))
+
+/** \brief Count the event named \e name (a string literal) \e times times */
+#define OMPL_PROFILE_EVENT(name, times)                                 \
+    do {                                                                \
+        static const ompl::tools::Profiler::Key ompl_profiler_key_ = ompl::tools::Profiler::Register(name); \
+        ompl::tools::Profiler::Event(ompl_profiler_key_, times);        \
+    } while (0)
+
+/** \brief Maintain the average of \e value under the name \e name (a string literal) */
+#define OMPL_PROFILE_AVERAGE(name, value)                               \
+    do {                                                                \
+        static const ompl::tools::Profiler::Key ompl_profiler_key_ = ompl::tools::Profiler::Register(name); \
+        ompl::tools::Profiler::Average(ompl_profiler_key_, value);      \
+    } while (0)
+
+#else
+
+#define OMPL_PROFILE_BLOCK(name)
+#define OMPL_PROFILE_EVENT(name, times) do {} while (0)
+#define OMPL_PROFILE_AVERAGE(name, value) do {} while (0)
+
+#endif
+
 #endif
@@ -46,10 +46,254 @@ ompl::tools::Profiler& ompl::tools::Profiler::Instance(void)
 #if ENABLE_PROFILING
 
 #include "ompl/util/Console.h"
+#include "ompl/util/Exception.h"
 #include <vector>
 #include <algorithm>
 #include <sstream>
 
+/// @cond IGNORE
+namespace
+{
+    /* The names that have been interned, shared by all instances of the profiler */
+    struct KeyRegistry
+    {
+        boost::mutex                                          lock;
+        std::map<std::string, ompl::tools::Profiler::Key>     keys;
+        std::vector<std::string>                              names;
+    };
+
+    KeyRegistry& keyRegistry(void)
+    {
+        static KeyRegistry registry;
+        return registry;
+    }
+
+    /* Protects PerThread::owner, which is reset when a profiler is destroyed before the threads that recorded into it */
+    boost::mutex& ownerLock(void)
+    {
+        static boost::mutex lock;
+        return lock;
+    }
+
+    /* Default number of timeline entries kept for each thread */
+    const unsigned int DEFAULT_TIMELINE_CAPACITY = 16384;
+
+    /* Default number of terminated threads whose timeline is kept */
+    const unsigned int DEFAULT_TIMELINE_RETAINED = 16;
+
+    /* Write a string as a JSON string literal */
+    void writeJSONString(std::ostream &out, const std::string &str)
+    {
+        out << '"';
+        for (std::size_t i = 0 ; i < str.size() ; ++i)
+        {
+            const char c = str[i];
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if ((unsigned char)c < 0x20)
+                out << ' ';
+            else
+                out << c;
+        }
+        out << '"';
+    }
+}
+/// @endcond
+
+ompl::tools::Profiler::Key ompl::tools::Profiler::Register(const std::string &name)
+{
+    KeyRegistry &r = keyRegistry();
+    boost::mutex::scoped_lock slock(r.lock);
+    std::map<std::string, Key>::const_iterator it = r.keys.find(name);
+    if (it != r.keys.end())
+        return it->second;
+    if (r.names.size() >= SLOTS_PER_CHUNK * MAX_CHUNKS)
+        throw Exception("Profiler", "Too many distinct names registered");
+    Key key = r.names.size();
+    r.keys[name] = key;
+    r.names.push_back(name);
+    return key;
+}
+
+std::string ompl::tools::Profiler::KeyName(Key key)
+{
+    KeyRegistry &r = keyRegistry();
+    boost::mutex::scoped_lock slock(r.lock);
+    return key < r.names.size() ? r.names[key] : std::string();
+}
+
+ompl::tools::Profiler::PerThread::PerThread(Profiler *prof) : owner(prof), generation(0)
+{
+    for (unsigned int i = 0 ; i < MAX_CHUNKS ; ++i)
+        chunks[i] = NULL;
+}
+
+ompl::tools::Profiler::PerThread::~PerThread(void)
+{
+    for (unsigned int i = 0 ; i < MAX_CHUNKS ; ++i)
+        delete[] chunks[i];
+}
+
+ompl::tools::Profiler::Slot* ompl::tools::Profiler::PerThread::allocateChunk(unsigned int index)
+{
+    // the chunk is published under the lock so that status() never sees slots that are not initialized yet
+    Slot *chunk = new Slot[SLOTS_PER_CHUNK];
+    boost::mutex::scoped_lock slock(owner->lock_);
+    chunks[index] = chunk;
+    return chunk;
+}
+
+void ompl::tools::Profiler::PerThread::reset(void)
+{
+    timeline.count = 0;
+    for (unsigned int i = 0 ; i < MAX_CHUNKS ; ++i)
+        if (chunks[i])
+            for (unsigned int j = 0 ; j < SLOTS_PER_CHUNK ; ++j)
+                chunks[i][j] = Slot();
+}
+
+void ompl::tools::Profiler::PerThread::renew(long gen)
+{
+    reset();
+    while (generation < gen)
+        ++generation;
+}
+
+ompl::tools::Profiler::Profiler(bool printOnDestroy, bool autoStart) :
+    retired_(this), epoch_(time::now()), timelineCapacity_(DEFAULT_TIMELINE_CAPACITY), timelineRetained_(DEFAULT_TIMELINE_RETAINED),
+    nextTid_(0), generation_(0), tss_(&Profiler::retireThread), running_(false), enabled_(true), timeline_(false), printOnDestroy_(printOnDestroy)
+{
+    if (autoStart)
+        start();
+}
+
+ompl::tools::Profiler::~Profiler(void)
+{
+    if (printOnDestroy_)
+    {
+        bool recorded = !threads_.empty();
+        for (unsigned int i = 0 ; i < MAX_CHUNKS && !recorded ; ++i)
+            recorded = retired_.chunks[i] != NULL;
+        if (recorded)
+            status();
+    }
+    // the data of the calling thread is freed here; the data of other threads
+    // that are still running is freed by retireThread() when they terminate
+    boost::mutex::scoped_lock olock(ownerLock());
+    PerThread *own = tss_.release();
+    for (unsigned int i = 0 ; i < threads_.size() ; ++i)
+        if (threads_[i] == own)
+            delete threads_[i];
+        else
+            threads_[i]->owner = NULL;
+    for (unsigned int i = 0 ; i < free_.size() ; ++i)
+        delete free_[i];
+}
+
+ompl::tools::Profiler::Key ompl::tools::Profiler::key(const std::string &name)
+{
+    std::map<std::string, Key> &cache = perThread().cache;
+    std::map<std::string, Key>::const_iterator it = cache.find(name);
+    if (it != cache.end())
+        return it->second;
+    Key k = Register(name);
+    cache[name] = k;
+    return k;
+}
+
+ompl::tools::Profiler::PerThread& ompl::tools::Profiler::registerThread(void)
+{
+    PerThread *pt;
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        if (free_.empty())
+            pt = new PerThread(this);
+        else
+        {
+            pt = free_.back();
+            free_.pop_back();
+        }
+        pt->id = boost::this_thread::get_id();
+        pt->timeline.id = pt->id;
+        pt->timeline.tid = ++nextTid_;
+        pt->renew(generation_);
+        threads_.push_back(pt);
+    }
+    tss_.reset(pt);
+    return *pt;
+}
+
+void ompl::tools::Profiler::retireThread(PerThread *pt)
+{
+    boost::mutex::scoped_lock olock(ownerLock());
+    Profiler *prof = pt->owner;
+    if (!prof)
+    {
+        delete pt;
+        return;
+    }
+    boost::mutex::scoped_lock slock(prof->lock_);
+    if (!prof->current(*pt))
+        pt->reset();
+    accumulate(prof->retired_, *pt);
+    if (pt->timeline.count > 0 && prof->timelineRetained_ > 0)
+    {
+        prof->retiredTimelines_.push_back(ThreadTimeline());
+        std::swap(prof->retiredTimelines_.back(), pt->timeline);
+        while (prof->retiredTimelines_.size() > prof->timelineRetained_)
+            prof->retiredTimelines_.pop_front();
+    }
+    pt->timeline = ThreadTimeline();
+    pt->reset();
+    pt->cache.clear();
+    prof->threads_.erase(std::find(prof->threads_.begin(), prof->threads_.end(), pt));
+    prof->free_.push_back(pt);
+}
+
+void ompl::tools::Profiler::accumulate(PerThread &dest, const PerThread &src)
+{
+    for (unsigned int i = 0 ; i < MAX_CHUNKS ; ++i)
+        if (src.chunks[i])
+        {
+            if (!dest.chunks[i])
+                dest.chunks[i] = new Slot[SLOTS_PER_CHUNK];
+            for (unsigned int j = 0 ; j < SLOTS_PER_CHUNK ; ++j)
+            {
+                const Slot &s = src.chunks[i][j];
+                Slot &d = dest.chunks[i][j];
+                d.events += s.events;
+                d.avg.total += s.avg.total;
+                d.avg.totalSqr += s.avg.totalSqr;
+                d.avg.parts += s.avg.parts;
+                d.time.merge(s.time);
+            }
+        }
+}
+
+void ompl::tools::Profiler::combine(Combined &dest, const PerThread &src)
+{
+    for (unsigned int i = 0 ; i < MAX_CHUNKS ; ++i)
+        if (src.chunks[i])
+            for (unsigned int j = 0 ; j < SLOTS_PER_CHUNK ; ++j)
+            {
+                const Slot &s = src.chunks[i][j];
+                if (s.events == 0 && s.avg.parts == 0 && s.time.parts == 0)
+                    continue;
+                const std::string &name = KeyName(i * SLOTS_PER_CHUNK + j);
+                if (s.events > 0)
+                    dest.events[name] += s.events;
+                if (s.avg.parts > 0)
+                {
+                    AvgInfo &a = dest.avg[name];
+                    a.total += s.avg.total;
+                    a.totalSqr += s.avg.totalSqr;
+                    a.parts += s.avg.parts;
+                }
+                if (s.time.parts > 0)
+                    dest.time[name].merge(s.time);
+            }
+}
+
 void ompl::tools::Profiler::start(void)
 {
     lock_.lock();
@@ -75,42 +319,89 @@ void ompl::tools::Profiler::stop(void)
 void ompl::tools::Profiler::clear(void)
 {
     lock_.lock();
-    data_.clear();
+    ++generation_;
+    retired_.reset();
+    retiredTimelines_.clear();
     tinfo_ = TimeInfo();
     if (running_)
         tinfo_.set();
     lock_.unlock();
 }
 
-void ompl::tools::Profiler::event(const std::string &name, const unsigned int times)
+void ompl::tools::Profiler::setTimelineCapacity(unsigned int perThread, unsigned int retainedThreads)
 {
-    lock_.lock();
-    data_[boost::this_thread::get_id()].events[name] += times;
-    lock_.unlock();
+    boost::mutex::scoped_lock slock(lock_);
+    timelineCapacity_ = perThread;
+    timelineRetained_ = retainedThreads;
+    while (retiredTimelines_.size() > timelineRetained_)
+        retiredTimelines_.pop_front();
 }
 
-void ompl::tools::Profiler::average(const std::string &name, const double value)
+bool ompl::tools::Profiler::allocateTimeline(ThreadTimeline &t)
 {
-    lock_.lock();
-    AvgInfo &a = data_[boost::this_thread::get_id()].avg[name];
-    a.total += value;
-    a.totalSqr += value*value;
-    a.parts++;
-    lock_.unlock();
+    if (timelineCapacity_ == 0)
+        return false;
+    // the storage is allocated under the lock so that timeline() never sees a partially constructed buffer
+    boost::mutex::scoped_lock slock(lock_);
+    t.entries.resize(timelineCapacity_);
+    return !t.entries.empty();
 }
 
-void ompl::tools::Profiler::begin(const std::string &name)
+void ompl::tools::Profiler::timeline(std::ostream &out)
 {
-    lock_.lock();
-    data_[boost::this_thread::get_id()].time[name].set();
-    lock_.unlock();
+    boost::mutex::scoped_lock slock(lock_);
+    bool first = true;
+    out << "{\"traceEvents\":[";
+    for (std::deque<ThreadTimeline>::const_iterator it = retiredTimelines_.begin() ; it != retiredTimelines_.end() ; ++it)
+        writeTimeline(out, *it, first);
+    for (unsigned int i = 0 ; i < threads_.size() ; ++i)
+        if (current(*threads_[i]))
+            writeTimeline(out, threads_[i]->timeline, first);
+    out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
 }
 
-void ompl::tools::Profiler::end(const std::string &name)
+void ompl::tools::Profiler::writeTimeline(std::ostream &out, const ThreadTimeline &t, bool &first)
 {
-    lock_.lock();
-    data_[boost::this_thread::get_id()].time[name].update();
-    lock_.unlock();
+    const unsigned long int count = t.count;
+    if (count == 0 || t.entries.empty())
+        return;
+
+    std::stringstream thread;
+    thread << t.id;
+    out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t.tid << ",\"args\":{\"name\":";
+    writeJSONString(out, thread.str());
+    out << "}}";
+    first = false;
+
+    std::map<Key, std::string> names;
+    const unsigned long int size = t.entries.size();
+    unsigned long int depth = 0;
+    for (unsigned long int i = count > size ? count - size : 0 ; i < count ; ++i)
+    {
+        const TimelineEntry &e = t.entries[i % size];
+        // the beginning of the block may have been overwritten in the ring buffer
+        if (e.phase == 'E')
+        {
+            if (depth == 0)
+                continue;
+            --depth;
+        }
+        else if (e.phase == 'B')
+            ++depth;
+
+        std::map<Key, std::string>::iterator n = names.find(e.key);
+        if (n == names.end())
+            n = names.insert(std::make_pair(e.key, KeyName(e.key))).first;
+
+        out << ",\n{\"name\":";
+        writeJSONString(out, n->second);
+        out << ",\"cat\":\"ompl\",\"ph\":\"" << e.phase << "\",\"ts\":" << e.stamp << ",\"pid\":1,\"tid\":" << t.tid;
+        if (e.phase == 'i')
+            out << ",\"s\":\"t\",\"args\":{\"times\":" << e.value << "}";
+        else if (e.phase == 'C')
+            out << ",\"args\":{\"value\":" << e.value << "}";
+        out << "}";
+    }
 }
 
 void ompl::tools::Profiler::status(std::ostream &out, bool merge)
@@ -124,36 +415,31 @@ void ompl::tools::Profiler::status(std::ostream &out, bool merge)
 
     if (merge)
     {
-        PerThread combined;
-        for (std::map<boost::thread::id, PerThread>::const_iterator it = data_.begin() ; it != data_.end() ; ++it)
-        {
-            for (std::map<std::string, unsigned long int>::const_iterator iev = it->second.events.begin() ; iev != it->second.events.end(); ++iev)
-                combined.events[iev->first] += iev->second;
-            for (std::map<std::string, AvgInfo>::const_iterator iavg = it->second.avg.begin() ; iavg != it->second.avg.end(); ++iavg)
-            {
-                combined.avg[iavg->first].total += iavg->second.total;
-                combined.avg[iavg->first].totalSqr += iavg->second.totalSqr;
-                combined.avg[iavg->first].parts += iavg->second.parts;
-            }
-            for (std::map<std::string, TimeInfo>::const_iterator itm = it->second.time.begin() ; itm != it->second.time.end(); ++itm)
-            {
-                TimeInfo &tc = combined.time[itm->first];
-                tc.total = tc.total + itm->second.total;
-                tc.parts = tc.parts + itm->second.parts;
-                if (tc.shortest > itm->second.shortest)
-                    tc.shortest = itm->second.shortest;
-                if (tc.longest < itm->second.longest)
-                    tc.longest = itm->second.longest;
-            }
-        }
+        Combined combined;
+        combine(combined, retired_);
+        for (unsigned int i = 0 ; i < threads_.size() ; ++i)
+            if (current(*threads_[i]))
+                combine(combined, *threads_[i]);
         printThreadInfo(out, combined);
     }
     else
-        for (std::map<boost::thread::id, PerThread>::const_iterator it = data_.begin() ; it != data_.end() ; ++it)
+    {
+        for (unsigned int i = 0 ; i < threads_.size() ; ++i)
         {
-            out << "Thread " << it->first << ":" << std::endl;
-            printThreadInfo(out, it->second);
+            Combined combined;
+            if (current(*threads_[i]))
+                combine(combined, *threads_[i]);
+            out << "Thread " << threads_[i]->id << ":" << std::endl;
+            printThreadInfo(out, combined);
         }
+        Combined combined;
+        combine(combined, retired_);
+        if (!combined.events.empty() || !combined.avg.empty() || !combined.time.empty())
+        {
+            out << "Terminated threads:" << std::endl;
+            printThreadInfo(out, combined);
+        }
+    }
     lock_.unlock();
 }
 
@@ -199,7 +485,7 @@ namespace ompl
 }
 /// @endcond
 
-void ompl::tools::Profiler::printThreadInfo(std::ostream &out, const PerThread &data)
+void ompl::tools::Profiler::printThreadInfo(std::ostream &out, const Combined &data)
 {
     double total = time::seconds(tinfo_.total);
 
@@ -0,0 +1,150 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_TOOLS_EXPERIENCE_EXPERIENCE_DATABASE_
+#define OMPL_TOOLS_EXPERIENCE_EXPERIENCE_DATABASE_
+
+#include "ompl/base/SpaceInformation.h"
+#include "ompl/geometric/PathGeometric.h"
+#include "ompl/datastructures/NearestNeighbors.h"
+#include <boost/thread/mutex.hpp>
+#include <iostream>
+#include <vector>
+
+namespace ompl
+{
+
+    namespace tools
+    {
+
+        /// @cond IGNORE
+        /** \brief Forward declaration of ompl::tools::ExperienceDatabase */
+        ClassForward(ExperienceDatabase);
+        /// @endcond
+
+        /** \class ompl::tools::ExperienceDatabasePtr
+            \brief A boost shared pointer wrapper for ompl::tools::ExperienceDatabase */
+
+        /** \brief A database of solution paths, indexed by the
+            start and goal states of the paths. The states of each
+            path are kept in serialized form (see
+            ompl::base::StateSpace::serialize()). Paths computed for
+            queries similar to a new one are retrieved by
+            nearest-neighbor search over start and goal pairs: the
+            distance between two pairs is the sum of the distances
+            between their start states and between their goal
+            states. The database is thread safe and can be stored to
+            and loaded from disk. */
+        class ExperienceDatabase
+        {
+        public:
+
+            /** \brief Create a database for paths of the states of space information \e si */
+            ExperienceDatabase(const base::SpaceInformationPtr &si);
+
+            virtual ~ExperienceDatabase(void);
+
+            /** \brief Get the space information the stored paths are defined for */
+            const base::SpaceInformationPtr& getSpaceInformation(void) const
+            {
+                return si_;
+            }
+
+            /** \brief Add \e path to the database, keyed by its first and last states. Paths with fewer than two states
+                are ignored. Return true if the path was added. */
+            bool addPath(const geometric::PathGeometric &path);
+
+            /** \brief Fill \e paths with at most \e k stored paths whose start and goal states are closest to \e start and
+                \e goal, the most similar path first. */
+            void getSimilarPaths(const base::State *start, const base::State *goal, unsigned int k,
+                                 std::vector<geometric::PathGeometric> &paths) const;
+
+            /** \brief Get the number of stored paths */
+            std::size_t size(void) const;
+
+            /** \brief Forget all stored paths */
+            void clear(void);
+
+            /** \brief Load the paths stored in a file. The current content is replaced. */
+            void load(const char *filename);
+
+            /** \brief Load the paths stored in a stream. The current content is replaced. */
+            void load(std::istream &in);
+
+            /** \brief Save the paths to a file */
+            void store(const char *filename) const;
+
+            /** \brief Save the paths to a stream */
+            void store(std::ostream &out) const;
+
+        protected:
+
+            /** \brief A stored path */
+            struct Experience
+            {
+                /** \brief The first state of the path */
+                base::State       *start;
+
+                /** \brief The last state of the path */
+                base::State       *goal;
+
+                /** \brief The number of states on the path */
+                unsigned int       stateCount;
+
+                /** \brief The serialized states of the path */
+                std::vector<char>  data;
+            };
+
+            /** \brief Add the experience \e e to the index; the database takes ownership of \e e */
+            void addExperience(Experience *e);
+
+            /** \brief Distance between the start and goal pairs of two experiences */
+            double distance(const Experience *a, const Experience *b) const;
+
+            /** \brief Free the memory of all stored experiences */
+            void freeMemory(void);
+
+            /** \brief The space information the stored paths are defined for */
+            base::SpaceInformationPtr                        si_;
+
+            /** \brief The stored experiences, indexed by start and goal pair */
+            boost::shared_ptr< NearestNeighbors<Experience*> > nn_;
+
+            /** \brief Lock protecting the stored experiences */
+            mutable boost::mutex                             lock_;
+        };
+    }
+}
+
+#endif
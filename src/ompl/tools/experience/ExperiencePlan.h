@@ -0,0 +1,176 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_TOOLS_EXPERIENCE_EXPERIENCE_PLAN_
+#define OMPL_TOOLS_EXPERIENCE_EXPERIENCE_PLAN_
+
+#include "ompl/base/Planner.h"
+#include "ompl/tools/experience/ExperienceDatabase.h"
+
+namespace ompl
+{
+
+    namespace tools
+    {
+
+        /** \brief Plan using the solutions of previous, similar
+            queries. On every call to solve(), the paths in an
+            ExperienceDatabase whose start and goal states are closest
+            to the query are retrieved, connected to the start and
+            goal states of the query, and repaired with
+            ompl::geometric::PathGeometric::checkAndRepair(). The
+            repair runs in a separate thread, racing a planner that
+            solves the query from scratch; whichever succeeds first
+            stops the other. Solutions found by the planner are added
+            to the database, so that later queries can reuse them.
+
+            Retrieval requires the goal to be an instance of
+            ompl::base::GoalState; for other goals, solve() only runs
+            the planner (and solutions are still recorded, keyed by
+            the last state of the path). */
+        class ExperiencePlan
+        {
+        public:
+
+            /** \brief Create an instance for a problem definition \e pdef. If \e db is not specified, an empty database is allocated. */
+            ExperiencePlan(const base::ProblemDefinitionPtr &pdef, const ExperienceDatabasePtr &db = ExperienceDatabasePtr());
+
+            virtual ~ExperiencePlan(void)
+            {
+            }
+
+            /** \brief Get the problem definition used */
+            const base::ProblemDefinitionPtr& getProblemDefinition(void) const
+            {
+                return pdef_;
+            }
+
+            /** \brief Get the database of previous solutions */
+            const ExperienceDatabasePtr& getExperienceDatabase(void) const
+            {
+                return db_;
+            }
+
+            /** \brief Set the planner that solves queries from scratch. If no planner is set, a default one is allocated by solve(). */
+            void setPlanner(const base::PlannerPtr &planner);
+
+            /** \brief Get the planner that solves queries from scratch */
+            const base::PlannerPtr& getPlanner(void) const
+            {
+                return planner_;
+            }
+
+            /** \brief Set the maximum number of previous solutions to attempt to repair for each query */
+            void setRecallCount(unsigned int count)
+            {
+                recallCount_ = count;
+            }
+
+            /** \brief Get the maximum number of previous solutions to attempt to repair for each query */
+            unsigned int getRecallCount(void) const
+            {
+                return recallCount_;
+            }
+
+            /** \brief Set the number of attempts to sample a replacement for each invalid segment of a previous solution
+                (see ompl::geometric::PathGeometric::checkAndRepair()) */
+            void setRepairAttempts(unsigned int attempts)
+            {
+                repairAttempts_ = attempts;
+            }
+
+            /** \brief Get the number of attempts to sample a replacement for each invalid segment of a previous solution */
+            unsigned int getRepairAttempts(void) const
+            {
+                return repairAttempts_;
+            }
+
+            /** \brief Set whether exact solutions computed by the planner are added to the database */
+            void setRecordSolutions(bool flag)
+            {
+                recordSolutions_ = flag;
+            }
+
+            /** \brief Return true if exact solutions computed by the planner are added to the database */
+            bool getRecordSolutions(void) const
+            {
+                return recordSolutions_;
+            }
+
+            /** \brief Return true if the solution path after the last call to solve() is a repaired previous solution */
+            bool lastSolutionFromExperience(void) const
+            {
+                return fromExperience_;
+            }
+
+            /** \brief Solve the problem, running for at most \e solveTime seconds */
+            base::PlannerStatus solve(double solveTime);
+
+            /** \brief Solve the problem, running until \e ptc becomes true at the latest */
+            base::PlannerStatus solve(const base::PlannerTerminationCondition &ptc);
+
+        protected:
+
+            /** \brief Connect the paths in \e recalled to \e start and \e goal and repair them, in order, until one is valid
+                or \e ptc becomes true. A valid path is added to the problem definition, stored in \e repaired, and \e ptc is
+                terminated so that the planner stops. */
+            void repairPaths(const std::vector<geometric::PathGeometric> *recalled, const base::State *start,
+                             const base::State *goal, const base::PlannerTerminationCondition *ptc, base::PathPtr *repaired);
+
+            /** \brief The problem definition used */
+            base::ProblemDefinitionPtr      pdef_;
+
+            /** \brief The database of previous solutions */
+            ExperienceDatabasePtr           db_;
+
+            /** \brief The planner that solves queries from scratch */
+            base::PlannerPtr                planner_;
+
+            /** \brief The maximum number of previous solutions to repair for each query */
+            unsigned int                    recallCount_;
+
+            /** \brief The number of sampling attempts for repairing each invalid segment */
+            unsigned int                    repairAttempts_;
+
+            /** \brief Flag indicating whether solutions of the planner are recorded */
+            bool                            recordSolutions_;
+
+            /** \brief Flag indicating whether the last solution is a repaired previous solution */
+            bool                            fromExperience_;
+        };
+
+    }
+}
+
+#endif
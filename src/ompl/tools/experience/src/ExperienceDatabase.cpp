@@ -0,0 +1,264 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/tools/experience/ExperienceDatabase.h"
+#include "ompl/datastructures/NearestNeighborsGNAT.h"
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/archive_exception.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/binary_object.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/bind.hpp>
+#include <fstream>
+
+/// @cond IGNORE
+namespace
+{
+    const boost::uint32_t OMPL_ARCHIVE_MARKER = 0x4C504D4F; // this spells OMPL
+
+    struct Header
+    {
+        boost::uint32_t  marker;
+        std::size_t      path_count;
+        std::vector<int> signature;
+
+        template<typename Archive>
+        void serialize(Archive & ar, const unsigned int version)
+        {
+            ar & marker;
+            ar & path_count;
+            ar & signature;
+        }
+    };
+}
+/// @endcond
+
+ompl::tools::ExperienceDatabase::ExperienceDatabase(const base::SpaceInformationPtr &si) : si_(si)
+{
+    nn_.reset(new NearestNeighborsGNAT<Experience*>());
+    nn_->setDistanceFunction(boost::bind(&ExperienceDatabase::distance, this, _1, _2));
+}
+
+ompl::tools::ExperienceDatabase::~ExperienceDatabase(void)
+{
+    freeMemory();
+}
+
+double ompl::tools::ExperienceDatabase::distance(const Experience *a, const Experience *b) const
+{
+    return si_->distance(a->start, b->start) + si_->distance(a->goal, b->goal);
+}
+
+void ompl::tools::ExperienceDatabase::freeMemory(void)
+{
+    std::vector<Experience*> experiences;
+    nn_->list(experiences);
+    for (std::size_t i = 0 ; i < experiences.size() ; ++i)
+    {
+        si_->freeState(experiences[i]->start);
+        si_->freeState(experiences[i]->goal);
+        delete experiences[i];
+    }
+    nn_->clear();
+}
+
+void ompl::tools::ExperienceDatabase::clear(void)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    freeMemory();
+}
+
+std::size_t ompl::tools::ExperienceDatabase::size(void) const
+{
+    boost::mutex::scoped_lock slock(lock_);
+    return nn_->size();
+}
+
+bool ompl::tools::ExperienceDatabase::addPath(const geometric::PathGeometric &path)
+{
+    const std::size_t n = path.getStateCount();
+    if (n < 2)
+        return false;
+
+    const base::StateSpacePtr &space = si_->getStateSpace();
+    const unsigned int l = space->getSerializationLength();
+    Experience *e = new Experience();
+    e->start = si_->cloneState(path.getState(0));
+    e->goal = si_->cloneState(path.getState(n - 1));
+    e->stateCount = n;
+    e->data.resize(n * l);
+    for (std::size_t i = 0 ; i < n ; ++i)
+        space->serialize(&e->data[i * l], path.getState(i));
+    addExperience(e);
+    return true;
+}
+
+void ompl::tools::ExperienceDatabase::addExperience(Experience *e)
+{
+    boost::mutex::scoped_lock slock(lock_);
+    nn_->add(e);
+}
+
+void ompl::tools::ExperienceDatabase::getSimilarPaths(const base::State *start, const base::State *goal, unsigned int k,
+                                                      std::vector<geometric::PathGeometric> &paths) const
+{
+    paths.clear();
+    Experience query;
+    query.start = const_cast<base::State*>(start);
+    query.goal = const_cast<base::State*>(goal);
+    query.stateCount = 0;
+
+    const base::StateSpacePtr &space = si_->getStateSpace();
+    const unsigned int l = space->getSerializationLength();
+    base::State *temp = si_->allocState();
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        if (nn_->size() > 0 && k > 0)
+        {
+            std::vector<Experience*> nbh;
+            nn_->nearestK(&query, k, nbh);
+            for (std::size_t i = 0 ; i < nbh.size() ; ++i)
+            {
+                paths.push_back(geometric::PathGeometric(si_));
+                for (unsigned int j = 0 ; j < nbh[i]->stateCount ; ++j)
+                {
+                    space->deserialize(temp, &nbh[i]->data[j * l]);
+                    paths.back().append(temp);
+                }
+            }
+        }
+    }
+    si_->freeState(temp);
+}
+
+void ompl::tools::ExperienceDatabase::load(const char *filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    load(in);
+    in.close();
+}
+
+void ompl::tools::ExperienceDatabase::store(const char *filename) const
+{
+    std::ofstream out(filename, std::ios::binary);
+    store(out);
+    out.close();
+}
+
+void ompl::tools::ExperienceDatabase::load(std::istream &in)
+{
+    clear();
+    if (!in.good() || in.eof())
+    {
+        logWarn("Unable to load experience database");
+        return;
+    }
+    try
+    {
+        boost::archive::binary_iarchive ia(in);
+        Header h;
+        ia >> h;
+        if (h.marker != OMPL_ARCHIVE_MARKER)
+        {
+            logError("OMPL archive marker not found");
+            return;
+        }
+
+        std::vector<int> sig;
+        si_->getStateSpace()->computeSignature(sig);
+        if (h.signature != sig)
+        {
+            logError("State space signatures do not match");
+            return;
+        }
+
+        logDebug("Deserializing %u paths", (unsigned int)h.path_count);
+        const base::StateSpacePtr &space = si_->getStateSpace();
+        const unsigned int l = space->getSerializationLength();
+        for (std::size_t i = 0 ; i < h.path_count ; ++i)
+        {
+            unsigned int n;
+            ia >> n;
+            if (n < 2)
+                continue;
+            Experience *e = new Experience();
+            e->stateCount = n;
+            e->data.resize(n * l);
+            ia >> boost::serialization::make_binary_object(&e->data[0], e->data.size());
+            e->start = si_->allocState();
+            e->goal = si_->allocState();
+            space->deserialize(e->start, &e->data[0]);
+            space->deserialize(e->goal, &e->data[(n - 1) * l]);
+            addExperience(e);
+        }
+    }
+    catch (boost::archive::archive_exception &ae)
+    {
+        logError("Unable to load archive: %s", ae.what());
+    }
+}
+
+void ompl::tools::ExperienceDatabase::store(std::ostream &out) const
+{
+    if (!out.good())
+    {
+        logWarn("Unable to store experience database");
+        return;
+    }
+    try
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        std::vector<Experience*> experiences;
+        nn_->list(experiences);
+
+        Header h;
+        h.marker = OMPL_ARCHIVE_MARKER;
+        h.path_count = experiences.size();
+        si_->getStateSpace()->computeSignature(h.signature);
+
+        boost::archive::binary_oarchive oa(out);
+        oa << h;
+        logDebug("Serializing %u paths", (unsigned int)h.path_count);
+        for (std::size_t i = 0 ; i < experiences.size() ; ++i)
+        {
+            oa << experiences[i]->stateCount;
+            oa << boost::serialization::make_binary_object(&experiences[i]->data[0], experiences[i]->data.size());
+        }
+    }
+    catch (boost::archive::archive_exception &ae)
+    {
+        logError("Unable to save archive: %s", ae.what());
+    }
+}
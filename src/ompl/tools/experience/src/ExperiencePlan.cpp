@@ -0,0 +1,137 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/tools/experience/ExperiencePlan.h"
+#include "ompl/base/goals/GoalState.h"
+#include "ompl/geometric/SimpleSetup.h"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+ompl::tools::ExperiencePlan::ExperiencePlan(const base::ProblemDefinitionPtr &pdef, const ExperienceDatabasePtr &db) :
+    pdef_(pdef), db_(db), recallCount_(3), repairAttempts_(10), recordSolutions_(true), fromExperience_(false)
+{
+    if (!db_)
+        db_.reset(new ExperienceDatabase(pdef_->getSpaceInformation()));
+    else
+        if (db_->getSpaceInformation().get() != pdef_->getSpaceInformation().get())
+            throw Exception("Experience database does not match space information");
+}
+
+void ompl::tools::ExperiencePlan::setPlanner(const base::PlannerPtr &planner)
+{
+    if (planner && planner->getSpaceInformation().get() != pdef_->getSpaceInformation().get())
+        throw Exception("Planner instance does not match space information");
+    planner_ = planner;
+}
+
+ompl::base::PlannerStatus ompl::tools::ExperiencePlan::solve(double solveTime)
+{
+    return solve(base::timedPlannerTerminationCondition(solveTime, std::min(solveTime / 100.0, 0.1)));
+}
+
+ompl::base::PlannerStatus ompl::tools::ExperiencePlan::solve(const base::PlannerTerminationCondition &ptc)
+{
+    if (!pdef_->getSpaceInformation()->isSetup())
+        pdef_->getSpaceInformation()->setup();
+    if (!planner_)
+        planner_ = geometric::getDefaultPlanner(pdef_->getGoal());
+    if (planner_->getProblemDefinition().get() != pdef_.get())
+        planner_->setProblemDefinition(pdef_);
+    if (!planner_->isSetup())
+        planner_->setup();
+    fromExperience_ = false;
+
+    // retrieve the solutions of the most similar previous queries
+    std::vector<geometric::PathGeometric> recalled;
+    const base::State *start = pdef_->getStartStateCount() > 0 ? pdef_->getStartState(0) : NULL;
+    const base::State *goal = pdef_->getGoal()->hasType(base::GOAL_STATE) ? pdef_->getGoal()->as<base::GoalState>()->getState() : NULL;
+    if (start && goal && recallCount_ > 0)
+        db_->getSimilarPaths(start, goal, recallCount_, recalled);
+
+    // whichever of the repair and the planner succeeds first stops the other one through this condition,
+    // so that the caller's condition is left untouched
+    base::PlannerTerminationCondition racePtc(boost::bind(&base::PlannerTerminationCondition::operator(), &ptc));
+    base::PathPtr repaired;
+    boost::thread *repairThread = NULL;
+    if (!recalled.empty())
+    {
+        logDebug("Attempting to repair %u previous solutions", (unsigned int)recalled.size());
+        repairThread = new boost::thread(boost::bind(&ExperiencePlan::repairPaths, this, &recalled, start, goal, &racePtc, &repaired));
+    }
+
+    base::PlannerStatus status = planner_->solve(racePtc);
+    if (repairThread)
+    {
+        racePtc.terminate();
+        repairThread->join();
+        delete repairThread;
+    }
+
+    if (repaired)
+    {
+        fromExperience_ = pdef_->getSolutionPath() == repaired;
+        status = base::PlannerStatus::EXACT_SOLUTION;
+        if (fromExperience_)
+            logInform("Solution obtained by repairing a previous solution");
+    }
+    else
+        if (recordSolutions_ && status == base::PlannerStatus::EXACT_SOLUTION && !pdef_->hasApproximateSolution())
+            db_->addPath(*static_cast<geometric::PathGeometric*>(pdef_->getSolutionPath().get()));
+
+    return status;
+}
+
+void ompl::tools::ExperiencePlan::repairPaths(const std::vector<geometric::PathGeometric> *recalled, const base::State *start,
+                                              const base::State *goal, const base::PlannerTerminationCondition *ptc, base::PathPtr *repaired)
+{
+    const base::SpaceInformationPtr &si = pdef_->getSpaceInformation();
+    for (std::size_t i = 0 ; i < recalled->size() && !(*ptc)() ; ++i)
+    {
+        // adapt the previous solution to the endpoints of the current query
+        geometric::PathGeometric *path = new geometric::PathGeometric(si, start);
+        path->append(recalled->at(i));
+        path->append(goal);
+
+        // checkAndRepair() does not check the last segment of a path, so the repaired path is checked in full
+        if (path->checkAndRepair(repairAttempts_).second && path->check() && pdef_->getGoal()->isSatisfied(path->getStates().back()))
+        {
+            repaired->reset(path);
+            pdef_->addSolutionPath(*repaired);
+            ptc->terminate();
+            logDebug("Repaired previous solution %u of %u", (unsigned int)(i + 1), (unsigned int)recalled->size());
+            return;
+        }
+        delete path;
+    }
+}
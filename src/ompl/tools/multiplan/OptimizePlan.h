@@ -46,7 +46,8 @@ namespace ompl
 
         /** \brief Run one or more motion planners repeatedly (using a
             specified number of threads), and hybridize solutions, trying
-            to optimize solutions. */
+            to optimize solutions. The threads of the underlying
+            ParallelPlan instance are reused from one round to the next. */
         class OptimizePlan
         {
         public:
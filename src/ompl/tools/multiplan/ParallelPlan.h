@@ -59,7 +59,13 @@ namespace ompl
             using ompl::geometric::PathHybridization. Between calls to
             solve(), the set of known solutions (maintained by
             ompl::base::Goal) are not cleared, and neither is the
-            hybridization datastructure.*/
+            hybridization datastructure.
+
+            Planners run on a pool of threads that is kept alive
+            between calls to solve(), so repeated calls do not create
+            and join threads. Solutions are hybridized by the calling
+            thread while the planners that have not yet terminated keep
+            running.*/
         class ParallelPlan
         {
         public:
@@ -114,9 +120,16 @@ namespace ompl
             /** \brief Run the planner and call ompl::base::PlannerTerminationCondition::terminate() for the other planners once a first solution is found */
             void solveOne(base::Planner *planner, std::size_t minSolCount, const base::PlannerTerminationCondition *ptc);
 
-            /** \brief Run the planner and collect the solutions. This function is only called if hybridize_ is true. */
+            /** \brief Run the planner and notify the thread waiting in solve() that there are new solutions to hybridize.
+                This function is only called if hybridize_ is true. */
             void solveMore(base::Planner *planner, std::size_t minSolCount, std::size_t maxSolCount, const base::PlannerTerminationCondition *ptc);
 
+            /** \brief Record the known solutions in the hybridization and, if at least \e minSolCount are available, compute the hybrid path */
+            void hybridizeSolutions(std::size_t minSolCount);
+
+            /** \brief The loop of the pool thread that runs planner \e index in each round started after round \e round */
+            void worker(std::size_t index, unsigned int round);
+
             /** \brief The problem definition used */
             base::ProblemDefinitionPtr      pdef_;
 
@@ -136,6 +149,38 @@ namespace ompl
 
             /** \brief Lock for phybrid_ */
             boost::mutex                    foundSolCountLock_;
+
+            /** \brief The threads of the pool; there is one thread for each planner */
+            std::vector<boost::thread*>     workers_;
+
+            /** \brief Lock for the state of the pool */
+            boost::mutex                    poolLock_;
+
+            /** \brief Signaled when a round starts or the pool shuts down */
+            boost::condition_variable       roundStart_;
+
+            /** \brief Signaled when a planner terminates or finds solutions to hybridize */
+            boost::condition_variable       roundUpdate_;
+
+            /** \brief The number of rounds started so far */
+            unsigned int                    round_;
+
+            /** \brief The number of planners still running in the current round */
+            std::size_t                     pending_;
+
+            /** \brief The number of solutions found and not yet hybridized in the current round */
+            unsigned int                    toHybridize_;
+
+            /** \brief Set when the pool threads must exit */
+            bool                            shutdown_;
+
+            /** \brief The termination condition of the current round */
+            const base::PlannerTerminationCondition *roundPtc_;
+
+            /** \brief The arguments of solve() for the current round */
+            std::size_t                     minSolCount_;
+            std::size_t                     maxSolCount_;
+            bool                            hybridize_;
         };
 
     }
@@ -38,12 +38,23 @@
 #include "ompl/geometric/PathHybridization.h"
 
 ompl::tools::ParallelPlan::ParallelPlan(const base::ProblemDefinitionPtr &pdef) :
-    pdef_(pdef), phybrid_(new geometric::PathHybridization(pdef->getSpaceInformation()))
+    pdef_(pdef), phybrid_(new geometric::PathHybridization(pdef->getSpaceInformation())), foundSolCount_(0),
+    round_(0), pending_(0), toHybridize_(0), shutdown_(false), roundPtc_(NULL), minSolCount_(0), maxSolCount_(0), hybridize_(false)
 {
 }
 
 ompl::tools::ParallelPlan::~ParallelPlan(void)
 {
+    {
+        boost::mutex::scoped_lock slock(poolLock_);
+        shutdown_ = true;
+        roundStart_.notify_all();
+    }
+    for (std::size_t i = 0 ; i < workers_.size() ; ++i)
+    {
+        workers_[i]->join();
+        delete workers_[i];
+    }
 }
 
 void ompl::tools::ParallelPlan::addPlanner(const base::PlannerPtr &planner)
@@ -94,19 +105,36 @@ ompl::base::PlannerStatus ompl::tools::ParallelPlan::solve(const base::PlannerTe
         pdef_->getSpaceInformation()->setup();
     foundSolCount_ = 0;
 
-    time::point start = time::now();
-    std::vector<boost::thread*> threads(planners_.size());
-    if (hybridize)
-        for (std::size_t i = 0 ; i < threads.size() ; ++i)
-            threads[i] = new boost::thread(boost::bind(&ParallelPlan::solveMore, this, planners_[i].get(), minSolCount, maxSolCount, &ptc));
-    else
-        for (std::size_t i = 0 ; i < threads.size() ; ++i)
-            threads[i] = new boost::thread(boost::bind(&ParallelPlan::solveOne, this, planners_[i].get(), minSolCount, &ptc));
+    // planners that are done stop the others through this condition, so that the caller's condition is left untouched
+    base::PlannerTerminationCondition roundPtc(boost::bind(&base::PlannerTerminationCondition::operator(), &ptc));
 
-    for (std::size_t i = 0 ; i < threads.size() ; ++i)
+    time::point start = time::now();
     {
-        threads[i]->join();
-        delete threads[i];
+        boost::mutex::scoped_lock slock(poolLock_);
+        while (workers_.size() < planners_.size())
+            workers_.push_back(new boost::thread(boost::bind(&ParallelPlan::worker, this, workers_.size(), round_)));
+
+        roundPtc_ = &roundPtc;
+        minSolCount_ = minSolCount;
+        maxSolCount_ = maxSolCount;
+        hybridize_ = hybridize;
+        pending_ = planners_.size();
+        toHybridize_ = 0;
+        ++round_;
+        roundStart_.notify_all();
+
+        // hybridize solutions as they come in, while the remaining planners keep running
+        while (pending_ > 0 || toHybridize_ > 0)
+            if (toHybridize_ > 0)
+            {
+                toHybridize_ = 0;
+                slock.unlock();
+                hybridizeSolutions(minSolCount);
+                slock.lock();
+            }
+            else
+                roundUpdate_.wait(slock);
+        roundPtc_ = NULL;
     }
 
     if (hybridize)
@@ -157,18 +185,57 @@ void ompl::tools::ParallelPlan::solveMore(base::Planner *planner, std::size_t mi
 
         logDebug("Solution found by %s in %lf seconds", planner->getName().c_str(), duration);
 
-        const std::vector<base::PlannerSolution> &paths = pdef_->getSolutions();
+        boost::mutex::scoped_lock slock(poolLock_);
+        ++toHybridize_;
+        roundUpdate_.notify_all();
+    }
+}
 
-        boost::mutex::scoped_lock slock(phlock_);
-        start = time::now();
-        unsigned int attempts = 0;
-        for (std::size_t i = 0 ; i < paths.size() ; ++i)
-            attempts += phybrid_->recordPath(paths[i].path_, false);
+void ompl::tools::ParallelPlan::hybridizeSolutions(std::size_t minSolCount)
+{
+    const std::vector<base::PlannerSolution> &paths = pdef_->getSolutions();
+
+    boost::mutex::scoped_lock slock(phlock_);
+    time::point start = time::now();
+    unsigned int attempts = 0;
+    for (std::size_t i = 0 ; i < paths.size() ; ++i)
+        attempts += phybrid_->recordPath(paths[i].path_, false);
 
-        if (phybrid_->pathCount() >= minSolCount)
-            phybrid_->computeHybridPath();
+    if (phybrid_->pathCount() >= minSolCount)
+        phybrid_->computeHybridPath();
 
-        duration = time::seconds(time::now() - start);
-        logDebug("Spent %f seconds hybridizing %u solution paths (attempted %u connections between paths)", duration, (unsigned int)phybrid_->pathCount(), attempts);
+    double duration = time::seconds(time::now() - start);
+    logDebug("Spent %f seconds hybridizing %u solution paths (attempted %u connections between paths)", duration, (unsigned int)phybrid_->pathCount(), attempts);
+}
+
+void ompl::tools::ParallelPlan::worker(std::size_t index, unsigned int round)
+{
+    boost::mutex::scoped_lock slock(poolLock_);
+    while (true)
+    {
+        while (round_ == round && !shutdown_)
+            roundStart_.wait(slock);
+        if (shutdown_)
+            break;
+        round = round_;
+
+        // there may be more threads than planners in this round
+        if (index >= planners_.size())
+            continue;
+        base::Planner *planner = planners_[index].get();
+        const base::PlannerTerminationCondition *ptc = roundPtc_;
+        std::size_t minSolCount = minSolCount_;
+        std::size_t maxSolCount = maxSolCount_;
+        bool hybridize = hybridize_;
+        slock.unlock();
+
+        if (hybridize)
+            solveMore(planner, minSolCount, maxSolCount, ptc);
+        else
+            solveOne(planner, minSolCount, ptc);
+
+        slock.lock();
+        --pending_;
+        roundUpdate_.notify_all();
     }
 }
@@ -0,0 +1,123 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#ifndef OMPL_UTIL_LOW_DISCREPANCY_
+#define OMPL_UTIL_LOW_DISCREPANCY_
+
+#include <vector>
+
+namespace ompl
+{
+
+    /** \brief Deterministic low-discrepancy sequence of points in
+        the unit cube [0,1)^d. Point \e i of the sequence has as its
+        coordinate \e k the radical inverse of \e i in the base given
+        by the <em>k</em>-th prime number (the Halton
+        sequence). Compared to independent uniform samples, the
+        points of this sequence cover the unit cube more evenly for
+        the same number of points.
+
+        For higher dimensions, the plain Halton sequence shows strong
+        correlations between coordinates that use large
+        bases. Scrambling applies a fixed permutation to the digits
+        of each coordinate (a different permutation for every
+        coordinate), which removes these correlations while keeping
+        the sequence low-discrepancy. The permutations are drawn from
+        ompl::RNG when the sequence is constructed, so scrambled
+        sequences are reproducible when RNG::setSeed() is used.
+
+        An instance of this class is not thread safe. */
+    class HaltonSequence
+    {
+    public:
+
+        /** \brief Construct a sequence of points of dimension \e dimension. If \e scramble is true, digit scrambling is used. */
+        HaltonSequence(unsigned int dimension, bool scramble = false);
+
+        /** \brief Get the dimension of the generated points */
+        unsigned int getDimension(void) const
+        {
+            return bases_.size();
+        }
+
+        /** \brief Check if digit scrambling is used */
+        bool isScrambled(void) const
+        {
+            return !permutations_.empty();
+        }
+
+        /** \brief Get the index of the point the next call to next() produces */
+        unsigned long getIndex(void) const
+        {
+            return index_;
+        }
+
+        /** \brief Set the index of the point the next call to next() produces. Index 0 is the origin, so sequences start at 1 by default. */
+        void setIndex(unsigned long index)
+        {
+            index_ = index;
+        }
+
+        /** \brief Compute the next point of the sequence. The array \e value must have getDimension() elements. */
+        void next(double *value);
+
+        /** \brief Compute the next point of the sequence */
+        void next(std::vector<double> &value)
+        {
+            value.resize(bases_.size());
+            if (!value.empty())
+                next(&value[0]);
+        }
+
+        /** \brief Compute coordinate \e k of point \e index without advancing the sequence */
+        double value(unsigned long index, unsigned int k) const;
+
+        /** \brief Compute the radical inverse of \e index in base \e base: the digits of \e index, mirrored around the decimal point */
+        static double radicalInverse(unsigned long index, unsigned int base);
+
+    private:
+
+        /** \brief The base used for each coordinate */
+        std::vector<unsigned int>              bases_;
+
+        /** \brief The digit permutation used for each coordinate (empty if scrambling is not used) */
+        std::vector< std::vector<unsigned int> > permutations_;
+
+        /** \brief The index of the next point */
+        unsigned long                          index_;
+    };
+
+}
+
+#endif
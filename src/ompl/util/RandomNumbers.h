@@ -41,6 +41,8 @@
 #include <boost/random/uniform_real.hpp>
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/variate_generator.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
 #include <cassert>
 
 namespace ompl
@@ -50,7 +52,16 @@ namespace ompl
         are not const). However, the constructor is thread safe and
         different instances can be used safely in any number of
         threads. It is also guaranteed that all created instances will
-        have a different random seed. */
+        have a different random seed.
+
+        Besides the scalar functions, which draw from a Mersenne
+        twister, the class offers functions that fill arrays of
+        values. These use a counter-based generator (Philox-4x32-10)
+        that produces four 32-bit words per block with no state other
+        than the counter and a key, which keeps the generation loops
+        short and free of dependencies between iterations. Both
+        generators are seeded from the same seed, so setSeed() makes
+        either kind of output reproducible. */
     class RNG
     {
     public:
@@ -58,6 +69,17 @@ namespace ompl
         /** \brief Constructor. Always sets a different random seed */
         RNG(void);
 
+        /** \brief Constructor for one of a family of independent
+            streams. Instances constructed with the same \e seed and
+            different values of \e stream produce independent
+            sequences, which also differ from those of instances
+            built by the default constructor, and the same (\e seed, \e stream) pair always
+            produces the same sequence, regardless of the thread or
+            the order in which instances are constructed. Drawing \e
+            seed from another instance keeps the result reproducible
+            under setSeed(). */
+        RNG(boost::uint32_t seed, boost::uint32_t stream);
+
         /** \brief Generate a random real between 0 and 1 */
         double uniform01(void)
         {
@@ -111,6 +133,18 @@ namespace ompl
         /** \brief Uniform random unit quaternion sampling. The computed value has the order (x,y,z,w) */
         void   quaternion(double value[4]);
 
+        /** \brief Fill \e values with \e count random reals in [0, 1) */
+        void   uniform01Array(double *values, std::size_t count);
+
+        /** \brief Fill \e values with \e count random reals within given bounds: [\e lower_bound, \e upper_bound) */
+        void   uniformRealArray(double lower_bound, double upper_bound, double *values, std::size_t count);
+
+        /** \brief Fill \e values with \e count random reals drawn from a normal distribution with given mean and standard deviation */
+        void   gaussianArray(double mean, double stddev, double *values, std::size_t count);
+
+        /** \brief Sample \e count uniform random unit quaternions. The array \e values must hold 4 * \e count elements; each quaternion has the order (x,y,z,w) */
+        void   quaternionArray(double *values, std::size_t count);
+
         /** \brief Uniform random sampling of Euler roll-pitch-yaw angles, each in the range [-pi, pi). The computed value has the order (roll, pitch, yaw) */
         void   eulerRPY(double value[3]);
 
@@ -133,6 +167,19 @@ namespace ompl
         boost::variate_generator<boost::mt19937&, boost::uniform_real<> >        uni_;
         boost::variate_generator<boost::mt19937&, boost::normal_distribution<> > normal_;
 
+        /** \brief Compute the next block of the counter-based generator */
+        void nextBlock(boost::uint32_t block[4]);
+
+        /** \brief The key of the counter-based generator */
+        boost::uint32_t                                                          key_[2];
+
+        /** \brief The counter of the counter-based generator */
+        boost::uint64_t                                                          counter_;
+
+        /** \brief The high word of the counter blocks: 0 for default instances and 1 for streams, so
+            that no (\e seed, \e stream) pair can produce the sequence of a default instance */
+        boost::uint32_t                                                          domain_;
+
     };
 
 }
@@ -0,0 +1,121 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include "ompl/util/LowDiscrepancy.h"
+#include "ompl/util/RandomNumbers.h"
+#include <algorithm>
+
+/// @cond IGNORE
+namespace
+{
+    void firstPrimes(unsigned int count, std::vector<unsigned int> &primes)
+    {
+        primes.clear();
+        primes.reserve(count);
+        for (unsigned int n = 2 ; primes.size() < count ; ++n)
+        {
+            bool prime = true;
+            for (std::size_t i = 0 ; i < primes.size() && primes[i] * primes[i] <= n ; ++i)
+                if (n % primes[i] == 0)
+                {
+                    prime = false;
+                    break;
+                }
+            if (prime)
+                primes.push_back(n);
+        }
+    }
+}
+/// @endcond
+
+ompl::HaltonSequence::HaltonSequence(unsigned int dimension, bool scramble) : index_(1)
+{
+    firstPrimes(dimension, bases_);
+    if (scramble)
+    {
+        RNG rng;
+        permutations_.resize(dimension);
+        for (unsigned int k = 0 ; k < dimension ; ++k)
+        {
+            std::vector<unsigned int> &p = permutations_[k];
+            p.resize(bases_[k]);
+            for (unsigned int d = 0 ; d < bases_[k] ; ++d)
+                p[d] = d;
+            // digit 0 is kept in place so that the infinite string of
+            // leading zeros of every index still contributes nothing
+            for (unsigned int d = bases_[k] - 1 ; d > 1 ; --d)
+                std::swap(p[d], p[rng.uniformInt(1, d)]);
+        }
+    }
+}
+
+double ompl::HaltonSequence::radicalInverse(unsigned long index, unsigned int base)
+{
+    const double inv = 1.0 / (double)base;
+    double f = inv;
+    double r = 0.0;
+    while (index > 0)
+    {
+        r += f * (double)(index % base);
+        index /= base;
+        f *= inv;
+    }
+    return r;
+}
+
+double ompl::HaltonSequence::value(unsigned long index, unsigned int k) const
+{
+    const unsigned int base = bases_[k];
+    if (permutations_.empty())
+        return radicalInverse(index, base);
+
+    const std::vector<unsigned int> &p = permutations_[k];
+    const double inv = 1.0 / (double)base;
+    double f = inv;
+    double r = 0.0;
+    while (index > 0)
+    {
+        r += f * (double)p[index % base];
+        index /= base;
+        f *= inv;
+    }
+    return r;
+}
+
+void ompl::HaltonSequence::next(double *value)
+{
+    for (unsigned int k = 0 ; k < bases_.size() ; ++k)
+        value[k] = this->value(index_, k);
+    ++index_;
+}
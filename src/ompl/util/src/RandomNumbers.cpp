@@ -42,6 +42,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/math/constants/constants.hpp>
+#include <cmath>
 
 /// The seed the user asked for (cannot be 0)
 static boost::uint32_t& getUserSetSeed(void)
@@ -113,12 +114,138 @@ void ompl::RNG::setSeed(boost::uint32_t seed)
         getUserSetSeed() = seed;
 }
 
-ompl::RNG::RNG(void) : generator_(nextSeed()),
-                       uniDist_(0, 1),
+/// @cond IGNORE
+namespace
+{
+    // One round of Philox-4x32 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011)
+    inline void philoxRound(boost::uint32_t c[4], const boost::uint32_t k[2])
+    {
+        const boost::uint64_t p0 = (boost::uint64_t)0xD2511F53u * c[0];
+        const boost::uint64_t p1 = (boost::uint64_t)0xCD9E8D57u * c[2];
+        const boost::uint32_t c1 = c[1];
+        c[0] = (boost::uint32_t)(p1 >> 32) ^ c1 ^ k[0];
+        c[1] = (boost::uint32_t)p1;
+        c[2] = (boost::uint32_t)(p0 >> 32) ^ c[3] ^ k[1];
+        c[3] = (boost::uint32_t)p0;
+    }
+
+    // A real in [0, 1) with 53 random bits, from two 32-bit words
+    inline double toUnit(boost::uint32_t a, boost::uint32_t b)
+    {
+        return ((double)(a >> 5) * 67108864.0 + (double)(b >> 6)) * (1.0 / 9007199254740992.0);
+    }
+}
+/// @endcond
+
+ompl::RNG::RNG(void) : uniDist_(0, 1),
                        normalDist_(0, 1),
                        uni_(generator_, uniDist_),
-                       normal_(generator_, normalDist_)
+                       normal_(generator_, normalDist_),
+                       counter_(0), domain_(0)
+{
+    const boost::uint32_t seed = nextSeed();
+    generator_.seed(seed);
+    key_[0] = seed;
+    key_[1] = 0;
+}
+
+ompl::RNG::RNG(boost::uint32_t seed, boost::uint32_t stream) : uniDist_(0, 1),
+                                                               normalDist_(0, 1),
+                                                               uni_(generator_, uniDist_),
+                                                               normal_(generator_, normalDist_),
+                                                               counter_(0), domain_(1)
+{
+    // streams count in a different domain than the default constructor, so every stream value is usable
+    key_[0] = seed;
+    key_[1] = stream;
+    boost::uint32_t block[4];
+    nextBlock(block);
+    generator_.seed(block[0]);
+}
+
+void ompl::RNG::nextBlock(boost::uint32_t block[4])
+{
+    block[0] = (boost::uint32_t)counter_;
+    block[1] = (boost::uint32_t)(counter_ >> 32);
+    block[2] = domain_;
+    block[3] = 0;
+    boost::uint32_t k[2] = { key_[0], key_[1] };
+    philoxRound(block, k);
+    for (int r = 1 ; r < 10 ; ++r)
+    {
+        k[0] += 0x9E3779B9u;
+        k[1] += 0xBB67AE85u;
+        philoxRound(block, k);
+    }
+    ++counter_;
+}
+
+void ompl::RNG::uniform01Array(double *values, std::size_t count)
+{
+    boost::uint32_t block[4];
+    std::size_t i = 0;
+    for ( ; i + 1 < count ; i += 2)
+    {
+        nextBlock(block);
+        values[i] = toUnit(block[0], block[1]);
+        values[i + 1] = toUnit(block[2], block[3]);
+    }
+    if (i < count)
+    {
+        nextBlock(block);
+        values[i] = toUnit(block[0], block[1]);
+    }
+}
+
+void ompl::RNG::uniformRealArray(double lower_bound, double upper_bound, double *values, std::size_t count)
+{
+    assert(lower_bound <= upper_bound);
+    uniform01Array(values, count);
+    const double range = upper_bound - lower_bound;
+    for (std::size_t i = 0 ; i < count ; ++i)
+        values[i] = range * values[i] + lower_bound;
+}
+
+// Box-Muller transform: each block gives two uniform reals and thus two independent normal reals
+void ompl::RNG::gaussianArray(double mean, double stddev, double *values, std::size_t count)
 {
+    const double twopi = 2.0 * boost::math::constants::pi<double>();
+    boost::uint32_t block[4];
+    for (std::size_t i = 0 ; i < count ; i += 2)
+    {
+        nextBlock(block);
+        // 1 - u is in (0, 1], so the logarithm is finite
+        const double r = stddev * sqrt(-2.0 * log(1.0 - toUnit(block[0], block[1])));
+        const double t = twopi * toUnit(block[2], block[3]);
+        values[i] = r * cos(t) + mean;
+        if (i + 1 < count)
+            values[i + 1] = r * sin(t) + mean;
+    }
+}
+
+// Same construction as quaternion(), with the three uniform reals of
+// each quaternion coming from the counter-based generator
+void ompl::RNG::quaternionArray(double *values, std::size_t count)
+{
+    static const std::size_t CHUNK = 64;
+    const double twopi = 2.0 * boost::math::constants::pi<double>();
+    double u[3 * CHUNK];
+    while (count > 0)
+    {
+        const std::size_t n = count < CHUNK ? count : CHUNK;
+        uniform01Array(u, 3 * n);
+        for (std::size_t i = 0 ; i < n ; ++i, values += 4)
+        {
+            const double x0 = u[3 * i];
+            const double r1 = sqrt(1.0 - x0), r2 = sqrt(x0);
+            const double t1 = twopi * u[3 * i + 1], t2 = twopi * u[3 * i + 2];
+            values[0] = sin(t1) * r1;
+            values[1] = cos(t1) * r1;
+            values[2] = sin(t2) * r2;
+            values[3] = cos(t2) * r2;
+        }
+        count -= n;
+    }
 }
 
 double ompl::RNG::halfNormalReal(double r_min, double r_max, double focus)
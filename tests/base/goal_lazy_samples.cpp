@@ -0,0 +1,209 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "GoalLazySamples"
+#include <boost/test/unit_test.hpp>
+#include "ompl/base/goals/GoalLazySamples.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/geometric/planners/rrt/RRTConnect.h"
+#include "ompl/util/RandomNumbers.h"
+#include "ompl/util/Time.h"
+#include <boost/bind.hpp>
+#include <sstream>
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/// @cond IGNORE
+class GoalSampler
+{
+public:
+
+    /* produce at most maxCalls states, waiting delay seconds before each one; safe to call in parallel */
+    GoalSampler(unsigned int maxCalls, double delay) : calls_(0), maxCalls_(maxCalls), delay_(delay)
+    {
+    }
+
+    bool sample(const base::GoalLazySamples *goal, base::State *st)
+    {
+        if (delay_ > 0.0)
+            boost::this_thread::sleep(time::seconds(delay_));
+        boost::mutex::scoped_lock slock(lock_);
+        if (calls_ >= maxCalls_)
+            return false;
+        ++calls_;
+        double *values = st->as<base::RealVectorStateSpace::StateType>()->values;
+        values[0] = rng_.uniformReal(0.0, 1.0);
+        values[1] = rng_.uniformReal(0.0, 1.0);
+        return true;
+    }
+
+    unsigned int calls(void)
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        return calls_;
+    }
+
+private:
+
+    boost::mutex lock_;
+    RNG          rng_;
+    unsigned int calls_;
+    unsigned int maxCalls_;
+    double       delay_;
+};
+/// @endcond
+
+static base::SpaceInformationPtr spaceInformation(void)
+{
+    base::RealVectorStateSpace *space = new base::RealVectorStateSpace(2);
+    space->setBounds(0.0, 1.0);
+    base::SpaceInformationPtr si(new base::SpaceInformation(base::StateSpacePtr(space)));
+    si->setStateValidityChecker(base::StateValidityCheckerPtr(new base::AllValidStateValidityChecker(si)));
+    si->setup();
+    return si;
+}
+
+BOOST_AUTO_TEST_CASE(SamplerPool)
+{
+    base::SpaceInformationPtr si = spaceInformation();
+    GoalSampler sampler(1000000, 0.0);
+    base::GoalLazySamples goal(si, boost::bind(&GoalSampler::sample, &sampler, _1, _2), false);
+    goal.setSamplingThreadCount(4);
+    goal.setMaxStateCount(10);
+    BOOST_CHECK_EQUAL(goal.getSamplingThreadCount(), 4u);
+    goal.startSampling();
+    BOOST_CHECK(goal.isSampling());
+
+    /* the sampling threads fill the goal up to its bound and then wait */
+    BOOST_CHECK(goal.waitForStateCount(9, 10.0));
+    boost::this_thread::sleep(time::seconds(0.1));
+    BOOST_CHECK_EQUAL(goal.getStateCount(), 10u);
+    BOOST_CHECK(goal.isSampling());
+    unsigned int calls = sampler.calls();
+    boost::this_thread::sleep(time::seconds(0.1));
+    BOOST_CHECK_EQUAL(sampler.calls(), calls);
+
+    /* clearing the states lets sampling resume */
+    goal.clear();
+    BOOST_CHECK(goal.waitForStateCount(0, 10.0));
+    BOOST_CHECK(sampler.calls() > calls);
+
+    goal.stopSampling();
+    BOOST_CHECK(!goal.isSampling());
+    BOOST_CHECK(goal.getStateCount() <= 10u);
+    BOOST_CHECK_EQUAL(goal.samplingAttemptsCount(), sampler.calls());
+}
+
+BOOST_AUTO_TEST_CASE(WaitForStates)
+{
+    base::SpaceInformationPtr si = spaceInformation();
+
+    /* waiting threads are woken up when a state is added, well before the timeout */
+    GoalSampler slow(1, 0.2);
+    base::GoalLazySamples goal(si, boost::bind(&GoalSampler::sample, &slow, _1, _2));
+    time::point start = time::now();
+    BOOST_CHECK(goal.waitForStateCount(0, 10.0));
+    BOOST_CHECK(time::seconds(time::now() - start) < 5.0);
+
+    /* waiting stops once the sampling function asks for no more calls */
+    start = time::now();
+    BOOST_CHECK(!goal.waitForStateCount(1, 10.0));
+    BOOST_CHECK(time::seconds(time::now() - start) < 5.0);
+    BOOST_CHECK(!goal.isSampling());
+}
+
+BOOST_AUTO_TEST_CASE(StateCache)
+{
+    base::SpaceInformationPtr si = spaceInformation();
+    base::GoalStateCachePtr cache(new base::GoalStateCache());
+
+    /* states found for a goal are recorded under its key */
+    GoalSampler sampler(20, 0.0);
+    base::GoalLazySamples goal(si, boost::bind(&GoalSampler::sample, &sampler, _1, _2), false);
+    goal.setStateCache(cache, "goal");
+    goal.startSampling();
+    while (goal.isSampling())
+        goal.waitForStateCount(goal.getStateCount(), 0.1);
+    goal.stopSampling();
+    BOOST_CHECK_EQUAL(goal.getStateCount(), 20u);
+    BOOST_CHECK_EQUAL(cache->size("goal"), 20u);
+    BOOST_CHECK_EQUAL(cache->size("other"), 0u);
+
+    /* the cache survives storing and loading */
+    std::stringstream ss;
+    cache->store(ss);
+    base::GoalStateCachePtr loaded(new base::GoalStateCache());
+    loaded->load(ss);
+    BOOST_CHECK_EQUAL(loaded->size("goal"), 20u);
+
+    /* a later query for the same goal starts from the cached states, before any new sample is computed */
+    GoalSampler none(0, 0.0);
+    base::GoalLazySamples warm(si, boost::bind(&GoalSampler::sample, &none, _1, _2), false);
+    warm.setStateCache(loaded, "goal");
+    warm.startSampling();
+    BOOST_CHECK(warm.waitForStateCount(19, 10.0));
+    warm.stopSampling();
+    BOOST_CHECK_EQUAL(warm.getStateCount(), 20u);
+    for (std::size_t i = 0 ; i < warm.getStateCount() ; ++i)
+        BOOST_CHECK(goal.distanceGoal(warm.getState(i)) < 1e-12);
+
+    /* other goals are not affected */
+    base::GoalLazySamples cold(si, boost::bind(&GoalSampler::sample, &none, _1, _2), false);
+    cold.setStateCache(loaded, "other");
+    cold.startSampling();
+    cold.stopSampling();
+    BOOST_CHECK_EQUAL(cold.getStateCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(PlanToLazyGoal)
+{
+    base::SpaceInformationPtr si = spaceInformation();
+    GoalSampler sampler(5, 0.05);
+    base::GoalPtr goal(new base::GoalLazySamples(si, boost::bind(&GoalSampler::sample, &sampler, _1, _2)));
+
+    base::ProblemDefinitionPtr pdef(new base::ProblemDefinition(si));
+    base::ScopedState<base::RealVectorStateSpace> start(si);
+    start->values[0] = 0.5;
+    start->values[1] = 0.5;
+    pdef->addStartState(start);
+    pdef->setGoal(goal);
+
+    base::PlannerPtr planner(new geometric::RRTConnect(si));
+    planner->setProblemDefinition(pdef);
+    planner->setup();
+    BOOST_CHECK(planner->solve(10.0));
+    BOOST_CHECK(pdef->hasSolution());
+    goal->as<base::GoalLazySamples>()->stopSampling();
+}
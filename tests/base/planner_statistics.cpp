@@ -0,0 +1,192 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "PlannerStatistics"
+#include <boost/test/unit_test.hpp>
+#include "ompl/base/PlannerStatistics.h"
+#include "ompl/base/ProblemDefinition.h"
+#include "ompl/base/ScopedState.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/geometric/planners/rrt/RRT.h"
+#include <boost/thread.hpp>
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/// @cond IGNORE
+static void sleepBriefly(void)
+{
+    boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+}
+
+static base::PlannerPtr makePlanner(void)
+{
+    base::StateSpacePtr space(new base::RealVectorStateSpace(2));
+    space->as<base::RealVectorStateSpace>()->setBounds(0.0, 1.0);
+    base::SpaceInformationPtr si(new base::SpaceInformation(space));
+    si->setup();
+
+    base::ScopedState<base::RealVectorStateSpace> start(space), goal(space);
+    start->values[0] = start->values[1] = 0.1;
+    goal->values[0] = goal->values[1] = 0.9;
+    base::ProblemDefinitionPtr pdef(new base::ProblemDefinition(si));
+    pdef->setStartAndGoalStates(start, goal, 0.01);
+
+    base::PlannerPtr planner(new geometric::RRT(si));
+    planner->setProblemDefinition(pdef);
+    planner->setup();
+    return planner;
+}
+/// @endcond
+
+BOOST_AUTO_TEST_CASE(Timer)
+{
+    base::PlannerStatistics stats;
+    BOOST_CHECK(!stats.isTiming());
+
+    /* calls are always counted, time only when timing is enabled */
+    {
+        base::PlannerStatistics::Timer timer(stats.motionChecks);
+        sleepBriefly();
+    }
+    BOOST_CHECK_EQUAL(stats.motionChecks.calls, 1u);
+    BOOST_CHECK_EQUAL(stats.motionChecks.time, 0.0);
+
+    stats.setTiming(true);
+    {
+        base::PlannerStatistics::Timer timer(stats.motionChecks);
+        sleepBriefly();
+    }
+    BOOST_CHECK_EQUAL(stats.motionChecks.calls, 2u);
+    BOOST_CHECK(stats.motionChecks.time > 0.0);
+
+    /* adding counters sums them, but keeps the larger graph */
+    base::PlannerStatistics other;
+    other.motionChecks.calls = 3;
+    other.samples = 5;
+    other.graphStates = 7;
+    stats.graphStates = 10;
+    stats.add(other);
+    BOOST_CHECK_EQUAL(stats.motionChecks.calls, 5u);
+    BOOST_CHECK_EQUAL(stats.samples, 5u);
+    BOOST_CHECK_EQUAL(stats.graphStates, 10u);
+
+    std::map<std::string, std::string> properties;
+    stats.getProperties(properties);
+    BOOST_CHECK_EQUAL(properties["motion checks INTEGER"], "5");
+    BOOST_CHECK_EQUAL(properties["samples INTEGER"], "5");
+    BOOST_CHECK(properties.find("motion check time REAL") != properties.end());
+
+    /* the time properties are left out when time is not measured */
+    properties.clear();
+    other.getProperties(properties);
+    BOOST_CHECK_EQUAL(properties["motion checks INTEGER"], "3");
+    BOOST_CHECK(properties.find("motion check time REAL") == properties.end());
+
+    /* clearing resets the counters, but not the timing */
+    stats.clear();
+    BOOST_CHECK_EQUAL(stats.motionChecks.calls, 0u);
+    BOOST_CHECK_EQUAL(stats.motionChecks.time, 0.0);
+    BOOST_CHECK(stats.isTiming());
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedSolves)
+{
+    base::PlannerPtr planner = makePlanner();
+    BOOST_CHECK(!planner->getTimeStatistics());
+
+    BOOST_REQUIRE(planner->solve(1.0));
+    const base::PlannerStatistics first = planner->getStatistics();
+    BOOST_CHECK(first.nnQueries.calls > 0);
+    BOOST_CHECK(first.samples > 0);
+    /* the states checked by the motion validator are counted as well */
+    BOOST_CHECK(first.stateChecks.calls > 0);
+    BOOST_CHECK_EQUAL(first.nnQueries.time, 0.0);
+
+    /* a second solve() adds to the counters of the first one */
+    BOOST_REQUIRE(planner->solve(1.0));
+    const base::PlannerStatistics &second = planner->getStatistics();
+    BOOST_CHECK(second.nnQueries.calls > first.nnQueries.calls);
+    BOOST_CHECK(second.samples > first.samples);
+    BOOST_CHECK(second.graphStates >= first.graphStates);
+
+    /* clear() resets them */
+    planner->clear();
+    BOOST_CHECK_EQUAL(planner->getStatistics().nnQueries.calls, 0u);
+    BOOST_CHECK_EQUAL(planner->getStatistics().samples, 0u);
+
+    /* with timing enabled, the time of the counted operations is measured as well */
+    planner->setTimeStatistics(true);
+    planner->getProblemDefinition()->clearSolutionPaths();
+    BOOST_REQUIRE(planner->solve(1.0));
+    BOOST_CHECK(planner->getStatistics().nnQueries.calls > 0);
+    BOOST_CHECK(planner->getStatistics().nnQueries.time > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadScope)
+{
+    base::PlannerPtr planner = makePlanner();
+    const base::SpaceInformationPtr &si = planner->getSpaceInformation();
+    base::ScopedState<> state(si);
+    state.random();
+
+    /* without a scope, checks are not counted anywhere */
+    BOOST_CHECK(base::PlannerStatistics::getThreadStatistics() == NULL);
+    si->isValid(state.get());
+
+    base::PlannerStatistics outer, inner;
+    {
+        base::PlannerStatistics::ThreadScope outerScope(outer);
+        si->isValid(state.get());
+
+        /* the innermost scope counts */
+        {
+            base::PlannerStatistics::ThreadScope innerScope(inner);
+            BOOST_CHECK(base::PlannerStatistics::getThreadStatistics() == &inner);
+            si->isValid(state.get());
+            si->isValid(state.get());
+        }
+        BOOST_CHECK(base::PlannerStatistics::getThreadStatistics() == &outer);
+        si->isValid(state.get());
+
+        /* checks made by other threads are not counted in this thread's scope */
+        boost::thread other(boost::bind(&base::SpaceInformation::isValid, si.get(), state.get()));
+        other.join();
+    }
+    BOOST_CHECK(base::PlannerStatistics::getThreadStatistics() == NULL);
+    si->isValid(state.get());
+
+    BOOST_CHECK_EQUAL(outer.stateChecks.calls, 2u);
+    BOOST_CHECK_EQUAL(inner.stateChecks.calls, 2u);
+}
@@ -0,0 +1,245 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "ProblemDefinition"
+#include <boost/test/unit_test.hpp>
+#include "ompl/base/ProblemDefinition.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/util/RandomNumbers.h"
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/// @cond IGNORE
+/* a path that only knows its length */
+class LengthPath : public base::Path
+{
+public:
+
+    LengthPath(const base::SpaceInformationPtr &si, double length) : base::Path(si), length_(length)
+    {
+    }
+
+    virtual double length(void) const
+    {
+        return length_;
+    }
+
+    virtual double cost(const base::OptimizationObjective &) const
+    {
+        return length_;
+    }
+
+    virtual bool check(void) const
+    {
+        return true;
+    }
+
+    virtual void print(std::ostream &out) const
+    {
+        out << "Path of length " << length_ << std::endl;
+    }
+
+private:
+
+    double length_;
+};
+
+static base::SpaceInformationPtr allocSpaceInformation(void)
+{
+    base::StateSpacePtr space(new base::RealVectorStateSpace(1));
+    space->as<base::RealVectorStateSpace>()->setBounds(0.0, 1.0);
+    base::SpaceInformationPtr si(new base::SpaceInformation(space));
+    si->setup();
+    return si;
+}
+
+class BestSolutionRecorder
+{
+public:
+
+    BestSolutionRecorder(void) : calls_(0), monotonic_(true), last_(std::numeric_limits<double>::infinity())
+    {
+    }
+
+    void record(const base::PlannerSolution &solution)
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        ++calls_;
+        if (solution.length_ >= last_)
+            monotonic_ = false;
+        last_ = solution.length_;
+    }
+
+    unsigned int calls(void)
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        return calls_;
+    }
+
+    bool monotonic(void)
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        return monotonic_;
+    }
+
+    double last(void)
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        return last_;
+    }
+
+private:
+
+    unsigned int calls_;
+    bool         monotonic_;
+    double       last_;
+    boost::mutex lock_;
+};
+
+static void addSolutions(const base::ProblemDefinitionPtr &pdef, unsigned int count, double *shortest)
+{
+    RNG rng;
+    *shortest = std::numeric_limits<double>::infinity();
+    for (unsigned int i = 0 ; i < count ; ++i)
+    {
+        double length = rng.uniformReal(1.0, 100.0);
+        *shortest = std::min(*shortest, length);
+        pdef->addSolutionPath(base::PathPtr(new LengthPath(pdef->getSpaceInformation(), length)));
+    }
+}
+
+static void monitorBestSolution(const base::ProblemDefinitionPtr &pdef, const bool *done, bool *monotonic)
+{
+    double last = std::numeric_limits<double>::infinity();
+    while (!*done)
+    {
+        base::PathPtr path = pdef->getSolutionPath();
+        if (path)
+        {
+            if (path->length() > last)
+                *monotonic = false;
+            last = path->length();
+        }
+        boost::this_thread::yield();
+    }
+}
+/// @endcond
+
+BOOST_AUTO_TEST_CASE(SolutionRanking)
+{
+    base::SpaceInformationPtr si = allocSpaceInformation();
+    base::ProblemDefinition pdef(si);
+    BOOST_CHECK(!pdef.hasSolution());
+    BOOST_CHECK_EQUAL(pdef.getSolutionDifference(), -1.0);
+
+    pdef.addSolutionPath(base::PathPtr(new LengthPath(si, 1.0)), true, 0.5);
+    BOOST_CHECK(pdef.hasApproximateSolution());
+    BOOST_CHECK_EQUAL(pdef.getSolutionDifference(), 0.5);
+
+    /* exact solutions are preferred over approximate ones, then shorter ones over longer ones */
+    pdef.setMaxSolutionCount(3);
+    const double lengths[] = { 5.0, 4.0, 3.0, 6.0, 2.0 };
+    for (unsigned int i = 0 ; i < 5 ; ++i)
+        pdef.addSolutionPath(base::PathPtr(new LengthPath(si, lengths[i])));
+    BOOST_CHECK(!pdef.hasApproximateSolution());
+
+    /* the count includes the solutions that were not retained */
+    BOOST_CHECK_EQUAL(pdef.getSolutionCount(), 6u);
+    BOOST_CHECK_EQUAL(pdef.getSolutions().size(), 3u);
+    BOOST_CHECK_EQUAL(pdef.getSolutionPath()->length(), 2.0);
+
+    base::PlannerSolution best(base::PathPtr(new LengthPath(si, 0.0)));
+    BOOST_REQUIRE(pdef.getBestSolution(best));
+    BOOST_CHECK_EQUAL(best.length_, 2.0);
+    BOOST_CHECK_EQUAL(best.index_, 5);
+
+    std::vector<base::PlannerSolution> solutions = pdef.getSolutions();
+    BOOST_REQUIRE_EQUAL(solutions.size(), 3u);
+    BOOST_CHECK_EQUAL(solutions[0].length_, 2.0);
+    BOOST_CHECK_EQUAL(solutions[1].length_, 3.0);
+    BOOST_CHECK_EQUAL(solutions[2].length_, 4.0);
+
+    /* lowering the limit discards the worst of the retained solutions */
+    pdef.setMaxSolutionCount(2);
+    solutions = pdef.getSolutions();
+    BOOST_REQUIRE_EQUAL(solutions.size(), 2u);
+    BOOST_CHECK_EQUAL(solutions[1].length_, 3.0);
+
+    pdef.clearSolutionPaths();
+    BOOST_CHECK(!pdef.hasSolution());
+    BOOST_CHECK(!pdef.getSolutionPath());
+    BOOST_CHECK_EQUAL(pdef.getSolutionCount(), 0u);
+    BOOST_CHECK(!pdef.getBestSolution(best));
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentSolutions)
+{
+    base::ProblemDefinitionPtr pdef(new base::ProblemDefinition(allocSpaceInformation()));
+    pdef->setMaxSolutionCount(10);
+    BestSolutionRecorder recorder;
+    pdef->setBestSolutionCallback(boost::bind(&BestSolutionRecorder::record, &recorder, _1));
+
+    /* a monitoring thread must only ever see the best solution improve */
+    bool done = false;
+    bool monotonic = true;
+    boost::thread monitor(boost::bind(&monitorBestSolution, pdef, &done, &monotonic));
+
+    const unsigned int threads = 8;
+    const unsigned int count = 1000;
+    std::vector<double> shortest(threads);
+    boost::thread_group writers;
+    for (unsigned int i = 0 ; i < threads ; ++i)
+        writers.create_thread(boost::bind(&addSolutions, pdef, count, &shortest[i]));
+    writers.join_all();
+    done = true;
+    monitor.join();
+
+    BOOST_CHECK(monotonic);
+    BOOST_CHECK_EQUAL(pdef->getSolutionCount(), threads * count);
+    double best = *std::min_element(shortest.begin(), shortest.end());
+    BOOST_CHECK_EQUAL(pdef->getSolutionPath()->length(), best);
+    BOOST_CHECK(recorder.calls() >= 1);
+    BOOST_CHECK(recorder.monotonic());
+    BOOST_CHECK_EQUAL(recorder.last(), best);
+
+    /* the limit holds across all the threads that added solutions */
+    std::vector<base::PlannerSolution> solutions = pdef->getSolutions();
+    BOOST_REQUIRE_EQUAL(solutions.size(), 10u);
+    BOOST_CHECK_EQUAL(solutions[0].length_, best);
+    for (std::size_t i = 1 ; i < solutions.size() ; ++i)
+        BOOST_CHECK(solutions[i - 1].length_ <= solutions[i].length_);
+}
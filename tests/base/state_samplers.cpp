@@ -0,0 +1,154 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "StateSamplers"
+#include <boost/test/unit_test.hpp>
+
+#include "ompl/base/ScopedState.h"
+#include "ompl/base/samplers/HaltonStateSampler.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/base/spaces/SE3StateSpace.h"
+#include "ompl/base/spaces/TimeStateSpace.h"
+#include "ompl/base/spaces/DiscreteStateSpace.h"
+#include "ompl/util/LowDiscrepancy.h"
+#include <cmath>
+#include <set>
+
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+BOOST_AUTO_TEST_CASE(Halton_Sequence)
+{
+    BOOST_CHECK_EQUAL(HaltonSequence::radicalInverse(1, 2), 0.5);
+    BOOST_CHECK_EQUAL(HaltonSequence::radicalInverse(2, 2), 0.25);
+    BOOST_CHECK_EQUAL(HaltonSequence::radicalInverse(3, 2), 0.75);
+    BOOST_CHECK_EQUAL(HaltonSequence::radicalInverse(4, 2), 0.125);
+    BOOST_CHECK_CLOSE(HaltonSequence::radicalInverse(5, 3), 7.0 / 9.0, 1e-9);
+
+    HaltonSequence seq(3);
+    std::vector<double> p;
+    seq.next(p);
+    BOOST_CHECK_EQUAL(p.size(), 3u);
+    BOOST_CHECK_CLOSE(p[0], 1.0 / 2.0, 1e-9);
+    BOOST_CHECK_CLOSE(p[1], 1.0 / 3.0, 1e-9);
+    BOOST_CHECK_CLOSE(p[2], 1.0 / 5.0, 1e-9);
+    BOOST_CHECK_EQUAL(seq.getIndex(), 2u);
+
+    // scrambling permutes digits, but keeps points distinct and in the unit cube
+    HaltonSequence scrambled(20, true);
+    BOOST_CHECK(scrambled.isScrambled());
+    std::set<double> last;
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+        scrambled.next(p);
+        for (std::size_t k = 0 ; k < p.size() ; ++k)
+        {
+            BOOST_CHECK(p[k] >= 0.0 && p[k] < 1.0);
+        }
+        last.insert(p[19]);
+    }
+    BOOST_CHECK_EQUAL(last.size(), 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(Halton_Coverage)
+{
+    base::StateSpacePtr space(new base::RealVectorStateSpace(2));
+    space->as<base::RealVectorStateSpace>()->setBounds(0.0, 1.0);
+    space->setStateSamplerAllocator(&base::allocHaltonStateSampler);
+    base::StateSamplerPtr sampler = space->allocStateSampler();
+    BOOST_CHECK(dynamic_cast<base::HaltonStateSampler*>(sampler.get()) != NULL);
+    static_cast<base::HaltonStateSampler*>(sampler.get())->getSequence().setIndex(1);
+
+    // 256 points from the start of the sequence must fall in every cell of an 8x8 grid
+    bool hit[8][8] = {{false}};
+    base::ScopedState<base::RealVectorStateSpace> s(space);
+    for (int i = 0 ; i < 256 ; ++i)
+    {
+        sampler->sampleUniform(s.get());
+        hit[(int)(s[0] * 8)][(int)(s[1] * 8)] = true;
+    }
+    for (int i = 0 ; i < 8 ; ++i)
+        for (int j = 0 ; j < 8 ; ++j)
+            BOOST_CHECK(hit[i][j]);
+}
+
+BOOST_AUTO_TEST_CASE(Halton_Compound)
+{
+    base::StateSpacePtr se3(new base::SE3StateSpace());
+    base::RealVectorBounds bounds(3);
+    bounds.setLow(-1);
+    bounds.setHigh(1);
+    se3->as<base::SE3StateSpace>()->setBounds(bounds);
+    base::StateSpacePtr space = se3 + base::StateSpacePtr(new base::TimeStateSpace()) +
+        base::StateSpacePtr(new base::DiscreteStateSpace(2, 5));
+    space->setStateSamplerAllocator(&base::allocScrambledHaltonStateSampler);
+
+    base::StateSamplerPtr s1 = space->allocStateSampler();
+    base::StateSamplerPtr s2;
+    base::ScopedState<> a(space);
+    for (int i = 0 ; i < 1000 ; ++i)
+    {
+        s1->sampleUniform(a.get());
+        BOOST_CHECK(space->satisfiesBounds(a.get()));
+        const base::SO3StateSpace::StateType &q = a->as<base::CompoundState>()->as<base::SE3StateSpace::StateType>(0)->rotation();
+        BOOST_CHECK_CLOSE(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w, 1.0, 1e-6);
+        int v = a->as<base::CompoundState>()->as<base::DiscreteStateSpace::StateType>(2)->value;
+        BOOST_CHECK(v >= 2 && v <= 5);
+    }
+
+    // instances of the unscrambled sampler start at different points of the sequence
+    se3->setStateSamplerAllocator(&base::allocHaltonStateSampler);
+    s1 = se3->allocStateSampler();
+    s2 = se3->allocStateSampler();
+    HaltonSequence &q1 = static_cast<base::HaltonStateSampler*>(s1.get())->getSequence();
+    HaltonSequence &q2 = static_cast<base::HaltonStateSampler*>(s2.get())->getSequence();
+    BOOST_CHECK(q1.getIndex() != q2.getIndex());
+    base::ScopedState<base::SE3StateSpace> c(se3), d(se3);
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+        s1->sampleUniform(c.get());
+        s2->sampleUniform(d.get());
+        BOOST_CHECK(c != d);
+    }
+
+    // they generate the same samples from the same index
+    q2.setIndex(q1.getIndex());
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+        s1->sampleUniform(c.get());
+        s2->sampleUniform(d.get());
+        BOOST_CHECK(c == d);
+    }
+}
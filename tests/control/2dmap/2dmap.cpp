@@ -37,7 +37,10 @@
 #define BOOST_TEST_MODULE "ControlPlanning"
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
 #include <iostream>
+#include <algorithm>
+#include <set>
 
 #include "ompl/base/goals/GoalState.h"
 #include "ompl/base/spaces/RealVectorStateSpace.h"
@@ -48,6 +51,7 @@
 #include "ompl/control/planners/syclop/SyclopEST.h"
 #include "ompl/control/planners/syclop/SyclopRRT.h"
 #include "ompl/control/planners/syclop/GridDecomposition.h"
+#include "ompl/control/planners/syclop/AdaptiveDecomposition.h"
 
 #include "../../BoostTestTeamCityReporter.h"
 #include "../../resources/config.h"
@@ -319,11 +323,12 @@ protected:
     }
 };
 
-// A 2D workspace grid-decomposition for Syclop planners
-class SyclopDecomposition : public control::GridDecomposition
+// A 2D workspace decomposition for Syclop planners, either a grid or an adaptive one
+template <class Decomposition>
+class SyclopDecomposition : public Decomposition
 {
     public:
-        SyclopDecomposition(const int len, const base::RealVectorBounds& b) : GridDecomposition(len, 2, b) {}
+        SyclopDecomposition(const int len, const base::RealVectorBounds& b) : Decomposition(len, 2, b) {}
 
         virtual void project(const base::State* s, std::vector<double>& coord) const
         {
@@ -334,7 +339,7 @@ class SyclopDecomposition : public control::GridDecomposition
 
         virtual void sampleFromRegion(const int rid, const base::StateSamplerPtr& sampler, base::State* s)
         {
-            const base::RealVectorBounds& regionBounds = getRegionBounds(rid);
+            const base::RealVectorBounds& regionBounds = this->getRegionBounds(rid);
 
             sampler->sampleUniform(s);
             base::RealVectorStateSpace::StateType& st = *s->as<base::RealVectorStateSpace::StateType>();
@@ -346,8 +351,69 @@ class SyclopDecomposition : public control::GridDecomposition
         ompl::RNG rng_;
 };
 
+// An adaptive decomposition that counts the regions split by expansion threads while the thread that created it
+// computes a lead. A lead computation queries the neighbors of each region at most once, so a repeated query marks
+// the start of the next lead; splits are only counted once the lead computation they interrupted goes on.
+class LeadSplitDecomposition : public SyclopDecomposition<control::AdaptiveDecomposition>
+{
+    public:
+        LeadSplitDecomposition(const int len, const base::RealVectorBounds& b, unsigned int &splitsDuringLead) :
+            SyclopDecomposition<control::AdaptiveDecomposition>(len, b), leadThread_(boost::this_thread::get_id()),
+            pendingSplits_(0), splitsDuringLead_(splitsDuringLead)
+        {
+        }
+
+        virtual void getNeighbors(const int rid, std::vector<int>& neighbors) const
+        {
+            SyclopDecomposition<control::AdaptiveDecomposition>::getNeighbors(rid, neighbors);
+            if (boost::this_thread::get_id() != leadThread_)
+                return;
+            boost::mutex::scoped_lock lock(mutex_);
+            if (leadQueries_.insert(rid).second)
+                splitsDuringLead_ += pendingSplits_;
+            else
+            {
+                leadQueries_.clear();
+                leadQueries_.insert(rid);
+            }
+            pendingSplits_ = 0;
+        }
+
+        virtual bool refineRegion(const int rid, const double coverage, std::vector<int>& newRegions)
+        {
+            const bool split = SyclopDecomposition<control::AdaptiveDecomposition>::refineRegion(rid, coverage, newRegions);
+            if (split && boost::this_thread::get_id() != leadThread_)
+            {
+                boost::mutex::scoped_lock lock(mutex_);
+                ++pendingSplits_;
+            }
+            return split;
+        }
+
+    private:
+        boost::thread::id       leadThread_;
+        mutable boost::mutex    mutex_;
+        mutable std::set<int>   leadQueries_;
+        mutable unsigned int    pendingSplits_;
+        unsigned int           &splitsDuringLead_;
+};
+
 class SyclopRRTTest : public TestPlanner
 {
+public:
+
+    SyclopRRTTest(unsigned int threads = 1, bool adaptive = false) : threads_(threads), adaptive_(adaptive), splitsDuringLead_(0)
+    {
+    }
+
+    // The number of regions split by expansion threads while a lead was computed, over all the problems solved
+    unsigned int getSplitsDuringLead(void) const
+    {
+        return splitsDuringLead_;
+    }
+
+protected:
+
     base::PlannerPtr newPlanner(const control::SpaceInformationPtr &si)
     {
         base::RealVectorBounds bounds(2);
@@ -358,20 +424,42 @@ class SyclopRRTTest : public TestPlanner
         bounds.setHigh(0, spacebounds.high[0]);
         bounds.setHigh(1, spacebounds.high[1]);
 
-        // Create a 10x10 grid decomposition for Syclop
-        control::DecompositionPtr decomp(new SyclopDecomposition (10, bounds));
+        // Create a 10x10 grid decomposition for Syclop, or an adaptive one starting from a 5x5 grid
+        control::DecompositionPtr decomp;
+        if (adaptive_)
+        {
+            LeadSplitDecomposition *adaptive = new LeadSplitDecomposition(5, bounds, splitsDuringLead_);
+            // split regions early so that refinement happens on this small problem
+            adaptive->setSplitCoverage(0.05);
+            decomp.reset(adaptive);
+        }
+        else
+            decomp.reset(new SyclopDecomposition<control::GridDecomposition> (10, bounds));
 
         control::SyclopRRT *srrt = new control::SyclopRRT(si, decomp);
         // Set syclop parameters conducive to a tiny workspace
         srrt->setNumFreeVolumeSamples(1000);
         srrt->setNumRegionExpansions(10);
         srrt->setNumTreeExpansions(5);
+        srrt->setThreadCount(threads_);
         return base::PlannerPtr(srrt);
     }
+
+    unsigned int threads_;
+    bool         adaptive_;
+    unsigned int splitsDuringLead_;
 };
 
 class SyclopESTTest : public TestPlanner
 {
+public:
+
+    SyclopESTTest(unsigned int threads = 1) : threads_(threads)
+    {
+    }
+
+protected:
+
     base::PlannerPtr newPlanner(const control::SpaceInformationPtr &si)
     {
         base::RealVectorBounds bounds(2);
@@ -383,15 +471,18 @@ class SyclopESTTest : public TestPlanner
         bounds.setHigh(1, spacebounds.high[1]);
 
         // Create a 10x10 grid decomposition for Syclop
-        control::DecompositionPtr decomp(new SyclopDecomposition (10, bounds));
+        control::DecompositionPtr decomp(new SyclopDecomposition<control::GridDecomposition> (10, bounds));
 
         control::SyclopEST *sest = new control::SyclopEST(si, decomp);
         // Set syclop parameters conducive to a tiny workspace
         sest->setNumFreeVolumeSamples(1000);
         sest->setNumRegionExpansions(10);
         sest->setNumTreeExpansions(5);
+        sest->setThreadCount(threads_);
         return base::PlannerPtr(sest);
     }
+
+    unsigned int threads_;
 };
 
 
@@ -561,6 +652,50 @@ BOOST_AUTO_TEST_CASE(controlEST)
     BOOST_CHECK(avglength < 100.0);
 }
 
+BOOST_AUTO_TEST_CASE(controlAdaptiveDecomposition)
+{
+    base::RealVectorBounds bounds(2);
+    bounds.setLow(0.0);
+    bounds.setHigh(1.0);
+    SyclopDecomposition<control::AdaptiveDecomposition> decomp(2, bounds);
+    BOOST_CHECK_EQUAL(decomp.getNumRegions(), 4);
+
+    base::StateSpacePtr space(new base::RealVectorStateSpace(2));
+    base::ScopedState<base::RealVectorStateSpace> state(space);
+
+    // regions are not split until enough of them is covered
+    std::vector<int> newRegions;
+    BOOST_CHECK(!decomp.refineRegion(0, 0.1, newRegions));
+    BOOST_CHECK(decomp.refineRegion(0, 1.0, newRegions));
+    BOOST_REQUIRE_EQUAL(newRegions.size(), 3u);
+    BOOST_CHECK_EQUAL(decomp.getNumRegions(), 7);
+    BOOST_CHECK_CLOSE(decomp.getRegionVolume(0), 0.0625, 1e-9);
+
+    const double coords[][2] = { {0.1, 0.1}, {0.4, 0.1}, {0.1, 0.4}, {0.4, 0.4}, {0.9, 0.1} };
+    const int regions[] = { 0, newRegions[0], newRegions[1], newRegions[2], 2 };
+    for (int i = 0; i < 5; ++i)
+    {
+        state->values[0] = coords[i][0];
+        state->values[1] = coords[i][1];
+        BOOST_CHECK_EQUAL(decomp.locateRegion(state.get()), regions[i]);
+    }
+
+    // the region to the right of the split one touches two of its parts and both regions above
+    std::vector<int> neighbors;
+    decomp.getNeighbors(2, neighbors);
+    std::sort(neighbors.begin(), neighbors.end());
+    const int expected[] = { 1, 3, newRegions[0], newRegions[2] };
+    BOOST_CHECK_EQUAL_COLLECTIONS(neighbors.begin(), neighbors.end(), expected, expected + 4);
+
+    neighbors.clear();
+    decomp.getNeighbors(0, neighbors);
+    std::sort(neighbors.begin(), neighbors.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(neighbors.begin(), neighbors.end(), newRegions.begin(), newRegions.end());
+
+    decomp.setMaxDepth(1);
+    BOOST_CHECK(!decomp.refineRegion(newRegions[0], 1.0, newRegions));
+}
+
 BOOST_AUTO_TEST_CASE(controlSyclopRRT)
 {
     double success    = 0.0;
@@ -591,4 +726,66 @@ BOOST_AUTO_TEST_CASE(controlSyclopEST)
     BOOST_CHECK(avglength < 100.0);
 }
 
+BOOST_AUTO_TEST_CASE(controlSyclopRRTAdaptive)
+{
+    double success    = 0.0;
+    double avgruntime = 0.0;
+    double avglength  = 0.0;
+
+    TestPlanner *p = new SyclopRRTTest(1, true);
+    runPlanTest(p, &success, &avgruntime, &avglength);
+    delete p;
+
+    BOOST_CHECK(success >= 99.0);
+    BOOST_CHECK(avgruntime < 0.05);
+    BOOST_CHECK(avglength < 100.0);
+}
+
+BOOST_AUTO_TEST_CASE(controlSyclopRRTThreaded)
+{
+    double success    = 0.0;
+    double avgruntime = 0.0;
+    double avglength  = 0.0;
+
+    TestPlanner *p = new SyclopRRTTest(4);
+    runPlanTest(p, &success, &avgruntime, &avglength);
+    delete p;
+
+    BOOST_CHECK(success >= 99.0);
+    BOOST_CHECK(avgruntime < 0.05);
+    BOOST_CHECK(avglength < 100.0);
+}
+
+BOOST_AUTO_TEST_CASE(controlSyclopRRTThreadedAdaptive)
+{
+    double success    = 0.0;
+    double avgruntime = 0.0;
+    double avglength  = 0.0;
+
+    SyclopRRTTest *p = new SyclopRRTTest(4, true);
+    runPlanTest(p, &success, &avgruntime, &avglength);
+    // the expansion threads refine the decomposition while the next lead is computed from it
+    BOOST_CHECK(p->getSplitsDuringLead() > 0);
+    delete p;
+
+    BOOST_CHECK(success >= 99.0);
+    BOOST_CHECK(avgruntime < 0.05);
+    BOOST_CHECK(avglength < 100.0);
+}
+
+BOOST_AUTO_TEST_CASE(controlSyclopESTThreaded)
+{
+    double success    = 0.0;
+    double avgruntime = 0.0;
+    double avglength  = 0.0;
+
+    TestPlanner *p = new SyclopESTTest(4);
+    runPlanTest(p, &success, &avgruntime, &avglength);
+    delete p;
+
+    BOOST_CHECK(success >= 99.0);
+    BOOST_CHECK(avgruntime < 0.05);
+    BOOST_CHECK(avglength < 100.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
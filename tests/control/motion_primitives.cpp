@@ -0,0 +1,267 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "MotionPrimitives"
+#include <boost/test/unit_test.hpp>
+
+#include "ompl/control/MotionPrimitives.h"
+#include "ompl/control/SpaceInformation.h"
+#include "ompl/control/spaces/RealVectorControlSpace.h"
+#include "ompl/base/spaces/SE2StateSpace.h"
+#include "ompl/base/spaces/SE3StateSpace.h"
+#include <boost/bind.hpp>
+#include <cmath>
+
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/* A unicycle moving with constant forward velocity u[0] and turning rate u[1] */
+class UnicyclePropagator : public control::StatePropagator
+{
+public:
+
+    UnicyclePropagator(const control::SpaceInformationPtr &si) : control::StatePropagator(si)
+    {
+    }
+
+    virtual void propagate(const base::State *state, const control::Control* control, const double duration, base::State *result) const
+    {
+        const base::SE2StateSpace::StateType *s = state->as<base::SE2StateSpace::StateType>();
+        const double *u = control->as<control::RealVectorControlSpace::ControlType>()->values;
+        const double yaw = s->getYaw();
+        double x, y;
+        if (fabs(u[1]) < 1e-12)
+        {
+            x = s->getX() + u[0] * duration * cos(yaw);
+            y = s->getY() + u[0] * duration * sin(yaw);
+        }
+        else
+        {
+            const double r = u[0] / u[1];
+            x = s->getX() + r * (sin(yaw + u[1] * duration) - sin(yaw));
+            y = s->getY() - r * (cos(yaw + u[1] * duration) - cos(yaw));
+        }
+        base::SE2StateSpace::StateType *res = result->as<base::SE2StateSpace::StateType>();
+        res->setXY(x, y);
+        res->setYaw(yaw + u[1] * duration);
+        si_->getStateSpace()->as<base::SE2StateSpace>()->as<base::SO2StateSpace>(1)->enforceBounds(res->as<base::SO2StateSpace::StateType>(1));
+    }
+};
+
+/* A rigid body moving along its own x axis with velocity u[0] while turning about its own z axis with rate u[1] */
+class BodyPropagator : public control::StatePropagator
+{
+public:
+
+    BodyPropagator(const control::SpaceInformationPtr &si) : control::StatePropagator(si)
+    {
+    }
+
+    virtual void propagate(const base::State *state, const control::Control* control, const double duration, base::State *result) const
+    {
+        const base::SE3StateSpace::StateType *s = state->as<base::SE3StateSpace::StateType>();
+        const double *u = control->as<control::RealVectorControlSpace::ControlType>()->values;
+        const base::SO3StateSpace::StateType &q = s->rotation();
+
+        // the body x axis in world coordinates
+        const double ax = 1.0 - 2.0 * (q.y * q.y + q.z * q.z);
+        const double ay = 2.0 * (q.x * q.y + q.w * q.z);
+        const double az = 2.0 * (q.x * q.z - q.w * q.y);
+        const double d = u[0] * duration;
+
+        // rotate about the body z axis
+        const double hw = cos(u[1] * duration / 2.0), hz = sin(u[1] * duration / 2.0);
+        const double w = q.w * hw - q.z * hz;
+        const double x = q.x * hw + q.y * hz;
+        const double y = q.y * hw - q.x * hz;
+        const double z = q.z * hw + q.w * hz;
+
+        base::SE3StateSpace::StateType *r = result->as<base::SE3StateSpace::StateType>();
+        r->setXYZ(s->getX() + d * ax, s->getY() + d * ay, s->getZ() + d * az);
+        r->rotation().w = w;
+        r->rotation().x = x;
+        r->rotation().y = y;
+        r->rotation().z = z;
+    }
+};
+
+static bool alwaysValid(const base::State*)
+{
+    return true;
+}
+
+static control::SpaceInformationPtr makeSpaceInformation(const base::StateSpacePtr &space)
+{
+    control::ControlSpacePtr cspace(new control::RealVectorControlSpace(space, 2));
+    base::RealVectorBounds cbounds(2);
+    cbounds.setLow(-1);
+    cbounds.setHigh(1);
+    cspace->as<control::RealVectorControlSpace>()->setBounds(cbounds);
+    control::SpaceInformationPtr si(new control::SpaceInformation(space, cspace));
+    si->setStateValidityChecker(boost::bind(&alwaysValid, _1));
+    si->setPropagationStepSize(0.1);
+    si->setMinMaxControlDuration(1, 10);
+    return si;
+}
+
+static void addPrimitives(const control::SpaceInformationPtr &si, control::MotionPrimitiveStatePropagator &mp)
+{
+    control::Control *c = si->allocControl();
+    double *u = c->as<control::RealVectorControlSpace::ControlType>()->values;
+    for (int v = -1 ; v <= 1 ; v += 2)
+        for (int w = -2 ; w <= 2 ; ++w)
+        {
+            u[0] = v;
+            u[1] = w * 0.5;
+            mp.addPrimitive(c);
+        }
+    si->freeControl(c);
+}
+
+static void checkAgainstModel(const control::SpaceInformationPtr &si, const control::StatePropagatorPtr &model,
+                              const control::MotionPrimitiveStatePropagator &mp)
+{
+    base::StateSamplerPtr sampler = si->allocStateSampler();
+    base::State *start = si->allocState();
+    base::State *expected = si->allocState();
+    base::State *result = si->allocState();
+    for (unsigned int i = 0 ; i < 100 ; ++i)
+    {
+        sampler->sampleUniform(start);
+        const control::Control *c = mp.getPrimitive(i % mp.getPrimitiveCount());
+        const unsigned int steps = 1 + i % 7;
+
+        si->copyState(expected, start);
+        for (unsigned int s = 0 ; s < steps ; ++s)
+            model->propagate(expected, c, si->getPropagationStepSize(), expected);
+        mp.propagate(start, c, steps * si->getPropagationStepSize(), result);
+        BOOST_CHECK_SMALL(si->distance(expected, result), 1e-6);
+    }
+    si->freeState(start);
+    si->freeState(expected);
+    si->freeState(result);
+}
+
+BOOST_AUTO_TEST_CASE(MotionPrimitives_SE2)
+{
+    base::StateSpacePtr space(new base::SE2StateSpace());
+    base::RealVectorBounds bounds(2);
+    bounds.setLow(-10);
+    bounds.setHigh(10);
+    space->as<base::SE2StateSpace>()->setBounds(bounds);
+    control::SpaceInformationPtr si = makeSpaceInformation(space);
+
+    control::StatePropagatorPtr model(new UnicyclePropagator(si));
+    control::MotionPrimitiveStatePropagatorPtr mp(new control::MotionPrimitiveStatePropagator(si, model));
+    addPrimitives(si, *mp);
+    si->setStatePropagator(control::StatePropagatorPtr(mp));
+    si->setup();
+    mp->setup();
+    BOOST_CHECK_EQUAL(mp->getPrimitiveCount(), 10u);
+
+    checkAgainstModel(si, model, *mp);
+
+    // copies of the primitives are found at their index
+    for (unsigned int i = 0 ; i < mp->getPrimitiveCount() ; ++i)
+    {
+        control::Control *p = si->cloneControl(mp->getPrimitive(i));
+        BOOST_CHECK_EQUAL(mp->findPrimitive(p), (int)i);
+        si->freeControl(p);
+    }
+
+    // controls that are not primitives are passed on to the model
+    control::Control *c = si->allocControl();
+    c->as<control::RealVectorControlSpace::ControlType>()->values[0] = 0.3;
+    c->as<control::RealVectorControlSpace::ControlType>()->values[1] = 0.2;
+    BOOST_CHECK_EQUAL(mp->findPrimitive(c), -1);
+    base::State *start = si->allocState();
+    base::State *a = si->allocState();
+    base::State *b = si->allocState();
+    si->allocStateSampler()->sampleUniform(start);
+    model->propagate(start, c, 0.35, a);
+    mp->propagate(start, c, 0.35, b);
+    BOOST_CHECK_EQUAL(si->distance(a, b), 0.0);
+
+    // the sampler only produces primitives
+    si->getControlSpace()->setControlSamplerAllocator(boost::bind(&control::MotionPrimitiveStatePropagator::allocControlSampler, mp.get(), _1));
+    control::ControlSamplerPtr cs = si->allocControlSampler();
+    for (unsigned int i = 0 ; i < 50 ; ++i)
+    {
+        cs->sample(c);
+        BOOST_CHECK(mp->findPrimitive(c) >= 0);
+    }
+
+    // of several equal primitives, the first one is found
+    mp->addPrimitive(mp->getPrimitive(3));
+    mp->setup();
+    BOOST_CHECK_EQUAL(mp->findPrimitive(mp->getPrimitive(10)), 3);
+
+    si->freeControl(c);
+    si->freeState(start);
+    si->freeState(a);
+    si->freeState(b);
+}
+
+BOOST_AUTO_TEST_CASE(MotionPrimitives_SE3)
+{
+    base::StateSpacePtr space(new base::SE3StateSpace());
+    base::RealVectorBounds bounds(3);
+    bounds.setLow(-10);
+    bounds.setHigh(10);
+    space->as<base::SE3StateSpace>()->setBounds(bounds);
+    control::SpaceInformationPtr si = makeSpaceInformation(space);
+
+    control::StatePropagatorPtr model(new BodyPropagator(si));
+    control::MotionPrimitiveStatePropagatorPtr mp(new control::MotionPrimitiveStatePropagator(si, model));
+    addPrimitives(si, *mp);
+    si->setStatePropagator(control::StatePropagatorPtr(mp));
+    si->setup();
+    mp->setup();
+
+    checkAgainstModel(si, model, *mp);
+
+    // long chains of primitives keep the orientation a unit quaternion
+    base::State *start = si->allocState();
+    base::State *result = si->allocState();
+    si->allocStateSampler()->sampleUniform(start);
+    for (unsigned int i = 0 ; i < mp->getPrimitiveCount() ; ++i)
+    {
+        mp->propagate(start, mp->getPrimitive(i), 100000 * si->getPropagationStepSize(), result);
+        const base::SO3StateSpace::StateType &q = result->as<base::SE3StateSpace::StateType>()->rotation();
+        BOOST_CHECK_SMALL(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z - 1.0, 1e-12);
+    }
+    si->freeState(start);
+    si->freeState(result);
+}
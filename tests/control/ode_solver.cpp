@@ -0,0 +1,323 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "ODESolver"
+#include <boost/test/unit_test.hpp>
+
+#include "ompl/control/ODESolver.h"
+#include "ompl/control/SpaceInformation.h"
+#include "ompl/control/spaces/RealVectorControlSpace.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <cstdlib>
+
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/// @cond IGNORE
+/* count the calls to the global operator new, to check that propagation does not allocate memory */
+static unsigned long int allocations = 0;
+
+#ifdef __GNUC__
+// keep the replacements out of line, so the compiler does not pair malloc() and free() with new-expressions
+void* operator new(std::size_t size) throw(std::bad_alloc) __attribute__((noinline));
+void operator delete(void *p) throw() __attribute__((noinline));
+#endif
+
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+    ++allocations;
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+/* a forced pendulum: the state is (angle, angular velocity) and the control is a torque */
+static void pendulumODE(const control::ODESolver::StateType &q, const control::Control *c, control::ODESolver::StateType &qdot)
+{
+    const double u = c->as<control::RealVectorControlSpace::ControlType>()->values[0];
+    qdot.resize(q.size());
+    qdot[0] = q[1];
+    qdot[1] = u - sin(q[0]);
+}
+
+static void pendulumFixedODE(const boost::array<double, 2> &q, const control::Control *c, boost::array<double, 2> &qdot)
+{
+    const double u = c->as<control::RealVectorControlSpace::ControlType>()->values[0];
+    qdot[0] = q[1];
+    qdot[1] = u - sin(q[0]);
+}
+
+static bool alwaysValid(const base::State*)
+{
+    return true;
+}
+
+static control::SpaceInformationPtr makeSpaceInformation(unsigned int dim)
+{
+    base::StateSpacePtr space(new base::RealVectorStateSpace(dim));
+    space->as<base::RealVectorStateSpace>()->setBounds(-100.0, 100.0);
+    control::ControlSpacePtr cspace(new control::RealVectorControlSpace(space, 1));
+    base::RealVectorBounds cbounds(1);
+    cbounds.setLow(-1.0);
+    cbounds.setHigh(1.0);
+    cspace->as<control::RealVectorControlSpace>()->setBounds(cbounds);
+    control::SpaceInformationPtr si(new control::SpaceInformation(space, cspace));
+    si->setStateValidityChecker(boost::bind(&alwaysValid, _1));
+    si->setPropagationStepSize(0.1);
+    return si;
+}
+
+/* propagate the same states and controls with two propagators and return the largest difference */
+static double compare(const control::SpaceInformationPtr &si, const control::StatePropagatorPtr &a, const control::StatePropagatorPtr &b, double duration)
+{
+    double diff = 0.0;
+    base::StateSamplerPtr ss = si->allocStateSampler();
+    control::ControlSamplerPtr cs = si->allocControlSampler();
+    base::State *start = si->allocState();
+    base::State *ra = si->allocState();
+    base::State *rb = si->allocState();
+    control::Control *c = si->allocControl();
+    for (unsigned int i = 0 ; i < 100 ; ++i)
+    {
+        ss->sampleUniformNear(start, start, 1.0);
+        cs->sample(c);
+        a->propagate(start, c, duration, ra);
+        b->propagate(start, c, duration, rb);
+        for (unsigned int j = 0 ; j < si->getStateDimension() ; ++j)
+            diff = std::max(diff, fabs(ra->as<base::RealVectorStateSpace::StateType>()->values[j] -
+                                       rb->as<base::RealVectorStateSpace::StateType>()->values[j]));
+    }
+    si->freeControl(c);
+    si->freeState(rb);
+    si->freeState(ra);
+    si->freeState(start);
+    return diff;
+}
+/* the number of allocations made by n propagations, after a first one that sets up the buffers of the solver */
+static unsigned long int countAllocations(const control::SpaceInformationPtr &si, const control::StatePropagatorPtr &prop, unsigned int n)
+{
+    base::State *state = si->allocState();
+    base::State *result = si->allocState();
+    si->allocStateSampler()->sampleUniformNear(state, state, 0.0);
+    control::Control *c = si->allocControl();
+    si->allocControlSampler()->sample(c);
+    prop->propagate(state, c, 1.0, result);
+
+    const unsigned long int before = allocations;
+    for (unsigned int i = 0 ; i < n ; ++i)
+        prop->propagate(result, c, i % 2 ? 0.5 : -0.5, result);
+    const unsigned long int count = allocations - before;
+
+    si->freeControl(c);
+    si->freeState(result);
+    si->freeState(state);
+    return count;
+}
+
+/* propagate n states at once and one at a time, and check that the results are identical; return the number of
+   allocations made by the batch propagation, which is done twice so that the buffers of the solver are set up */
+static unsigned long int checkBatch(const control::SpaceInformationPtr &si, const control::StatePropagatorPtr &prop, unsigned int n, double duration)
+{
+    std::vector<base::State*> starts(n), batch(n), single(n);
+    std::vector<control::Control*> controls(n);
+    base::StateSamplerPtr ss = si->allocStateSampler();
+    control::ControlSamplerPtr cs = si->allocControlSampler();
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        starts[i] = si->allocState();
+        batch[i] = si->allocState();
+        single[i] = si->allocState();
+        controls[i] = si->allocControl();
+        ss->sampleUniformNear(starts[i], starts[i], 1.0);
+        cs->sample(controls[i]);
+    }
+
+    prop->propagateBatch(&starts[0], &controls[0], n, duration, &batch[0]);
+    const unsigned long int before = allocations;
+    prop->propagateBatch(&starts[0], &controls[0], n, duration, &batch[0]);
+    const unsigned long int count = allocations - before;
+
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        prop->propagate(starts[i], controls[i], duration, single[i]);
+        for (unsigned int j = 0 ; j < si->getStateDimension() ; ++j)
+            BOOST_CHECK_EQUAL(batch[i]->as<base::RealVectorStateSpace::StateType>()->values[j],
+                              single[i]->as<base::RealVectorStateSpace::StateType>()->values[j]);
+        si->freeControl(controls[i]);
+        si->freeState(single[i]);
+        si->freeState(batch[i]);
+        si->freeState(starts[i]);
+    }
+    return count;
+}
+
+/* propagate from start with c, then check that the reported error is that of one of the integrations running concurrently */
+static void checkErrors(control::ODEErrorSolver<> *solver, const control::StatePropagatorPtr &prop, const control::SpaceInformationPtr &si,
+                        const base::State *start, const control::Control *c, const std::vector<control::ODESolver::StateType> *expected, bool *ok)
+{
+    base::State *result = si->allocState();
+    for (unsigned int i = 0 ; i < 200 ; ++i)
+    {
+        prop->propagate(start, c, 1.0, result);
+        if (std::find(expected->begin(), expected->end(), solver->getError()) == expected->end())
+            *ok = false;
+        boost::this_thread::yield();
+    }
+    si->freeState(result);
+}
+/// @endcond
+
+BOOST_AUTO_TEST_CASE(FixedMatchesDynamic)
+{
+    control::SpaceInformationPtr si = makeSpaceInformation(2);
+
+    control::ODEBasicSolver<> basic(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEFixedBasicSolver<2> fixedBasic(si, boost::bind(&pendulumFixedODE, _1, _2, _3));
+    si->setStatePropagator(basic.getStatePropagator());
+    si->setup();
+    BOOST_CHECK(compare(si, basic.getStatePropagator(), fixedBasic.getStatePropagator(), 1.05) < 1e-12);
+    BOOST_CHECK(compare(si, basic.getStatePropagator(), fixedBasic.getStatePropagator(), -0.5) < 1e-12);
+
+    control::ODEAdaptiveSolver<> adaptive(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEFixedAdaptiveSolver<2> fixedAdaptive(si, boost::bind(&pendulumFixedODE, _1, _2, _3));
+    BOOST_CHECK(compare(si, adaptive.getStatePropagator(), fixedAdaptive.getStatePropagator(), 1.05) < 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(FixedDimensionMismatch)
+{
+    control::SpaceInformationPtr si = makeSpaceInformation(3);
+    control::ODEFixedBasicSolver<2> fixedBasic(si, boost::bind(&pendulumFixedODE, _1, _2, _3));
+    control::StatePropagatorPtr prop = fixedBasic.getStatePropagator();
+    si->setStatePropagator(prop);
+    si->setup();
+
+    base::State *state = si->allocState();
+    si->allocStateSampler()->sampleUniform(state);
+    control::Control *c = si->allocControl();
+    si->nullControl(c);
+    BOOST_CHECK_THROW(prop->propagate(state, c, 0.1, state), Exception);
+    si->freeControl(c);
+    si->freeState(state);
+}
+
+BOOST_AUTO_TEST_CASE(NoAllocation)
+{
+    control::SpaceInformationPtr si = makeSpaceInformation(2);
+    control::ODEBasicSolver<> basic(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEErrorSolver<> error(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEAdaptiveSolver<> adaptive(si, boost::bind(&pendulumODE, _1, _2, _3));
+    si->setStatePropagator(basic.getStatePropagator());
+    si->setup();
+
+    BOOST_CHECK_EQUAL(countAllocations(si, basic.getStatePropagator(), 100), 0u);
+    BOOST_CHECK_EQUAL(countAllocations(si, error.getStatePropagator(), 100), 0u);
+    BOOST_CHECK_EQUAL(countAllocations(si, adaptive.getStatePropagator(), 100), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(BatchMatchesSingle)
+{
+    control::SpaceInformationPtr si = makeSpaceInformation(2);
+    control::ODEBasicSolver<> basic(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEErrorSolver<> error(si, boost::bind(&pendulumODE, _1, _2, _3));
+    si->setStatePropagator(basic.getStatePropagator());
+    si->setup();
+
+    /* the basic solver integrates the stacked states in lockstep; batches of the same size do not allocate memory */
+    control::StatePropagatorPtr prop = basic.getStatePropagator();
+    BOOST_CHECK_EQUAL(checkBatch(si, prop, 8, 1.05), 0u);
+    BOOST_CHECK_EQUAL(checkBatch(si, prop, 3, -0.5), 0u);
+    checkBatch(si, prop, 1, 0.3);
+
+    /* the error-bounded solvers integrate each state on its own */
+    checkBatch(si, error.getStatePropagator(), 5, 1.05);
+}
+
+BOOST_AUTO_TEST_CASE(ErrorSolver)
+{
+    control::SpaceInformationPtr si = makeSpaceInformation(2);
+    control::ODEBasicSolver<> basic(si, boost::bind(&pendulumODE, _1, _2, _3));
+    control::ODEErrorSolver<> error(si, boost::bind(&pendulumODE, _1, _2, _3));
+    si->setStatePropagator(basic.getStatePropagator());
+    si->setup();
+
+    /* both directions of time are integrated */
+    BOOST_CHECK(compare(si, basic.getStatePropagator(), error.getStatePropagator(), 1.0) < 1e-6);
+    BOOST_CHECK(compare(si, basic.getStatePropagator(), error.getStatePropagator(), -1.0) < 1e-6);
+
+    base::State *start = si->allocState();
+    base::State *result = si->allocState();
+    si->allocStateSampler()->sampleUniformNear(start, start, 1.0);
+    control::Control *c = si->allocControl();
+    si->allocControlSampler()->sample(c);
+    control::StatePropagatorPtr prop = error.getStatePropagator();
+    prop->propagate(start, c, -1.0, result);
+    BOOST_CHECK(result->as<base::RealVectorStateSpace::StateType>()->values[0] !=
+                start->as<base::RealVectorStateSpace::StateType>()->values[0]);
+
+    /* concurrent integrations do not share a stepper, so every reported error is that of a whole integration */
+    const unsigned int threads = 4;
+    std::vector<base::State*> starts(threads);
+    std::vector<control::ODESolver::StateType> expected(threads);
+    bool ok = true;
+    boost::thread_group group;
+    for (unsigned int i = 0 ; i < threads ; ++i)
+    {
+        starts[i] = si->allocState();
+        si->allocStateSampler()->sampleUniformNear(starts[i], start, 1.0);
+        prop->propagate(starts[i], c, 1.0, result);
+        expected[i] = error.getError();
+    }
+    for (unsigned int i = 0 ; i < threads ; ++i)
+        group.create_thread(boost::bind(&checkErrors, &error, prop, si, starts[i], c, &expected, &ok));
+    group.join_all();
+    BOOST_CHECK(ok);
+
+    for (unsigned int i = 0 ; i < threads ; ++i)
+        si->freeState(starts[i]);
+    si->freeControl(c);
+    si->freeState(result);
+    si->freeState(start);
+}
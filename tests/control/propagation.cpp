@@ -0,0 +1,266 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "Propagation"
+#include <boost/test/unit_test.hpp>
+
+#include "ompl/control/SimpleDirectedControlSampler.h"
+#include "ompl/control/SpaceInformation.h"
+#include "ompl/control/spaces/RealVectorControlSpace.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/util/RandomNumbers.h"
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cmath>
+#include <limits>
+
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+/// @cond IGNORE
+/* moves the state by the control, scaled by the duration, and counts the propagated steps */
+class CountingPropagator : public control::StatePropagator
+{
+public:
+
+    CountingPropagator(const control::SpaceInformationPtr &si) : control::StatePropagator(si), count_(0)
+    {
+    }
+
+    virtual void propagate(const base::State *state, const control::Control *control, const double duration, base::State *result) const
+    {
+        const double *x = state->as<base::RealVectorStateSpace::StateType>()->values;
+        const double *u = control->as<control::RealVectorControlSpace::ControlType>()->values;
+        double *y = result->as<base::RealVectorStateSpace::StateType>()->values;
+        y[0] = x[0] + u[0] * duration;
+        y[1] = x[1] + u[1] * duration + 0.1 * sin(x[0]) * duration;
+        boost::mutex::scoped_lock slock(lock_);
+        ++count_;
+    }
+
+    unsigned int count(void) const
+    {
+        boost::mutex::scoped_lock slock(lock_);
+        return count_;
+    }
+
+private:
+
+    mutable unsigned int count_;
+    mutable boost::mutex lock_;
+};
+
+/* produces the same sequence of controls and step counts in every instance */
+class SequenceControlSampler : public control::ControlSampler
+{
+public:
+
+    SequenceControlSampler(const control::ControlSpace *space) : control::ControlSampler(space), next_(0)
+    {
+    }
+
+    virtual void sample(control::Control *control)
+    {
+        double *u = control->as<control::RealVectorControlSpace::ControlType>()->values;
+        u[0] = value();
+        u[1] = value();
+    }
+
+    virtual unsigned int sampleStepCount(unsigned int minSteps, unsigned int maxSteps)
+    {
+        return minSteps + next_++ % (maxSteps - minSteps + 1);
+    }
+
+private:
+
+    double value(void)
+    {
+        // a deterministic sequence in [-1, 1]
+        return sin(1.7 * ++next_);
+    }
+
+    unsigned long int next_;
+};
+
+static control::ControlSamplerPtr allocSequenceControlSampler(const control::ControlSpace *space)
+{
+    return control::ControlSamplerPtr(new SequenceControlSampler(space));
+}
+
+/* a plane whose bottom half is invalid */
+static bool isValid(const base::State *state)
+{
+    return state->as<base::RealVectorStateSpace::StateType>()->values[1] > -5.0;
+}
+
+static control::SpaceInformationPtr makeSpaceInformation(CountingPropagator **propagator)
+{
+    base::StateSpacePtr space(new base::RealVectorStateSpace(2));
+    space->as<base::RealVectorStateSpace>()->setBounds(-10.0, 10.0);
+    control::ControlSpacePtr cspace(new control::RealVectorControlSpace(space, 2));
+    base::RealVectorBounds cbounds(2);
+    cbounds.setLow(-1.0);
+    cbounds.setHigh(1.0);
+    cspace->as<control::RealVectorControlSpace>()->setBounds(cbounds);
+    cspace->setControlSamplerAllocator(boost::bind(&allocSequenceControlSampler, _1));
+    control::SpaceInformationPtr si(new control::SpaceInformation(space, cspace));
+    si->setStateValidityChecker(boost::bind(&isValid, _1));
+    *propagator = new CountingPropagator(si);
+    si->setStatePropagator(control::StatePropagatorPtr(*propagator));
+    si->setPropagationStepSize(0.5);
+    si->setMinMaxControlDuration(1, 10);
+    si->setup();
+    return si;
+}
+/// @endcond
+
+BOOST_AUTO_TEST_CASE(ThreadedDirectedSampling)
+{
+    CountingPropagator *propagator;
+    control::SpaceInformationPtr si = makeSpaceInformation(&propagator);
+    control::SimpleDirectedControlSampler serial(si.get(), 20);
+    control::SimpleDirectedControlSampler threaded(si.get(), 20);
+    threaded.setThreadCount(4);
+    BOOST_CHECK_EQUAL(threaded.getThreadCount(), 4u);
+
+    /* the candidates are sampled on the calling thread, so the chosen control does not depend on the thread count */
+    base::StateSamplerPtr ss = si->allocStateSampler();
+    base::State *source = si->allocState();
+    base::State *target = si->allocState();
+    control::Control *a = si->allocControl();
+    control::Control *b = si->allocControl();
+    for (unsigned int i = 0 ; i < 100 ; ++i)
+    {
+        ss->sampleUniform(source);
+        ss->sampleUniform(target);
+        BOOST_CHECK_EQUAL(serial.sampleTo(a, source, target), threaded.sampleTo(b, source, target));
+        BOOST_CHECK(si->equalControls(a, b));
+        BOOST_CHECK_EQUAL(serial.sampleTo(a, a, source, target), threaded.sampleTo(b, b, source, target));
+        BOOST_CHECK(si->equalControls(a, b));
+    }
+    si->freeControl(b);
+    si->freeControl(a);
+    si->freeState(target);
+    si->freeState(source);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPropagation)
+{
+    CountingPropagator *propagator;
+    control::SpaceInformationPtr si = makeSpaceInformation(&propagator);
+    base::StateSamplerPtr ss = si->allocStateSampler();
+    control::ControlSamplerPtr cs = si->allocControlSampler();
+
+    const unsigned int n = 16;
+    std::vector<control::Control*> controls(n);
+    std::vector<int> steps(n);
+    std::vector<base::State*> batch(n);
+    base::State *single = si->allocState();
+    base::State *source = si->allocState();
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        controls[i] = si->allocControl();
+        batch[i] = si->allocState();
+    }
+
+    /* the buffers are reused for batches of different sizes; each motion stops where the single-control propagation stops */
+    control::SpaceInformation::PropagationBuffers buffers;
+    std::vector<unsigned int> validSteps;
+    for (unsigned int k = 0 ; k < 20 ; ++k)
+    {
+        ss->sampleUniform(source);
+        std::vector<control::Control*> c(controls.begin(), controls.begin() + 1 + k % n);
+        std::vector<int> s(c.size());
+        for (unsigned int i = 0 ; i < c.size() ; ++i)
+        {
+            cs->sample(c[i]);
+            s[i] = cs->sampleStepCount(1, 20);
+        }
+        if (k % 2)
+            si->propagateWhileValid(source, c, s, batch, validSteps, buffers);
+        else
+            si->propagateWhileValid(source, c, s, batch, validSteps);
+        BOOST_REQUIRE_EQUAL(validSteps.size(), c.size());
+
+        for (unsigned int i = 0 ; i < c.size() ; ++i)
+        {
+            BOOST_CHECK_EQUAL(validSteps[i], si->propagateWhileValid(source, c[i], s[i], single));
+            for (unsigned int j = 0 ; j < 2 ; ++j)
+                BOOST_CHECK_EQUAL(batch[i]->as<base::RealVectorStateSpace::StateType>()->values[j],
+                                  single->as<base::RealVectorStateSpace::StateType>()->values[j]);
+        }
+    }
+
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        si->freeState(batch[i]);
+        si->freeControl(controls[i]);
+    }
+    si->freeState(source);
+    si->freeState(single);
+}
+
+BOOST_AUTO_TEST_CASE(EarlyStop)
+{
+    CountingPropagator *propagator;
+    control::SpaceInformationPtr si = makeSpaceInformation(&propagator);
+    control::SimpleDirectedControlSampler full(si.get(), 40);
+    control::SimpleDirectedControlSampler early(si.get(), 40);
+    early.setEarlyStopDistance(std::numeric_limits<double>::infinity());
+    BOOST_CHECK_EQUAL(early.getEarlyStopDistance(), std::numeric_limits<double>::infinity());
+
+    base::State *source = si->allocState();
+    base::State *target = si->allocState();
+    si->allocStateSampler()->sampleUniform(source);
+    si->allocStateSampler()->sampleUniform(target);
+    control::Control *c = si->allocControl();
+
+    unsigned int before = propagator->count();
+    unsigned int steps = full.sampleTo(c, source, target);
+    const unsigned int fullCount = propagator->count() - before;
+    BOOST_CHECK(steps >= 1 && steps <= 10);
+
+    /* every candidate is close enough, so only the first batch of candidates is propagated */
+    before = propagator->count();
+    steps = early.sampleTo(c, source, target);
+    const unsigned int earlyCount = propagator->count() - before;
+    BOOST_CHECK(steps >= 1 && steps <= 10);
+    BOOST_CHECK(earlyCount > 0);
+    BOOST_CHECK(earlyCount < fullCount);
+
+    si->freeControl(c);
+    si->freeState(target);
+    si->freeState(source);
+}
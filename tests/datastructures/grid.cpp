@@ -39,7 +39,9 @@
 
 #include "ompl/datastructures/Grid.h"
 #include "ompl/datastructures/GridN.h"
+#include "ompl/util/RandomNumbers.h"
 #include "../BoostTestTeamCityReporter.h"
+#include <map>
 
 using namespace ompl;
 
@@ -198,3 +200,56 @@ BOOST_AUTO_TEST_CASE(GridN_Simple)
     BOOST_CHECK_EQUAL((unsigned int)2, g.components().size());
     BOOST_CHECK_EQUAL(g.components()[0].size() + g.components()[1].size(), g.size());
 }
+
+BOOST_AUTO_TEST_CASE(Grid_AddRemove)
+{
+    // compare the grid against a map through a long sequence of random
+    // additions and removals, so the hash table grows and shifts entries
+    Grid<int> g(3);
+    std::map<Grid<int>::Coord, Grid<int>::Cell*> ref;
+    RNG rng;
+
+    Grid<int>::Coord coord(3);
+    for (int i = 0 ; i < 20000 ; ++i)
+    {
+        for (int k = 0 ; k < 3 ; ++k)
+            coord[k] = rng.uniformInt(-6, 6);
+        Grid<int>::Cell *cell = g.getCell(coord);
+        BOOST_CHECK_EQUAL(cell, ref.count(coord) ? ref[coord] : NULL);
+        if (cell)
+        {
+            BOOST_CHECK(g.remove(cell));
+            g.destroyCell(cell);
+            ref.erase(coord);
+        }
+        else
+        {
+            cell = g.createCell(coord);
+            cell->data = i;
+            g.add(cell);
+            ref[coord] = cell;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(g.size(), ref.size());
+    unsigned int count = 0;
+    for (Grid<int>::iterator it = g.begin() ; it != g.end() ; ++it, ++count)
+        BOOST_CHECK_EQUAL(ref[*it->first], it->second);
+    BOOST_CHECK_EQUAL(count, ref.size());
+
+    for (std::map<Grid<int>::Coord, Grid<int>::Cell*>::iterator it = ref.begin() ; it != ref.end() ; ++it)
+    {
+        Grid<int>::CellArray nbh;
+        g.neighbors(it->second, nbh);
+        unsigned int expected = 0;
+        coord = it->first;
+        for (int k = 0 ; k < 3 ; ++k)
+            for (int d = -1 ; d <= 1 ; d += 2)
+            {
+                coord[k] += d;
+                expected += ref.count(coord);
+                coord[k] -= d;
+            }
+        BOOST_CHECK_EQUAL(nbh.size(), expected);
+    }
+}
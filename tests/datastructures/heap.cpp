@@ -37,6 +37,9 @@
 #define BOOST_TEST_MODULE "Heap"
 #include <boost/test/unit_test.hpp>
 #include "ompl/datastructures/BinaryHeap.h"
+#include "ompl/datastructures/DAryHeap.h"
+#include "ompl/util/RandomNumbers.h"
+#include <algorithm>
 #include "../BoostTestTeamCityReporter.h"
 
 using namespace ompl;
@@ -87,3 +90,88 @@ BOOST_AUTO_TEST_CASE(Simple)
     h.insert(-1);
     BOOST_CHECK(h.top()->data == -1);
 }
+
+struct Item
+{
+    int          key;
+    unsigned int position;
+};
+
+struct ItemPosition
+{
+    unsigned int& operator()(Item* const &item) const
+    {
+        return item->position;
+    }
+};
+
+struct ItemLess
+{
+    bool operator()(const Item *a, const Item *b) const
+    {
+        return a->key < b->key;
+    }
+};
+
+static int minKey(const std::vector<Item*> &items)
+{
+    int m = items[0]->key;
+    for (std::size_t i = 1 ; i < items.size() ; ++i)
+        m = std::min(m, items[i]->key);
+    return m;
+}
+
+BOOST_AUTO_TEST_CASE(DAry)
+{
+    RNG rng;
+    std::vector<Item> storage(1000);
+    std::vector<Item*> in;
+    for (std::size_t i = 0 ; i < storage.size() ; ++i)
+    {
+        storage[i].key = rng.uniformInt(0, 10000);
+        in.push_back(&storage[i]);
+    }
+
+    DAryHeap<Item*, ItemPosition, ItemLess> h;
+    h.buildFrom(in);
+    BOOST_CHECK_EQUAL(h.size(), in.size());
+    BOOST_CHECK_EQUAL(h.top()->key, minKey(in));
+
+    // random updates, removals and insertions
+    for (int i = 0 ; i < 5000 ; ++i)
+    {
+        const int op = rng.uniformInt(0, 2);
+        const std::size_t k = rng.uniformInt(0, in.size() - 1);
+        if (op == 0)
+        {
+            in[k]->key = rng.uniformInt(0, 10000);
+            h.update(in[k]);
+        }
+        else if (op == 1 && in.size() > 1)
+        {
+            h.remove(in[k]);
+            in.erase(in.begin() + k);
+        }
+        else
+        {
+            Item *item = in[k];
+            h.remove(item);
+            item->key = rng.uniformInt(-100, 10000);
+            h.insert(item);
+        }
+        BOOST_CHECK_EQUAL(h.top()->key, minKey(in));
+    }
+    BOOST_CHECK_EQUAL(h.size(), in.size());
+
+    // change all keys at once and rebuild
+    for (std::size_t i = 0 ; i < in.size() ; ++i)
+        in[i]->key = -in[i]->key;
+    h.rebuild();
+    int last = h.top()->key;
+    while (!h.empty())
+    {
+        BOOST_CHECK(last <= h.top()->key);
+        last = h.top()->key;
+        h.pop();
+    }
+}
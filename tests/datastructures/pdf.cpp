@@ -45,10 +45,11 @@
 // define a convenience macro
 #define BOOST_OMPL_EXPECT_NEAR(a, b, diff) BOOST_CHECK_SMALL((a) - (b), diff)
 
-BOOST_AUTO_TEST_CASE(Simple)
+template <class Weights>
+void testSimple(void)
 {
-    typedef ompl::PDF<int>::Element Element;
-    ompl::PDF<int> p;
+    typedef typename ompl::PDF<int, Weights>::Element Element;
+    ompl::PDF<int, Weights> p;
     BOOST_CHECK(p.empty());
     p.add(0, 1.0);
     BOOST_CHECK_EQUAL(0, p.sample(0.5));
@@ -131,7 +132,48 @@ BOOST_AUTO_TEST_CASE(Simple)
     p.clear();
 }
 
-BOOST_AUTO_TEST_CASE(Statistical)
+BOOST_AUTO_TEST_CASE(Simple)
+{
+    testSimple<ompl::PDFLayeredTree>();
+}
+
+BOOST_AUTO_TEST_CASE(SimpleFenwick)
+{
+    testSimple<ompl::PDFFenwickTree>();
+}
+
+BOOST_AUTO_TEST_CASE(AliasTable)
+{
+    typedef ompl::PDF<int, ompl::PDFAliasTable>::Element Element;
+    ompl::PDF<int, ompl::PDFAliasTable> p;
+    Element* e0 = p.add(0, 0.0);
+    p.add(1, 3.0);
+    Element* e2 = p.add(2, 1.0);
+    p.add(3, 0.0);
+    for (unsigned int i = 0 ; i <= 100 ; ++i)
+    {
+        int s = p.sample(i / 100.0);
+        BOOST_CHECK(s == 1 || s == 2);
+    }
+
+    // the table has to be rebuilt after a change
+    p.update(e2, 0.0);
+    p.update(e0, 2.0);
+    BOOST_CHECK_EQUAL(p.getWeight(e0), 2.0);
+    for (unsigned int i = 0 ; i <= 100 ; ++i)
+    {
+        int s = p.sample(i / 100.0);
+        BOOST_CHECK(s == 0 || s == 1);
+    }
+
+    p.remove(e0);
+    BOOST_CHECK_EQUAL(3u, p.size());
+    for (unsigned int i = 0 ; i <= 100 ; ++i)
+        BOOST_CHECK_EQUAL(1, p.sample(i / 100.0));
+}
+
+template <class Weights>
+void testStatistical(void)
 {
     const std::size_t NUM_SAMPLES = 5000000;
     /* The following widening factor is multiplied by the standard error of the mean
@@ -147,7 +189,7 @@ BOOST_AUTO_TEST_CASE(Statistical)
     values.push_back(std::pair<int,double>(3, 15.0));
     values.push_back(std::pair<int,double>(4, 20.0));
 
-    ompl::PDF<int> p;
+    ompl::PDF<int, Weights> p;
     double mean = 0.0;
     double sumWeights = 0.0;
     /* Calculate weighted mean of discrete uniform distribution as we add elements to PDF. */
@@ -179,3 +221,10 @@ BOOST_AUTO_TEST_CASE(Statistical)
 
     BOOST_OMPL_EXPECT_NEAR(sampleMean, mean, STDERR_WIDENING_FACTOR*standerr);
 }
+
+BOOST_AUTO_TEST_CASE(Statistical)
+{
+    testStatistical<ompl::PDFLayeredTree>();
+    testStatistical<ompl::PDFFenwickTree>();
+    testStatistical<ompl::PDFAliasTable>();
+}
@@ -39,6 +39,9 @@
 
 #include "2DmapSetup.h"
 #include <iostream>
+#include <algorithm>
+#include <set>
+#include <sstream>
 
 #include "ompl/base/spaces/RealVectorStateProjections.h"
 
@@ -53,6 +56,9 @@
 #include "ompl/geometric/planners/rrt/LazyRRT.h"
 #include "ompl/geometric/planners/est/EST.h"
 #include "ompl/geometric/planners/prm/PRM.h"
+#include "ompl/geometric/PathHybridization.h"
+#include "ompl/tools/multiplan/OptimizePlan.h"
+#include "ompl/tools/experience/ExperiencePlan.h"
 
 #include "../../BoostTestTeamCityReporter.h"
 #include "../../base/PlannerTest.h"
@@ -609,4 +615,277 @@ BOOST_AUTO_TEST_CASE(geometric_SBL)
     BOOST_CHECK(avglength < 100.0);
 }
 
+/* solve the problem in env with RRT and return the solution path, for the tests of path post-processing */
+static base::PathPtr solveRRT(const base::SpaceInformationPtr &si, Environment2D &env)
+{
+    base::ProblemDefinitionPtr pdef = geometric::problemDefinition2DMap(si, env);
+    geometric::RRT *rrt = new geometric::RRT(si);
+    rrt->setRange(10.0);
+    base::PlannerPtr planner(rrt);
+    planner->setProblemDefinition(pdef);
+    planner->setup();
+    BOOST_REQUIRE(planner->solve(SOLUTION_TIME));
+    return pdef->getSolutionPath();
+}
+
+BOOST_AUTO_TEST_CASE(geometric_PathSimplifierThreaded)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    geometric::PathSimplifier sm(si);
+    sm.setThreadCount(4);
+    BOOST_CHECK_EQUAL(sm.getThreadCount(), 4u);
+
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+        /* the helper threads are kept between calls, and some of them stay idle when the thread count is lowered */
+        if (i > 0)
+            sm.setThreadCount(2 + i % 3);
+
+        geometric::PathGeometric path(*static_cast<geometric::PathGeometric*>(solveRRT(si, env).get()));
+        path.interpolate(200);
+        base::State *start = si->cloneState(path.getStates().front());
+        base::State *goal = si->cloneState(path.getStates().back());
+        double length = path.length();
+        std::vector<base::State*> original = path.getStates();
+
+        /* the vertices that are kept must appear in their original order */
+        sm.reduceVertices(path);
+        std::vector<base::State*>::iterator it = original.begin();
+        for (std::size_t j = 0 ; j < path.getStateCount() ; ++j)
+        {
+            it = std::find(it, original.end(), path.getState(j));
+            BOOST_CHECK(it != original.end());
+        }
+        BOOST_CHECK(path.getStateCount() < original.size());
+        BOOST_CHECK(path.length() <= length + 1e-9);
+
+        length = path.length();
+        sm.shortcutPath(path);
+        BOOST_CHECK(path.length() <= length + 1e-9);
+        BOOST_CHECK(si->equalStates(start, path.getStates().front()));
+        BOOST_CHECK(si->equalStates(goal, path.getStates().back()));
+        si->freeState(start);
+        si->freeState(goal);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geometric_PathSimplifierAdaptive)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    geometric::PathSimplifier sm(si);
+    BOOST_CHECK_EQUAL(sm.getStages().size(), 4u);
+
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+        geometric::PathGeometric path(*static_cast<geometric::PathGeometric*>(solveRRT(si, env).get()));
+        double length = path.length();
+
+        /* the stages converge long before the time budget runs out */
+        ompl::time::point start = ompl::time::now();
+        sm.simplifyAdaptive(path, 10.0);
+        BOOST_CHECK(ompl::time::seconds(ompl::time::now() - start) < 5.0);
+
+        const std::vector<geometric::PathSimplifier::TraceEntry> &trace = sm.getTrace();
+        BOOST_REQUIRE(trace.size() >= 4);
+        BOOST_CHECK_EQUAL(trace[0].stage, sm.getStages()[0]);
+        std::set<geometric::PathSimplifier::Stage> used;
+        for (std::size_t j = 0 ; j < trace.size() ; ++j)
+        {
+            used.insert(trace[j].stage);
+            BOOST_CHECK(trace[j].length <= length + 1e-6);
+            BOOST_CHECK(j == 0 || trace[j].time >= trace[j - 1].time);
+            length = trace[j].length;
+        }
+        BOOST_CHECK_EQUAL(used.size(), 4u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(geometric_PathHybridization)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    geometric::PathHybridization hybrid(si);
+    hybrid.setThreadCount(4);
+
+    double shortest = std::numeric_limits<double>::infinity();
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+        base::PathPtr path = solveRRT(si, env);
+        shortest = std::min(shortest, path->length());
+        hybrid.recordPath(path, i % 2 == 0);
+        BOOST_CHECK_EQUAL(hybrid.recordPath(path, false), 0u);
+        BOOST_CHECK_EQUAL(hybrid.pathCount(), (std::size_t)i + 1);
+
+        /* the hybrid path is kept up to date as paths are added */
+        hybrid.computeHybridPath();
+        BOOST_REQUIRE(hybrid.getHybridPath());
+        BOOST_CHECK(hybrid.getHybridPath()->length() <= shortest + 1e-9);
+        BOOST_CHECK(hybrid.getHybridPath()->check());
+    }
+
+    hybrid.clear();
+    BOOST_CHECK_EQUAL(hybrid.pathCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(geometric_ParallelPlan)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    base::ProblemDefinitionPtr pdef = geometric::problemDefinition2DMap(si, env);
+    tools::ParallelPlan pp(pdef);
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+        geometric::RRT *rrt = new geometric::RRT(si);
+        rrt->setRange(10.0);
+        pp.addPlanner(base::PlannerPtr(rrt));
+    }
+
+    /* the same pool of threads serves repeated calls */
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+        BOOST_CHECK(pp.solve(SOLUTION_TIME, false) == base::PlannerStatus::EXACT_SOLUTION);
+        BOOST_CHECK(pp.solve(SOLUTION_TIME, 2, 4, true) == base::PlannerStatus::EXACT_SOLUTION);
+    }
+    BOOST_CHECK(pdef->getSolutionCount() >= 10);
+
+    /* stopping the remaining planners must not terminate the caller's condition */
+    base::PlannerTerminationCondition ptc = base::timedPlannerTerminationCondition(SOLUTION_TIME);
+    BOOST_CHECK(pp.solve(ptc, false));
+    BOOST_CHECK(!ptc());
+
+    tools::OptimizePlan op(geometric::problemDefinition2DMap(si, env));
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+        geometric::RRT *rrt = new geometric::RRT(si);
+        rrt->setRange(10.0);
+        op.addPlanner(base::PlannerPtr(rrt));
+    }
+    BOOST_CHECK(op.solve(0.2, 10, 2) == base::PlannerStatus::EXACT_SOLUTION);
+}
+
+/// @cond IGNORE
+/* a planner that never finds a solution; it only waits for its termination condition */
+class IdlePlanner : public base::Planner
+{
+public:
+
+    IdlePlanner(const base::SpaceInformationPtr &si) : base::Planner(si, "Idle")
+    {
+    }
+
+    virtual base::PlannerStatus solve(const base::PlannerTerminationCondition &ptc)
+    {
+        while (!ptc())
+            boost::this_thread::sleep(time::seconds(0.001));
+        return base::PlannerStatus::TIMEOUT;
+    }
+};
+/// @endcond
+
+BOOST_AUTO_TEST_CASE(geometric_ExperiencePlan)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    base::ProblemDefinitionPtr pdef = geometric::problemDefinition2DMap(si, env);
+    tools::ExperiencePlan ep(pdef);
+    ep.setPlanner(base::PlannerPtr(new geometric::RRTConnect(si)));
+
+    /* solutions computed from scratch are recorded */
+    BOOST_CHECK(ep.solve(SOLUTION_TIME) == base::PlannerStatus::EXACT_SOLUTION);
+    BOOST_CHECK(!ep.lastSolutionFromExperience());
+    const tools::ExperienceDatabasePtr &db = ep.getExperienceDatabase();
+    BOOST_CHECK_EQUAL(db->size(), 1u);
+
+    /* the database survives storing and loading */
+    std::stringstream ss;
+    db->store(ss);
+    tools::ExperienceDatabasePtr loaded(new tools::ExperienceDatabase(si));
+    loaded->load(ss);
+    BOOST_CHECK_EQUAL(loaded->size(), 1u);
+
+    const base::State *start = pdef->getStartState(0);
+    const base::State *goal = pdef->getGoal()->as<base::GoalState>()->getState();
+    std::vector<geometric::PathGeometric> paths;
+    loaded->getSimilarPaths(start, goal, 5, paths);
+    BOOST_REQUIRE_EQUAL(paths.size(), 1u);
+    geometric::PathGeometric &solution = static_cast<geometric::PathGeometric&>(*pdef->getSolutionPath());
+    BOOST_REQUIRE_EQUAL(paths[0].getStateCount(), solution.getStateCount());
+    for (std::size_t i = 0 ; i < solution.getStateCount() ; ++i)
+        BOOST_CHECK(si->equalStates(paths[0].getState(i), solution.getState(i)));
+
+    /* a planner that cannot solve the query loses the race against the repaired previous solution */
+    base::ProblemDefinitionPtr pdef2 = geometric::problemDefinition2DMap(si, env);
+    tools::ExperiencePlan recall(pdef2, loaded);
+    recall.setPlanner(base::PlannerPtr(new IdlePlanner(si)));
+    time::point startTime = time::now();
+    BOOST_CHECK(recall.solve(10.0) == base::PlannerStatus::EXACT_SOLUTION);
+    BOOST_CHECK(time::seconds(time::now() - startTime) < 5.0);
+    BOOST_CHECK(recall.lastSolutionFromExperience());
+    BOOST_CHECK(pdef2->getSolutionPath()->check());
+    BOOST_CHECK_EQUAL(loaded->size(), 1u);
+
+    /* without previous solutions, the planner is on its own */
+    loaded->clear();
+    BOOST_CHECK(recall.solve(0.1) == base::PlannerStatus::TIMEOUT);
+    BOOST_CHECK(!recall.lastSolutionFromExperience());
+}
+
+/* solve once, then move the start along the solution, block a cell further along it and solve again with the kept tree */
+template<typename T>
+static void testTreeReuse(Environment2D &env)
+{
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+    base::ProblemDefinitionPtr pdef = geometric::problemDefinition2DMap(si, env);
+    T *tree = new T(si);
+    base::PlannerPtr planner(tree);
+    planner->setProblemDefinition(pdef);
+
+    /* without reuse, clearing the planner discards the tree */
+    BOOST_CHECK(!tree->getTreeReuse());
+    BOOST_REQUIRE(planner->solve(SOLUTION_TIME));
+    planner->clear();
+    base::PlannerData data(si);
+    planner->getPlannerData(data);
+    BOOST_CHECK_EQUAL(data.numVertices(), 0u);
+
+    tree->setTreeReuse(true);
+    pdef->clearSolutionPaths();
+    BOOST_REQUIRE(planner->solve(SOLUTION_TIME) == base::PlannerStatus::EXACT_SOLUTION);
+    geometric::PathGeometric first(static_cast<geometric::PathGeometric&>(*pdef->getSolutionPath()));
+    first.interpolate();
+    BOOST_REQUIRE(first.getStateCount() >= 4);
+
+    base::ScopedState<> start(si);
+    si->copyState(start.get(), first.getState(first.getStateCount() / 4));
+    const base::RealVectorStateSpace::StateType *block =
+        first.getState(3 * first.getStateCount() / 4)->as<base::RealVectorStateSpace::StateType>();
+    Environment2D changed = env;
+    int x = (int)block->values[0];
+    int y = (int)block->values[1];
+    if ((x != (int)env.goal.first || y != (int)env.goal.second) &&
+        (x != (int)start[0] || y != (int)start[1]))
+        changed.grid[x][y] = T_OBSTACLE;
+    si->setStateValidityChecker(base::StateValidityCheckerPtr(new geometric::StateValidityChecker2DMap(si, changed.grid)));
+
+    pdef->clearStartStates();
+    pdef->addStartState(start);
+    pdef->clearSolutionPaths();
+    planner->clear();
+    data.clear();
+    planner->getPlannerData(data);
+    BOOST_CHECK(data.numVertices() > 0);
+
+    BOOST_REQUIRE(planner->solve(SOLUTION_TIME) == base::PlannerStatus::EXACT_SOLUTION);
+    geometric::PathGeometric &second = static_cast<geometric::PathGeometric&>(*pdef->getSolutionPath());
+    BOOST_CHECK(si->equalStates(second.getState(0), start.get()));
+    BOOST_CHECK(pdef->getGoal()->isSatisfied(second.getStates().back()));
+    BOOST_CHECK(second.check());
+}
+
+BOOST_AUTO_TEST_CASE(geometric_TreeReuse)
+{
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+        testTreeReuse<geometric::RRT>(env);
+        testTreeReuse<geometric::RRTConnect>(env);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
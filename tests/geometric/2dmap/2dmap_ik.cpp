@@ -87,3 +87,53 @@ BOOST_AUTO_TEST_CASE(SimpleIK)
     time = time / (double)N;
     BOOST_CHECK(time < 0.01);
 }
+
+BOOST_AUTO_TEST_CASE(IslandIK)
+{
+    Environment2D env;
+    boost::filesystem::path path(TEST_RESOURCES_DIR);
+    path = path / "env1.txt";
+    loadEnvironment(path.string().c_str(), env);
+
+    if (env.width * env.height == 0)
+    {
+        BOOST_FAIL( "The environment has a 0 dimension. Cannot continue" );
+    }
+
+    base::SpaceInformationPtr si = geometric::spaceInformation2DMap(env);
+
+    base::GoalState goal(si);
+    base::ScopedState<base::RealVectorStateSpace> gstate(si);
+    gstate->values[0] = env.goal.first;
+    gstate->values[1] = env.goal.second;
+    goal.setState(gstate);
+    goal.setThreshold(1e-3);
+
+    geometric::GAIK gaik(si);
+    gaik.setRange(5.0);
+    gaik.setThreadCount(4);
+    gaik.setMigrationInterval(2);
+    BOOST_CHECK_EQUAL(gaik.getThreadCount(), 4u);
+    base::ScopedState<base::RealVectorStateSpace> found(si);
+
+    /* start from fresh populations, so that the islands evolve and exchange individuals */
+    const int N = 20;
+    for (int i = 0 ; i < N ; ++i)
+    {
+        gaik.clear();
+        BOOST_CHECK(gaik.solve(1.0, goal, found.get()));
+        BOOST_CHECK(si->distance(found.get(), gstate.get()) < 1e-3);
+    }
+
+    /* hints are spread over the islands; a hint that satisfies the goal is returned right away */
+    std::vector<base::State*> hint(1, gstate.get());
+    gaik.clear();
+    BOOST_CHECK(gaik.solve(1.0, goal, found.get(), hint));
+    BOOST_CHECK(si->distance(found.get(), gstate.get()) < 1e-3);
+
+    /* with hill climbing, the best individuals of all islands are improved in parallel */
+    goal.setThreshold(0.5);
+    gaik.setTryImprove(true);
+    BOOST_CHECK(gaik.solve(1.0, goal, found.get()));
+    BOOST_CHECK(goal.isSatisfied(found.get()));
+}
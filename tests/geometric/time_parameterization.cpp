@@ -0,0 +1,247 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Rice University
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Rice University nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#define BOOST_TEST_MODULE "TimeParameterization"
+#include <boost/test/unit_test.hpp>
+
+#include "ompl/geometric/TimeParameterization.h"
+#include "ompl/base/spaces/RealVectorStateSpace.h"
+#include "ompl/base/spaces/SO2StateSpace.h"
+#include "ompl/base/ScopedState.h"
+#include <cmath>
+
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+static base::SpaceInformationPtr planarSpace(void)
+{
+    base::RealVectorStateSpace *space = new base::RealVectorStateSpace(2);
+    space->setBounds(-100.0, 100.0);
+    base::SpaceInformationPtr si(new base::SpaceInformation(base::StateSpacePtr(space)));
+    si->setup();
+    return si;
+}
+
+static void addState(geometric::PathGeometric &path, double x, double y)
+{
+    base::ScopedState<base::RealVectorStateSpace> s(path.getSpaceInformation());
+    s->values[0] = x;
+    s->values[1] = y;
+    path.append(s.get());
+}
+
+BOOST_AUTO_TEST_CASE(StraightLine)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    addState(path, 0.0, 0.0);
+    addState(path, 10.0, 0.0);
+    path.interpolate(101);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2, 1.0), acc(2, 1.0), jerk;
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+    BOOST_REQUIRE_EQUAL(times.size(), path.getStateCount());
+    BOOST_REQUIRE_EQUAL(velocities.size(), path.getStateCount());
+
+    // accelerate for 1s, cruise for 9s, decelerate for 1s
+    BOOST_CHECK_CLOSE(times.back(), 11.0, 1e-6);
+    BOOST_CHECK_CLOSE(velocities[50], 1.0, 1e-6);
+    BOOST_CHECK_SMALL(velocities.front(), 1e-12);
+    BOOST_CHECK_SMALL(velocities.back(), 1e-12);
+
+    // with a jerk limit, changing speed takes longer
+    std::vector<double> jtimes, jvelocities;
+    jerk.resize(2, 1.0);
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, jtimes, jvelocities));
+    BOOST_CHECK(jtimes.back() > times.back());
+    for (std::size_t i = 1 ; i < jtimes.size() ; ++i)
+        BOOST_CHECK(jtimes[i] >= jtimes[i - 1]);
+}
+
+BOOST_AUTO_TEST_CASE(JointLimits)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    addState(path, 0.0, 0.0);
+    addState(path, 10.0, 10.0);
+    path.interpolate(50);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2), acc(2, 2.0), jerk(2, 10.0);
+    vel[0] = 1.0;
+    vel[1] = 0.5;
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+
+    // no joint moves faster than its limit, on average over any segment
+    for (std::size_t i = 1 ; i < times.size() ; ++i)
+    {
+        const double *a = path.getState(i - 1)->as<base::RealVectorStateSpace::StateType>()->values;
+        const double *b = path.getState(i)->as<base::RealVectorStateSpace::StateType>()->values;
+        BOOST_CHECK(fabs(b[1] - a[1]) <= vel[1] * (times[i] - times[i - 1]) + 1e-9);
+        BOOST_CHECK(velocities[i] <= 0.5 * sqrt(2.0) + 1e-9);
+    }
+    // the second joint needs at least 20s
+    BOOST_CHECK(times.back() >= 20.0);
+}
+
+BOOST_AUTO_TEST_CASE(Corner)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    addState(path, 0.0, 0.0);
+    addState(path, 5.0, 0.0);
+    addState(path, 5.0, 5.0);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2, 1.0), acc(2, 1.0), jerk;
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities, 0.0, 0.0));
+
+    // the path stops at the right angle turn, so each leg is a separate motion
+    BOOST_CHECK_SMALL(velocities[1], 1e-12);
+    BOOST_CHECK_CLOSE(times[1], 6.0, 1e-6);
+    BOOST_CHECK_CLOSE(times[2], 12.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(ShallowCorner)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    addState(path, 0.0, 0.0);
+    addState(path, 5.0, 0.0);
+    addState(path, 10.0, 2.0);
+    path.interpolate(41);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2, 1.0), acc(2), jerk;
+    acc[0] = 1.0;
+    acc[1] = 0.5;
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities, 0.0, 0.0));
+
+    // the velocity of each joint at a state is the same whether it is computed from the segment before or
+    // after it, and it changes along each segment no faster than the acceleration limit of the joint allows
+    std::vector<double> dirIn(2, 0.0), dirOut(2);
+    for (std::size_t i = 0 ; i + 1 < path.getStateCount() ; ++i)
+    {
+        const double *a = path.getState(i)->as<base::RealVectorStateSpace::StateType>()->values;
+        const double *b = path.getState(i + 1)->as<base::RealVectorStateSpace::StateType>()->values;
+        const double length = sqrt((b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]));
+        for (unsigned int j = 0 ; j < 2 ; ++j)
+        {
+            dirOut[j] = (b[j] - a[j]) / length;
+            BOOST_CHECK_SMALL(velocities[i] * (dirOut[j] - dirIn[j]), 1e-9);
+            BOOST_CHECK(fabs(velocities[i + 1] - velocities[i]) * fabs(dirOut[j]) <= acc[j] * (times[i + 1] - times[i]) + 1e-9);
+        }
+        dirIn = dirOut;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Reversal)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    for (int i = 0 ; i <= 20 ; ++i)
+        addState(path, 0.5 * (i <= 10 ? i : 20 - i), 0.0);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2, 1.0), acc(2, 1.0), jerk;
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities, 0.0, 0.0));
+
+    // the path stops where it turns back, so each leg is a separate motion
+    BOOST_CHECK_SMALL(velocities[10], 1e-12);
+    BOOST_CHECK_CLOSE(times[10], 6.0, 1e-6);
+    BOOST_CHECK_CLOSE(times.back(), 12.0, 1e-6);
+
+    // the speed never changes faster than the acceleration limit allows
+    for (std::size_t i = 1 ; i < times.size() ; ++i)
+        BOOST_CHECK(fabs(velocities[i] - velocities[i - 1]) <= acc[0] * (times[i] - times[i - 1]) + 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(LongPath)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    for (int i = 0 ; i < 20000 ; ++i)
+        addState(path, 50.0 * cos(i * 0.001), 50.0 * sin(i * 0.001));
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(2, 1.0), acc(2, 1.0), jerk(2, 1.0);
+    BOOST_REQUIRE(tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+    BOOST_CHECK_EQUAL(times.size(), path.getStateCount());
+    BOOST_CHECK(times.back() > path.length() / sqrt(2.0));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidLimits)
+{
+    base::SpaceInformationPtr si = planarSpace();
+    geometric::PathGeometric path(si);
+    addState(path, 0.0, 0.0);
+    addState(path, 1.0, 0.0);
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(3, 1.0), acc(2, 1.0), jerk;
+    BOOST_CHECK(!tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+    vel.resize(2);
+    acc[1] = 0.0;
+    BOOST_CHECK(!tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+
+    // the start velocity exceeds the joint limits
+    acc[1] = 1.0;
+    BOOST_CHECK(!tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities, 2.0));
+}
+
+BOOST_AUTO_TEST_CASE(RealVectorOnly)
+{
+    base::SpaceInformationPtr si(new base::SpaceInformation(base::StateSpacePtr(new base::SO2StateSpace())));
+    si->setup();
+    geometric::PathGeometric path(si);
+    base::ScopedState<base::SO2StateSpace> s(si);
+    s->value = 3.0;
+    path.append(s.get());
+    s->value = -3.0;
+    path.append(s.get());
+
+    geometric::TimeParameterization tp;
+    std::vector<double> times, velocities;
+    std::vector<double> vel(1, 1.0), acc(1, 1.0), jerk;
+    BOOST_CHECK(!tp.computeTimeOptimalParametrization(path, vel, acc, jerk, times, velocities));
+}
@@ -0,0 +1,201 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2012, Willow Garage, Inc.
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the Willow Garage nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+
+#define BOOST_TEST_MODULE "Profiler"
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <sstream>
+#include "ompl/tools/debug/Profiler.h"
+#include "../BoostTestTeamCityReporter.h"
+
+using namespace ompl;
+
+static void recordEvents(tools::Profiler *prof, unsigned int n)
+{
+    static const tools::Profiler::Key key = tools::Profiler::Register("test.keyed");
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        prof->event(key);
+        prof->event("test.named", 2);
+        tools::Profiler::ScopedBlock block(key, *prof);
+    }
+}
+
+static bool contains(const std::string &text, const std::string &line)
+{
+    return text.find(line) != std::string::npos;
+}
+
+BOOST_AUTO_TEST_CASE(Register)
+{
+    tools::Profiler::Key a = tools::Profiler::Register("test.register.a");
+    tools::Profiler::Key b = tools::Profiler::Register("test.register.b");
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL(a, tools::Profiler::Register("test.register.a"));
+    BOOST_CHECK_EQUAL(tools::Profiler::KeyName(b), "test.register.b");
+}
+
+BOOST_AUTO_TEST_CASE(MergeThreads)
+{
+    tools::Profiler prof;
+    prof.start();
+
+    // some threads terminate before status() is called, the calling thread does not
+    std::vector<boost::thread*> threads;
+    for (unsigned int i = 0 ; i < 4 ; ++i)
+        threads.push_back(new boost::thread(boost::bind(&recordEvents, &prof, 1000)));
+    recordEvents(&prof, 1000);
+    for (unsigned int i = 0 ; i < threads.size() ; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    std::stringstream ss;
+    prof.status(ss);
+    BOOST_CHECK(contains(ss.str(), "test.keyed: 5000\n"));
+    BOOST_CHECK(contains(ss.str(), "test.named: 10000\n"));
+    BOOST_CHECK(contains(ss.str(), "5000 parts"));
+
+    prof.clear();
+    std::stringstream empty;
+    prof.status(empty);
+    BOOST_CHECK(!contains(empty.str(), "test.keyed"));
+}
+
+static void toggleWhileRecording(tools::Profiler *prof, unsigned int n)
+{
+    for (unsigned int i = 0 ; i < n ; ++i)
+    {
+        prof->clear();
+        prof->setTimelineEnabled(i % 2 == 0);
+        boost::this_thread::yield();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ClearWhileRecording)
+{
+    tools::Profiler prof;
+    prof.setTimelineCapacity(64, 2);
+
+    // the recording threads reset their own data after clear()
+    std::vector<boost::thread*> threads;
+    for (unsigned int i = 0 ; i < 4 ; ++i)
+        threads.push_back(new boost::thread(boost::bind(&recordEvents, &prof, 20000)));
+    toggleWhileRecording(&prof, 100);
+    for (unsigned int i = 0 ; i < threads.size() ; ++i)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    prof.clear();
+    recordEvents(&prof, 10);
+    std::stringstream ss;
+    prof.status(ss);
+    BOOST_CHECK(contains(ss.str(), "test.keyed: 10\n"));
+}
+
+static void recordAndWait(tools::Profiler *prof, boost::barrier *barrier)
+{
+    recordEvents(prof, 10);
+    barrier->wait();
+    // the profiler is destroyed while this thread is still running
+    barrier->wait();
+}
+
+BOOST_AUTO_TEST_CASE(DestroyBeforeThreads)
+{
+    boost::barrier barrier(2);
+    tools::Profiler *prof = new tools::Profiler();
+    boost::thread t(boost::bind(&recordAndWait, prof, &barrier));
+    barrier.wait();
+    recordEvents(prof, 10);
+    delete prof;
+    barrier.wait();
+    t.join();
+}
+
+BOOST_AUTO_TEST_CASE(Disabled)
+{
+    tools::Profiler prof;
+    prof.setEnabled(false);
+    recordEvents(&prof, 10);
+    prof.setEnabled(true);
+    prof.event("test.enabled");
+
+    std::stringstream ss;
+    prof.status(ss);
+    BOOST_CHECK(!contains(ss.str(), "test.keyed"));
+    BOOST_CHECK(contains(ss.str(), "test.enabled: 1\n"));
+}
+
+static unsigned int countOccurrences(const std::string &text, const std::string &what)
+{
+    unsigned int n = 0;
+    for (std::size_t pos = text.find(what) ; pos != std::string::npos ; pos = text.find(what, pos + what.size()))
+        ++n;
+    return n;
+}
+
+BOOST_AUTO_TEST_CASE(Timeline)
+{
+    tools::Profiler prof;
+    prof.setTimelineEnabled(true);
+    prof.setTimelineCapacity(16, 2);
+
+    // each call records 3 events and one block (a begin and an end entry)
+    recordEvents(&prof, 2);
+    std::stringstream small;
+    prof.timeline(small);
+    BOOST_CHECK_EQUAL(countOccurrences(small.str(), "\"ph\":\"B\""), 2u);
+    BOOST_CHECK_EQUAL(countOccurrences(small.str(), "\"ph\":\"E\""), 2u);
+    BOOST_CHECK_EQUAL(countOccurrences(small.str(), "\"ph\":\"i\""), 4u);
+    BOOST_CHECK(contains(small.str(), "\"name\":\"test.keyed\""));
+
+    // the ring buffers bound the number of kept entries
+    for (unsigned int i = 0 ; i < 4 ; ++i)
+    {
+        boost::thread t(boost::bind(&recordEvents, &prof, 100));
+        t.join();
+    }
+    recordEvents(&prof, 100);
+    std::stringstream large;
+    prof.timeline(large);
+    BOOST_CHECK(countOccurrences(large.str(), "\"cat\":\"ompl\"") <= 3 * 16u);
+    BOOST_CHECK_EQUAL(countOccurrences(large.str(), "\"thread_name\""), 3u);
+    // every block that is written out is closed
+    BOOST_CHECK(countOccurrences(large.str(), "\"ph\":\"E\"") <= countOccurrences(large.str(), "\"ph\":\"B\""));
+}
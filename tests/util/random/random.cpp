@@ -205,3 +205,65 @@ BOOST_AUTO_TEST_CASE(NormalReals)
 {
     BOOST_OMPL_EXPECT_NEAR(avgNormalReals(10.0, 1.0), 10.0, errNormal(1.0));
 }
+
+BOOST_AUTO_TEST_CASE(ArrayReals)
+{
+    RNG r;
+    std::vector<double> v(NUM_REAL_SAMPLES + 1);
+    r.uniformRealArray(-2.0, 4.0, &v[0], v.size());
+    double sum = 0.0;
+    for (std::size_t i = 0 ; i < v.size() ; ++i)
+    {
+        BOOST_CHECK(v[i] >= -2.0 && v[i] < 4.0);
+        sum += v[i];
+    }
+    BOOST_OMPL_EXPECT_NEAR(sum / (double)v.size(), 1.0, errUniformReal(-2, 4));
+
+    r.gaussianArray(10.0, 1.0, &v[0], v.size());
+    sum = 0.0;
+    double sq = 0.0;
+    for (std::size_t i = 0 ; i < v.size() ; ++i)
+    {
+        sum += v[i];
+        sq += (v[i] - 10.0) * (v[i] - 10.0);
+    }
+    BOOST_OMPL_EXPECT_NEAR(sum / (double)v.size(), 10.0, errNormal(1.0));
+    BOOST_OMPL_EXPECT_NEAR(sq / (double)v.size(), 1.0, 0.01);
+
+    std::vector<double> q(4 * 1001);
+    r.quaternionArray(&q[0], 1001);
+    for (std::size_t i = 0 ; i < q.size() ; i += 4)
+        BOOST_OMPL_EXPECT_NEAR(q[i] * q[i] + q[i + 1] * q[i + 1] + q[i + 2] * q[i + 2] + q[i + 3] * q[i + 3], 1.0, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(Streams)
+{
+    RNG a(5, 1), b(5, 1), c(5, 2);
+    double va[8], vb[8], vc[8];
+    a.uniform01Array(va, 8);
+    b.uniform01Array(vb, 8);
+    c.uniform01Array(vc, 8);
+    int same = 0;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        BOOST_CHECK_EQUAL(va[i], vb[i]);
+        if (va[i] == vc[i])
+            ++same;
+    }
+    BOOST_CHECK_EQUAL(same, 0);
+    BOOST_CHECK_EQUAL(a.uniformInt(0, 1000000), b.uniformInt(0, 1000000));
+
+    /* every stream value gives its own sequence, including the largest one */
+    RNG d(5, 0), e(5, 0xFFFFFFFFu);
+    double vd[8], ve[8];
+    d.uniform01Array(vd, 8);
+    e.uniform01Array(ve, 8);
+    same = 0;
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+        BOOST_CHECK(ve[i] >= 0.0 && ve[i] < 1.0);
+        if (vd[i] == ve[i] || va[i] == ve[i])
+            ++same;
+    }
+    BOOST_CHECK_EQUAL(same, 0);
+}